@@ -100,6 +100,8 @@ public:
 template <typename S>
 void SSaPCollisionManager<S>::unregisterObject(CollisionObject<S>* obj)
 {
+  this->removePersistentPairs(obj);
+
   setup();
 
   DummyCollisionObject<S> dummyHigh(AABB<S>(obj->getAABB().max_));
@@ -186,6 +188,8 @@ void SSaPCollisionManager<S>::update()
 template <typename S>
 void SSaPCollisionManager<S>::clear()
 {
+  this->removeAllPersistentPairs();
+
   objs_x.clear();
   objs_y.clear();
   objs_z.clear();
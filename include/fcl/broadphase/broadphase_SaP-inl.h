@@ -51,6 +51,8 @@ class FCL_EXPORT SaPCollisionManager<double>;
 template <typename S>
 void SaPCollisionManager<S>::unregisterObject(CollisionObject<S>* obj)
 {
+  this->removePersistentPairs(obj);
+
   auto it = AABB_arr.begin();
   for(auto end = AABB_arr.end(); it != end; ++it)
   {
@@ -109,6 +111,8 @@ SaPCollisionManager<S>::SaPCollisionManager()
 template <typename S>
 SaPCollisionManager<S>::~SaPCollisionManager()
 {
+  // The kept pairs are not reported when the manager goes away
+  this->clearPersistentPairs();
   clear();
 }
 
@@ -520,6 +524,8 @@ void SaPCollisionManager<S>::update()
 template <typename S>
 void SaPCollisionManager<S>::clear()
 {
+  this->removeAllPersistentPairs();
+
   for(auto it = AABB_arr.begin(), end = AABB_arr.end(); it != end; ++it)
   {
     delete (*it)->hi;
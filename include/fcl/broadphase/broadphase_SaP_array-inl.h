@@ -0,0 +1,889 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#ifndef FCL_BROAD_PHASE_SAP_ARRAY_INL_H
+#define FCL_BROAD_PHASE_SAP_ARRAY_INL_H
+
+#include "fcl/broadphase/broadphase_SaP_array.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace fcl
+{
+
+//==============================================================================
+extern template
+class FCL_EXPORT SaPCollisionManager_Array<double>;
+
+//==============================================================================
+template <typename S>
+SaPCollisionManager_Array<S>::SaPCollisionManager_Array()
+{
+  num_persistent_pairs = 0;
+  optimal_axis = 0;
+  for(size_t axis = 0; axis < 3; ++axis)
+    max_extent[axis] = 0;
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::registerObjects(const std::vector<CollisionObject<S>*>& other_objs)
+{
+  if(other_objs.empty()) return;
+
+  for(CollisionObject<S>* obj : other_objs)
+  {
+    if(obj_slot_map.find(obj) != obj_slot_map.end())
+      continue;
+
+    const uint32 slot = allocateSlot(obj);
+    objs[slot] = obj;
+    aabbs[slot] = obj->getAABB();
+    alive[slot] = true;
+    obj_slot_map[obj] = slot;
+
+    for(size_t axis = 0; axis < 3; ++axis)
+    {
+      endpoints[axis].push_back({aabbs[slot].min_[axis], 2 * slot});
+      endpoints[axis].push_back({aabbs[slot].max_[axis], 2 * slot + 1});
+    }
+  }
+
+  // Sorting from scratch beats one insertion sort pass per new object
+  rebuild();
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::registerObject(CollisionObject<S>* obj)
+{
+  if(obj_slot_map.find(obj) != obj_slot_map.end())
+    return;
+
+  const uint32 slot = allocateSlot(obj);
+  objs[slot] = obj;
+  aabbs[slot] = obj->getAABB();
+  alive[slot] = true;
+  obj_slot_map[obj] = slot;
+
+  // The new end points enter at the back and move into place, meeting every
+  // interval they overlap along the way
+  for(size_t axis = 0; axis < 3; ++axis)
+  {
+    max_extent[axis] = std::max(max_extent[axis],
+                                aabbs[slot].max_[axis] - aabbs[slot].min_[axis]);
+    endpoints[axis].push_back({aabbs[slot].min_[axis], 2 * slot});
+    endpoints[axis].push_back({aabbs[slot].max_[axis], 2 * slot + 1});
+    insertionSort(axis);
+  }
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::unregisterObject(CollisionObject<S>* obj)
+{
+  auto it = obj_slot_map.find(obj);
+  if(it == obj_slot_map.end())
+    return;
+
+  const uint32 slot = it->second;
+  obj_slot_map.erase(it);
+  alive[slot] = false;
+
+  // The pairs of the object are among the intervals that overlap its own
+  const size_t axis = optimal_axis;
+  const auto range = candidateRange(axis, aabbs[slot]);
+  for(auto pos = range.first; pos != range.second; ++pos)
+  {
+    if(!pos->isMax() && pos->slot() != slot)
+      removePair(slot, pos->slot());
+  }
+
+  // Its pairs reported by collidePersistent() are reported as removed while
+  // the object is alive, before the slot is given to another object
+  std::vector<detail::PairHashSet::Key> removed_keys;
+  static_cast<const detail::PairHashSet&>(persistent_removed).forEach(
+        [&](detail::PairHashSet::Key key, unsigned char)
+  {
+    if(detail::PairHashSet::first(key) == slot || detail::PairHashSet::second(key) == slot)
+      removed_keys.push_back(key);
+  });
+
+  for(detail::PairHashSet::Key key : removed_keys)
+  {
+    if(this->persistent_removed_pair)
+    {
+      const ObjectPair pair = makeObjectPair(detail::PairHashSet::first(key),
+                                             detail::PairHashSet::second(key));
+      this->persistent_removed_pair(pair.first, pair.second, this->persistent_cdata);
+    }
+    persistent_removed.erase(key);
+    --num_persistent_pairs;
+  }
+
+  for(size_t axis = 0; axis < 3; ++axis)
+  {
+    endpoints[axis].erase(
+          std::remove_if(endpoints[axis].begin(), endpoints[axis].end(),
+                         [slot](const EndPoint& e) { return e.slot() == slot; }),
+          endpoints[axis].end());
+  }
+
+  // objs[slot] stays valid until the removed pairs are published
+  pending_free_slots.push_back(slot);
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::setup()
+{
+  computeOptimalAxis();
+  publishPairs();
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::update()
+{
+  for(size_t slot = 0; slot < objs.size(); ++slot)
+  {
+    if(alive[slot])
+      aabbs[slot] = objs[slot]->getAABB();
+  }
+
+  updateEndPoints();
+  computeOptimalAxis();
+  publishPairs();
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::update(CollisionObject<S>* updated_obj)
+{
+  auto it = obj_slot_map.find(updated_obj);
+  if(it != obj_slot_map.end())
+    aabbs[it->second] = updated_obj->getAABB();
+
+  updateEndPoints();
+  computeOptimalAxis();
+  publishPairs();
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::update(const std::vector<CollisionObject<S>*>& updated_objs)
+{
+  for(CollisionObject<S>* obj : updated_objs)
+  {
+    auto it = obj_slot_map.find(obj);
+    if(it != obj_slot_map.end())
+      aabbs[it->second] = obj->getAABB();
+  }
+
+  updateEndPoints();
+  computeOptimalAxis();
+  publishPairs();
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::clear()
+{
+  if(this->persistent_removed_pair)
+  {
+    auto report = [&](detail::PairHashSet::Key key)
+    {
+      const ObjectPair pair = makeObjectPair(detail::PairHashSet::first(key),
+                                             detail::PairHashSet::second(key));
+      this->persistent_removed_pair(pair.first, pair.second, this->persistent_cdata);
+    };
+
+    static_cast<const detail::PairHashSet&>(overlap_pairs).forEach(
+          [&](detail::PairHashSet::Key key, unsigned char tag)
+    {
+      if(tag & PAIR_REPORTED)
+        report(key);
+    });
+    static_cast<const detail::PairHashSet&>(persistent_removed).forEach(
+          [&](detail::PairHashSet::Key key, unsigned char)
+    {
+      report(key);
+    });
+  }
+
+  for(size_t axis = 0; axis < 3; ++axis)
+    endpoints[axis].clear();
+
+  objs.clear();
+  aabbs.clear();
+  alive.clear();
+  free_slots.clear();
+  pending_free_slots.clear();
+
+  overlap_pairs.clear();
+  removed_since_publish.clear();
+  added_pairs.clear();
+  removed_pairs.clear();
+  persistent_removed.clear();
+  num_persistent_pairs = 0;
+
+  obj_slot_map.clear();
+  optimal_axis = 0;
+  for(size_t axis = 0; axis < 3; ++axis)
+    max_extent[axis] = 0;
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::getObjects(std::vector<CollisionObject<S>*>& objs_) const
+{
+  objs_.resize(size());
+  size_t i = 0;
+  for(size_t slot = 0; slot < objs.size(); ++slot)
+  {
+    if(alive[slot])
+      objs_[i++] = objs[slot];
+  }
+}
+
+//==============================================================================
+template <typename S>
+std::pair<typename std::vector<typename SaPCollisionManager_Array<S>::EndPoint>::const_iterator,
+          typename std::vector<typename SaPCollisionManager_Array<S>::EndPoint>::const_iterator>
+SaPCollisionManager_Array<S>::candidateRange(size_t axis, const AABB<S>& aabb) const
+{
+  const std::vector<EndPoint>& list = endpoints[axis];
+
+  // Only the intervals starting no later than aabb ends, and no earlier than
+  // the longest interval before it starts, can overlap it
+  EndPoint dummy;
+  dummy.value = aabb.max_[axis];
+  dummy.data = 1;
+  const auto end_pos = std::upper_bound(list.begin(), list.end(), dummy);
+  dummy.value = aabb.min_[axis] - max_extent[axis];
+  dummy.data = 0;
+  const auto begin_pos = std::lower_bound(list.begin(), end_pos, dummy);
+
+  return std::make_pair(begin_pos, end_pos);
+}
+
+//==============================================================================
+template <typename S>
+bool SaPCollisionManager_Array<S>::collide_(CollisionObject<S>* obj, void* cdata, CollisionCallBack<S> callback) const
+{
+  const AABB<S>& obj_aabb = obj->getAABB();
+  const auto range = candidateRange(optimal_axis, obj_aabb);
+
+  for(auto pos = range.first; pos != range.second; ++pos)
+  {
+    if(pos->isMax())
+      continue;
+
+    const uint32 slot = pos->slot();
+    if(objs[slot] != obj && aabbs[slot].overlap(obj_aabb))
+    {
+      if(callback(obj, objs[slot], cdata))
+        return true;
+    }
+  }
+
+  return false;
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::collide(CollisionObject<S>* obj, void* cdata, CollisionCallBack<S> callback) const
+{
+  if(size() == 0) return;
+
+  collide_(obj, cdata, callback);
+}
+
+//==============================================================================
+template <typename S>
+bool SaPCollisionManager_Array<S>::distance_(CollisionObject<S>* obj, void* cdata, DistanceCallBack<S> callback, S& min_dist) const
+{
+  Vector3<S> delta = (obj->getAABB().max_ - obj->getAABB().min_) * 0.5;
+  AABB<S> aabb = obj->getAABB();
+
+  if(min_dist < std::numeric_limits<S>::max())
+  {
+    Vector3<S> min_dist_delta(min_dist, min_dist, min_dist);
+    aabb.expand(min_dist_delta);
+  }
+
+  const size_t axis = optimal_axis;
+  const std::vector<EndPoint>& list = endpoints[axis];
+
+  int status = 1;
+  S old_min_distance;
+
+  while(1)
+  {
+    old_min_distance = min_dist;
+    S min_val = aabb.min_[axis];
+
+    EndPoint dummy;
+    dummy.value = aabb.max_[axis];
+    dummy.data = 1;
+    const auto end_pos = std::upper_bound(list.begin(), list.end(), dummy);
+
+    for(auto pos = list.begin(); pos != end_pos; ++pos)
+    {
+      if(pos->isMax())
+        continue;
+
+      const uint32 slot = pos->slot();
+      if(aabbs[slot].max_[axis] < min_val)
+        continue;
+
+      CollisionObject<S>* curr_obj = objs[slot];
+      if(curr_obj == obj)
+        continue;
+
+      if(!this->enable_tested_set_)
+      {
+        if(aabbs[slot].distance(obj->getAABB()) < min_dist)
+        {
+          if(callback(curr_obj, obj, cdata, min_dist))
+            return true;
+        }
+      }
+      else
+      {
+        if(!this->inTestedSet(curr_obj, obj))
+        {
+          if(aabbs[slot].distance(obj->getAABB()) < min_dist)
+          {
+            if(callback(curr_obj, obj, cdata, min_dist))
+              return true;
+          }
+
+          this->insertTestedSet(curr_obj, obj);
+        }
+      }
+    }
+
+    if(status == 1)
+    {
+      if(old_min_distance < std::numeric_limits<S>::max())
+        break;
+      else
+      {
+        if(min_dist < old_min_distance)
+        {
+          Vector3<S> min_dist_delta(min_dist, min_dist, min_dist);
+          aabb = AABB<S>(obj->getAABB(), min_dist_delta);
+          status = 0;
+        }
+        else
+        {
+          if(aabb.equal(obj->getAABB()))
+            aabb.expand(delta);
+          else
+            aabb.expand(obj->getAABB(), 2.0);
+        }
+      }
+    }
+    else if(status == 0)
+      break;
+  }
+
+  return false;
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::distance(CollisionObject<S>* obj, void* cdata, DistanceCallBack<S> callback) const
+{
+  if(size() == 0) return;
+
+  S min_dist = std::numeric_limits<S>::max();
+
+  distance_(obj, cdata, callback, min_dist);
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::collide(void* cdata, CollisionCallBack<S> callback) const
+{
+  if(size() == 0) return;
+
+  overlap_pairs.findIf([&](detail::PairHashSet::Key key, unsigned char)
+  {
+    CollisionObject<S>* obj1 = objs[detail::PairHashSet::first(key)];
+    CollisionObject<S>* obj2 = objs[detail::PairHashSet::second(key)];
+
+    return callback(obj1, obj2, cdata);
+  });
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::distance(void* cdata, DistanceCallBack<S> callback) const
+{
+  if(size() == 0) return;
+
+  this->enable_tested_set_ = true;
+  this->tested_set.clear();
+
+  S min_dist = std::numeric_limits<S>::max();
+
+  for(size_t slot = 0; slot < objs.size(); ++slot)
+  {
+    if(!alive[slot])
+      continue;
+
+    if(distance_(objs[slot], cdata, callback, min_dist))
+      break;
+  }
+
+  this->enable_tested_set_ = false;
+  this->tested_set.clear();
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::collide(BroadPhaseCollisionManager<S>* other_manager_, void* cdata, CollisionCallBack<S> callback) const
+{
+  SaPCollisionManager_Array* other_manager = static_cast<SaPCollisionManager_Array*>(other_manager_);
+
+  if((size() == 0) || (other_manager->size() == 0)) return;
+
+  if(this == other_manager)
+  {
+    collide(cdata, callback);
+    return;
+  }
+
+  // Query the larger manager with the objects of the smaller one
+  const SaPCollisionManager_Array* queried = this;
+  const SaPCollisionManager_Array* querying = other_manager;
+  if(this->size() < other_manager->size())
+    std::swap(queried, querying);
+
+  for(size_t slot = 0; slot < querying->objs.size(); ++slot)
+  {
+    if(!querying->alive[slot])
+      continue;
+
+    if(queried->collide_(querying->objs[slot], cdata, callback))
+      return;
+  }
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::distance(BroadPhaseCollisionManager<S>* other_manager_, void* cdata, DistanceCallBack<S> callback) const
+{
+  SaPCollisionManager_Array* other_manager = static_cast<SaPCollisionManager_Array*>(other_manager_);
+
+  if((size() == 0) || (other_manager->size() == 0)) return;
+
+  if(this == other_manager)
+  {
+    distance(cdata, callback);
+    return;
+  }
+
+  S min_dist = std::numeric_limits<S>::max();
+
+  const SaPCollisionManager_Array* queried = this;
+  const SaPCollisionManager_Array* querying = other_manager;
+  if(this->size() < other_manager->size())
+    std::swap(queried, querying);
+
+  for(size_t slot = 0; slot < querying->objs.size(); ++slot)
+  {
+    if(!querying->alive[slot])
+      continue;
+
+    if(queried->distance_(querying->objs[slot], cdata, callback, min_dist))
+      return;
+  }
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::collidePersistent(
+    void* cdata,
+    PairCallBack<S> new_pair,
+    PairCallBack<S> persisting_pair,
+    PairCallBack<S> removed_pair)
+{
+  this->persistent_cdata = cdata;
+  this->persistent_removed_pair = removed_pair;
+
+  if(removed_pair)
+  {
+    static_cast<const detail::PairHashSet&>(persistent_removed).forEach(
+          [&](detail::PairHashSet::Key key, unsigned char)
+    {
+      const ObjectPair pair = makeObjectPair(detail::PairHashSet::first(key),
+                                             detail::PairHashSet::second(key));
+      removed_pair(pair.first, pair.second, cdata);
+    });
+  }
+  persistent_removed.clear();
+
+  overlap_pairs.forEach([&](detail::PairHashSet::Key key, unsigned char& tag)
+  {
+    const ObjectPair pair = makeObjectPair(detail::PairHashSet::first(key),
+                                           detail::PairHashSet::second(key));
+    if(tag & PAIR_REPORTED)
+    {
+      if(persisting_pair)
+        persisting_pair(pair.first, pair.second, cdata);
+    }
+    else
+    {
+      tag |= PAIR_REPORTED;
+      if(new_pair)
+        new_pair(pair.first, pair.second, cdata);
+    }
+  });
+
+  num_persistent_pairs = overlap_pairs.size();
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::clearPersistentPairs()
+{
+  overlap_pairs.forEach([](detail::PairHashSet::Key, unsigned char& tag)
+  {
+    tag &= ~PAIR_REPORTED;
+  });
+  persistent_removed.clear();
+  num_persistent_pairs = 0;
+  BroadPhaseCollisionManager<S>::clearPersistentPairs();
+}
+
+//==============================================================================
+template <typename S>
+size_t SaPCollisionManager_Array<S>::numPersistentPairs() const
+{
+  return num_persistent_pairs;
+}
+
+//==============================================================================
+template <typename S>
+bool SaPCollisionManager_Array<S>::empty() const
+{
+  return obj_slot_map.empty();
+}
+
+//==============================================================================
+template <typename S>
+size_t SaPCollisionManager_Array<S>::size() const
+{
+  return obj_slot_map.size();
+}
+
+//==============================================================================
+template <typename S>
+size_t SaPCollisionManager_Array<S>::numOverlapPairs() const
+{
+  return overlap_pairs.size();
+}
+
+//==============================================================================
+template <typename S>
+const std::vector<typename SaPCollisionManager_Array<S>::ObjectPair>&
+SaPCollisionManager_Array<S>::getAddedPairs() const
+{
+  return added_pairs;
+}
+
+//==============================================================================
+template <typename S>
+const std::vector<typename SaPCollisionManager_Array<S>::ObjectPair>&
+SaPCollisionManager_Array<S>::getRemovedPairs() const
+{
+  return removed_pairs;
+}
+
+//==============================================================================
+template <typename S>
+uint32 SaPCollisionManager_Array<S>::allocateSlot(CollisionObject<S>* obj)
+{
+  for(size_t i = 0; i < pending_free_slots.size(); ++i)
+  {
+    const uint32 slot = pending_free_slots[i];
+    if(objs[slot] == obj)
+    {
+      pending_free_slots[i] = pending_free_slots.back();
+      pending_free_slots.pop_back();
+      return slot;
+    }
+  }
+
+  if(!free_slots.empty())
+  {
+    const uint32 slot = free_slots.back();
+    free_slots.pop_back();
+    return slot;
+  }
+
+  objs.push_back(nullptr);
+  aabbs.emplace_back();
+  alive.push_back(false);
+  return static_cast<uint32>(objs.size() - 1);
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::insertionSort(size_t axis)
+{
+  std::vector<EndPoint>& list = endpoints[axis];
+
+  for(size_t i = 1; i < list.size(); ++i)
+  {
+    const EndPoint e = list[i];
+    size_t j = i;
+
+    while(j > 0 && e < list[j - 1])
+    {
+      const EndPoint& prev = list[j - 1];
+
+      if(!e.isMax() && prev.isMax())
+      {
+        // A lower bound passing an upper bound: the intervals start to
+        // overlap along this axis, so the boxes may overlap now
+        if(aabbs[e.slot()].overlap(aabbs[prev.slot()]))
+          addPair(e.slot(), prev.slot());
+      }
+      else if(e.isMax() && !prev.isMax())
+      {
+        // An upper bound passing a lower bound: the intervals separate
+        removePair(e.slot(), prev.slot());
+      }
+
+      list[j] = prev;
+      --j;
+    }
+
+    list[j] = e;
+  }
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::updateEndPoints()
+{
+  computeMaxExtent();
+
+  for(size_t axis = 0; axis < 3; ++axis)
+  {
+    for(EndPoint& e : endpoints[axis])
+    {
+      const AABB<S>& aabb = aabbs[e.slot()];
+      e.value = e.isMax() ? aabb.max_[axis] : aabb.min_[axis];
+    }
+
+    insertionSort(axis);
+  }
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::rebuild()
+{
+  computeMaxExtent();
+
+  for(size_t axis = 0; axis < 3; ++axis)
+    std::sort(endpoints[axis].begin(), endpoints[axis].end());
+
+  computeOptimalAxis();
+
+  std::vector<uint32> active;
+  for(const EndPoint& e : endpoints[optimal_axis])
+  {
+    const uint32 slot = e.slot();
+
+    if(e.isMax())
+    {
+      auto it = std::find(active.begin(), active.end(), slot);
+      *it = active.back();
+      active.pop_back();
+      continue;
+    }
+
+    for(uint32 other : active)
+    {
+      if(aabbs[slot].overlap(aabbs[other]))
+        addPair(slot, other);
+    }
+
+    active.push_back(slot);
+  }
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::computeOptimalAxis()
+{
+  if(endpoints[0].empty()) return;
+
+  S scale[3];
+  for(size_t axis = 0; axis < 3; ++axis)
+    scale[axis] = endpoints[axis].back().value - endpoints[axis].front().value;
+
+  size_t axis = 0;
+  if(scale[axis] < scale[1]) axis = 1;
+  if(scale[axis] < scale[2]) axis = 2;
+  optimal_axis = axis;
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::computeMaxExtent()
+{
+  for(size_t axis = 0; axis < 3; ++axis)
+    max_extent[axis] = 0;
+
+  for(size_t slot = 0; slot < objs.size(); ++slot)
+  {
+    if(!alive[slot])
+      continue;
+
+    for(size_t axis = 0; axis < 3; ++axis)
+    {
+      max_extent[axis] = std::max(max_extent[axis],
+                                  aabbs[slot].max_[axis] - aabbs[slot].min_[axis]);
+    }
+  }
+}
+
+//==============================================================================
+template <typename S>
+typename SaPCollisionManager_Array<S>::ObjectPair
+SaPCollisionManager_Array<S>::makeObjectPair(uint32 a, uint32 b) const
+{
+  if(objs[a] < objs[b])
+    return ObjectPair(objs[a], objs[b]);
+  return ObjectPair(objs[b], objs[a]);
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::addPair(uint32 a, uint32 b)
+{
+  const detail::PairHashSet::Key key = detail::PairHashSet::makeKey(a, b);
+  if(overlap_pairs.contains(key))
+    return;
+
+  // A pair removed and added again since the last publication, or since the
+  // last collidePersistent(), is unchanged for it
+  unsigned char tag = 0;
+  if(!removed_since_publish.erase(key))
+    tag |= PAIR_ADDED;
+  if(persistent_removed.erase(key))
+    tag |= PAIR_REPORTED;
+  overlap_pairs.insert(key, tag);
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::removePair(uint32 a, uint32 b)
+{
+  const detail::PairHashSet::Key key = detail::PairHashSet::makeKey(a, b);
+
+  unsigned char tag;
+  if(!overlap_pairs.erase(key, &tag))
+    return;
+
+  if(!(tag & PAIR_ADDED))
+    removed_since_publish.insert(key);
+  if(tag & PAIR_REPORTED)
+    persistent_removed.insert(key);
+}
+
+//==============================================================================
+template <typename S>
+void SaPCollisionManager_Array<S>::publishPairs()
+{
+  added_pairs.clear();
+  removed_pairs.clear();
+
+  overlap_pairs.forEach([&](detail::PairHashSet::Key key, unsigned char& tag)
+  {
+    if(tag & PAIR_ADDED)
+    {
+      added_pairs.emplace_back(objs[detail::PairHashSet::first(key)],
+                               objs[detail::PairHashSet::second(key)]);
+      tag &= ~PAIR_ADDED;
+    }
+  });
+
+  removed_since_publish.forEach([&](detail::PairHashSet::Key key, unsigned char)
+  {
+    removed_pairs.emplace_back(objs[detail::PairHashSet::first(key)],
+                               objs[detail::PairHashSet::second(key)]);
+  });
+  removed_since_publish.clear();
+
+  free_slots.insert(free_slots.end(), pending_free_slots.begin(), pending_free_slots.end());
+  pending_free_slots.clear();
+}
+
+//==============================================================================
+template <typename S>
+uint32 SaPCollisionManager_Array<S>::EndPoint::slot() const
+{
+  return data >> 1;
+}
+
+//==============================================================================
+template <typename S>
+bool SaPCollisionManager_Array<S>::EndPoint::isMax() const
+{
+  return data & 1;
+}
+
+//==============================================================================
+template <typename S>
+bool SaPCollisionManager_Array<S>::EndPoint::operator < (const EndPoint& other) const
+{
+  if(value != other.value)
+    return value < other.value;
+  return (data & 1) < (other.data & 1);
+}
+
+} // namespace fcl
+
+#endif
@@ -0,0 +1,270 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#ifndef FCL_BROAD_PHASE_SAP_ARRAY_H
+#define FCL_BROAD_PHASE_SAP_ARRAY_H
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "fcl/broadphase/broadphase_collision_manager.h"
+#include "fcl/broadphase/detail/pair_hash_set.h"
+
+namespace fcl
+{
+
+/// @brief Rigorous SAP collision manager stored in flat arrays.
+///
+/// Works as SaPCollisionManager, but keeps the three end point lists as
+/// contiguous arrays that are re-sorted with insertion sort on update, and
+/// the overlapping pairs in an open-addressed hash set. When the objects move
+/// a little between updates, an update costs O(n + k) for k end point swaps.
+///
+/// The manager also reports how the set of overlapping pairs changed: after
+/// each setup() or update(), getAddedPairs() and getRemovedPairs() return the
+/// pairs that started and stopped overlapping since the previous setup() or
+/// update(). A pair that is removed and added again in between is reported in
+/// neither list. collidePersistent() reads the same pair set.
+template <typename S>
+class FCL_EXPORT SaPCollisionManager_Array : public BroadPhaseCollisionManager<S>
+{
+public:
+
+  using ObjectPair = std::pair<CollisionObject<S>*, CollisionObject<S>*>;
+
+  SaPCollisionManager_Array();
+
+  /// @brief add objects to the manager
+  void registerObjects(const std::vector<CollisionObject<S>*>& other_objs);
+
+  /// @brief add one object to the manager
+  void registerObject(CollisionObject<S>* obj);
+
+  /// @brief remove one object from the manager
+  void unregisterObject(CollisionObject<S>* obj);
+
+  /// @brief initialize the manager, related with the specific type of manager
+  void setup();
+
+  /// @brief update the condition of manager
+  void update();
+
+  /// @brief update the manager by explicitly given the object updated
+  void update(CollisionObject<S>* updated_obj);
+
+  /// @brief update the manager by explicitly given the set of objects update
+  void update(const std::vector<CollisionObject<S>*>& updated_objs);
+
+  /// @brief clear the manager
+  void clear();
+
+  /// @brief return the objects managed by the manager
+  void getObjects(std::vector<CollisionObject<S>*>& objs) const;
+
+  /// @brief perform collision test between one object and all the objects belonging to the manager
+  void collide(CollisionObject<S>* obj, void* cdata, CollisionCallBack<S> callback) const;
+
+  /// @brief perform distance computation between one object and all the objects belonging to the manager
+  void distance(CollisionObject<S>* obj, void* cdata, DistanceCallBack<S> callback) const;
+
+  /// @brief perform collision test for the objects belonging to the manager (i.e., N^2 self collision)
+  void collide(void* cdata, CollisionCallBack<S> callback) const;
+
+  /// @brief perform distance test for the objects belonging to the manager (i.e., N^2 self distance)
+  void distance(void* cdata, DistanceCallBack<S> callback) const;
+
+  /// @brief perform collision test with objects belonging to another manager
+  void collide(BroadPhaseCollisionManager<S>* other_manager, void* cdata, CollisionCallBack<S> callback) const;
+
+  /// @brief perform distance test with objects belonging to another manager
+  void distance(BroadPhaseCollisionManager<S>* other_manager, void* cdata, DistanceCallBack<S> callback) const;
+
+  /// @brief perform self collision in persistent-pair mode, see
+  /// BroadPhaseCollisionManager::collidePersistent(). The pairs are read from
+  /// and marked in the manager's own overlapping pair set, so the callbacks
+  /// must not modify the manager.
+  void collidePersistent(void* cdata, PairCallBack<S> new_pair, PairCallBack<S> persisting_pair, PairCallBack<S> removed_pair);
+
+  /// @brief forget the pairs kept by collidePersistent()
+  void clearPersistentPairs();
+
+  /// @brief the number of pairs kept by collidePersistent()
+  size_t numPersistentPairs() const;
+
+  /// @brief whether the manager is empty
+  bool empty() const;
+
+  /// @brief the number of objects managed by the manager
+  size_t size() const;
+
+  /// @brief the number of pairs of objects whose AABBs overlap
+  size_t numOverlapPairs() const;
+
+  /// @brief pairs that started overlapping before the last setup() or update()
+  const std::vector<ObjectPair>& getAddedPairs() const;
+
+  /// @brief pairs that stopped overlapping before the last setup() or
+  /// update(), including the pairs of objects that were unregistered
+  const std::vector<ObjectPair>& getRemovedPairs() const;
+
+protected:
+
+  /// @brief End point of the interval of one object along one axis
+  struct EndPoint
+  {
+    /// @brief coordinate of the end point
+    S value;
+
+    /// @brief slot of the object times two, plus one for an upper bound
+    uint32 data;
+
+    uint32 slot() const;
+
+    bool isMax() const;
+
+    /// @brief order by value, lower bounds first on ties so that touching
+    /// intervals count as overlapping
+    bool operator < (const EndPoint& other) const;
+  };
+
+  /// @brief bits of the tags of the pairs in overlap_pairs
+  enum PairTag : unsigned char
+  {
+    /// @brief added since the last publication
+    PAIR_ADDED = 1,
+
+    /// @brief reported by the last collidePersistent()
+    PAIR_REPORTED = 2
+  };
+
+  /// @brief slot for a new object; an object registered again before the
+  /// next publication gets its old slot back, so its pairs are unchanged
+  uint32 allocateSlot(CollisionObject<S>* obj);
+
+  /// @brief restore the order of one end point array with insertion sort,
+  /// adding the pairs whose intervals start to overlap along the axis and
+  /// removing those whose intervals stop overlapping
+  void insertionSort(size_t axis);
+
+  /// @brief copy the cached AABBs into the end points and insertion sort all
+  /// the end point arrays
+  void updateEndPoints();
+
+  /// @brief sort the end point arrays from scratch and add all the
+  /// overlapping pairs found by a sweep along the optimal axis
+  void rebuild();
+
+  void computeOptimalAxis();
+
+  /// @brief recompute max_extent from the cached AABBs
+  void computeMaxExtent();
+
+  /// @brief the objects in slots a and b, smaller pointer first
+  ObjectPair makeObjectPair(uint32 a, uint32 b) const;
+
+  void addPair(uint32 a, uint32 b);
+
+  void removePair(uint32 a, uint32 b);
+
+  /// @brief fill the added and removed lists with the changes recorded since
+  /// the last publication, and release the slots freed since then
+  void publishPairs();
+
+  /// @brief the lower bounds in [first, second) of endpoints[axis] include
+  /// those of all the intervals overlapping aabb along axis
+  std::pair<typename std::vector<EndPoint>::const_iterator,
+            typename std::vector<EndPoint>::const_iterator>
+  candidateRange(size_t axis, const AABB<S>& aabb) const;
+
+  bool collide_(CollisionObject<S>* obj, void* cdata, CollisionCallBack<S> callback) const;
+
+  bool distance_(CollisionObject<S>* obj, void* cdata, DistanceCallBack<S> callback, S& min_dist) const;
+
+  /// @brief end points along x, y and z, each sorted by value
+  std::vector<EndPoint> endpoints[3];
+
+  /// @brief object in each slot, kept after unregistration until the next
+  /// publication so that removed pairs can still be reported
+  std::vector<CollisionObject<S>*> objs;
+
+  /// @brief cached AABB of the object in each slot
+  std::vector<AABB<S>> aabbs;
+
+  /// @brief whether each slot holds a registered object
+  std::vector<bool> alive;
+
+  /// @brief slots that can be given to new objects
+  std::vector<uint32> free_slots;
+
+  /// @brief slots freed since the last publication
+  std::vector<uint32> pending_free_slots;
+
+  /// @brief overlapping pairs, tagged with whether they were added since the
+  /// last publication
+  detail::PairHashSet overlap_pairs;
+
+  /// @brief pairs that overlapped at the last publication and were removed
+  /// since
+  detail::PairHashSet removed_since_publish;
+
+  std::vector<ObjectPair> added_pairs;
+
+  std::vector<ObjectPair> removed_pairs;
+
+  /// @brief pairs reported by collidePersistent() that were removed since by
+  /// update(). Those of unregistered objects are reported right away.
+  detail::PairHashSet persistent_removed;
+
+  size_t num_persistent_pairs;
+
+  size_t optimal_axis;
+
+  /// @brief upper bound on the extent of the AABBs along each axis, so that
+  /// a query can binary-search the first interval that may overlap it
+  S max_extent[3];
+
+  std::unordered_map<CollisionObject<S>*, uint32> obj_slot_map;
+};
+
+using SaPCollisionManager_Arrayf = SaPCollisionManager_Array<float>;
+using SaPCollisionManager_Arrayd = SaPCollisionManager_Array<double>;
+
+} // namespace fcl
+
+#include "fcl/broadphase/broadphase_SaP_array-inl.h"
+
+#endif
@@ -66,6 +66,8 @@ void NaiveCollisionManager<S>::registerObjects(const std::vector<CollisionObject
 template <typename S>
 void NaiveCollisionManager<S>::unregisterObject(CollisionObject<S>* obj)
 {
+  this->removePersistentPairs(obj);
+
   objs.remove(obj);
 }
 
@@ -94,6 +96,8 @@ void NaiveCollisionManager<S>::update()
 template <typename S>
 void NaiveCollisionManager<S>::clear()
 {
+  this->removeAllPersistentPairs();
+
   objs.clear();
 }
 
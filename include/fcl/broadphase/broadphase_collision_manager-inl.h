@@ -40,6 +40,9 @@
 
 #include "fcl/broadphase/broadphase_collision_manager.h"
 
+#include <algorithm>
+#include <cassert>
+
 #include "fcl/common/unused.h"
 
 namespace fcl {
@@ -51,7 +54,10 @@ class FCL_EXPORT BroadPhaseCollisionManager<double>;
 //==============================================================================
 template <typename S>
 BroadPhaseCollisionManager<S>::BroadPhaseCollisionManager()
-  : enable_tested_set_(false)
+  : enable_tested_set_(false),
+    persistent_cdata(nullptr),
+    persistent_removed_pair(nullptr),
+    persistent_parity(0)
 {
   // Do nothing
 }
@@ -91,6 +97,211 @@ void BroadPhaseCollisionManager<S>::update(
   update();
 }
 
+//==============================================================================
+template <typename S>
+void BroadPhaseCollisionManager<S>::collideBatch(
+    const std::vector<CollisionObject<S>*>& objs,
+    const std::vector<void*>& cdata,
+    CollisionCallBack<S> callback) const
+{
+  assert(objs.size() == cdata.size());
+
+  for(size_t i = 0; i < objs.size(); ++i)
+    collide(objs[i], cdata[i], callback);
+}
+
+//==============================================================================
+template <typename S>
+void BroadPhaseCollisionManager<S>::distanceBatch(
+    const std::vector<CollisionObject<S>*>& objs,
+    const std::vector<void*>& cdata,
+    DistanceCallBack<S> callback) const
+{
+  assert(objs.size() == cdata.size());
+
+  for(size_t i = 0; i < objs.size(); ++i)
+    distance(objs[i], cdata[i], callback);
+}
+
+namespace detail {
+
+//==============================================================================
+template <typename S, typename CollisionFunction>
+bool invokeCollisionFunction(
+    CollisionObject<S>* o1, CollisionObject<S>* o2, void* cdata)
+{
+  return (*static_cast<CollisionFunction*>(cdata))(o1, o2);
+}
+
+//==============================================================================
+template <typename S, typename DistanceFunction>
+bool invokeDistanceFunction(
+    CollisionObject<S>* o1, CollisionObject<S>* o2, void* cdata, S& dist)
+{
+  return (*static_cast<DistanceFunction*>(cdata))(o1, o2, dist);
+}
+
+} // namespace detail
+
+//==============================================================================
+template <typename S>
+void BroadPhaseCollisionManager<S>::collidePersistent(
+    void* cdata,
+    PairCallBack<S> new_pair,
+    PairCallBack<S> persisting_pair,
+    PairCallBack<S> removed_pair)
+{
+  persistent_cdata = cdata;
+  persistent_removed_pair = removed_pair;
+
+  // The pairs found by this call get its parity as tag, so that the kept
+  // pairs still tagged with the previous one are those no longer found
+  persistent_parity ^= 1;
+
+  auto update_pair = [&](CollisionObject<S>* o1, CollisionObject<S>* o2)
+  {
+    // Some managers report every pair, so keep only the overlapping ones
+    if(o1 == o2 || !o1->getAABB().overlap(o2->getAABB()))
+      return false;
+
+    const detail::PairHashSet::Key key
+        = detail::PairHashSet::makeKey(getPersistentId_(o1), getPersistentId_(o2));
+    if(o2 < o1)
+      std::swap(o1, o2);
+
+    // A pair reported twice by the manager is only passed on once
+    unsigned char tag;
+    if(persistent_pairs.insert(key, persistent_parity))
+    {
+      if(new_pair)
+        new_pair(o1, o2, cdata);
+    }
+    else if(persistent_pairs.setTag(key, persistent_parity, &tag)
+            && tag != persistent_parity && persisting_pair)
+    {
+      persisting_pair(o1, o2, cdata);
+    }
+
+    return false;
+  };
+  collide(&update_pair, detail::invokeCollisionFunction<S, decltype(update_pair)>);
+
+  std::vector<detail::PairHashSet::Key> removed_keys;
+  persistent_pairs.forEach([&](detail::PairHashSet::Key key, unsigned char tag)
+  {
+    if(tag != persistent_parity)
+      removed_keys.push_back(key);
+  });
+
+  for(detail::PairHashSet::Key key : removed_keys)
+  {
+    if(removed_pair)
+      reportPersistentPair_(key, removed_pair);
+    persistent_pairs.erase(key);
+  }
+}
+
+//==============================================================================
+template <typename S>
+void BroadPhaseCollisionManager<S>::clearPersistentPairs()
+{
+  persistent_pairs.clear();
+  persistent_ids.clear();
+  persistent_objs.clear();
+  persistent_free_ids.clear();
+  persistent_cdata = nullptr;
+  persistent_removed_pair = nullptr;
+}
+
+//==============================================================================
+template <typename S>
+size_t BroadPhaseCollisionManager<S>::numPersistentPairs() const
+{
+  return persistent_pairs.size();
+}
+
+//==============================================================================
+template <typename S>
+void BroadPhaseCollisionManager<S>::removePersistentPairs(CollisionObject<S>* obj)
+{
+  const auto it = persistent_ids.find(obj);
+  if(it == persistent_ids.end())
+    return;
+
+  const uint32 id = it->second;
+  std::vector<detail::PairHashSet::Key> removed_keys;
+  static_cast<const detail::PairHashSet&>(persistent_pairs).forEach(
+        [&](detail::PairHashSet::Key key, unsigned char)
+  {
+    if(detail::PairHashSet::first(key) == id || detail::PairHashSet::second(key) == id)
+      removed_keys.push_back(key);
+  });
+
+  for(detail::PairHashSet::Key key : removed_keys)
+  {
+    if(persistent_removed_pair)
+      reportPersistentPair_(key, persistent_removed_pair);
+    persistent_pairs.erase(key);
+  }
+
+  persistent_objs[id] = nullptr;
+  persistent_free_ids.push_back(id);
+  persistent_ids.erase(it);
+}
+
+//==============================================================================
+template <typename S>
+void BroadPhaseCollisionManager<S>::removeAllPersistentPairs()
+{
+  if(persistent_removed_pair)
+  {
+    static_cast<const detail::PairHashSet&>(persistent_pairs).forEach(
+          [&](detail::PairHashSet::Key key, unsigned char)
+    {
+      reportPersistentPair_(key, persistent_removed_pair);
+    });
+  }
+
+  BroadPhaseCollisionManager<S>::clearPersistentPairs();
+}
+
+//==============================================================================
+template <typename S>
+uint32 BroadPhaseCollisionManager<S>::getPersistentId_(CollisionObject<S>* obj)
+{
+  const auto inserted = persistent_ids.emplace(obj, 0);
+  if(!inserted.second)
+    return inserted.first->second;
+
+  uint32 id;
+  if(persistent_free_ids.empty())
+  {
+    id = static_cast<uint32>(persistent_objs.size());
+    persistent_objs.push_back(obj);
+  }
+  else
+  {
+    id = persistent_free_ids.back();
+    persistent_free_ids.pop_back();
+    persistent_objs[id] = obj;
+  }
+
+  inserted.first->second = id;
+  return id;
+}
+
+//==============================================================================
+template <typename S>
+void BroadPhaseCollisionManager<S>::reportPersistentPair_(
+    detail::PairHashSet::Key key, PairCallBack<S> callback) const
+{
+  CollisionObject<S>* o1 = persistent_objs[detail::PairHashSet::first(key)];
+  CollisionObject<S>* o2 = persistent_objs[detail::PairHashSet::second(key)];
+  if(o2 < o1)
+    std::swap(o1, o2);
+  callback(o1, o2, persistent_cdata);
+}
+
 //==============================================================================
 template <typename S>
 bool BroadPhaseCollisionManager<S>::inTestedSet(
@@ -39,8 +39,11 @@
 #define FCL_BROADPHASE_BROADPHASECOLLISIONMANAGER_H
 
 #include <set>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "fcl/broadphase/detail/pair_hash_set.h"
 #include "fcl/narrowphase/collision_object.h"
 
 namespace fcl
@@ -59,6 +62,28 @@ using DistanceCallBack = bool (*)(
     CollisionObject<S>* o1,
     CollisionObject<S>* o2, void* cdata, S& dist);
 
+/// @brief Callback for a pair of objects reported by the persistent-pair mode
+/// of a broadphase manager, see BroadPhaseCollisionManager::collidePersistent().
+template <typename S>
+using PairCallBack = void (*)(
+    CollisionObject<S>* o1, CollisionObject<S>* o2, void* cdata);
+
+namespace detail {
+
+/// @brief Collision callback calling the callable that cdata points to as
+/// callback(o1, o2), for traversals that only take function pointers
+template <typename S, typename CollisionFunction>
+bool invokeCollisionFunction(
+    CollisionObject<S>* o1, CollisionObject<S>* o2, void* cdata);
+
+/// @brief Distance callback calling the callable that cdata points to as
+/// callback(o1, o2, dist)
+template <typename S, typename DistanceFunction>
+bool invokeDistanceFunction(
+    CollisionObject<S>* o1, CollisionObject<S>* o2, void* cdata, S& dist);
+
+} // namespace detail
+
 /// @brief Base class for broad phase collision. It helps to accelerate the
 /// collision/distance between N objects. Also support self collision, self
 /// distance and collision/distance with another M objects.
@@ -103,6 +128,21 @@ public:
   /// @brief perform distance computation between one object and all the objects belonging to the manager
   virtual void distance(CollisionObject<S>* obj, void* cdata, DistanceCallBack<S> callback) const = 0;
 
+  /// @brief perform collision test between each of a batch of query objects
+  /// and all the objects belonging to the manager. The result is the same as
+  /// calling collide(objs[i], cdata[i], callback) for every i, so each query
+  /// gets its own callback data. Managers may process the queries in any
+  /// order and, if they were explicitly asked to run them in parallel, the
+  /// callback may be invoked concurrently for different queries (but never
+  /// for the same query).
+  virtual void collideBatch(const std::vector<CollisionObject<S>*>& objs, const std::vector<void*>& cdata, CollisionCallBack<S> callback) const;
+
+  /// @brief perform distance computation between each of a batch of query
+  /// objects and all the objects belonging to the manager. The result is the
+  /// same as calling distance(objs[i], cdata[i], callback) for every i, with
+  /// the same concurrency caveats as collideBatch().
+  virtual void distanceBatch(const std::vector<CollisionObject<S>*>& objs, const std::vector<void*>& cdata, DistanceCallBack<S> callback) const;
+
   /// @brief perform collision test for the objects belonging to the manager (i.e., N^2 self collision)
   virtual void collide(void* cdata, CollisionCallBack<S> callback) const = 0;
 
@@ -115,6 +155,34 @@ public:
   /// @brief perform distance test with objects belonging to another manager
   virtual void distance(BroadPhaseCollisionManager* other_manager, void* cdata, DistanceCallBack<S> callback) const = 0;
 
+  /// @brief perform self collision in persistent-pair mode. The manager keeps
+  /// the pairs of objects with overlapping AABBs from one call to the next
+  /// and, for its current state (call update() first), reports new_pair for
+  /// the pairs that did not overlap at the previous call, persisting_pair for
+  /// the pairs that still overlap, and removed_pair for the pairs that no
+  /// longer overlap. The first call reports every pair as new. Any of the
+  /// callbacks may be null. Within a pair, o1 < o2.
+  ///
+  /// This lets the caller keep per-pair narrowphase state, such as contact
+  /// manifolds, alive as long as the pair persists. The pairs of an object
+  /// are instead reported as removed by unregisterObject() or clear(), while
+  /// the object is still alive, through the removed_pair and cdata of the
+  /// last call; removed_pair must then not modify the manager. Destroying the
+  /// manager reports nothing. An object registered afterwards starts without
+  /// pairs, even at the address of an unregistered one.
+  ///
+  /// The base implementation runs a self collision and updates the kept
+  /// pairs in a hash set; managers that track overlapping pairs
+  /// incrementally override it.
+  virtual void collidePersistent(void* cdata, PairCallBack<S> new_pair, PairCallBack<S> persisting_pair, PairCallBack<S> removed_pair);
+
+  /// @brief forget the pairs kept by collidePersistent(), so that its next
+  /// call reports every overlapping pair as new
+  virtual void clearPersistentPairs();
+
+  /// @brief the number of pairs kept by collidePersistent()
+  virtual size_t numPersistentPairs() const;
+
   /// @brief whether the manager is empty
   virtual bool empty() const = 0;
   
@@ -131,6 +199,47 @@ protected:
 
   void insertTestedSet(CollisionObject<S>* a, CollisionObject<S>* b) const;
 
+  /// @brief report as removed and forget the pairs kept by
+  /// collidePersistent() for obj, to be called by unregisterObject() before
+  /// obj is removed
+  void removePersistentPairs(CollisionObject<S>* obj);
+
+  /// @brief report as removed and forget all the pairs kept by
+  /// collidePersistent(), to be called by clear()
+  void removeAllPersistentPairs();
+
+  /// @brief cdata and removed_pair of the last call of collidePersistent(),
+  /// with which the pairs of unregistered objects are reported
+  void* persistent_cdata;
+  PairCallBack<S> persistent_removed_pair;
+
+private:
+
+  /// @brief the persistent id of obj, assigning it a free one if it has none
+  uint32 getPersistentId_(CollisionObject<S>* obj);
+
+  /// @brief report the pair with the given key to callback
+  void reportPersistentPair_(detail::PairHashSet::Key key, PairCallBack<S> callback) const;
+
+  /// @brief pairs of objects with overlapping AABBs found by the last call of
+  /// collidePersistent(), keyed on the persistent ids of their objects and
+  /// tagged with the parity of the call that last found them
+  detail::PairHashSet persistent_pairs;
+
+  /// @brief parity of the last call of collidePersistent()
+  unsigned char persistent_parity;
+
+  /// @brief persistent id of each object of the kept pairs. An id is given
+  /// back when its object is unregistered, once its pairs are removed, so
+  /// that pairs never outlive the object they were found for.
+  std::unordered_map<CollisionObject<S>*, uint32> persistent_ids;
+
+  /// @brief object of each persistent id, nullptr for a free id
+  std::vector<CollisionObject<S>*> persistent_objs;
+
+  /// @brief persistent ids given back by unregistered objects
+  std::vector<uint32> persistent_free_ids;
+
 };
 
 using BroadPhaseCollisionManagerf = BroadPhaseCollisionManager<float>;
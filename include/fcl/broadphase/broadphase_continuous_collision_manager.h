@@ -98,22 +98,22 @@ public:
   virtual void getObjects(std::vector<ContinuousCollisionObject<S>*>& objs) const = 0;
 
   /// @brief perform collision test between one object and all the objects belonging to the manager
-  virtual void collide(ContinuousCollisionObject<S>* obj, void* cdata, CollisionCallBack<S> callback) const = 0;
+  virtual void collide(ContinuousCollisionObject<S>* obj, void* cdata, ContinuousCollisionCallBack<S> callback) const = 0;
 
   /// @brief perform distance computation between one object and all the objects belonging to the manager
-  virtual void distance(ContinuousCollisionObject<S>* obj, void* cdata, DistanceCallBack<S> callback) const = 0;
+  virtual void distance(ContinuousCollisionObject<S>* obj, void* cdata, ContinuousDistanceCallBack<S> callback) const = 0;
 
   /// @brief perform collision test for the objects belonging to the manager (i.e., N^2 self collision)
-  virtual void collide(void* cdata, CollisionCallBack<S> callback) const = 0;
+  virtual void collide(void* cdata, ContinuousCollisionCallBack<S> callback) const = 0;
 
   /// @brief perform distance test for the objects belonging to the manager (i.e., N^2 self distance)
-  virtual void distance(void* cdata, DistanceCallBack<S> callback) const = 0;
+  virtual void distance(void* cdata, ContinuousDistanceCallBack<S> callback) const = 0;
 
   /// @brief perform collision test with objects belonging to another manager
-  virtual void collide(BroadPhaseContinuousCollisionManager<S>* other_manager, void* cdata, CollisionCallBack<S> callback) const = 0;
+  virtual void collide(BroadPhaseContinuousCollisionManager<S>* other_manager, void* cdata, ContinuousCollisionCallBack<S> callback) const = 0;
 
   /// @brief perform distance test with objects belonging to another manager
-  virtual void distance(BroadPhaseContinuousCollisionManager<S>* other_manager, void* cdata, DistanceCallBack<S> callback) const = 0;
+  virtual void distance(BroadPhaseContinuousCollisionManager<S>* other_manager, void* cdata, ContinuousDistanceCallBack<S> callback) const = 0;
 
   /// @brief whether the manager is empty
   virtual bool empty() const = 0;
@@ -40,6 +40,10 @@
 
 #include "fcl/broadphase/broadphase_dynamic_AABB_tree.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
 #include <limits>
 
 #if FCL_HAVE_OCTOMAP
@@ -489,97 +493,131 @@ bool distanceRecurse(typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNod
 #endif
 
 //==============================================================================
-template <typename S>
+template <typename S, typename CollisionFunction>
 FCL_EXPORT
 bool collisionRecurse(
     typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNode* root1,
     typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNode* root2,
-    void* cdata,
-    CollisionCallBack<S> callback)
+    CollisionFunction& callback)
 {
   if(root1->isLeaf() && root2->isLeaf())
   {
     if(!root1->bv.overlap(root2->bv)) return false;
-    return callback(static_cast<CollisionObject<S>*>(root1->data), static_cast<CollisionObject<S>*>(root2->data), cdata);
+    return callback(static_cast<CollisionObject<S>*>(root1->data), static_cast<CollisionObject<S>*>(root2->data));
   }
 
   if(!root1->bv.overlap(root2->bv)) return false;
 
   if(root2->isLeaf() || (!root1->isLeaf() && (root1->bv.size() > root2->bv.size())))
   {
-    if(collisionRecurse(root1->children[0], root2, cdata, callback))
+    if(collisionRecurse<S>(root1->children[0], root2, callback))
       return true;
-    if(collisionRecurse(root1->children[1], root2, cdata, callback))
+    if(collisionRecurse<S>(root1->children[1], root2, callback))
       return true;
   }
   else
   {
-    if(collisionRecurse(root1, root2->children[0], cdata, callback))
+    if(collisionRecurse<S>(root1, root2->children[0], callback))
       return true;
-    if(collisionRecurse(root1, root2->children[1], cdata, callback))
+    if(collisionRecurse<S>(root1, root2->children[1], callback))
       return true;
   }
   return false;
 }
 
 //==============================================================================
-template <typename S>
+template <typename S, typename CollisionFunction>
 FCL_EXPORT
-bool collisionRecurse(typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNode* root, CollisionObject<S>* query, void* cdata, CollisionCallBack<S> callback)
+bool collisionRecurse(typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNode* root, CollisionObject<S>* query, CollisionFunction& callback)
 {
   if(root->isLeaf())
   {
     if(!root->bv.overlap(query->getAABB())) return false;
-    return callback(static_cast<CollisionObject<S>*>(root->data), query, cdata);
+    return callback(static_cast<CollisionObject<S>*>(root->data), query);
   }
 
   if(!root->bv.overlap(query->getAABB())) return false;
 
   int select_res = select(query->getAABB(), *(root->children[0]), *(root->children[1]));
 
-  if(collisionRecurse(root->children[select_res], query, cdata, callback))
+  if(collisionRecurse<S>(root->children[select_res], query, callback))
     return true;
 
-  if(collisionRecurse(root->children[1-select_res], query, cdata, callback))
+  if(collisionRecurse<S>(root->children[1-select_res], query, callback))
     return true;
 
   return false;
 }
 
 //==============================================================================
+/// @brief Collision between the tree and the queries of a packet selected by
+/// the mask active; the queries whose callback asks to stop are removed from
+/// packet.alive
 template <typename S>
 FCL_EXPORT
-bool selfCollisionRecurse(typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNode* root, void* cdata, CollisionCallBack<S> callback)
+void batchCollisionRecurse(typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNode* root, QueryPacket<S>& packet, uint32 active, CollisionCallBack<S> callback)
+{
+  active &= packet.alive;
+
+  uint32 overlap = 0;
+  for(std::size_t i = 0; i < packet.size; ++i)
+  {
+    const uint32 bit = uint32(1) << i;
+    if((active & bit) && root->bv.overlap(packet.bvs[i]))
+      overlap |= bit;
+  }
+
+  if(!overlap) return;
+
+  if(root->isLeaf())
+  {
+    CollisionObject<S>* root_obj = static_cast<CollisionObject<S>*>(root->data);
+    for(std::size_t i = 0; i < packet.size; ++i)
+    {
+      const uint32 bit = uint32(1) << i;
+      if((overlap & bit) && callback(root_obj, packet.objs[i], packet.cdata[i]))
+        packet.alive &= ~bit;
+    }
+    return;
+  }
+
+  batchCollisionRecurse<S>(root->children[0], packet, overlap, callback);
+  batchCollisionRecurse<S>(root->children[1], packet, overlap, callback);
+}
+
+//==============================================================================
+template <typename S, typename CollisionFunction>
+FCL_EXPORT
+bool selfCollisionRecurse(typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNode* root, CollisionFunction& callback)
 {
   if(root->isLeaf()) return false;
 
-  if(selfCollisionRecurse(root->children[0], cdata, callback))
+  if(selfCollisionRecurse<S>(root->children[0], callback))
     return true;
 
-  if(selfCollisionRecurse(root->children[1], cdata, callback))
+  if(selfCollisionRecurse<S>(root->children[1], callback))
     return true;
 
-  if(collisionRecurse(root->children[0], root->children[1], cdata, callback))
+  if(collisionRecurse<S>(root->children[0], root->children[1], callback))
     return true;
 
   return false;
 }
 
 //==============================================================================
-template <typename S>
+template <typename S, typename DistanceFunction>
 FCL_EXPORT
 bool distanceRecurse(
     typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNode* root1,
     typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNode* root2,
-    void* cdata,
-    DistanceCallBack<S> callback,
+    DistanceFunction& callback,
     S& min_dist)
 {
   if(root1->isLeaf() && root2->isLeaf())
   {
     CollisionObject<S>* root1_obj = static_cast<CollisionObject<S>*>(root1->data);
     CollisionObject<S>* root2_obj = static_cast<CollisionObject<S>*>(root2->data);
-    return callback(root1_obj, root2_obj, cdata, min_dist);
+    return callback(root1_obj, root2_obj, min_dist);
   }
 
   if(root2->isLeaf() || (!root1->isLeaf() && (root1->bv.size() > root2->bv.size())))
@@ -591,13 +629,13 @@ bool distanceRecurse(
     {
       if(d2 < min_dist)
       {
-        if(distanceRecurse(root1->children[1], root2, cdata, callback, min_dist))
+        if(distanceRecurse<S>(root1->children[1], root2, callback, min_dist))
           return true;
       }
 
       if(d1 < min_dist)
       {
-        if(distanceRecurse(root1->children[0], root2, cdata, callback, min_dist))
+        if(distanceRecurse<S>(root1->children[0], root2, callback, min_dist))
           return true;
       }
     }
@@ -605,13 +643,13 @@ bool distanceRecurse(
     {
       if(d1 < min_dist)
       {
-        if(distanceRecurse(root1->children[0], root2, cdata, callback, min_dist))
+        if(distanceRecurse<S>(root1->children[0], root2, callback, min_dist))
           return true;
       }
 
       if(d2 < min_dist)
       {
-        if(distanceRecurse(root1->children[1], root2, cdata, callback, min_dist))
+        if(distanceRecurse<S>(root1->children[1], root2, callback, min_dist))
           return true;
       }
     }
@@ -625,13 +663,13 @@ bool distanceRecurse(
     {
       if(d2 < min_dist)
       {
-        if(distanceRecurse(root1, root2->children[1], cdata, callback, min_dist))
+        if(distanceRecurse<S>(root1, root2->children[1], callback, min_dist))
           return true;
       }
 
       if(d1 < min_dist)
       {
-        if(distanceRecurse(root1, root2->children[0], cdata, callback, min_dist))
+        if(distanceRecurse<S>(root1, root2->children[0], callback, min_dist))
           return true;
       }
     }
@@ -639,13 +677,13 @@ bool distanceRecurse(
     {
       if(d1 < min_dist)
       {
-        if(distanceRecurse(root1, root2->children[0], cdata, callback, min_dist))
+        if(distanceRecurse<S>(root1, root2->children[0], callback, min_dist))
           return true;
       }
 
       if(d2 < min_dist)
       {
-        if(distanceRecurse(root1, root2->children[1], cdata, callback, min_dist))
+        if(distanceRecurse<S>(root1, root2->children[1], callback, min_dist))
           return true;
       }
     }
@@ -655,14 +693,14 @@ bool distanceRecurse(
 }
 
 //==============================================================================
-template <typename S>
+template <typename S, typename DistanceFunction>
 FCL_EXPORT
-bool distanceRecurse(typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNode* root, CollisionObject<S>* query, void* cdata, DistanceCallBack<S> callback, S& min_dist)
+bool distanceRecurse(typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNode* root, CollisionObject<S>* query, DistanceFunction& callback, S& min_dist)
 {
   if(root->isLeaf())
   {
     CollisionObject<S>* root_obj = static_cast<CollisionObject<S>*>(root->data);
-    return callback(root_obj, query, cdata, min_dist);
+    return callback(root_obj, query, min_dist);
   }
 
   S d1 = query->getAABB().distance(root->children[0]->bv);
@@ -672,13 +710,13 @@ bool distanceRecurse(typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNod
   {
     if(d2 < min_dist)
     {
-      if(distanceRecurse(root->children[1], query, cdata, callback, min_dist))
+      if(distanceRecurse<S>(root->children[1], query, callback, min_dist))
         return true;
     }
 
     if(d1 < min_dist)
     {
-      if(distanceRecurse(root->children[0], query, cdata, callback, min_dist))
+      if(distanceRecurse<S>(root->children[0], query, callback, min_dist))
         return true;
     }
   }
@@ -686,13 +724,13 @@ bool distanceRecurse(typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNod
   {
     if(d1 < min_dist)
     {
-      if(distanceRecurse(root->children[0], query, cdata, callback, min_dist))
+      if(distanceRecurse<S>(root->children[0], query, callback, min_dist))
         return true;
     }
 
     if(d2 < min_dist)
     {
-      if(distanceRecurse(root->children[1], query, cdata, callback, min_dist))
+      if(distanceRecurse<S>(root->children[1], query, callback, min_dist))
         return true;
     }
   }
@@ -701,24 +739,159 @@ bool distanceRecurse(typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNod
 }
 
 //==============================================================================
-template <typename S>
+template <typename S, typename DistanceFunction>
 FCL_EXPORT
-bool selfDistanceRecurse(typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNode* root, void* cdata, DistanceCallBack<S> callback, S& min_dist)
+bool selfDistanceRecurse(typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNode* root, DistanceFunction& callback, S& min_dist)
 {
   if(root->isLeaf()) return false;
 
-  if(selfDistanceRecurse(root->children[0], cdata, callback, min_dist))
+  if(selfDistanceRecurse<S>(root->children[0], callback, min_dist))
     return true;
 
-  if(selfDistanceRecurse(root->children[1], cdata, callback, min_dist))
+  if(selfDistanceRecurse<S>(root->children[1], callback, min_dist))
     return true;
 
-  if(distanceRecurse(root->children[0], root->children[1], cdata, callback, min_dist))
+  if(distanceRecurse<S>(root->children[0], root->children[1], callback, min_dist))
     return true;
 
   return false;
 }
 
+//==============================================================================
+/// @brief One unit of work of a parallel self query: the self traversal of
+/// node1 when node2 is null, otherwise the traversal of the pair (node1, node2)
+template <typename S>
+struct SelfTraversalTask
+{
+  typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNode* node1;
+  typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNode* node2;
+};
+
+//==============================================================================
+/// @brief Splits the traversal of the pair (root1, root2) into tasks, mirroring
+/// the descent and the BV culling of collisionRecurse()
+template <typename S>
+FCL_EXPORT
+void generateCollisionTasks(
+    typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNode* root1,
+    typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNode* root2,
+    int depth,
+    std::vector<SelfTraversalTask<S>>& tasks)
+{
+  if(!root1->bv.overlap(root2->bv)) return;
+
+  if(depth <= 0 || (root1->isLeaf() && root2->isLeaf()))
+  {
+    tasks.push_back({root1, root2});
+    return;
+  }
+
+  if(root2->isLeaf() || (!root1->isLeaf() && (root1->bv.size() > root2->bv.size())))
+  {
+    generateCollisionTasks<S>(root1->children[0], root2, depth - 1, tasks);
+    generateCollisionTasks<S>(root1->children[1], root2, depth - 1, tasks);
+  }
+  else
+  {
+    generateCollisionTasks<S>(root1, root2->children[0], depth - 1, tasks);
+    generateCollisionTasks<S>(root1, root2->children[1], depth - 1, tasks);
+  }
+}
+
+//==============================================================================
+/// @brief Splits selfCollisionRecurse(root) into tasks listed in the order in
+/// which the serial traversal visits them
+template <typename S>
+FCL_EXPORT
+void generateSelfCollisionTasks(
+    typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNode* root,
+    int depth,
+    std::vector<SelfTraversalTask<S>>& tasks)
+{
+  if(root->isLeaf()) return;
+
+  if(depth <= 0)
+  {
+    tasks.push_back({root, nullptr});
+    return;
+  }
+
+  generateSelfCollisionTasks<S>(root->children[0], depth - 1, tasks);
+  generateSelfCollisionTasks<S>(root->children[1], depth - 1, tasks);
+  generateCollisionTasks<S>(root->children[0], root->children[1], depth - 1, tasks);
+}
+
+//==============================================================================
+/// @brief Splits the traversal of the pair (root1, root2) into tasks. Unlike
+/// distanceRecurse() no subtree is pruned here since the running minimum
+/// distance is only known inside the tasks.
+template <typename S>
+FCL_EXPORT
+void generateDistanceTasks(
+    typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNode* root1,
+    typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNode* root2,
+    int depth,
+    std::vector<SelfTraversalTask<S>>& tasks)
+{
+  if(depth <= 0 || (root1->isLeaf() && root2->isLeaf()))
+  {
+    tasks.push_back({root1, root2});
+    return;
+  }
+
+  if(root2->isLeaf() || (!root1->isLeaf() && (root1->bv.size() > root2->bv.size())))
+  {
+    generateDistanceTasks<S>(root1->children[0], root2, depth - 1, tasks);
+    generateDistanceTasks<S>(root1->children[1], root2, depth - 1, tasks);
+  }
+  else
+  {
+    generateDistanceTasks<S>(root1, root2->children[0], depth - 1, tasks);
+    generateDistanceTasks<S>(root1, root2->children[1], depth - 1, tasks);
+  }
+}
+
+//==============================================================================
+/// @brief Splits selfDistanceRecurse(root) into tasks listed in the order in
+/// which the serial traversal visits them
+template <typename S>
+FCL_EXPORT
+void generateSelfDistanceTasks(
+    typename DynamicAABBTreeCollisionManager<S>::DynamicAABBNode* root,
+    int depth,
+    std::vector<SelfTraversalTask<S>>& tasks)
+{
+  if(root->isLeaf()) return;
+
+  if(depth <= 0)
+  {
+    tasks.push_back({root, nullptr});
+    return;
+  }
+
+  generateSelfDistanceTasks<S>(root->children[0], depth - 1, tasks);
+  generateSelfDistanceTasks<S>(root->children[1], depth - 1, tasks);
+  generateDistanceTasks<S>(root->children[0], root->children[1], depth - 1, tasks);
+}
+
+//==============================================================================
+/// @brief Number of tree levels to unfold into tasks so that every thread gets
+/// several tasks to balance the load with
+FCL_EXPORT
+inline int parallelTaskDepth(unsigned int num_threads)
+{
+  return static_cast<int>(std::ceil(std::log2(static_cast<double>(num_threads)))) + 3;
+}
+
+//==============================================================================
+/// @brief Lowers first_stopped to task_id if task_id is smaller
+FCL_EXPORT
+inline void recordStoppedTask(std::atomic<std::size_t>& first_stopped, std::size_t task_id)
+{
+  std::size_t current = first_stopped.load();
+  while(task_id < current && !first_stopped.compare_exchange_weak(current, task_id)) {}
+}
+
 } // namespace dynamic_AABB_tree
 
 } // namespace detail
@@ -740,6 +913,16 @@ DynamicAABBTreeCollisionManager<S>::DynamicAABBTreeCollisionManager()
   // from experiment, this is the optimal setting
   octree_as_geometry_collide = true;
   octree_as_geometry_distance = false;
+
+  num_threads = 0;
+  enable_parallel_batch = false;
+  enable_parallel_build = false;
+  parallel_build_min_objects = 4096;
+
+  use_fat_aabbs = false;
+  fat_aabb_margin = 0;
+  num_fat_aabb_reinsertions = 0;
+  num_fat_aabb_reinsertions_avoided = 0;
 }
 
 //==============================================================================
@@ -761,7 +944,7 @@ void DynamicAABBTreeCollisionManager<S>::registerObjects(
     for(size_t i = 0, size = other_objs.size(); i < size; ++i)
     {
       DynamicAABBNode* node = new DynamicAABBNode; // node will be managed by the dtree
-      node->bv = other_objs[i]->getAABB();
+      node->bv = getLeafAABB_(other_objs[i]);
       node->parent = nullptr;
       node->children[1] = nullptr;
       node->data = other_objs[i];
@@ -769,6 +952,7 @@ void DynamicAABBTreeCollisionManager<S>::registerObjects(
       leaves[i] = node;
     }
 
+    setBuildThreadPool_(other_objs.size());
     dtree.init(leaves, tree_init_level);
 
     setup_ = true;
@@ -780,7 +964,7 @@ template <typename S>
 FCL_EXPORT
 void DynamicAABBTreeCollisionManager<S>::registerObject(CollisionObject<S>* obj)
 {
-  DynamicAABBNode* node = dtree.insert(obj->getAABB(), obj);
+  DynamicAABBNode* node = dtree.insert(getLeafAABB_(obj), obj);
   table[obj] = node;
 }
 
@@ -789,8 +973,11 @@ template <typename S>
 FCL_EXPORT
 void DynamicAABBTreeCollisionManager<S>::unregisterObject(CollisionObject<S>* obj)
 {
+  this->removePersistentPairs(obj);
+
   DynamicAABBNode* node = table[obj];
   table.erase(obj);
+  fat_aabb_params_.erase(obj);
   dtree.remove(node);
 }
 
@@ -814,7 +1001,10 @@ void DynamicAABBTreeCollisionManager<S>::setup()
     if(height - std::log((S)num) / std::log(2.0) < max_tree_nonbalanced_level)
       dtree.balanceIncremental(tree_incremental_balance_pass);
     else
+    {
+      setBuildThreadPool_(num);
       dtree.balanceTopdown();
+    }
 
     setup_ = true;
   }
@@ -825,14 +1015,23 @@ template <typename S>
 FCL_EXPORT
 void DynamicAABBTreeCollisionManager<S>::update()
 {
-  for(auto it = table.cbegin(); it != table.cend(); ++it)
+  if(use_fat_aabbs)
   {
-    CollisionObject<S>* obj = it->first;
-    DynamicAABBNode* node = it->second;
-    node->bv = obj->getAABB();
+    for(auto it = table.cbegin(); it != table.cend(); ++it)
+      updateFatAABB_(it->first, it->second);
   }
+  else
+  {
+    for(auto it = table.cbegin(); it != table.cend(); ++it)
+    {
+      CollisionObject<S>* obj = it->first;
+      DynamicAABBNode* node = it->second;
+      node->bv = obj->getAABB();
+    }
 
-  dtree.refit();
+    setBuildThreadPool_(table.size());
+    dtree.refit();
+  }
   setup_ = false;
 
   setup();
@@ -847,7 +1046,9 @@ void DynamicAABBTreeCollisionManager<S>::update_(CollisionObject<S>* updated_obj
   if(it != table.end())
   {
     DynamicAABBNode* node = it->second;
-    if(!node->bv.equal(updated_obj->getAABB()))
+    if(use_fat_aabbs)
+      updateFatAABB_(updated_obj, node);
+    else if(!node->bv.equal(updated_obj->getAABB()))
       dtree.update(node, updated_obj->getAABB());
   }
   setup_ = false;
@@ -877,8 +1078,29 @@ template <typename S>
 FCL_EXPORT
 void DynamicAABBTreeCollisionManager<S>::clear()
 {
+  this->removeAllPersistentPairs();
+
   dtree.clear();
   table.clear();
+  fat_aabb_params_.clear();
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager<S>::setFatAABBMargin(CollisionObject<S>* obj, S margin)
+{
+  FatAABBParameters& params = fat_aabb_params_[obj];
+  params.has_margin = true;
+  params.margin = margin;
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager<S>::setFatAABBVelocity(CollisionObject<S>* obj, const Vector3<S>& vel)
+{
+  fat_aabb_params_[obj].vel = vel;
 }
 
 //==============================================================================
@@ -894,6 +1116,227 @@ void DynamicAABBTreeCollisionManager<S>::getObjects(std::vector<CollisionObject<
 template <typename S>
 FCL_EXPORT
 void DynamicAABBTreeCollisionManager<S>::collide(CollisionObject<S>* obj, void* cdata, CollisionCallBack<S> callback) const
+{
+  collide(obj, [=](CollisionObject<S>* o1, CollisionObject<S>* o2) {
+    return callback(o1, o2, cdata);
+  });
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager<S>::distance(CollisionObject<S>* obj, void* cdata, DistanceCallBack<S> callback) const
+{
+  distance(obj, [=](CollisionObject<S>* o1, CollisionObject<S>* o2, S& dist) {
+    return callback(o1, o2, cdata, dist);
+  });
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager<S>::collideBatch(const std::vector<CollisionObject<S>*>& objs, const std::vector<void*>& cdata, CollisionCallBack<S> callback) const
+{
+  assert(objs.size() == cdata.size());
+  if(size() == 0) return;
+
+  std::vector<std::size_t> indices;
+  indices.reserve(objs.size());
+  for(std::size_t i = 0; i < objs.size(); ++i)
+  {
+#if FCL_HAVE_OCTOMAP
+    if(!octree_as_geometry_collide && objs[i]->collisionGeometry()->getNodeType() == GEOM_OCTREE)
+    {
+      collide(objs[i], cdata[i], callback);
+      continue;
+    }
+#endif
+    indices.push_back(i);
+  }
+
+  detail::sortQueriesByMortonCode(objs, indices);
+
+  const std::size_t packet_size = detail::queryPacketSize();
+  const std::size_t num_packets = (indices.size() + packet_size - 1) / packet_size;
+
+  runPackets_(num_packets, [&](std::size_t i) {
+    const std::size_t begin = i * packet_size;
+    detail::QueryPacket<S> packet(
+        objs, cdata, indices, begin, std::min(packet_size, indices.size() - begin));
+    detail::dynamic_AABB_tree::batchCollisionRecurse<S>(
+        dtree.getRoot(), packet, packet.all(), callback);
+  });
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager<S>::distanceBatch(const std::vector<CollisionObject<S>*>& objs, const std::vector<void*>& cdata, DistanceCallBack<S> callback) const
+{
+  assert(objs.size() == cdata.size());
+  if(size() == 0) return;
+
+  std::vector<std::size_t> indices;
+  indices.reserve(objs.size());
+  for(std::size_t i = 0; i < objs.size(); ++i)
+  {
+#if FCL_HAVE_OCTOMAP
+    if(!octree_as_geometry_distance && objs[i]->collisionGeometry()->getNodeType() == GEOM_OCTREE)
+    {
+      distance(objs[i], cdata[i], callback);
+      continue;
+    }
+#endif
+    indices.push_back(i);
+  }
+
+  detail::sortQueriesByMortonCode(objs, indices);
+
+  const std::size_t packet_size = detail::queryPacketSize();
+  const std::size_t num_packets = (indices.size() + packet_size - 1) / packet_size;
+
+  runPackets_(num_packets, [&](std::size_t i) {
+    const std::size_t end = std::min((i + 1) * packet_size, indices.size());
+    for(std::size_t j = i * packet_size; j < end; ++j)
+    {
+      void* query_cdata = cdata[indices[j]];
+      auto query_callback = [=](CollisionObject<S>* o1, CollisionObject<S>* o2, S& dist) {
+        return callback(o1, o2, query_cdata, dist);
+      };
+      S min_dist = std::numeric_limits<S>::max();
+      detail::dynamic_AABB_tree::distanceRecurse<S>(
+          dtree.getRoot(), objs[indices[j]], query_callback, min_dist);
+    }
+  });
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager<S>::collide(void* cdata, CollisionCallBack<S> callback) const
+{
+  collide([=](CollisionObject<S>* o1, CollisionObject<S>* o2) {
+    return callback(o1, o2, cdata);
+  });
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager<S>::distance(void* cdata, DistanceCallBack<S> callback) const
+{
+  distance([=](CollisionObject<S>* o1, CollisionObject<S>* o2, S& dist) {
+    return callback(o1, o2, cdata, dist);
+  });
+}
+
+//==============================================================================
+template <typename S>
+template <typename Data, typename ResetFunction, typename MergeFunction>
+void DynamicAABBTreeCollisionManager<S>::collideParallel(
+    Data* cdata, CollisionCallBack<S> callback, ResetFunction reset,
+    MergeFunction merge) const
+{
+  if(size() == 0) return;
+
+  std::shared_ptr<detail::ThreadPool> pool = getThreadPool_();
+
+  std::vector<detail::dynamic_AABB_tree::SelfTraversalTask<S>> tasks;
+  detail::dynamic_AABB_tree::generateSelfCollisionTasks<S>(
+      dtree.getRoot(), detail::dynamic_AABB_tree::parallelTaskDepth(pool->size()), tasks);
+  if(tasks.empty()) return;
+
+  // The tasks start without the results already in *cdata, which would
+  // otherwise be merged back into it once per task
+  Data empty_data(*cdata);
+  reset(empty_data);
+  std::vector<Data, Eigen::aligned_allocator<Data>> task_data(tasks.size(), empty_data);
+  std::atomic<std::size_t> first_stopped(tasks.size());
+
+  pool->run(tasks.size(), [&](std::size_t i, unsigned int) {
+    // Once an earlier task has stopped the traversal, the results of this one
+    // are discarded anyway and the task is cut short
+    auto task_callback = [&](CollisionObject<S>* o1, CollisionObject<S>* o2) {
+      if(first_stopped.load(std::memory_order_relaxed) < i) return true;
+      return callback(o1, o2, &task_data[i]);
+    };
+    const auto& task = tasks[i];
+    const bool stopped = (task.node2)
+        ? detail::dynamic_AABB_tree::collisionRecurse<S>(task.node1, task.node2, task_callback)
+        : detail::dynamic_AABB_tree::selfCollisionRecurse<S>(task.node1, task_callback);
+    if(stopped)
+      detail::dynamic_AABB_tree::recordStoppedTask(first_stopped, i);
+  });
+
+  for(std::size_t i = 0; i < tasks.size() && i <= first_stopped; ++i)
+    merge(*cdata, task_data[i]);
+}
+
+//==============================================================================
+template <typename S>
+template <typename Data, typename ResetFunction, typename MergeFunction>
+void DynamicAABBTreeCollisionManager<S>::distanceParallel(
+    Data* cdata, DistanceCallBack<S> callback, ResetFunction reset,
+    MergeFunction merge) const
+{
+  if(size() == 0) return;
+
+  std::shared_ptr<detail::ThreadPool> pool = getThreadPool_();
+
+  std::vector<detail::dynamic_AABB_tree::SelfTraversalTask<S>> tasks;
+  detail::dynamic_AABB_tree::generateSelfDistanceTasks<S>(
+      dtree.getRoot(), detail::dynamic_AABB_tree::parallelTaskDepth(pool->size()), tasks);
+  if(tasks.empty()) return;
+
+  // The tasks start without the results already in *cdata, which would
+  // otherwise be merged back into it once per task
+  Data empty_data(*cdata);
+  reset(empty_data);
+  std::vector<Data, Eigen::aligned_allocator<Data>> task_data(tasks.size(), empty_data);
+  std::atomic<std::size_t> first_stopped(tasks.size());
+
+  pool->run(tasks.size(), [&](std::size_t i, unsigned int) {
+    auto task_callback = [&](CollisionObject<S>* o1, CollisionObject<S>* o2, S& dist) {
+      if(first_stopped.load(std::memory_order_relaxed) < i) return true;
+      return callback(o1, o2, &task_data[i], dist);
+    };
+    const auto& task = tasks[i];
+    S min_dist = std::numeric_limits<S>::max();
+    const bool stopped = (task.node2)
+        ? detail::dynamic_AABB_tree::distanceRecurse<S>(task.node1, task.node2, task_callback, min_dist)
+        : detail::dynamic_AABB_tree::selfDistanceRecurse<S>(task.node1, task_callback, min_dist);
+    if(stopped)
+      detail::dynamic_AABB_tree::recordStoppedTask(first_stopped, i);
+  });
+
+  for(std::size_t i = 0; i < tasks.size() && i <= first_stopped; ++i)
+    merge(*cdata, task_data[i]);
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager<S>::collide(BroadPhaseCollisionManager<S>* other_manager_, void* cdata, CollisionCallBack<S> callback) const
+{
+  collide(other_manager_, [=](CollisionObject<S>* o1, CollisionObject<S>* o2) {
+    return callback(o1, o2, cdata);
+  });
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager<S>::distance(BroadPhaseCollisionManager<S>* other_manager_, void* cdata, DistanceCallBack<S> callback) const
+{
+  distance(other_manager_, [=](CollisionObject<S>* o1, CollisionObject<S>* o2, S& dist) {
+    return callback(o1, o2, cdata, dist);
+  });
+}
+
+//==============================================================================
+template <typename S>
+template <typename CollisionFunction>
+void DynamicAABBTreeCollisionManager<S>::collide(CollisionObject<S>* obj, CollisionFunction callback) const
 {
   if(size() == 0) return;
   switch(obj->collisionGeometry()->getNodeType())
@@ -903,23 +1346,24 @@ void DynamicAABBTreeCollisionManager<S>::collide(CollisionObject<S>* obj, void*
     {
       if(!octree_as_geometry_collide)
       {
+        // The octree traversal only takes function pointers
         const OcTree<S>* octree = static_cast<const OcTree<S>*>(obj->collisionGeometry().get());
-        detail::dynamic_AABB_tree::collisionRecurse(dtree.getRoot(), octree, octree->getRoot(), octree->getRootBV(), obj->getTransform(), cdata, callback);
+        detail::dynamic_AABB_tree::collisionRecurse(dtree.getRoot(), octree, octree->getRoot(), octree->getRootBV(), obj->getTransform(), &callback, detail::invokeCollisionFunction<S, CollisionFunction>);
       }
       else
-        detail::dynamic_AABB_tree::collisionRecurse(dtree.getRoot(), obj, cdata, callback);
+        detail::dynamic_AABB_tree::collisionRecurse<S>(dtree.getRoot(), obj, callback);
     }
     break;
 #endif
   default:
-    detail::dynamic_AABB_tree::collisionRecurse(dtree.getRoot(), obj, cdata, callback);
+    detail::dynamic_AABB_tree::collisionRecurse<S>(dtree.getRoot(), obj, callback);
   }
 }
 
 //==============================================================================
 template <typename S>
-FCL_EXPORT
-void DynamicAABBTreeCollisionManager<S>::distance(CollisionObject<S>* obj, void* cdata, DistanceCallBack<S> callback) const
+template <typename DistanceFunction>
+void DynamicAABBTreeCollisionManager<S>::distance(CollisionObject<S>* obj, DistanceFunction callback) const
 {
   if(size() == 0) return;
   S min_dist = std::numeric_limits<S>::max();
@@ -931,56 +1375,56 @@ void DynamicAABBTreeCollisionManager<S>::distance(CollisionObject<S>* obj, void*
       if(!octree_as_geometry_distance)
       {
         const OcTree<S>* octree = static_cast<const OcTree<S>*>(obj->collisionGeometry().get());
-        detail::dynamic_AABB_tree::distanceRecurse(dtree.getRoot(), octree, octree->getRoot(), octree->getRootBV(), obj->getTransform(), cdata, callback, min_dist);
+        detail::dynamic_AABB_tree::distanceRecurse(dtree.getRoot(), octree, octree->getRoot(), octree->getRootBV(), obj->getTransform(), &callback, detail::invokeDistanceFunction<S, DistanceFunction>, min_dist);
       }
       else
-        detail::dynamic_AABB_tree::distanceRecurse(dtree.getRoot(), obj, cdata, callback, min_dist);
+        detail::dynamic_AABB_tree::distanceRecurse<S>(dtree.getRoot(), obj, callback, min_dist);
     }
     break;
 #endif
   default:
-    detail::dynamic_AABB_tree::distanceRecurse(dtree.getRoot(), obj, cdata, callback, min_dist);
+    detail::dynamic_AABB_tree::distanceRecurse<S>(dtree.getRoot(), obj, callback, min_dist);
   }
 }
 
 //==============================================================================
 template <typename S>
-FCL_EXPORT
-void DynamicAABBTreeCollisionManager<S>::collide(void* cdata, CollisionCallBack<S> callback) const
+template <typename CollisionFunction>
+void DynamicAABBTreeCollisionManager<S>::collide(CollisionFunction callback) const
 {
   if(size() == 0) return;
-  detail::dynamic_AABB_tree::selfCollisionRecurse(dtree.getRoot(), cdata, callback);
+  detail::dynamic_AABB_tree::selfCollisionRecurse<S>(dtree.getRoot(), callback);
 }
 
 //==============================================================================
 template <typename S>
-FCL_EXPORT
-void DynamicAABBTreeCollisionManager<S>::distance(void* cdata, DistanceCallBack<S> callback) const
+template <typename DistanceFunction>
+void DynamicAABBTreeCollisionManager<S>::distance(DistanceFunction callback) const
 {
   if(size() == 0) return;
   S min_dist = std::numeric_limits<S>::max();
-  detail::dynamic_AABB_tree::selfDistanceRecurse(dtree.getRoot(), cdata, callback, min_dist);
+  detail::dynamic_AABB_tree::selfDistanceRecurse<S>(dtree.getRoot(), callback, min_dist);
 }
 
 //==============================================================================
 template <typename S>
-FCL_EXPORT
-void DynamicAABBTreeCollisionManager<S>::collide(BroadPhaseCollisionManager<S>* other_manager_, void* cdata, CollisionCallBack<S> callback) const
+template <typename CollisionFunction>
+void DynamicAABBTreeCollisionManager<S>::collide(BroadPhaseCollisionManager<S>* other_manager_, CollisionFunction callback) const
 {
   DynamicAABBTreeCollisionManager* other_manager = static_cast<DynamicAABBTreeCollisionManager*>(other_manager_);
   if((size() == 0) || (other_manager->size() == 0)) return;
-  detail::dynamic_AABB_tree::collisionRecurse(dtree.getRoot(), other_manager->dtree.getRoot(), cdata, callback);
+  detail::dynamic_AABB_tree::collisionRecurse<S>(dtree.getRoot(), other_manager->dtree.getRoot(), callback);
 }
 
 //==============================================================================
 template <typename S>
-FCL_EXPORT
-void DynamicAABBTreeCollisionManager<S>::distance(BroadPhaseCollisionManager<S>* other_manager_, void* cdata, DistanceCallBack<S> callback) const
+template <typename DistanceFunction>
+void DynamicAABBTreeCollisionManager<S>::distance(BroadPhaseCollisionManager<S>* other_manager_, DistanceFunction callback) const
 {
   DynamicAABBTreeCollisionManager* other_manager = static_cast<DynamicAABBTreeCollisionManager*>(other_manager_);
   if((size() == 0) || (other_manager->size() == 0)) return;
   S min_dist = std::numeric_limits<S>::max();
-  detail::dynamic_AABB_tree::distanceRecurse(dtree.getRoot(), other_manager->dtree.getRoot(), cdata, callback, min_dist);
+  detail::dynamic_AABB_tree::distanceRecurse<S>(dtree.getRoot(), other_manager->dtree.getRoot(), callback, min_dist);
 }
 
 //==============================================================================
@@ -1008,6 +1452,95 @@ DynamicAABBTreeCollisionManager<S>::getTree() const
   return dtree;
 }
 
+//==============================================================================
+template <typename S>
+template <typename PacketFunction>
+void DynamicAABBTreeCollisionManager<S>::runPackets_(std::size_t num_packets, PacketFunction process) const
+{
+  if(enable_parallel_batch)
+  {
+    getThreadPool_()->run(num_packets, [&](std::size_t i, unsigned int) {
+      process(i);
+    });
+  }
+  else
+  {
+    for(std::size_t i = 0; i < num_packets; ++i)
+      process(i);
+  }
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+std::shared_ptr<detail::ThreadPool>
+DynamicAABBTreeCollisionManager<S>::getThreadPool_() const
+{
+  std::lock_guard<std::mutex> lock(thread_pool_mutex_);
+  const unsigned int n = detail::ThreadPool::resolveNumThreads(num_threads);
+  if(!thread_pool_ || thread_pool_->size() != n)
+    thread_pool_ = std::make_shared<detail::ThreadPool>(n);
+  return thread_pool_;
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager<S>::getFatAABBParameters_(CollisionObject<S>* obj, Vector3<S>& vel, S& margin) const
+{
+  const auto it = fat_aabb_params_.find(obj);
+  if(it == fat_aabb_params_.end())
+  {
+    vel.setZero();
+    margin = fat_aabb_margin;
+  }
+  else
+  {
+    vel = it->second.vel;
+    margin = it->second.has_margin ? it->second.margin : fat_aabb_margin;
+  }
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+AABB<S> DynamicAABBTreeCollisionManager<S>::getLeafAABB_(CollisionObject<S>* obj) const
+{
+  if(!use_fat_aabbs)
+    return obj->getAABB();
+
+  Vector3<S> vel;
+  S margin;
+  getFatAABBParameters_(obj, vel, margin);
+  return detail::fatBV(obj->getAABB(), vel, margin);
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager<S>::updateFatAABB_(CollisionObject<S>* obj, DynamicAABBNode* node)
+{
+  Vector3<S> vel;
+  S margin;
+  getFatAABBParameters_(obj, vel, margin);
+  if(dtree.update(node, obj->getAABB(), vel, margin))
+    ++num_fat_aabb_reinsertions;
+  else
+    ++num_fat_aabb_reinsertions_avoided;
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager<S>::setBuildThreadPool_(std::size_t num_objects)
+{
+  if(enable_parallel_build && num_threads != 1
+     && num_objects >= parallel_build_min_objects)
+    dtree.thread_pool = getThreadPool_().get();
+  else
+    dtree.thread_pool = nullptr;
+}
+
 } // namespace fcl
 
 #endif
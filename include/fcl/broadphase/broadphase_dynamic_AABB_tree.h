@@ -40,12 +40,16 @@
 
 #include <unordered_map>
 #include <functional>
+#include <memory>
+#include <mutex>
 
 #include "fcl/math/bv/utility.h"
 #include "fcl/geometry/shape/box.h"
 #include "fcl/geometry/shape/utility.h"
 #include "fcl/broadphase/broadphase_collision_manager.h"
 #include "fcl/broadphase/detail/hierarchy_tree.h"
+#include "fcl/broadphase/detail/query_batch.h"
+#include "fcl/common/detail/thread_pool.h"
 
 namespace fcl
 {
@@ -67,6 +71,43 @@ public:
   bool octree_as_geometry_collide;
   bool octree_as_geometry_distance;
 
+  /// @brief number of threads used by collideParallel(), distanceParallel()
+  /// and, if enable_parallel_batch or enable_parallel_build is set, the batch
+  /// queries or the builds of large trees, including the calling thread;
+  /// 0 means one thread per hardware core
+  unsigned int num_threads;
+
+  /// @brief whether collideBatch() and distanceBatch() may process the query
+  /// packets on num_threads threads; off by default, so that the callbacks
+  /// are only ever called from the calling thread unless asked to
+  bool enable_parallel_batch;
+
+  /// @brief whether registerObjects(), setup() and update() may build,
+  /// balance or refit the tree on num_threads threads; off by default, so that
+  /// these never start a thread pool unless asked to
+  bool enable_parallel_build;
+
+  /// @brief minimum number of objects for which the tree is built, balanced
+  /// or refitted in parallel when enable_parallel_build is set
+  std::size_t parallel_build_min_objects;
+
+  /// @brief fat AABB mode of the update functions: a leaf stores the AABB of
+  /// its object enlarged by a margin and extended by the predicted
+  /// displacement of the object, and it is only reinserted into the tree
+  /// once the AABB of the object leaves this fat AABB. The queries then
+  /// report the candidate pairs of overlapping fat AABBs. Off by default.
+  bool use_fat_aabbs;
+
+  /// @brief margin of the fat AABBs of the objects without a margin of their
+  /// own (see setFatAABBMargin())
+  S fat_aabb_margin;
+
+  /// @brief number of leaves the updates in the fat AABB mode reinserted,
+  /// and of the reinsertions they avoided because the AABB of the object was
+  /// still inside its fat AABB
+  std::size_t num_fat_aabb_reinsertions;
+  std::size_t num_fat_aabb_reinsertions_avoided;
+
   DynamicAABBTreeCollisionManager();
 
   /// @brief add objects to the manager
@@ -93,6 +134,16 @@ public:
   /// @brief clear the manager
   void clear();
 
+  /// @brief set the margin of the fat AABB of obj, in place of
+  /// fat_aabb_margin. It takes effect the next time the leaf of obj is
+  /// (re)inserted.
+  void setFatAABBMargin(CollisionObject<S>* obj, S margin);
+
+  /// @brief set the displacement predicted for obj until its next update, by
+  /// which its fat AABB is extended. It takes effect the next time the leaf
+  /// of obj is (re)inserted.
+  void setFatAABBVelocity(CollisionObject<S>* obj, const Vector3<S>& vel);
+
   /// @brief return the objects managed by the manager
   void getObjects(std::vector<CollisionObject<S>*>& objs) const;
 
@@ -102,17 +153,92 @@ public:
   /// @brief perform distance computation between one object and all the objects belonging to the manager
   void distance(CollisionObject<S>* obj, void* cdata, DistanceCallBack<S> callback) const;
 
+  /// @brief perform collision test between each of a batch of query objects
+  /// and all the objects belonging to the manager.
+  ///
+  /// The queries are sorted along a Morton curve and cut into packets of
+  /// nearby queries, which descend the tree together. The packets are
+  /// processed one after the other, or on num_threads threads if
+  /// enable_parallel_batch is set. Within a query the leaves may be visited
+  /// in a different order than by collide(obj, cdata, callback), which only
+  /// matters if the callback asks to stop early.
+  void collideBatch(const std::vector<CollisionObject<S>*>& objs, const std::vector<void*>& cdata, CollisionCallBack<S> callback) const;
+
+  /// @brief perform distance computation between each of a batch of query
+  /// objects and all the objects belonging to the manager. The queries are
+  /// packed as in collideBatch() and every query runs the same traversal as
+  /// distance(obj, cdata, callback).
+  void distanceBatch(const std::vector<CollisionObject<S>*>& objs, const std::vector<void*>& cdata, DistanceCallBack<S> callback) const;
+
   /// @brief perform collision test for the objects belonging to the manager (i.e., N^2 self collision)
   void collide(void* cdata, CollisionCallBack<S> callback) const;
 
   /// @brief perform distance test for the objects belonging to the manager (i.e., N^2 self distance)
   void distance(void* cdata, DistanceCallBack<S> callback) const;
 
+  /// @brief perform collision test for the objects belonging to the manager
+  /// (i.e., N^2 self collision) on num_threads threads.
+  ///
+  /// The tree is split into independent tasks (self collision of a subtree or
+  /// collision between two subtrees), which are processed by a work-stealing
+  /// pool. Every task runs the callback on its own copy of *cdata, emptied by
+  /// reset(task_data) so that it only collects what the task finds; when all
+  /// tasks are done the copies are folded back into *cdata by calling
+  /// merge(*cdata, task_data) in the order in which the serial traversal would
+  /// have visited them. Tasks after the first one whose callback asked to stop
+  /// are discarded, so the merged data matches collide(cdata, callback).
+  ///
+  /// @tparam Data          copy-constructible callback data
+  /// @tparam ResetFunction callable as reset(Data&)
+  /// @tparam MergeFunction callable as merge(Data&, Data&)
+  template <typename Data, typename ResetFunction, typename MergeFunction>
+  void collideParallel(Data* cdata, CollisionCallBack<S> callback, ResetFunction reset, MergeFunction merge) const;
+
+  /// @brief perform distance test for the objects belonging to the manager
+  /// (i.e., N^2 self distance) on num_threads threads. Tasks, per-task data
+  /// and merging work as in collideParallel(); every task prunes with its own
+  /// running minimum distance.
+  template <typename Data, typename ResetFunction, typename MergeFunction>
+  void distanceParallel(Data* cdata, DistanceCallBack<S> callback, ResetFunction reset, MergeFunction merge) const;
+
   /// @brief perform collision test with objects belonging to another manager
   void collide(BroadPhaseCollisionManager<S>* other_manager_, void* cdata, CollisionCallBack<S> callback) const;
 
   /// @brief perform distance test with objects belonging to another manager
   void distance(BroadPhaseCollisionManager<S>* other_manager_, void* cdata, DistanceCallBack<S> callback) const;
+
+  /// @brief perform collision test between one object and all the objects
+  /// belonging to the manager, calling callback(o1, o2) on every candidate
+  /// pair until it returns true. Unlike a CollisionCallBack, the callable (for
+  /// instance a lambda capturing its data) is a template parameter of the
+  /// traversal and can be inlined into it; the function pointer overloads
+  /// forward to these.
+  template <typename CollisionFunction>
+  void collide(CollisionObject<S>* obj, CollisionFunction callback) const;
+
+  /// @brief perform distance computation between one object and all the
+  /// objects belonging to the manager, calling callback(o1, o2, min_dist) as
+  /// a DistanceCallBack but without its cdata
+  template <typename DistanceFunction>
+  void distance(CollisionObject<S>* obj, DistanceFunction callback) const;
+
+  /// @brief perform self collision calling callback(o1, o2)
+  template <typename CollisionFunction>
+  void collide(CollisionFunction callback) const;
+
+  /// @brief perform self distance calling callback(o1, o2, min_dist)
+  template <typename DistanceFunction>
+  void distance(DistanceFunction callback) const;
+
+  /// @brief perform collision test with objects belonging to another manager
+  /// calling callback(o1, o2)
+  template <typename CollisionFunction>
+  void collide(BroadPhaseCollisionManager<S>* other_manager_, CollisionFunction callback) const;
+
+  /// @brief perform distance test with objects belonging to another manager
+  /// calling callback(o1, o2, min_dist)
+  template <typename DistanceFunction>
+  void distance(BroadPhaseCollisionManager<S>* other_manager_, DistanceFunction callback) const;
   
   /// @brief whether the manager is empty
   bool empty() const;
@@ -128,7 +254,43 @@ private:
 
   bool setup_;
 
+  struct FatAABBParameters
+  {
+    bool has_margin = false;
+    S margin = 0;
+    Vector3<S> vel = Vector3<S>::Zero();
+  };
+
+  /// The fat AABB margins and velocities set for individual objects
+  std::unordered_map<CollisionObject<S>*, FatAABBParameters> fat_aabb_params_;
+
+  mutable std::shared_ptr<detail::ThreadPool> thread_pool_;
+  mutable std::mutex thread_pool_mutex_;
+
   void update_(CollisionObject<S>* updated_obj);
+
+  /// @brief the velocity and margin of the fat AABB of obj
+  void getFatAABBParameters_(CollisionObject<S>* obj, Vector3<S>& vel, S& margin) const;
+
+  /// @brief the bounding volume with which the leaf of obj is inserted
+  AABB<S> getLeafAABB_(CollisionObject<S>* obj) const;
+
+  /// @brief reinsert the leaf of obj with its fat AABB if the AABB of obj
+  /// left it, counting the reinsertions done and avoided
+  void updateFatAABB_(CollisionObject<S>* obj, DynamicAABBNode* node);
+
+  /// @brief call process(i) for every packet i < num_packets of a batch
+  /// query, on the thread pool if enable_parallel_batch is set
+  template <typename PacketFunction>
+  void runPackets_(std::size_t num_packets, PacketFunction process) const;
+
+  /// @brief the pool used by the parallel queries, (re)created on demand to
+  /// match num_threads
+  std::shared_ptr<detail::ThreadPool> getThreadPool_() const;
+
+  /// @brief hand the thread pool to the tree if a build or refit of
+  /// num_objects objects is large enough to run in parallel
+  void setBuildThreadPool_(std::size_t num_objects);
 };
 
 using DynamicAABBTreeCollisionManagerf = DynamicAABBTreeCollisionManager<float>;
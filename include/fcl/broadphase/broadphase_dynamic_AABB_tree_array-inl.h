@@ -40,6 +40,9 @@
 
 #include "fcl/broadphase/broadphase_dynamic_AABB_tree_array.h"
 
+#include <algorithm>
+#include <cassert>
+
 #if FCL_HAVE_OCTOMAP
 #include "fcl/geometry/octree/octree.h"
 #endif
@@ -463,90 +466,127 @@ bool distanceRecurse_(
 #endif
 
 //==============================================================================
-template <typename S>
+template <typename S, typename CollisionFunction>
 FCL_EXPORT
 bool collisionRecurse(typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* nodes1, size_t root1_id,
                       typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* nodes2, size_t root2_id,
-                      void* cdata, CollisionCallBack<S> callback)
+                      CollisionFunction& callback)
 {
   typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* root1 = nodes1 + root1_id;
   typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* root2 = nodes2 + root2_id;
   if(root1->isLeaf() && root2->isLeaf())
   {
     if(!root1->bv.overlap(root2->bv)) return false;
-    return callback(static_cast<CollisionObject<S>*>(root1->data), static_cast<CollisionObject<S>*>(root2->data), cdata);
+    return callback(static_cast<CollisionObject<S>*>(root1->data), static_cast<CollisionObject<S>*>(root2->data));
   }
 
   if(!root1->bv.overlap(root2->bv)) return false;
 
   if(root2->isLeaf() || (!root1->isLeaf() && (root1->bv.size() > root2->bv.size())))
   {
-    if(collisionRecurse(nodes1, root1->children[0], nodes2, root2_id, cdata, callback))
+    if(collisionRecurse<S>(nodes1, root1->children[0], nodes2, root2_id, callback))
       return true;
-    if(collisionRecurse(nodes1, root1->children[1], nodes2, root2_id, cdata, callback))
+    if(collisionRecurse<S>(nodes1, root1->children[1], nodes2, root2_id, callback))
       return true;
   }
   else
   {
-    if(collisionRecurse(nodes1, root1_id, nodes2, root2->children[0], cdata, callback))
+    if(collisionRecurse<S>(nodes1, root1_id, nodes2, root2->children[0], callback))
       return true;
-    if(collisionRecurse(nodes1, root1_id, nodes2, root2->children[1], cdata, callback))
+    if(collisionRecurse<S>(nodes1, root1_id, nodes2, root2->children[1], callback))
       return true;
   }
   return false;
 }
 
 //==============================================================================
-template <typename S>
+template <typename S, typename CollisionFunction>
 FCL_EXPORT
-bool collisionRecurse(typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* nodes, size_t root_id, CollisionObject<S>* query, void* cdata, CollisionCallBack<S> callback)
+bool collisionRecurse(typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* nodes, size_t root_id, CollisionObject<S>* query, CollisionFunction& callback)
 {
   typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* root = nodes + root_id;
   if(root->isLeaf())
   {
     if(!root->bv.overlap(query->getAABB())) return false;
-    return callback(static_cast<CollisionObject<S>*>(root->data), query, cdata);
+    return callback(static_cast<CollisionObject<S>*>(root->data), query);
   }
 
   if(!root->bv.overlap(query->getAABB())) return false;
 
   int select_res = implementation_array::select(query->getAABB(), root->children[0], root->children[1], nodes);
 
-  if(collisionRecurse(nodes, root->children[select_res], query, cdata, callback))
+  if(collisionRecurse<S>(nodes, root->children[select_res], query, callback))
     return true;
 
-  if(collisionRecurse(nodes, root->children[1-select_res], query, cdata, callback))
+  if(collisionRecurse<S>(nodes, root->children[1-select_res], query, callback))
     return true;
 
   return false;
 }
 
 //==============================================================================
+/// @brief Collision between the tree and the queries of a packet selected by
+/// the mask active; the queries whose callback asks to stop are removed from
+/// packet.alive
 template <typename S>
 FCL_EXPORT
-bool selfCollisionRecurse(typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* nodes, size_t root_id, void* cdata, CollisionCallBack<S> callback)
+void batchCollisionRecurse(typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* nodes, size_t root_id, QueryPacket<S>& packet, uint32 active, CollisionCallBack<S> callback)
+{
+  typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* root = nodes + root_id;
+  active &= packet.alive;
+
+  uint32 overlap = 0;
+  for(std::size_t i = 0; i < packet.size; ++i)
+  {
+    const uint32 bit = uint32(1) << i;
+    if((active & bit) && root->bv.overlap(packet.bvs[i]))
+      overlap |= bit;
+  }
+
+  if(!overlap) return;
+
+  if(root->isLeaf())
+  {
+    CollisionObject<S>* root_obj = static_cast<CollisionObject<S>*>(root->data);
+    for(std::size_t i = 0; i < packet.size; ++i)
+    {
+      const uint32 bit = uint32(1) << i;
+      if((overlap & bit) && callback(root_obj, packet.objs[i], packet.cdata[i]))
+        packet.alive &= ~bit;
+    }
+    return;
+  }
+
+  batchCollisionRecurse<S>(nodes, root->children[0], packet, overlap, callback);
+  batchCollisionRecurse<S>(nodes, root->children[1], packet, overlap, callback);
+}
+
+//==============================================================================
+template <typename S, typename CollisionFunction>
+FCL_EXPORT
+bool selfCollisionRecurse(typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* nodes, size_t root_id, CollisionFunction& callback)
 {
   typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* root = nodes + root_id;
   if(root->isLeaf()) return false;
 
-  if(selfCollisionRecurse(nodes, root->children[0], cdata, callback))
+  if(selfCollisionRecurse<S>(nodes, root->children[0], callback))
     return true;
 
-  if(selfCollisionRecurse(nodes, root->children[1], cdata, callback))
+  if(selfCollisionRecurse<S>(nodes, root->children[1], callback))
     return true;
 
-  if(collisionRecurse(nodes, root->children[0], nodes, root->children[1], cdata, callback))
+  if(collisionRecurse<S>(nodes, root->children[0], nodes, root->children[1], callback))
     return true;
 
   return false;
 }
 
 //==============================================================================
-template <typename S>
+template <typename S, typename DistanceFunction>
 FCL_EXPORT
 bool distanceRecurse(typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* nodes1, size_t root1_id,
                      typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* nodes2, size_t root2_id,
-                     void* cdata, DistanceCallBack<S> callback, S& min_dist)
+                     DistanceFunction& callback, S& min_dist)
 {
   typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* root1 = nodes1 + root1_id;
   typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* root2 = nodes2 + root2_id;
@@ -554,7 +594,7 @@ bool distanceRecurse(typename DynamicAABBTreeCollisionManager_Array<S>::DynamicA
   {
     CollisionObject<S>* root1_obj = static_cast<CollisionObject<S>*>(root1->data);
     CollisionObject<S>* root2_obj = static_cast<CollisionObject<S>*>(root2->data);
-    return callback(root1_obj, root2_obj, cdata, min_dist);
+    return callback(root1_obj, root2_obj, min_dist);
   }
 
   if(root2->isLeaf() || (!root1->isLeaf() && (root1->bv.size() > root2->bv.size())))
@@ -566,13 +606,13 @@ bool distanceRecurse(typename DynamicAABBTreeCollisionManager_Array<S>::DynamicA
     {
       if(d2 < min_dist)
       {
-        if(distanceRecurse(nodes1, root1->children[1], nodes2, root2_id, cdata, callback, min_dist))
+        if(distanceRecurse<S>(nodes1, root1->children[1], nodes2, root2_id, callback, min_dist))
           return true;
       }
 
       if(d1 < min_dist)
       {
-        if(distanceRecurse(nodes1, root1->children[0], nodes2, root2_id, cdata, callback, min_dist))
+        if(distanceRecurse<S>(nodes1, root1->children[0], nodes2, root2_id, callback, min_dist))
           return true;
       }
     }
@@ -580,13 +620,13 @@ bool distanceRecurse(typename DynamicAABBTreeCollisionManager_Array<S>::DynamicA
     {
       if(d1 < min_dist)
       {
-        if(distanceRecurse(nodes1, root1->children[0], nodes2, root2_id, cdata, callback, min_dist))
+        if(distanceRecurse<S>(nodes1, root1->children[0], nodes2, root2_id, callback, min_dist))
           return true;
       }
 
       if(d2 < min_dist)
       {
-        if(distanceRecurse(nodes1, root1->children[1], nodes2, root2_id, cdata, callback, min_dist))
+        if(distanceRecurse<S>(nodes1, root1->children[1], nodes2, root2_id, callback, min_dist))
           return true;
       }
     }
@@ -600,13 +640,13 @@ bool distanceRecurse(typename DynamicAABBTreeCollisionManager_Array<S>::DynamicA
     {
       if(d2 < min_dist)
       {
-        if(distanceRecurse(nodes1, root1_id, nodes2, root2->children[1], cdata, callback, min_dist))
+        if(distanceRecurse<S>(nodes1, root1_id, nodes2, root2->children[1], callback, min_dist))
           return true;
       }
 
       if(d1 < min_dist)
       {
-        if(distanceRecurse(nodes1, root1_id, nodes2, root2->children[0], cdata, callback, min_dist))
+        if(distanceRecurse<S>(nodes1, root1_id, nodes2, root2->children[0], callback, min_dist))
           return true;
       }
     }
@@ -614,13 +654,13 @@ bool distanceRecurse(typename DynamicAABBTreeCollisionManager_Array<S>::DynamicA
     {
       if(d1 < min_dist)
       {
-        if(distanceRecurse(nodes1, root1_id, nodes2, root2->children[0], cdata, callback, min_dist))
+        if(distanceRecurse<S>(nodes1, root1_id, nodes2, root2->children[0], callback, min_dist))
           return true;
       }
 
       if(d2 < min_dist)
       {
-        if(distanceRecurse(nodes1, root1_id, nodes2, root2->children[1], cdata, callback, min_dist))
+        if(distanceRecurse<S>(nodes1, root1_id, nodes2, root2->children[1], callback, min_dist))
           return true;
       }
     }
@@ -630,15 +670,15 @@ bool distanceRecurse(typename DynamicAABBTreeCollisionManager_Array<S>::DynamicA
 }
 
 //==============================================================================
-template <typename S>
+template <typename S, typename DistanceFunction>
 FCL_EXPORT
-bool distanceRecurse(typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* nodes, size_t root_id, CollisionObject<S>* query, void* cdata, DistanceCallBack<S> callback, S& min_dist)
+bool distanceRecurse(typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* nodes, size_t root_id, CollisionObject<S>* query, DistanceFunction& callback, S& min_dist)
 {
   typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* root = nodes + root_id;
   if(root->isLeaf())
   {
     CollisionObject<S>* root_obj = static_cast<CollisionObject<S>*>(root->data);
-    return callback(root_obj, query, cdata, min_dist);
+    return callback(root_obj, query, min_dist);
   }
 
   S d1 = query->getAABB().distance((nodes + root->children[0])->bv);
@@ -648,13 +688,13 @@ bool distanceRecurse(typename DynamicAABBTreeCollisionManager_Array<S>::DynamicA
   {
     if(d2 < min_dist)
     {
-      if(distanceRecurse(nodes, root->children[1], query, cdata, callback, min_dist))
+      if(distanceRecurse<S>(nodes, root->children[1], query, callback, min_dist))
         return true;
     }
 
     if(d1 < min_dist)
     {
-      if(distanceRecurse(nodes, root->children[0], query, cdata, callback, min_dist))
+      if(distanceRecurse<S>(nodes, root->children[0], query, callback, min_dist))
         return true;
     }
   }
@@ -662,13 +702,13 @@ bool distanceRecurse(typename DynamicAABBTreeCollisionManager_Array<S>::DynamicA
   {
     if(d1 < min_dist)
     {
-      if(distanceRecurse(nodes, root->children[0], query, cdata, callback, min_dist))
+      if(distanceRecurse<S>(nodes, root->children[0], query, callback, min_dist))
         return true;
     }
 
     if(d2 < min_dist)
     {
-      if(distanceRecurse(nodes, root->children[1], query, cdata, callback, min_dist))
+      if(distanceRecurse<S>(nodes, root->children[1], query, callback, min_dist))
         return true;
     }
   }
@@ -677,20 +717,20 @@ bool distanceRecurse(typename DynamicAABBTreeCollisionManager_Array<S>::DynamicA
 }
 
 //==============================================================================
-template <typename S>
+template <typename S, typename DistanceFunction>
 FCL_EXPORT
-bool selfDistanceRecurse(typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* nodes, size_t root_id, void* cdata, DistanceCallBack<S> callback, S& min_dist)
+bool selfDistanceRecurse(typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* nodes, size_t root_id, DistanceFunction& callback, S& min_dist)
 {
   typename DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBNode* root = nodes + root_id;
   if(root->isLeaf()) return false;
 
-  if(selfDistanceRecurse(nodes, root->children[0], cdata, callback, min_dist))
+  if(selfDistanceRecurse<S>(nodes, root->children[0], callback, min_dist))
     return true;
 
-  if(selfDistanceRecurse(nodes, root->children[1], cdata, callback, min_dist))
+  if(selfDistanceRecurse<S>(nodes, root->children[1], callback, min_dist))
     return true;
 
-  if(distanceRecurse(nodes, root->children[0], nodes, root->children[1], cdata, callback, min_dist))
+  if(distanceRecurse<S>(nodes, root->children[0], nodes, root->children[1], callback, min_dist))
     return true;
 
   return false;
@@ -744,6 +784,16 @@ DynamicAABBTreeCollisionManager_Array<S>::DynamicAABBTreeCollisionManager_Array(
   // from experiment, this is the optimal setting
   octree_as_geometry_collide = true;
   octree_as_geometry_distance = false;
+
+  num_threads = 0;
+  enable_parallel_batch = false;
+  enable_parallel_build = false;
+  parallel_build_min_objects = 4096;
+
+  use_fat_aabbs = false;
+  fat_aabb_margin = 0;
+  num_fat_aabb_reinsertions = 0;
+  num_fat_aabb_reinsertions_avoided = 0;
 }
 
 //==============================================================================
@@ -764,7 +814,7 @@ void DynamicAABBTreeCollisionManager_Array<S>::registerObjects(
     table.rehash(other_objs.size());
     for(size_t i = 0, size = other_objs.size(); i < size; ++i)
     {
-      leaves[i].bv = other_objs[i]->getAABB();
+      leaves[i].bv = getLeafAABB_(other_objs[i]);
       leaves[i].parent = dtree.NULL_NODE;
       leaves[i].children[1] = dtree.NULL_NODE;
       leaves[i].data = other_objs[i];
@@ -773,6 +823,7 @@ void DynamicAABBTreeCollisionManager_Array<S>::registerObjects(
 
     int n_leaves = other_objs.size();
 
+    setBuildThreadPool_(other_objs.size());
     dtree.init(leaves, n_leaves, tree_init_level);
 
     setup_ = true;
@@ -784,7 +835,7 @@ template <typename S>
 FCL_EXPORT
 void DynamicAABBTreeCollisionManager_Array<S>::registerObject(CollisionObject<S>* obj)
 {
-  size_t node = dtree.insert(obj->getAABB(), obj);
+  size_t node = dtree.insert(getLeafAABB_(obj), obj);
   table[obj] = node;
 }
 
@@ -793,8 +844,11 @@ template <typename S>
 FCL_EXPORT
 void DynamicAABBTreeCollisionManager_Array<S>::unregisterObject(CollisionObject<S>* obj)
 {
+  this->removePersistentPairs(obj);
+
   size_t node = table[obj];
   table.erase(obj);
+  fat_aabb_params_.erase(obj);
   dtree.remove(node);
 }
 
@@ -818,7 +872,10 @@ void DynamicAABBTreeCollisionManager_Array<S>::setup()
     if(height - std::log((S)num) / std::log(2.0) < max_tree_nonbalanced_level)
       dtree.balanceIncremental(tree_incremental_balance_pass);
     else
+    {
+      setBuildThreadPool_(num);
       dtree.balanceTopdown();
+    }
 
     setup_ = true;
   }
@@ -829,14 +886,23 @@ template <typename S>
 FCL_EXPORT
 void DynamicAABBTreeCollisionManager_Array<S>::update()
 {
-  for(auto it = table.cbegin(), end = table.cend(); it != end; ++it)
+  if(use_fat_aabbs)
   {
-    const CollisionObject<S>* obj = it->first;
-    size_t node = it->second;
-    dtree.getNodes()[node].bv = obj->getAABB();
+    for(auto it = table.cbegin(), end = table.cend(); it != end; ++it)
+      updateFatAABB_(it->first, it->second);
   }
+  else
+  {
+    for(auto it = table.cbegin(), end = table.cend(); it != end; ++it)
+    {
+      const CollisionObject<S>* obj = it->first;
+      size_t node = it->second;
+      dtree.getNodes()[node].bv = obj->getAABB();
+    }
 
-  dtree.refit();
+    setBuildThreadPool_(table.size());
+    dtree.refit();
+  }
   setup_ = false;
 
   setup();
@@ -851,7 +917,9 @@ void DynamicAABBTreeCollisionManager_Array<S>::update_(CollisionObject<S>* updat
   if(it != table.end())
   {
     size_t node = it->second;
-    if(!dtree.getNodes()[node].bv.equal(updated_obj->getAABB()))
+    if(use_fat_aabbs)
+      updateFatAABB_(updated_obj, node);
+    else if(!dtree.getNodes()[node].bv.equal(updated_obj->getAABB()))
       dtree.update(node, updated_obj->getAABB());
   }
   setup_ = false;
@@ -881,8 +949,29 @@ template <typename S>
 FCL_EXPORT
 void DynamicAABBTreeCollisionManager_Array<S>::clear()
 {
+  this->removeAllPersistentPairs();
+
   dtree.clear();
   table.clear();
+  fat_aabb_params_.clear();
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager_Array<S>::setFatAABBMargin(CollisionObject<S>* obj, S margin)
+{
+  FatAABBParameters& params = fat_aabb_params_[obj];
+  params.has_margin = true;
+  params.margin = margin;
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager_Array<S>::setFatAABBVelocity(CollisionObject<S>* obj, const Vector3<S>& vel)
+{
+  fat_aabb_params_[obj].vel = vel;
 }
 
 //==============================================================================
@@ -898,6 +987,144 @@ void DynamicAABBTreeCollisionManager_Array<S>::getObjects(std::vector<CollisionO
 template <typename S>
 FCL_EXPORT
 void DynamicAABBTreeCollisionManager_Array<S>::collide(CollisionObject<S>* obj, void* cdata, CollisionCallBack<S> callback) const
+{
+  collide(obj, [=](CollisionObject<S>* o1, CollisionObject<S>* o2) {
+    return callback(o1, o2, cdata);
+  });
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager_Array<S>::distance(CollisionObject<S>* obj, void* cdata, DistanceCallBack<S> callback) const
+{
+  distance(obj, [=](CollisionObject<S>* o1, CollisionObject<S>* o2, S& dist) {
+    return callback(o1, o2, cdata, dist);
+  });
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager_Array<S>::collideBatch(const std::vector<CollisionObject<S>*>& objs, const std::vector<void*>& cdata, CollisionCallBack<S> callback) const
+{
+  assert(objs.size() == cdata.size());
+  if(size() == 0) return;
+
+  std::vector<std::size_t> indices;
+  indices.reserve(objs.size());
+  for(std::size_t i = 0; i < objs.size(); ++i)
+  {
+#if FCL_HAVE_OCTOMAP
+    if(!octree_as_geometry_collide && objs[i]->collisionGeometry()->getNodeType() == GEOM_OCTREE)
+    {
+      collide(objs[i], cdata[i], callback);
+      continue;
+    }
+#endif
+    indices.push_back(i);
+  }
+
+  detail::sortQueriesByMortonCode(objs, indices);
+
+  const std::size_t packet_size = detail::queryPacketSize();
+  const std::size_t num_packets = (indices.size() + packet_size - 1) / packet_size;
+
+  runPackets_(num_packets, [&](std::size_t i) {
+    const std::size_t begin = i * packet_size;
+    detail::QueryPacket<S> packet(
+        objs, cdata, indices, begin, std::min(packet_size, indices.size() - begin));
+    detail::dynamic_AABB_tree_array::batchCollisionRecurse<S>(
+        dtree.getNodes(), dtree.getRoot(), packet, packet.all(), callback);
+  });
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager_Array<S>::distanceBatch(const std::vector<CollisionObject<S>*>& objs, const std::vector<void*>& cdata, DistanceCallBack<S> callback) const
+{
+  assert(objs.size() == cdata.size());
+  if(size() == 0) return;
+
+  std::vector<std::size_t> indices;
+  indices.reserve(objs.size());
+  for(std::size_t i = 0; i < objs.size(); ++i)
+  {
+#if FCL_HAVE_OCTOMAP
+    if(!octree_as_geometry_distance && objs[i]->collisionGeometry()->getNodeType() == GEOM_OCTREE)
+    {
+      distance(objs[i], cdata[i], callback);
+      continue;
+    }
+#endif
+    indices.push_back(i);
+  }
+
+  detail::sortQueriesByMortonCode(objs, indices);
+
+  const std::size_t packet_size = detail::queryPacketSize();
+  const std::size_t num_packets = (indices.size() + packet_size - 1) / packet_size;
+
+  runPackets_(num_packets, [&](std::size_t i) {
+    const std::size_t end = std::min((i + 1) * packet_size, indices.size());
+    for(std::size_t j = i * packet_size; j < end; ++j)
+    {
+      void* query_cdata = cdata[indices[j]];
+      auto query_callback = [=](CollisionObject<S>* o1, CollisionObject<S>* o2, S& dist) {
+        return callback(o1, o2, query_cdata, dist);
+      };
+      S min_dist = std::numeric_limits<S>::max();
+      detail::dynamic_AABB_tree_array::distanceRecurse<S>(
+          dtree.getNodes(), dtree.getRoot(), objs[indices[j]], query_callback, min_dist);
+    }
+  });
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager_Array<S>::collide(void* cdata, CollisionCallBack<S> callback) const
+{
+  collide([=](CollisionObject<S>* o1, CollisionObject<S>* o2) {
+    return callback(o1, o2, cdata);
+  });
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager_Array<S>::distance(void* cdata, DistanceCallBack<S> callback) const
+{
+  distance([=](CollisionObject<S>* o1, CollisionObject<S>* o2, S& dist) {
+    return callback(o1, o2, cdata, dist);
+  });
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager_Array<S>::collide(BroadPhaseCollisionManager<S>* other_manager_, void* cdata, CollisionCallBack<S> callback) const
+{
+  collide(other_manager_, [=](CollisionObject<S>* o1, CollisionObject<S>* o2) {
+    return callback(o1, o2, cdata);
+  });
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager_Array<S>::distance(BroadPhaseCollisionManager<S>* other_manager_, void* cdata, DistanceCallBack<S> callback) const
+{
+  distance(other_manager_, [=](CollisionObject<S>* o1, CollisionObject<S>* o2, S& dist) {
+    return callback(o1, o2, cdata, dist);
+  });
+}
+
+//==============================================================================
+template <typename S>
+template <typename CollisionFunction>
+void DynamicAABBTreeCollisionManager_Array<S>::collide(CollisionObject<S>* obj, CollisionFunction callback) const
 {
   if(size() == 0) return;
   switch(obj->collisionGeometry()->getNodeType())
@@ -907,23 +1134,24 @@ void DynamicAABBTreeCollisionManager_Array<S>::collide(CollisionObject<S>* obj,
     {
       if(!octree_as_geometry_collide)
       {
+        // The octree traversal only takes function pointers
         const OcTree<S>* octree = static_cast<const OcTree<S>*>(obj->collisionGeometry().get());
-        detail::dynamic_AABB_tree_array::collisionRecurse(dtree.getNodes(), dtree.getRoot(), octree, octree->getRoot(), octree->getRootBV(), obj->getTransform(), cdata, callback);
+        detail::dynamic_AABB_tree_array::collisionRecurse(dtree.getNodes(), dtree.getRoot(), octree, octree->getRoot(), octree->getRootBV(), obj->getTransform(), &callback, detail::invokeCollisionFunction<S, CollisionFunction>);
       }
       else
-        detail::dynamic_AABB_tree_array::collisionRecurse(dtree.getNodes(), dtree.getRoot(), obj, cdata, callback);
+        detail::dynamic_AABB_tree_array::collisionRecurse<S>(dtree.getNodes(), dtree.getRoot(), obj, callback);
     }
     break;
 #endif
   default:
-    detail::dynamic_AABB_tree_array::collisionRecurse(dtree.getNodes(), dtree.getRoot(), obj, cdata, callback);
+    detail::dynamic_AABB_tree_array::collisionRecurse<S>(dtree.getNodes(), dtree.getRoot(), obj, callback);
   }
 }
 
 //==============================================================================
 template <typename S>
-FCL_EXPORT
-void DynamicAABBTreeCollisionManager_Array<S>::distance(CollisionObject<S>* obj, void* cdata, DistanceCallBack<S> callback) const
+template <typename DistanceFunction>
+void DynamicAABBTreeCollisionManager_Array<S>::distance(CollisionObject<S>* obj, DistanceFunction callback) const
 {
   if(size() == 0) return;
   S min_dist = std::numeric_limits<S>::max();
@@ -935,56 +1163,56 @@ void DynamicAABBTreeCollisionManager_Array<S>::distance(CollisionObject<S>* obj,
       if(!octree_as_geometry_distance)
       {
         const OcTree<S>* octree = static_cast<const OcTree<S>*>(obj->collisionGeometry().get());
-        detail::dynamic_AABB_tree_array::distanceRecurse(dtree.getNodes(), dtree.getRoot(), octree, octree->getRoot(), octree->getRootBV(), obj->getTransform(), cdata, callback, min_dist);
+        detail::dynamic_AABB_tree_array::distanceRecurse(dtree.getNodes(), dtree.getRoot(), octree, octree->getRoot(), octree->getRootBV(), obj->getTransform(), &callback, detail::invokeDistanceFunction<S, DistanceFunction>, min_dist);
       }
       else
-        detail::dynamic_AABB_tree_array::distanceRecurse(dtree.getNodes(), dtree.getRoot(), obj, cdata, callback, min_dist);
+        detail::dynamic_AABB_tree_array::distanceRecurse<S>(dtree.getNodes(), dtree.getRoot(), obj, callback, min_dist);
     }
     break;
 #endif
   default:
-    detail::dynamic_AABB_tree_array::distanceRecurse(dtree.getNodes(), dtree.getRoot(), obj, cdata, callback, min_dist);
+    detail::dynamic_AABB_tree_array::distanceRecurse<S>(dtree.getNodes(), dtree.getRoot(), obj, callback, min_dist);
   }
 }
 
 //==============================================================================
 template <typename S>
-FCL_EXPORT
-void DynamicAABBTreeCollisionManager_Array<S>::collide(void* cdata, CollisionCallBack<S> callback) const
+template <typename CollisionFunction>
+void DynamicAABBTreeCollisionManager_Array<S>::collide(CollisionFunction callback) const
 {
   if(size() == 0) return;
-  detail::dynamic_AABB_tree_array::selfCollisionRecurse(dtree.getNodes(), dtree.getRoot(), cdata, callback);
+  detail::dynamic_AABB_tree_array::selfCollisionRecurse<S>(dtree.getNodes(), dtree.getRoot(), callback);
 }
 
 //==============================================================================
 template <typename S>
-FCL_EXPORT
-void DynamicAABBTreeCollisionManager_Array<S>::distance(void* cdata, DistanceCallBack<S> callback) const
+template <typename DistanceFunction>
+void DynamicAABBTreeCollisionManager_Array<S>::distance(DistanceFunction callback) const
 {
   if(size() == 0) return;
   S min_dist = std::numeric_limits<S>::max();
-  detail::dynamic_AABB_tree_array::selfDistanceRecurse(dtree.getNodes(), dtree.getRoot(), cdata, callback, min_dist);
+  detail::dynamic_AABB_tree_array::selfDistanceRecurse<S>(dtree.getNodes(), dtree.getRoot(), callback, min_dist);
 }
 
 //==============================================================================
 template <typename S>
-FCL_EXPORT
-void DynamicAABBTreeCollisionManager_Array<S>::collide(BroadPhaseCollisionManager<S>* other_manager_, void* cdata, CollisionCallBack<S> callback) const
+template <typename CollisionFunction>
+void DynamicAABBTreeCollisionManager_Array<S>::collide(BroadPhaseCollisionManager<S>* other_manager_, CollisionFunction callback) const
 {
   DynamicAABBTreeCollisionManager_Array* other_manager = static_cast<DynamicAABBTreeCollisionManager_Array*>(other_manager_);
   if((size() == 0) || (other_manager->size() == 0)) return;
-  detail::dynamic_AABB_tree_array::collisionRecurse(dtree.getNodes(), dtree.getRoot(), other_manager->dtree.getNodes(), other_manager->dtree.getRoot(), cdata, callback);
+  detail::dynamic_AABB_tree_array::collisionRecurse<S>(dtree.getNodes(), dtree.getRoot(), other_manager->dtree.getNodes(), other_manager->dtree.getRoot(), callback);
 }
 
 //==============================================================================
 template <typename S>
-FCL_EXPORT
-void DynamicAABBTreeCollisionManager_Array<S>::distance(BroadPhaseCollisionManager<S>* other_manager_, void* cdata, DistanceCallBack<S> callback) const
+template <typename DistanceFunction>
+void DynamicAABBTreeCollisionManager_Array<S>::distance(BroadPhaseCollisionManager<S>* other_manager_, DistanceFunction callback) const
 {
   DynamicAABBTreeCollisionManager_Array* other_manager = static_cast<DynamicAABBTreeCollisionManager_Array*>(other_manager_);
   if((size() == 0) || (other_manager->size() == 0)) return;
   S min_dist = std::numeric_limits<S>::max();
-  detail::dynamic_AABB_tree_array::distanceRecurse(dtree.getNodes(), dtree.getRoot(), other_manager->dtree.getNodes(), other_manager->dtree.getRoot(), cdata, callback, min_dist);
+  detail::dynamic_AABB_tree_array::distanceRecurse<S>(dtree.getNodes(), dtree.getRoot(), other_manager->dtree.getNodes(), other_manager->dtree.getRoot(), callback, min_dist);
 }
 
 //==============================================================================
@@ -1012,6 +1240,95 @@ DynamicAABBTreeCollisionManager_Array<S>::getTree() const
   return dtree;
 }
 
+//==============================================================================
+template <typename S>
+template <typename PacketFunction>
+void DynamicAABBTreeCollisionManager_Array<S>::runPackets_(std::size_t num_packets, PacketFunction process) const
+{
+  if(enable_parallel_batch)
+  {
+    getThreadPool_()->run(num_packets, [&](std::size_t i, unsigned int) {
+      process(i);
+    });
+  }
+  else
+  {
+    for(std::size_t i = 0; i < num_packets; ++i)
+      process(i);
+  }
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+std::shared_ptr<detail::ThreadPool>
+DynamicAABBTreeCollisionManager_Array<S>::getThreadPool_() const
+{
+  std::lock_guard<std::mutex> lock(thread_pool_mutex_);
+  const unsigned int n = detail::ThreadPool::resolveNumThreads(num_threads);
+  if(!thread_pool_ || thread_pool_->size() != n)
+    thread_pool_ = std::make_shared<detail::ThreadPool>(n);
+  return thread_pool_;
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager_Array<S>::getFatAABBParameters_(CollisionObject<S>* obj, Vector3<S>& vel, S& margin) const
+{
+  const auto it = fat_aabb_params_.find(obj);
+  if(it == fat_aabb_params_.end())
+  {
+    vel.setZero();
+    margin = fat_aabb_margin;
+  }
+  else
+  {
+    vel = it->second.vel;
+    margin = it->second.has_margin ? it->second.margin : fat_aabb_margin;
+  }
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+AABB<S> DynamicAABBTreeCollisionManager_Array<S>::getLeafAABB_(CollisionObject<S>* obj) const
+{
+  if(!use_fat_aabbs)
+    return obj->getAABB();
+
+  Vector3<S> vel;
+  S margin;
+  getFatAABBParameters_(obj, vel, margin);
+  return detail::fatBV(obj->getAABB(), vel, margin);
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager_Array<S>::updateFatAABB_(CollisionObject<S>* obj, size_t node)
+{
+  Vector3<S> vel;
+  S margin;
+  getFatAABBParameters_(obj, vel, margin);
+  if(dtree.update(node, obj->getAABB(), vel, margin))
+    ++num_fat_aabb_reinsertions;
+  else
+    ++num_fat_aabb_reinsertions_avoided;
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+void DynamicAABBTreeCollisionManager_Array<S>::setBuildThreadPool_(std::size_t num_objects)
+{
+  if(enable_parallel_build && num_threads != 1
+     && num_objects >= parallel_build_min_objects)
+    dtree.thread_pool = getThreadPool_().get();
+  else
+    dtree.thread_pool = nullptr;
+}
+
 } // namespace fcl
 
 #endif
@@ -41,12 +41,16 @@
 #include <unordered_map>
 #include <functional>
 #include <limits>
+#include <memory>
+#include <mutex>
 
 #include "fcl/math/bv/utility.h"
 #include "fcl/geometry/shape/box.h"
 #include "fcl/geometry/shape/utility.h"
 #include "fcl/broadphase/broadphase_collision_manager.h"
 #include "fcl/broadphase/detail/hierarchy_tree_array.h"
+#include "fcl/broadphase/detail/query_batch.h"
+#include "fcl/common/detail/thread_pool.h"
 
 namespace fcl
 {
@@ -67,7 +71,43 @@ public:
 
   bool octree_as_geometry_collide;
   bool octree_as_geometry_distance;
-  
+
+  /// @brief number of threads used, if enable_parallel_batch or
+  /// enable_parallel_build is set, by the batch queries or the builds of large
+  /// trees, including the calling thread; 0 means one thread per hardware core
+  unsigned int num_threads;
+
+  /// @brief whether collideBatch() and distanceBatch() may process the query
+  /// packets on num_threads threads; off by default, so that the callbacks
+  /// are only ever called from the calling thread unless asked to
+  bool enable_parallel_batch;
+
+  /// @brief whether registerObjects(), setup() and update() may build,
+  /// balance or refit the tree on num_threads threads; off by default, so that
+  /// these never start a thread pool unless asked to
+  bool enable_parallel_build;
+
+  /// @brief minimum number of objects for which the tree is built, balanced
+  /// or refitted in parallel when enable_parallel_build is set
+  std::size_t parallel_build_min_objects;
+
+  /// @brief fat AABB mode of the update functions: a leaf stores the AABB of
+  /// its object enlarged by a margin and extended by the predicted
+  /// displacement of the object, and it is only reinserted into the tree
+  /// once the AABB of the object leaves this fat AABB. The queries then
+  /// report the candidate pairs of overlapping fat AABBs. Off by default.
+  bool use_fat_aabbs;
+
+  /// @brief margin of the fat AABBs of the objects without a margin of their
+  /// own (see setFatAABBMargin())
+  S fat_aabb_margin;
+
+  /// @brief number of leaves the updates in the fat AABB mode reinserted,
+  /// and of the reinsertions they avoided because the AABB of the object was
+  /// still inside its fat AABB
+  std::size_t num_fat_aabb_reinsertions;
+  std::size_t num_fat_aabb_reinsertions_avoided;
+
   DynamicAABBTreeCollisionManager_Array();
 
   /// @brief add objects to the manager
@@ -94,6 +134,16 @@ public:
   /// @brief clear the manager
   void clear();
 
+  /// @brief set the margin of the fat AABB of obj, in place of
+  /// fat_aabb_margin. It takes effect the next time the leaf of obj is
+  /// (re)inserted.
+  void setFatAABBMargin(CollisionObject<S>* obj, S margin);
+
+  /// @brief set the displacement predicted for obj until its next update, by
+  /// which its fat AABB is extended. It takes effect the next time the leaf
+  /// of obj is (re)inserted.
+  void setFatAABBVelocity(CollisionObject<S>* obj, const Vector3<S>& vel);
+
   /// @brief return the objects managed by the manager
   void getObjects(std::vector<CollisionObject<S>*>& objs) const;
 
@@ -103,6 +153,16 @@ public:
   /// @brief perform distance computation between one object and all the objects belonging to the manager
   void distance(CollisionObject<S>* obj, void* cdata, DistanceCallBack<S> callback) const;
 
+  /// @brief perform collision test between each of a batch of query objects
+  /// and all the objects belonging to the manager. Works as
+  /// DynamicAABBTreeCollisionManager::collideBatch().
+  void collideBatch(const std::vector<CollisionObject<S>*>& objs, const std::vector<void*>& cdata, CollisionCallBack<S> callback) const;
+
+  /// @brief perform distance computation between each of a batch of query
+  /// objects and all the objects belonging to the manager. Works as
+  /// DynamicAABBTreeCollisionManager::distanceBatch().
+  void distanceBatch(const std::vector<CollisionObject<S>*>& objs, const std::vector<void*>& cdata, DistanceCallBack<S> callback) const;
+
   /// @brief perform collision test for the objects belonging to the manager (i.e., N^2 self collision)
   void collide(void* cdata, CollisionCallBack<S> callback) const;
 
@@ -114,6 +174,39 @@ public:
 
   /// @brief perform distance test with objects belonging to another manager
   void distance(BroadPhaseCollisionManager<S>* other_manager_, void* cdata, DistanceCallBack<S> callback) const;
+
+  /// @brief perform collision test between one object and all the objects
+  /// belonging to the manager, calling callback(o1, o2) on every candidate
+  /// pair until it returns true. Unlike a CollisionCallBack, the callable (for
+  /// instance a lambda capturing its data) is a template parameter of the
+  /// traversal and can be inlined into it; the function pointer overloads
+  /// forward to these.
+  template <typename CollisionFunction>
+  void collide(CollisionObject<S>* obj, CollisionFunction callback) const;
+
+  /// @brief perform distance computation between one object and all the
+  /// objects belonging to the manager, calling callback(o1, o2, min_dist) as
+  /// a DistanceCallBack but without its cdata
+  template <typename DistanceFunction>
+  void distance(CollisionObject<S>* obj, DistanceFunction callback) const;
+
+  /// @brief perform self collision calling callback(o1, o2)
+  template <typename CollisionFunction>
+  void collide(CollisionFunction callback) const;
+
+  /// @brief perform self distance calling callback(o1, o2, min_dist)
+  template <typename DistanceFunction>
+  void distance(DistanceFunction callback) const;
+
+  /// @brief perform collision test with objects belonging to another manager
+  /// calling callback(o1, o2)
+  template <typename CollisionFunction>
+  void collide(BroadPhaseCollisionManager<S>* other_manager_, CollisionFunction callback) const;
+
+  /// @brief perform distance test with objects belonging to another manager
+  /// calling callback(o1, o2, min_dist)
+  template <typename DistanceFunction>
+  void distance(BroadPhaseCollisionManager<S>* other_manager_, DistanceFunction callback) const;
   
   /// @brief whether the manager is empty
   bool empty() const;
@@ -129,7 +222,43 @@ private:
 
   bool setup_;
 
+  struct FatAABBParameters
+  {
+    bool has_margin = false;
+    S margin = 0;
+    Vector3<S> vel = Vector3<S>::Zero();
+  };
+
+  /// The fat AABB margins and velocities set for individual objects
+  std::unordered_map<CollisionObject<S>*, FatAABBParameters> fat_aabb_params_;
+
+  mutable std::shared_ptr<detail::ThreadPool> thread_pool_;
+  mutable std::mutex thread_pool_mutex_;
+
   void update_(CollisionObject<S>* updated_obj);
+
+  /// @brief the velocity and margin of the fat AABB of obj
+  void getFatAABBParameters_(CollisionObject<S>* obj, Vector3<S>& vel, S& margin) const;
+
+  /// @brief the bounding volume with which the leaf of obj is inserted
+  AABB<S> getLeafAABB_(CollisionObject<S>* obj) const;
+
+  /// @brief reinsert the leaf of obj with its fat AABB if the AABB of obj
+  /// left it, counting the reinsertions done and avoided
+  void updateFatAABB_(CollisionObject<S>* obj, size_t node);
+
+  /// @brief call process(i) for every packet i < num_packets of a batch
+  /// query, on the thread pool if enable_parallel_batch is set
+  template <typename PacketFunction>
+  void runPackets_(std::size_t num_packets, PacketFunction process) const;
+
+  /// @brief the pool used by the batch queries, (re)created on demand to
+  /// match num_threads
+  std::shared_ptr<detail::ThreadPool> getThreadPool_() const;
+
+  /// @brief hand the thread pool to the tree if a build or refit of
+  /// num_objects objects is large enough to run in parallel
+  void setBuildThreadPool_(std::size_t num_objects);
 };
 
 using DynamicAABBTreeCollisionManager_Arrayf = DynamicAABBTreeCollisionManager_Array<float>;
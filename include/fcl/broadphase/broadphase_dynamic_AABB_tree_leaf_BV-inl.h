@@ -0,0 +1,420 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#ifndef FCL_BROAD_PHASE_DYNAMIC_AABB_TREE_LEAF_BV_INL_H
+#define FCL_BROAD_PHASE_DYNAMIC_AABB_TREE_LEAF_BV_INL_H
+
+#include "fcl/broadphase/broadphase_dynamic_AABB_tree_leaf_BV.h"
+
+#include "fcl/geometry/shape/box.h"
+#include "fcl/geometry/shape/capsule.h"
+#include "fcl/geometry/shape/cone.h"
+#include "fcl/geometry/shape/convex.h"
+#include "fcl/geometry/shape/cylinder.h"
+#include "fcl/geometry/shape/ellipsoid.h"
+#include "fcl/geometry/shape/sphere.h"
+#include "fcl/geometry/shape/triangle_p.h"
+#include "fcl/geometry/shape/utility.h"
+
+namespace fcl
+{
+
+//==============================================================================
+extern template
+class FCL_EXPORT DynamicAABBTreeLeafBVCollisionManager<OBB<double>>;
+
+//==============================================================================
+extern template
+class FCL_EXPORT DynamicAABBTreeLeafBVCollisionManager<KDOP<double, 18>>;
+
+namespace detail {
+
+//==============================================================================
+extern template
+class FCL_EXPORT LeafBVCollisionObject<OBB<double>>;
+
+//==============================================================================
+extern template
+class FCL_EXPORT LeafBVCollisionObject<KDOP<double, 18>>;
+
+//==============================================================================
+template <typename BV>
+FCL_EXPORT
+bool computeWorldBV(const CollisionObject<typename BV::S>& obj, BV& bv)
+{
+  using S = typename BV::S;
+
+  const CollisionGeometry<S>* geom = obj.collisionGeometry().get();
+  const Transform3<S>& tf = obj.getTransform();
+
+  switch(geom->getNodeType())
+  {
+  case GEOM_BOX:
+    computeBV(*static_cast<const Box<S>*>(geom), tf, bv);
+    return true;
+  case GEOM_SPHERE:
+    computeBV(*static_cast<const Sphere<S>*>(geom), tf, bv);
+    return true;
+  case GEOM_ELLIPSOID:
+    computeBV(*static_cast<const Ellipsoid<S>*>(geom), tf, bv);
+    return true;
+  case GEOM_CAPSULE:
+    computeBV(*static_cast<const Capsule<S>*>(geom), tf, bv);
+    return true;
+  case GEOM_CONE:
+    computeBV(*static_cast<const Cone<S>*>(geom), tf, bv);
+    return true;
+  case GEOM_CYLINDER:
+    computeBV(*static_cast<const Cylinder<S>*>(geom), tf, bv);
+    return true;
+  case GEOM_CONVEX:
+    computeBV(*static_cast<const Convex<S>*>(geom), tf, bv);
+    return true;
+  case GEOM_TRIANGLE:
+    computeBV(*static_cast<const TriangleP<S>*>(geom), tf, bv);
+    return true;
+  case GEOM_HALFSPACE:
+  case GEOM_PLANE:
+    return false;
+  default:
+  {
+    // Meshes and octrees: the box of the local AABB, placed in the world
+    const AABB<S>& aabb = geom->aabb_local;
+    Transform3<S> box_tf = tf;
+    box_tf.translation() = tf * aabb.center();
+    computeBV(Box<S>(aabb.width(), aabb.height(), aabb.depth()), box_tf, bv);
+    return true;
+  }
+  }
+}
+
+//==============================================================================
+template <typename BV>
+LeafBVCollisionObject<BV>::LeafBVCollisionObject(CollisionObject<S>* object)
+  : CollisionObject<S>(std::const_pointer_cast<CollisionGeometry<S>>(
+        object->collisionGeometry())),
+    object_(object)
+{
+  updateLeafBV();
+}
+
+//==============================================================================
+template <typename BV>
+void LeafBVCollisionObject<BV>::updateLeafBV()
+{
+  this->setTransform(object_->getTransform());
+  this->aabb = object_->getAABB();
+  bounded_ = computeWorldBV(*object_, bv_);
+}
+
+//==============================================================================
+template <typename BV>
+CollisionObject<typename BV::S>* LeafBVCollisionObject<BV>::getObject() const
+{
+  return object_;
+}
+
+//==============================================================================
+template <typename BV>
+const BV* LeafBVCollisionObject<BV>::getLeafBV() const
+{
+  return bounded_ ? &bv_ : nullptr;
+}
+
+} // namespace detail
+
+//==============================================================================
+template <typename BV>
+DynamicAABBTreeLeafBVCollisionManager<BV>::DynamicAABBTreeLeafBVCollisionManager()
+{
+  // Do nothing
+}
+
+//==============================================================================
+template <typename BV>
+void DynamicAABBTreeLeafBVCollisionManager<BV>::registerObjects(
+    const std::vector<CollisionObject<S>*>& other_objs)
+{
+  std::vector<CollisionObject<S>*> new_leaf_objs;
+  new_leaf_objs.reserve(other_objs.size());
+  for(CollisionObject<S>* obj : other_objs)
+  {
+    auto& leaf_obj = leaf_objects[obj];
+    if(leaf_obj) continue;
+
+    leaf_obj.reset(new LeafObject(obj));
+    new_leaf_objs.push_back(leaf_obj.get());
+  }
+  aabb_tree_manager.registerObjects(new_leaf_objs);
+}
+
+//==============================================================================
+template <typename BV>
+void DynamicAABBTreeLeafBVCollisionManager<BV>::registerObject(CollisionObject<S>* obj)
+{
+  auto& leaf_obj = leaf_objects[obj];
+  if(leaf_obj) return;
+
+  leaf_obj.reset(new LeafObject(obj));
+  aabb_tree_manager.registerObject(leaf_obj.get());
+}
+
+//==============================================================================
+template <typename BV>
+void DynamicAABBTreeLeafBVCollisionManager<BV>::unregisterObject(CollisionObject<S>* obj)
+{
+  this->removePersistentPairs(obj);
+
+  const auto it = leaf_objects.find(obj);
+  if(it == leaf_objects.end()) return;
+
+  aabb_tree_manager.unregisterObject(it->second.get());
+  leaf_objects.erase(it);
+}
+
+//==============================================================================
+template <typename BV>
+void DynamicAABBTreeLeafBVCollisionManager<BV>::setup()
+{
+  aabb_tree_manager.setup();
+}
+
+//==============================================================================
+template <typename BV>
+void DynamicAABBTreeLeafBVCollisionManager<BV>::update()
+{
+  for(auto& leaf_obj : leaf_objects)
+    leaf_obj.second->updateLeafBV();
+  aabb_tree_manager.update();
+}
+
+//==============================================================================
+template <typename BV>
+void DynamicAABBTreeLeafBVCollisionManager<BV>::update(CollisionObject<S>* updated_obj)
+{
+  LeafObject* leaf_obj = getLeafObject_(updated_obj);
+  if(!leaf_obj) return;
+
+  leaf_obj->updateLeafBV();
+  aabb_tree_manager.update(leaf_obj);
+}
+
+//==============================================================================
+template <typename BV>
+void DynamicAABBTreeLeafBVCollisionManager<BV>::update(
+    const std::vector<CollisionObject<S>*>& updated_objs)
+{
+  std::vector<CollisionObject<S>*> updated_leaf_objs;
+  updated_leaf_objs.reserve(updated_objs.size());
+  for(CollisionObject<S>* obj : updated_objs)
+  {
+    LeafObject* leaf_obj = getLeafObject_(obj);
+    if(!leaf_obj) continue;
+
+    leaf_obj->updateLeafBV();
+    updated_leaf_objs.push_back(leaf_obj);
+  }
+  aabb_tree_manager.update(updated_leaf_objs);
+}
+
+//==============================================================================
+template <typename BV>
+void DynamicAABBTreeLeafBVCollisionManager<BV>::clear()
+{
+  this->removeAllPersistentPairs();
+
+  aabb_tree_manager.clear();
+  leaf_objects.clear();
+}
+
+//==============================================================================
+template <typename BV>
+void DynamicAABBTreeLeafBVCollisionManager<BV>::getObjects(
+    std::vector<CollisionObject<S>*>& objs) const
+{
+  aabb_tree_manager.getObjects(objs);
+  for(CollisionObject<S>*& obj : objs)
+    obj = static_cast<LeafObject*>(obj)->getObject();
+}
+
+//==============================================================================
+template <typename BV>
+void DynamicAABBTreeLeafBVCollisionManager<BV>::collide(
+    CollisionObject<S>* obj, void* cdata, CollisionCallBack<S> callback) const
+{
+  BV query_bv;
+  const BV* bv2 = detail::computeWorldBV(*obj, query_bv) ? &query_bv : nullptr;
+
+  // The tree reports its own object first; octrees queried as geometry report
+  // temporary objects instead of obj, which are never filtered.
+  aabb_tree_manager.collide(obj, [&](CollisionObject<S>* o1, CollisionObject<S>* o2)
+  {
+    const LeafObject* leaf_obj1 = static_cast<LeafObject*>(o1);
+    const BV* bv1 = leaf_obj1->getLeafBV();
+    if(bv1 && bv2 && o2 == obj && !bv1->overlap(*bv2))
+      return false;
+    return callback(leaf_obj1->getObject(), o2, cdata);
+  });
+}
+
+//==============================================================================
+template <typename BV>
+void DynamicAABBTreeLeafBVCollisionManager<BV>::distance(
+    CollisionObject<S>* obj, void* cdata, DistanceCallBack<S> callback) const
+{
+  aabb_tree_manager.distance(obj, [&](CollisionObject<S>* o1, CollisionObject<S>* o2, S& dist)
+  {
+    return callback(static_cast<LeafObject*>(o1)->getObject(), o2, cdata, dist);
+  });
+}
+
+//==============================================================================
+template <typename BV>
+void DynamicAABBTreeLeafBVCollisionManager<BV>::collide(
+    void* cdata, CollisionCallBack<S> callback) const
+{
+  aabb_tree_manager.collide([&](CollisionObject<S>* o1, CollisionObject<S>* o2)
+  {
+    const LeafObject* leaf_obj1 = static_cast<LeafObject*>(o1);
+    const LeafObject* leaf_obj2 = static_cast<LeafObject*>(o2);
+    const BV* bv1 = leaf_obj1->getLeafBV();
+    const BV* bv2 = leaf_obj2->getLeafBV();
+    if(bv1 && bv2 && !bv1->overlap(*bv2))
+      return false;
+    return callback(leaf_obj1->getObject(), leaf_obj2->getObject(), cdata);
+  });
+}
+
+//==============================================================================
+template <typename BV>
+void DynamicAABBTreeLeafBVCollisionManager<BV>::distance(
+    void* cdata, DistanceCallBack<S> callback) const
+{
+  aabb_tree_manager.distance([&](CollisionObject<S>* o1, CollisionObject<S>* o2, S& dist)
+  {
+    return callback(static_cast<LeafObject*>(o1)->getObject(),
+                    static_cast<LeafObject*>(o2)->getObject(), cdata, dist);
+  });
+}
+
+//==============================================================================
+template <typename BV>
+void DynamicAABBTreeLeafBVCollisionManager<BV>::collide(
+    BroadPhaseCollisionManager<S>* other_manager_, void* cdata, CollisionCallBack<S> callback) const
+{
+  DynamicAABBTreeLeafBVCollisionManager* other_manager
+      = static_cast<DynamicAABBTreeLeafBVCollisionManager*>(other_manager_);
+
+  aabb_tree_manager.collide(&other_manager->aabb_tree_manager,
+                            [&](CollisionObject<S>* o1, CollisionObject<S>* o2)
+  {
+    const LeafObject* leaf_obj1 = static_cast<LeafObject*>(o1);
+    const LeafObject* leaf_obj2 = static_cast<LeafObject*>(o2);
+    const BV* bv1 = leaf_obj1->getLeafBV();
+    const BV* bv2 = leaf_obj2->getLeafBV();
+    if(bv1 && bv2 && !bv1->overlap(*bv2))
+      return false;
+    return callback(leaf_obj1->getObject(), leaf_obj2->getObject(), cdata);
+  });
+}
+
+//==============================================================================
+template <typename BV>
+void DynamicAABBTreeLeafBVCollisionManager<BV>::distance(
+    BroadPhaseCollisionManager<S>* other_manager_, void* cdata, DistanceCallBack<S> callback) const
+{
+  DynamicAABBTreeLeafBVCollisionManager* other_manager
+      = static_cast<DynamicAABBTreeLeafBVCollisionManager*>(other_manager_);
+
+  aabb_tree_manager.distance(&other_manager->aabb_tree_manager,
+                             [&](CollisionObject<S>* o1, CollisionObject<S>* o2, S& dist)
+  {
+    return callback(static_cast<LeafObject*>(o1)->getObject(),
+                    static_cast<LeafObject*>(o2)->getObject(), cdata, dist);
+  });
+}
+
+//==============================================================================
+template <typename BV>
+bool DynamicAABBTreeLeafBVCollisionManager<BV>::empty() const
+{
+  return aabb_tree_manager.empty();
+}
+
+//==============================================================================
+template <typename BV>
+size_t DynamicAABBTreeLeafBVCollisionManager<BV>::size() const
+{
+  return aabb_tree_manager.size();
+}
+
+//==============================================================================
+template <typename BV>
+DynamicAABBTreeCollisionManager<typename BV::S>&
+DynamicAABBTreeLeafBVCollisionManager<BV>::getAABBTreeManager()
+{
+  return aabb_tree_manager;
+}
+
+//==============================================================================
+template <typename BV>
+const DynamicAABBTreeCollisionManager<typename BV::S>&
+DynamicAABBTreeLeafBVCollisionManager<BV>::getAABBTreeManager() const
+{
+  return aabb_tree_manager;
+}
+
+//==============================================================================
+template <typename BV>
+const BV* DynamicAABBTreeLeafBVCollisionManager<BV>::getLeafBV(
+    CollisionObject<S>* obj) const
+{
+  const LeafObject* leaf_obj = getLeafObject_(obj);
+  return leaf_obj ? leaf_obj->getLeafBV() : nullptr;
+}
+
+//==============================================================================
+template <typename BV>
+typename DynamicAABBTreeLeafBVCollisionManager<BV>::LeafObject*
+DynamicAABBTreeLeafBVCollisionManager<BV>::getLeafObject_(CollisionObject<S>* obj) const
+{
+  const auto it = leaf_objects.find(obj);
+  return (it == leaf_objects.end()) ? nullptr : it->second.get();
+}
+
+} // namespace fcl
+
+#endif
@@ -0,0 +1,208 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#ifndef FCL_BROAD_PHASE_DYNAMIC_AABB_TREE_LEAF_BV_H
+#define FCL_BROAD_PHASE_DYNAMIC_AABB_TREE_LEAF_BV_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "fcl/math/bv/OBB.h"
+#include "fcl/math/bv/kDOP.h"
+#include "fcl/broadphase/broadphase_dynamic_AABB_tree.h"
+
+namespace fcl
+{
+
+namespace detail
+{
+
+/// @brief The stand-in a DynamicAABBTreeLeafBVCollisionManager registers in
+/// its AABB tree for an object: a collision object with the AABB of the object
+/// that also carries the object's tight BV, so that a tree leaf reaches the BV
+/// without any lookup
+template <typename BV>
+class FCL_EXPORT LeafBVCollisionObject : public CollisionObject<typename BV::S>
+{
+public:
+
+  using S = typename BV::S;
+
+  explicit LeafBVCollisionObject(CollisionObject<S>* object);
+
+  /// @brief copies the transform and AABB of the object and recomputes its
+  /// BV from its current transform
+  void updateLeafBV();
+
+  /// @brief the object this object stands for
+  CollisionObject<S>* getObject() const;
+
+  /// @brief the BV of the object, or nullptr if it has no finite BV
+  const BV* getLeafBV() const;
+
+private:
+  CollisionObject<S>* object_;
+  BV bv_;
+  bool bounded_;
+};
+
+} // namespace detail
+
+/// @brief Dynamic AABB tree collision manager whose leaves also store a
+/// tighter world-space bounding volume of their object, such as OBB<S> or
+/// KDOP<S, 18>.
+///
+/// Every object is represented in a DynamicAABBTreeCollisionManager by a
+/// detail::LeafBVCollisionObject holding its BV, and a candidate pair found by
+/// the AABB tree is only passed to the collision callback if the BVs of its
+/// two objects overlap as well. For long, thin and rotated
+/// objects, such as the links of a robot arm, this removes most of the false
+/// candidate pairs, and so of the narrowphase work, at the cost of one BV per
+/// object computed on each update. Objects without a finite BV (halfspaces
+/// and planes) are never filtered. The distance queries are those of the
+/// AABB tree.
+template <typename BV>
+class FCL_EXPORT DynamicAABBTreeLeafBVCollisionManager
+    : public BroadPhaseCollisionManager<typename BV::S>
+{
+public:
+
+  using S = typename BV::S;
+
+  DynamicAABBTreeLeafBVCollisionManager();
+
+  /// @brief add objects to the manager
+  void registerObjects(const std::vector<CollisionObject<S>*>& other_objs);
+
+  /// @brief add one object to the manager
+  void registerObject(CollisionObject<S>* obj);
+
+  /// @brief remove one object from the manager
+  void unregisterObject(CollisionObject<S>* obj);
+
+  /// @brief initialize the manager, related with the specific type of manager
+  void setup();
+
+  /// @brief update the condition of manager
+  void update();
+
+  /// @brief update the manager by explicitly given the object updated
+  void update(CollisionObject<S>* updated_obj);
+
+  /// @brief update the manager by explicitly given the set of objects update
+  void update(const std::vector<CollisionObject<S>*>& updated_objs);
+
+  /// @brief clear the manager
+  void clear();
+
+  /// @brief return the objects managed by the manager
+  void getObjects(std::vector<CollisionObject<S>*>& objs) const;
+
+  /// @brief perform collision test between one object and all the objects belonging to the manager
+  void collide(CollisionObject<S>* obj, void* cdata, CollisionCallBack<S> callback) const;
+
+  /// @brief perform distance computation between one object and all the objects belonging to the manager
+  void distance(CollisionObject<S>* obj, void* cdata, DistanceCallBack<S> callback) const;
+
+  /// @brief perform collision test for the objects belonging to the manager (i.e., N^2 self collision)
+  void collide(void* cdata, CollisionCallBack<S> callback) const;
+
+  /// @brief perform distance test for the objects belonging to the manager (i.e., N^2 self distance)
+  void distance(void* cdata, DistanceCallBack<S> callback) const;
+
+  /// @brief perform collision test with objects belonging to another manager
+  /// of the same type
+  void collide(BroadPhaseCollisionManager<S>* other_manager_, void* cdata, CollisionCallBack<S> callback) const;
+
+  /// @brief perform distance test with objects belonging to another manager
+  /// of the same type
+  void distance(BroadPhaseCollisionManager<S>* other_manager_, void* cdata, DistanceCallBack<S> callback) const;
+
+  /// @brief whether the manager is empty
+  bool empty() const;
+
+  /// @brief the number of objects managed by the manager
+  size_t size() const;
+
+  /// @brief the AABB tree manager holding the stand-ins of the objects, e.g.
+  /// to tune its tree. Its octree_as_geometry_collide and
+  /// octree_as_geometry_distance options must be left on, as the callbacks
+  /// expect every object the tree reports from its own leaves to be a
+  /// stand-in.
+  DynamicAABBTreeCollisionManager<S>& getAABBTreeManager();
+
+  const DynamicAABBTreeCollisionManager<S>& getAABBTreeManager() const;
+
+  /// @brief the BV stored for obj, or nullptr if obj is not managed or has
+  /// no finite BV
+  const BV* getLeafBV(CollisionObject<S>* obj) const;
+
+private:
+
+  using LeafObject = detail::LeafBVCollisionObject<BV>;
+
+  DynamicAABBTreeCollisionManager<S> aabb_tree_manager;
+
+  /// @brief the stand-in of every managed object in aabb_tree_manager
+  std::unordered_map<CollisionObject<S>*, std::unique_ptr<LeafObject>> leaf_objects;
+
+  /// @brief the stand-in of obj, or nullptr if obj is not managed
+  LeafObject* getLeafObject_(CollisionObject<S>* obj) const;
+};
+
+using DynamicAABBTreeOBBCollisionManagerf = DynamicAABBTreeLeafBVCollisionManager<OBB<float>>;
+using DynamicAABBTreeOBBCollisionManagerd = DynamicAABBTreeLeafBVCollisionManager<OBB<double>>;
+using DynamicAABBTreeKDOP18CollisionManagerf = DynamicAABBTreeLeafBVCollisionManager<KDOP<float, 18>>;
+using DynamicAABBTreeKDOP18CollisionManagerd = DynamicAABBTreeLeafBVCollisionManager<KDOP<double, 18>>;
+
+namespace detail {
+
+/// @brief Compute the world-space BV of an object from its current
+/// transform, fitting the shape itself for the primitive shapes and the box of
+/// its local AABB otherwise. Returns false if the object has no finite BV
+/// (halfspaces and planes).
+template <typename BV>
+FCL_EXPORT
+bool computeWorldBV(const CollisionObject<typename BV::S>& obj, BV& bv);
+
+} // namespace detail
+
+} // namespace fcl
+
+#include "fcl/broadphase/broadphase_dynamic_AABB_tree_leaf_BV-inl.h"
+
+#endif
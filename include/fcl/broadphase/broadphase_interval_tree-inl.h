@@ -40,6 +40,8 @@
 
 #include "fcl/broadphase/broadphase_interval_tree.h"
 
+#include <algorithm>
+
 namespace fcl
 {
 
@@ -51,87 +53,19 @@ class FCL_EXPORT IntervalTreeCollisionManager<double>;
 template <typename S>
 void IntervalTreeCollisionManager<S>::unregisterObject(CollisionObject<S>* obj)
 {
+  this->removePersistentPairs(obj);
+
   // must sorted before
   setup();
 
-  EndPoint p;
-  p.value = obj->getAABB().min_[0];
-  auto start1 = std::lower_bound(endpoints[0].begin(), endpoints[0].end(), p);
-  p.value = obj->getAABB().max_[0];
-  auto end1 = std::upper_bound(start1, endpoints[0].end(), p);
-
-  if(start1 < end1)
-  {
-    unsigned int start_id = start1 - endpoints[0].begin();
-    unsigned int end_id = end1 - endpoints[0].begin();
-    unsigned int cur_id = start_id;
-    for(unsigned int i = start_id; i < end_id; ++i)
-    {
-      if(endpoints[0][i].obj != obj)
-      {
-        if(i == cur_id) cur_id++;
-        else
-        {
-          endpoints[0][cur_id] = endpoints[0][i];
-          cur_id++;
-        }
-      }
-    }
-    if(cur_id < end_id)
-      endpoints[0].resize(endpoints[0].size() - 2);
-  }
-
-  p.value = obj->getAABB().min_[1];
-  auto start2 = std::lower_bound(endpoints[1].begin(), endpoints[1].end(), p);
-  p.value = obj->getAABB().max_[1];
-  auto end2 = std::upper_bound(start2, endpoints[1].end(), p);
-
-  if(start2 < end2)
-  {
-    unsigned int start_id = start2 - endpoints[1].begin();
-    unsigned int end_id = end2 - endpoints[1].begin();
-    unsigned int cur_id = start_id;
-    for(unsigned int i = start_id; i < end_id; ++i)
-    {
-      if(endpoints[1][i].obj != obj)
-      {
-        if(i == cur_id) cur_id++;
-        else
-        {
-          endpoints[1][cur_id] = endpoints[1][i];
-          cur_id++;
-        }
-      }
-    }
-    if(cur_id < end_id)
-      endpoints[1].resize(endpoints[1].size() - 2);
-  }
-
-
-  p.value = obj->getAABB().min_[2];
-  auto start3 = std::lower_bound(endpoints[2].begin(), endpoints[2].end(), p);
-  p.value = obj->getAABB().max_[2];
-  auto end3 = std::upper_bound(start3, endpoints[2].end(), p);
-
-  if(start3 < end3)
+  // The end points may no longer match the current AABB of the object, so
+  // look for them by object
+  for(int i = 0; i < 3; ++i)
   {
-    unsigned int start_id = start3 - endpoints[2].begin();
-    unsigned int end_id = end3 - endpoints[2].begin();
-    unsigned int cur_id = start_id;
-    for(unsigned int i = start_id; i < end_id; ++i)
-    {
-      if(endpoints[2][i].obj != obj)
-      {
-        if(i == cur_id) cur_id++;
-        else
-        {
-          endpoints[2][cur_id] = endpoints[2][i];
-          cur_id++;
-        }
-      }
-    }
-    if(cur_id < end_id)
-      endpoints[2].resize(endpoints[2].size() - 2);
+    endpoints[i].erase(
+          std::remove_if(endpoints[i].begin(), endpoints[i].end(),
+                         [obj](const EndPoint& p) { return p.obj == obj; }),
+          endpoints[i].end());
   }
 
   // update the interval tree
@@ -167,6 +101,8 @@ IntervalTreeCollisionManager<S>::IntervalTreeCollisionManager() : setup_(false)
 template <typename S>
 IntervalTreeCollisionManager<S>::~IntervalTreeCollisionManager()
 {
+  // The kept pairs are not reported when the manager goes away
+  this->clearPersistentPairs();
   clear();
 }
 
@@ -330,6 +266,8 @@ void IntervalTreeCollisionManager<S>::update(const std::vector<CollisionObject<S
 template <typename S>
 void IntervalTreeCollisionManager<S>::clear()
 {
+  this->removeAllPersistentPairs();
+
   endpoints[0].clear();
   endpoints[1].clear();
   endpoints[2].clear();
@@ -99,6 +99,8 @@ void SpatialHashingCollisionManager<S, HashTable>::registerObject(
 template<typename S, typename HashTable>
 void SpatialHashingCollisionManager<S, HashTable>::unregisterObject(CollisionObject<S>* obj)
 {
+  this->removePersistentPairs(obj);
+
   objs.remove(obj);
 
   const AABB<S>& obj_aabb = obj->getAABB();
@@ -282,6 +284,8 @@ void SpatialHashingCollisionManager<S, HashTable>::update(const std::vector<Coll
 template<typename S, typename HashTable>
 void SpatialHashingCollisionManager<S, HashTable>::clear()
 {
+  this->removeAllPersistentPairs();
+
   objs.clear();
   hash_table->clear();
   objs_outside_scene_limit.clear();
@@ -323,7 +327,8 @@ bool SpatialHashingCollisionManager<S, HashTable>::collide_(
 
   if(scene_limit.overlap(obj_aabb, overlap_aabb))
   {
-    const auto query_result = hash_table->query(overlap_aabb);
+    std::vector<CollisionObject<S>*> query_result;
+    hash_table->query(overlap_aabb, query_result);
     for(const auto& obj2 : query_result)
     {
       if(obj == obj2)
@@ -383,6 +388,7 @@ bool SpatialHashingCollisionManager<S, HashTable>::distance_(
   }
 
   AABB<S> overlap_aabb;
+  std::vector<CollisionObject<S>*> query_result;
 
   auto status = 1;
   S old_min_distance;
@@ -393,8 +399,9 @@ bool SpatialHashingCollisionManager<S, HashTable>::distance_(
 
     if(scene_limit.overlap(aabb, overlap_aabb))
     {
+      hash_table->query(overlap_aabb, query_result);
       if (distanceObjectToObjects(
-            obj, hash_table->query(overlap_aabb), cdata, callback, min_dist))
+            obj, query_result, cdata, callback, min_dist))
       {
         return true;
       }
@@ -463,6 +470,8 @@ void SpatialHashingCollisionManager<S, HashTable>::collide(
   if(size() == 0)
     return;
 
+  std::vector<CollisionObject<S>*> query_result;
+
   for(const auto& obj1 : objs)
   {
     const auto& obj_aabb = obj1->getAABB();
@@ -470,7 +479,7 @@ void SpatialHashingCollisionManager<S, HashTable>::collide(
 
     if(scene_limit.overlap(obj_aabb, overlap_aabb))
     {
-      auto query_result = hash_table->query(overlap_aabb);
+      hash_table->query(overlap_aabb, query_result);
       for(const auto& obj2 : query_result)
       {
         if(obj1 < obj2)
@@ -0,0 +1,370 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#ifndef FCL_BROADPHASE_BROADPHASESWEPTVOLUMECONTINUOUS_INL_H
+#define FCL_BROADPHASE_BROADPHASESWEPTVOLUMECONTINUOUS_INL_H
+
+#include "fcl/broadphase/broadphase_swept_volume_continuous.h"
+
+namespace fcl
+{
+
+//==============================================================================
+extern template
+class FCL_EXPORT SweptVolumeContinuousCollisionManager<
+    double, DynamicAABBTreeCollisionManager<double>>;
+
+//==============================================================================
+extern template
+class FCL_EXPORT SweptVolumeContinuousCollisionManager<
+    double, SaPCollisionManager<double>>;
+
+namespace detail
+{
+
+//==============================================================================
+extern template
+class FCL_EXPORT SweptCollisionObject<double>;
+
+//==============================================================================
+template <typename S>
+SweptCollisionObject<S>::SweptCollisionObject(
+    ContinuousCollisionObject<S>* object)
+  : CollisionObject<S>(std::const_pointer_cast<CollisionGeometry<S>>(
+        object->collisionGeometry())),
+    object_(object)
+{
+  updateSweptAABB();
+}
+
+//==============================================================================
+template <typename S>
+void SweptCollisionObject<S>::updateSweptAABB()
+{
+  object_->computeAABB();
+  this->aabb = object_->getAABB();
+}
+
+//==============================================================================
+template <typename S>
+ContinuousCollisionObject<S>*
+SweptCollisionObject<S>::getContinuousObject() const
+{
+  return object_;
+}
+
+namespace swept_volume_continuous
+{
+
+//==============================================================================
+/// @brief The data handed to the discrete manager by the continuous queries
+template <typename CallBack>
+struct CallBackData
+{
+  void* cdata;
+  CallBack callback;
+};
+
+//==============================================================================
+/// @brief Forwards a candidate pair of swept volumes to the continuous
+/// collision callback
+template <typename S>
+FCL_EXPORT
+bool collisionCallBack(CollisionObject<S>* o1, CollisionObject<S>* o2, void* data)
+{
+  auto* cdata = static_cast<CallBackData<ContinuousCollisionCallBack<S>>*>(data);
+  return cdata->callback(
+      static_cast<SweptCollisionObject<S>*>(o1)->getContinuousObject(),
+      static_cast<SweptCollisionObject<S>*>(o2)->getContinuousObject(),
+      cdata->cdata);
+}
+
+//==============================================================================
+/// @brief Forwards a candidate pair of swept volumes to the continuous
+/// distance callback
+template <typename S>
+FCL_EXPORT
+bool distanceCallBack(CollisionObject<S>* o1, CollisionObject<S>* o2, void* data, S& dist)
+{
+  auto* cdata = static_cast<CallBackData<ContinuousDistanceCallBack<S>>*>(data);
+  return cdata->callback(
+      static_cast<SweptCollisionObject<S>*>(o1)->getContinuousObject(),
+      static_cast<SweptCollisionObject<S>*>(o2)->getContinuousObject(),
+      cdata->cdata, dist);
+}
+
+} // namespace swept_volume_continuous
+
+} // namespace detail
+
+//==============================================================================
+template <typename S, typename Manager>
+SweptVolumeContinuousCollisionManager<S, Manager>::SweptVolumeContinuousCollisionManager()
+{
+  // Do nothing
+}
+
+//==============================================================================
+template <typename S, typename Manager>
+void SweptVolumeContinuousCollisionManager<S, Manager>::registerObjects(
+    const std::vector<ContinuousCollisionObject<S>*>& other_objs)
+{
+  std::vector<CollisionObject<S>*> swept_objs;
+  swept_objs.reserve(other_objs.size());
+  for(auto obj : other_objs)
+  {
+    // An object registered before, or twice in other_objs, keeps the swept
+    // volume the discrete manager already points to.
+    auto& swept = table_[obj];
+    if(swept) continue;
+
+    swept.reset(new detail::SweptCollisionObject<S>(obj));
+    swept_objs.push_back(swept.get());
+  }
+
+  manager_.registerObjects(swept_objs);
+}
+
+//==============================================================================
+template <typename S, typename Manager>
+void SweptVolumeContinuousCollisionManager<S, Manager>::registerObject(
+    ContinuousCollisionObject<S>* obj)
+{
+  auto& swept = table_[obj];
+  if(swept) return;
+
+  swept.reset(new detail::SweptCollisionObject<S>(obj));
+  manager_.registerObject(swept.get());
+}
+
+//==============================================================================
+template <typename S, typename Manager>
+void SweptVolumeContinuousCollisionManager<S, Manager>::unregisterObject(
+    ContinuousCollisionObject<S>* obj)
+{
+  auto it = table_.find(obj);
+  if(it == table_.end()) return;
+
+  manager_.unregisterObject(it->second.get());
+  table_.erase(it);
+}
+
+//==============================================================================
+template <typename S, typename Manager>
+void SweptVolumeContinuousCollisionManager<S, Manager>::setup()
+{
+  manager_.setup();
+}
+
+//==============================================================================
+template <typename S, typename Manager>
+void SweptVolumeContinuousCollisionManager<S, Manager>::update()
+{
+  for(auto& entry : table_)
+    entry.second->updateSweptAABB();
+
+  manager_.update();
+}
+
+//==============================================================================
+template <typename S, typename Manager>
+void SweptVolumeContinuousCollisionManager<S, Manager>::update(
+    ContinuousCollisionObject<S>* updated_obj)
+{
+  auto it = table_.find(updated_obj);
+  if(it == table_.end()) return;
+
+  it->second->updateSweptAABB();
+  manager_.update(it->second.get());
+}
+
+//==============================================================================
+template <typename S, typename Manager>
+void SweptVolumeContinuousCollisionManager<S, Manager>::update(
+    const std::vector<ContinuousCollisionObject<S>*>& updated_objs)
+{
+  std::vector<CollisionObject<S>*> swept_objs;
+  swept_objs.reserve(updated_objs.size());
+  for(auto obj : updated_objs)
+  {
+    auto it = table_.find(obj);
+    if(it == table_.end()) continue;
+
+    it->second->updateSweptAABB();
+    swept_objs.push_back(it->second.get());
+  }
+
+  manager_.update(swept_objs);
+}
+
+//==============================================================================
+template <typename S, typename Manager>
+void SweptVolumeContinuousCollisionManager<S, Manager>::clear()
+{
+  manager_.clear();
+  table_.clear();
+}
+
+//==============================================================================
+template <typename S, typename Manager>
+void SweptVolumeContinuousCollisionManager<S, Manager>::getObjects(
+    std::vector<ContinuousCollisionObject<S>*>& objs) const
+{
+  std::vector<CollisionObject<S>*> swept_objs;
+  manager_.getObjects(swept_objs);
+
+  objs.resize(swept_objs.size());
+  for(size_t i = 0; i < swept_objs.size(); ++i)
+  {
+    objs[i] = static_cast<detail::SweptCollisionObject<S>*>(swept_objs[i])
+        ->getContinuousObject();
+  }
+}
+
+//==============================================================================
+template <typename S, typename Manager>
+void SweptVolumeContinuousCollisionManager<S, Manager>::collide(
+    ContinuousCollisionObject<S>* obj,
+    void* cdata,
+    ContinuousCollisionCallBack<S> callback) const
+{
+  detail::SweptCollisionObject<S> query(obj);
+  detail::swept_volume_continuous::CallBackData<ContinuousCollisionCallBack<S>>
+      data{cdata, callback};
+  manager_.collide(
+      &query, &data, detail::swept_volume_continuous::collisionCallBack<S>);
+}
+
+//==============================================================================
+template <typename S, typename Manager>
+void SweptVolumeContinuousCollisionManager<S, Manager>::distance(
+    ContinuousCollisionObject<S>* obj,
+    void* cdata,
+    ContinuousDistanceCallBack<S> callback) const
+{
+  detail::SweptCollisionObject<S> query(obj);
+  detail::swept_volume_continuous::CallBackData<ContinuousDistanceCallBack<S>>
+      data{cdata, callback};
+  manager_.distance(
+      &query, &data, detail::swept_volume_continuous::distanceCallBack<S>);
+}
+
+//==============================================================================
+template <typename S, typename Manager>
+void SweptVolumeContinuousCollisionManager<S, Manager>::collide(
+    void* cdata, ContinuousCollisionCallBack<S> callback) const
+{
+  detail::swept_volume_continuous::CallBackData<ContinuousCollisionCallBack<S>>
+      data{cdata, callback};
+  manager_.collide(
+      &data, detail::swept_volume_continuous::collisionCallBack<S>);
+}
+
+//==============================================================================
+template <typename S, typename Manager>
+void SweptVolumeContinuousCollisionManager<S, Manager>::distance(
+    void* cdata, ContinuousDistanceCallBack<S> callback) const
+{
+  detail::swept_volume_continuous::CallBackData<ContinuousDistanceCallBack<S>>
+      data{cdata, callback};
+  manager_.distance(
+      &data, detail::swept_volume_continuous::distanceCallBack<S>);
+}
+
+//==============================================================================
+template <typename S, typename Manager>
+void SweptVolumeContinuousCollisionManager<S, Manager>::collide(
+    BroadPhaseContinuousCollisionManager<S>* other_manager_,
+    void* cdata,
+    ContinuousCollisionCallBack<S> callback) const
+{
+  auto* other_manager
+      = static_cast<SweptVolumeContinuousCollisionManager*>(other_manager_);
+  detail::swept_volume_continuous::CallBackData<ContinuousCollisionCallBack<S>>
+      data{cdata, callback};
+  manager_.collide(
+      &other_manager->manager_, &data,
+      detail::swept_volume_continuous::collisionCallBack<S>);
+}
+
+//==============================================================================
+template <typename S, typename Manager>
+void SweptVolumeContinuousCollisionManager<S, Manager>::distance(
+    BroadPhaseContinuousCollisionManager<S>* other_manager_,
+    void* cdata,
+    ContinuousDistanceCallBack<S> callback) const
+{
+  auto* other_manager
+      = static_cast<SweptVolumeContinuousCollisionManager*>(other_manager_);
+  detail::swept_volume_continuous::CallBackData<ContinuousDistanceCallBack<S>>
+      data{cdata, callback};
+  manager_.distance(
+      &other_manager->manager_, &data,
+      detail::swept_volume_continuous::distanceCallBack<S>);
+}
+
+//==============================================================================
+template <typename S, typename Manager>
+bool SweptVolumeContinuousCollisionManager<S, Manager>::empty() const
+{
+  return table_.empty();
+}
+
+//==============================================================================
+template <typename S, typename Manager>
+size_t SweptVolumeContinuousCollisionManager<S, Manager>::size() const
+{
+  return table_.size();
+}
+
+//==============================================================================
+template <typename S, typename Manager>
+Manager& SweptVolumeContinuousCollisionManager<S, Manager>::getManager()
+{
+  return manager_;
+}
+
+//==============================================================================
+template <typename S, typename Manager>
+const Manager&
+SweptVolumeContinuousCollisionManager<S, Manager>::getManager() const
+{
+  return manager_;
+}
+
+} // namespace fcl
+
+#endif
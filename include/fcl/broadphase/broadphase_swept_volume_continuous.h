@@ -0,0 +1,182 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#ifndef FCL_BROADPHASE_BROADPHASESWEPTVOLUMECONTINUOUS_H
+#define FCL_BROADPHASE_BROADPHASESWEPTVOLUMECONTINUOUS_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "fcl/broadphase/broadphase_continuous_collision_manager.h"
+#include "fcl/broadphase/broadphase_dynamic_AABB_tree.h"
+#include "fcl/broadphase/broadphase_SaP.h"
+
+namespace fcl
+{
+
+namespace detail
+{
+
+/// @brief The stand-in a SweptVolumeContinuousCollisionManager registers in
+/// its discrete manager for a continuous object: a collision object whose AABB
+/// is the AABB swept by the continuous object over its whole motion
+template <typename S>
+class FCL_EXPORT SweptCollisionObject : public CollisionObject<S>
+{
+public:
+  explicit SweptCollisionObject(ContinuousCollisionObject<S>* object);
+
+  /// @brief recomputes the swept AABB from the motion of the object
+  void updateSweptAABB();
+
+  /// @brief the continuous object this object stands for
+  ContinuousCollisionObject<S>* getContinuousObject() const;
+
+private:
+  ContinuousCollisionObject<S>* object_;
+};
+
+} // namespace detail
+
+/// @brief Broad phase continuous collision built on a discrete broad phase
+/// collision manager. Every continuous object is represented in the discrete
+/// manager by the AABB it sweeps over its motion (computed from the Taylor
+/// model of its MotionBase), so the discrete manager culls the pairs whose
+/// swept volumes are disjoint and the callback only sees the candidate pairs,
+/// typically to run the narrowphase continuous collision on them (see
+/// DefaultContinuousCollisionFunction()).
+///
+/// The swept AABBs are recomputed by registerObject() and update(); after
+/// changing the motion of registered objects, call update().
+///
+/// @tparam Manager the discrete BroadPhaseCollisionManager used for culling
+template <typename S, typename Manager>
+class FCL_EXPORT SweptVolumeContinuousCollisionManager
+    : public BroadPhaseContinuousCollisionManager<S>
+{
+public:
+  SweptVolumeContinuousCollisionManager();
+
+  /// @brief add objects to the manager, registering their swept volumes with
+  /// the discrete manager in one batch; objects already in the manager are
+  /// skipped
+  void registerObjects(const std::vector<ContinuousCollisionObject<S>*>& other_objs);
+
+  /// @brief add one object to the manager; does nothing if obj is already in
+  /// the manager
+  void registerObject(ContinuousCollisionObject<S>* obj);
+
+  /// @brief remove one object from the manager
+  void unregisterObject(ContinuousCollisionObject<S>* obj);
+
+  /// @brief initialize the manager, related with the specific type of manager
+  void setup();
+
+  /// @brief update the condition of manager
+  void update();
+
+  /// @brief update the manager by explicitly given the object updated
+  void update(ContinuousCollisionObject<S>* updated_obj);
+
+  /// @brief update the manager by explicitly given the set of objects update
+  void update(const std::vector<ContinuousCollisionObject<S>*>& updated_objs);
+
+  /// @brief clear the manager
+  void clear();
+
+  /// @brief return the objects managed by the manager
+  void getObjects(std::vector<ContinuousCollisionObject<S>*>& objs) const;
+
+  /// @brief perform collision test between one object and all the objects belonging to the manager
+  void collide(ContinuousCollisionObject<S>* obj, void* cdata, ContinuousCollisionCallBack<S> callback) const;
+
+  /// @brief perform distance computation between one object and all the objects belonging to the manager
+  void distance(ContinuousCollisionObject<S>* obj, void* cdata, ContinuousDistanceCallBack<S> callback) const;
+
+  /// @brief perform collision test for the objects belonging to the manager (i.e., N^2 self collision)
+  void collide(void* cdata, ContinuousCollisionCallBack<S> callback) const;
+
+  /// @brief perform distance test for the objects belonging to the manager (i.e., N^2 self distance)
+  void distance(void* cdata, ContinuousDistanceCallBack<S> callback) const;
+
+  /// @brief perform collision test with objects belonging to another manager
+  /// of the same type
+  void collide(BroadPhaseContinuousCollisionManager<S>* other_manager, void* cdata, ContinuousCollisionCallBack<S> callback) const;
+
+  /// @brief perform distance test with objects belonging to another manager
+  /// of the same type
+  void distance(BroadPhaseContinuousCollisionManager<S>* other_manager, void* cdata, ContinuousDistanceCallBack<S> callback) const;
+
+  /// @brief whether the manager is empty
+  bool empty() const;
+
+  /// @brief the number of objects managed by the manager
+  size_t size() const;
+
+  /// @brief the discrete manager holding the swept volumes, e.g. to tune its
+  /// parameters
+  Manager& getManager();
+
+  /// @brief the discrete manager holding the swept volumes
+  const Manager& getManager() const;
+
+private:
+  Manager manager_;
+
+  std::unordered_map<ContinuousCollisionObject<S>*,
+                     std::unique_ptr<detail::SweptCollisionObject<S>>> table_;
+};
+
+template <typename S>
+using DynamicAABBTreeContinuousCollisionManager
+    = SweptVolumeContinuousCollisionManager<S, DynamicAABBTreeCollisionManager<S>>;
+
+using DynamicAABBTreeContinuousCollisionManagerf = DynamicAABBTreeContinuousCollisionManager<float>;
+using DynamicAABBTreeContinuousCollisionManagerd = DynamicAABBTreeContinuousCollisionManager<double>;
+
+template <typename S>
+using SaPContinuousCollisionManager
+    = SweptVolumeContinuousCollisionManager<S, SaPCollisionManager<S>>;
+
+using SaPContinuousCollisionManagerf = SaPContinuousCollisionManager<float>;
+using SaPContinuousCollisionManagerd = SaPContinuousCollisionManager<double>;
+
+} // namespace fcl
+
+#include "fcl/broadphase/broadphase_swept_volume_continuous-inl.h"
+
+#endif
@@ -104,6 +104,54 @@ bool DefaultCollisionFunction(CollisionObject<S>* o1, CollisionObject<S>* o2,
   return collision_data->done;
 }
 
+/// @brief Reset function for the parallel broadphase queries (e.g.,
+/// DynamicAABBTreeCollisionManager::collideParallel()) working on
+/// DefaultCollisionData. It empties the result of the copy of the query data
+/// that a task starts from, so that the task only collects its own contacts;
+/// the request is kept.
+///
+/// @param task_data  The data one task of the query will work on.
+/// @tparam S   The scalar type with which the computation will be performed.
+template <typename S>
+void DefaultCollisionResetFunction(DefaultCollisionData<S>& task_data) {
+  task_data.result.clear();
+  task_data.done = false;
+}
+
+/// @brief Merge function for the parallel broadphase queries (e.g.,
+/// DynamicAABBTreeCollisionManager::collideParallel()) working on
+/// DefaultCollisionData. It appends the contacts and cost sources found by one
+/// task to `data`, keeping at most the requested number of contacts, and
+/// applies the same stopping rule as DefaultCollisionFunction().
+///
+/// @param data       The data of the whole query.
+/// @param task_data  The data one task of the query has worked on.
+/// @tparam S   The scalar type with which the computation will be performed.
+template <typename S>
+void DefaultCollisionMergeFunction(DefaultCollisionData<S>& data,
+                                   DefaultCollisionData<S>& task_data) {
+  const CollisionRequest<S>& request = data.request;
+  CollisionResult<S>& result = data.result;
+
+  if (data.done) return;
+
+  std::vector<Contact<S>> contacts;
+  task_data.result.getContacts(contacts);
+  for (const auto& contact : contacts) {
+    if (result.numContacts() >= request.num_max_contacts) break;
+    result.addContact(contact);
+  }
+
+  std::vector<CostSource<S>> cost_sources;
+  task_data.result.getCostSources(cost_sources);
+  for (const auto& cost_source : cost_sources)
+    result.addCostSource(cost_source, request.num_max_cost_sources);
+
+  if (!request.enable_cost && result.isCollision() &&
+      result.numContacts() >= request.num_max_contacts) {
+    data.done = true;
+  }
+}
 
 /// @brief Collision data for use with the DefaultContinuousCollisionFunction.
 /// It stores the collision request and the result given by the collision
@@ -125,6 +173,10 @@ struct DefaultContinuousCollisionData {
 /// the `collide()` method on the culled pair of geometries and stores the
 /// results in the data's ContinuousCollisionResult instance.
 ///
+/// The result keeps the earliest contact found over all the culled pairs: a
+/// pair's result replaces the stored one only if the pair collides before the
+/// stored time of contact.
+///
 /// This callback will never cause the broadphase evaluation to terminate early.
 /// However, if the `done` member of the DefaultContinuousCollisionData is set
 /// to true, this method will simply return without doing any computation.
@@ -151,9 +203,15 @@ bool DefaultContinuousCollisionFunction(ContinuousCollisionObject<S>* o1,
   if (cdata->done) return true;
 
   const ContinuousCollisionRequest<S>& request = cdata->request;
-  ContinuousCollisionResult<S>& result = cdata->result;
+  ContinuousCollisionResult<S> result;
   collide(o1, o2, request, result);
 
+  if (result.is_collide && (!cdata->result.is_collide ||
+                            result.time_of_contact <
+                                cdata->result.time_of_contact)) {
+    cdata->result = result;
+  }
+
   return cdata->done;
 }
 
@@ -214,6 +272,36 @@ bool DefaultDistanceFunction(CollisionObject<S>* o1, CollisionObject<S>* o2,
   return cdata->done;
 }
 
+/// @brief Reset function for the parallel broadphase queries (e.g.,
+/// DynamicAABBTreeCollisionManager::distanceParallel()) working on
+/// DefaultDistanceData. It empties the result of the copy of the query data
+/// that a task starts from; the request is kept.
+///
+/// @param task_data  The data one task of the query will work on.
+/// @tparam S   The scalar type with which the computation will be performed.
+template <typename S>
+void DefaultDistanceResetFunction(DefaultDistanceData<S>& task_data) {
+  task_data.result.clear();
+  task_data.done = false;
+}
+
+/// @brief Merge function for the parallel broadphase queries (e.g.,
+/// DynamicAABBTreeCollisionManager::distanceParallel()) working on
+/// DefaultDistanceData. It keeps the closer of the two results; on a tie the
+/// result already in `data` wins.
+///
+/// @param data       The data of the whole query.
+/// @param task_data  The data one task of the query has worked on.
+/// @tparam S   The scalar type with which the computation will be performed.
+template <typename S>
+void DefaultDistanceMergeFunction(DefaultDistanceData<S>& data,
+                                  DefaultDistanceData<S>& task_data) {
+  if (data.done) return;
+
+  data.result.update(task_data.result);
+  data.done = task_data.done;
+}
+
 }  // namespace fcl
 
 #endif  // FCL_BROADPHASE_DEFAULTBROADPHASECALLBACKS_H
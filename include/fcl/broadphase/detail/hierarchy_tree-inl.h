@@ -40,6 +40,8 @@
 
 #include "fcl/broadphase/detail/hierarchy_tree.h"
 
+#include <algorithm>
+
 namespace fcl
 {
 
@@ -57,6 +59,8 @@ HierarchyTree<BV>::HierarchyTree(int bu_threshold_, int topdown_level_)
   opath = 0;
   bu_threshold = bu_threshold_;
   topdown_level = topdown_level_;
+  build_task_depth = 0;
+  thread_pool = nullptr;
 }
 
 //==============================================================================
@@ -169,46 +173,22 @@ bool HierarchyTree<BV>::update(NodeType* leaf, const BV& bv)
   return true;
 }
 
-//==============================================================================
-template <typename S, typename BV>
-struct UpdateImpl
-{
-  static bool run(
-      const HierarchyTree<BV>& tree,
-      typename HierarchyTree<BV>::NodeType* leaf,
-      const BV& bv,
-      const Vector3<S>& /*vel*/,
-      S /*margin*/)
-  {
-    if(leaf->bv.contain(bv)) return false;
-    tree.update_(leaf, bv);
-    return true;
-  }
-
-  static bool run(
-      const HierarchyTree<BV>& tree,
-      typename HierarchyTree<BV>::NodeType* leaf,
-      const BV& bv,
-      const Vector3<S>& /*vel*/)
-  {
-    if(leaf->bv.contain(bv)) return false;
-    tree.update_(leaf, bv);
-    return true;
-  }
-};
-
 //==============================================================================
 template<typename BV>
 bool HierarchyTree<BV>::update(NodeType* leaf, const BV& bv, const Vector3<S>& vel, S margin)
 {
-  return UpdateImpl<typename BV::S, BV>::run(*this, leaf, bv, vel, margin);
+  if(leaf->bv.contain(bv)) return false;
+  update_(leaf, fatBV(bv, vel, margin));
+  return true;
 }
 
 //==============================================================================
 template<typename BV>
 bool HierarchyTree<BV>::update(NodeType* leaf, const BV& bv, const Vector3<S>& vel)
 {
-  return UpdateImpl<typename BV::S, BV>::run(*this, leaf, bv, vel);
+  if(leaf->bv.contain(bv)) return false;
+  update_(leaf, fatBV(bv, vel, S(0)));
+  return true;
 }
 
 //==============================================================================
@@ -254,7 +234,9 @@ void HierarchyTree<BV>::balanceTopdown()
     std::vector<NodeType*> leaves;
     leaves.reserve(n_leaves);
     fetchLeaves(root_node, leaves);
-    root_node = topdown(leaves.begin(), leaves.end());
+    root_node = parallelBuild([&](int depth) {
+      return topdown(leaves.begin(), leaves.end(), depth);
+    });
   }
 }
 
@@ -284,7 +266,20 @@ void HierarchyTree<BV>::balanceIncremental(int iterations)
 template<typename BV>
 void HierarchyTree<BV>::refit()
 {
-  if(root_node)
+  if(!root_node)
+    return;
+
+  if(thread_pool && thread_pool->size() > 1)
+  {
+    const int depth = taskDepth();
+    std::vector<NodeType*> subtrees;
+    collectSubtrees(root_node, depth, subtrees);
+    thread_pool->run(subtrees.size(), [&](std::size_t i, unsigned int) {
+      recurseRefit(subtrees[i]);
+    });
+    recurseRefit(root_node, depth);
+  }
+  else
     recurseRefit(root_node);
 }
 
@@ -378,18 +373,18 @@ void HierarchyTree<BV>::bottomup(const NodeVecIterator lbeg, const NodeVecIterat
 
 //==============================================================================
 template<typename BV>
-typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::topdown(const NodeVecIterator lbeg, const NodeVecIterator lend)
+typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::topdown(const NodeVecIterator lbeg, const NodeVecIterator lend, int depth)
 {
   switch(topdown_level)
   {
   case 0:
-    return topdown_0(lbeg, lend);
+    return topdown_0(lbeg, lend, depth);
     break;
   case 1:
-    return topdown_1(lbeg, lend);
+    return topdown_1(lbeg, lend, depth);
     break;
   default:
-    return topdown_0(lbeg, lend);
+    return topdown_0(lbeg, lend, depth);
   }
 }
 
@@ -422,7 +417,7 @@ void HierarchyTree<BV>::getMaxDepth(NodeType* node, size_t depth, size_t& max_de
 
 //==============================================================================
 template<typename BV>
-typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::topdown_0(const NodeVecIterator lbeg, const NodeVecIterator lend)
+typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::topdown_0(const NodeVecIterator lbeg, const NodeVecIterator lend, int depth)
 {
   int num_leaves = lend - lbeg;
   if(num_leaves > 1)
@@ -443,10 +438,9 @@ typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::topdown_0(const NodeVec
       std::nth_element(lbeg, lcenter, lend, std::bind(&nodeBaseLess<BV>, std::placeholders::_1, std::placeholders::_2, std::ref(best_axis)));
 
       NodeType* node = createNode(nullptr, vol, nullptr);
-      node->children[0] = topdown_0(lbeg, lcenter);
-      node->children[1] = topdown_0(lcenter, lend);
-      node->children[0]->parent = node;
-      node->children[1]->parent = node;
+      buildChildren(node, depth,
+                    [=](int d) { return topdown_0(lbeg, lcenter, d); },
+                    [=](int d) { return topdown_0(lcenter, lend, d); });
       return node;
     }
     else
@@ -460,7 +454,7 @@ typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::topdown_0(const NodeVec
 
 //==============================================================================
 template<typename BV>
-typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::topdown_1(const NodeVecIterator lbeg, const NodeVecIterator lend)
+typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::topdown_1(const NodeVecIterator lbeg, const NodeVecIterator lend, int depth)
 {
   int num_leaves = lend - lbeg;
   if(num_leaves > 1)
@@ -515,10 +509,9 @@ typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::topdown_1(const NodeVec
       }
 
       NodeType* node = createNode(nullptr, vol, nullptr);
-      node->children[0] = topdown_1(lbeg, lcenter);
-      node->children[1] = topdown_1(lcenter, lend);
-      node->children[0]->parent = node;
-      node->children[1]->parent = node;
+      buildChildren(node, depth,
+                    [=](int d) { return topdown_1(lbeg, lcenter, d); },
+                    [=](int d) { return topdown_1(lcenter, lend, d); });
       return node;
     }
     else
@@ -535,7 +528,9 @@ template<typename BV>
 void HierarchyTree<BV>::init_0(std::vector<NodeType*>& leaves)
 {
   clear();
-  root_node = topdown(leaves.begin(), leaves.end());
+  root_node = parallelBuild([&](int depth) {
+    return topdown(leaves.begin(), leaves.end(), depth);
+  });
   n_leaves = leaves.size();
   max_lookahead_level = -1;
   opath = 0;
@@ -554,12 +549,11 @@ void HierarchyTree<BV>::init_1(std::vector<NodeType*>& leaves)
     bound_bv += leaves[i]->bv;
 
   morton_functor<typename BV::S, uint32> coder(bound_bv);
-  for(size_t i = 0; i < leaves.size(); ++i)
-    leaves[i]->code = coder(leaves[i]->bv.center());
-
-  std::sort(leaves.begin(), leaves.end(), SortByMorton());
+  sortByMorton(leaves, coder);
 
-  root_node = mortonRecurse_0(leaves.begin(), leaves.end(), (1 << (coder.bits()-1)), coder.bits()-1);
+  root_node = parallelBuild([&](int depth) {
+    return mortonRecurse_0(leaves.begin(), leaves.end(), (1 << (coder.bits()-1)), coder.bits()-1, depth);
+  });
 
   refit();
   n_leaves = leaves.size();
@@ -580,12 +574,11 @@ void HierarchyTree<BV>::init_2(std::vector<NodeType*>& leaves)
     bound_bv += leaves[i]->bv;
 
   morton_functor<typename BV::S, uint32> coder(bound_bv);
-  for(size_t i = 0; i < leaves.size(); ++i)
-    leaves[i]->code = coder(leaves[i]->bv.center());
+  sortByMorton(leaves, coder);
 
-  std::sort(leaves.begin(), leaves.end(), SortByMorton());
-
-  root_node = mortonRecurse_1(leaves.begin(), leaves.end(), (1 << (coder.bits()-1)), coder.bits()-1);
+  root_node = parallelBuild([&](int depth) {
+    return mortonRecurse_1(leaves.begin(), leaves.end(), (1 << (coder.bits()-1)), coder.bits()-1, depth);
+  });
 
   refit();
   n_leaves = leaves.size();
@@ -606,12 +599,11 @@ void HierarchyTree<BV>::init_3(std::vector<NodeType*>& leaves)
     bound_bv += leaves[i]->bv;
 
   morton_functor<typename BV::S, uint32> coder(bound_bv);
-  for(size_t i = 0; i < leaves.size(); ++i)
-    leaves[i]->code = coder(leaves[i]->bv.center());
-
-  std::sort(leaves.begin(), leaves.end(), SortByMorton());
+  sortByMorton(leaves, coder);
 
-  root_node = mortonRecurse_2(leaves.begin(), leaves.end());
+  root_node = parallelBuild([&](int depth) {
+    return mortonRecurse_2(leaves.begin(), leaves.end(), depth);
+  });
 
   refit();
   n_leaves = leaves.size();
@@ -621,7 +613,7 @@ void HierarchyTree<BV>::init_3(std::vector<NodeType*>& leaves)
 
 //==============================================================================
 template<typename BV>
-typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::mortonRecurse_0(const NodeVecIterator lbeg, const NodeVecIterator lend, const uint32& split, int bits)
+typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::mortonRecurse_0(const NodeVecIterator lbeg, const NodeVecIterator lend, const uint32& split, int bits, int depth)
 {
   int num_leaves = lend - lbeg;
   if(num_leaves > 1)
@@ -635,31 +627,28 @@ typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::mortonRecurse_0(const N
       if(lcenter == lbeg)
       {
         uint32 split2 = split | (1 << (bits - 1));
-        return mortonRecurse_0(lbeg, lend, split2, bits - 1);
+        return mortonRecurse_0(lbeg, lend, split2, bits - 1, depth);
       }
       else if(lcenter == lend)
       {
         uint32 split1 = (split & (~(1 << bits))) | (1 << (bits - 1));
-        return mortonRecurse_0(lbeg, lend, split1, bits - 1);
+        return mortonRecurse_0(lbeg, lend, split1, bits - 1, depth);
       }
       else
       {
         uint32 split1 = (split & (~(1 << bits))) | (1 << (bits - 1));
         uint32 split2 = split | (1 << (bits - 1));
 
-        NodeType* child1 = mortonRecurse_0(lbeg, lcenter, split1, bits - 1);
-        NodeType* child2 = mortonRecurse_0(lcenter, lend, split2, bits - 1);
         NodeType* node = createNode(nullptr, nullptr);
-        node->children[0] = child1;
-        node->children[1] = child2;
-        child1->parent = node;
-        child2->parent = node;
+        buildChildren(node, depth,
+                      [=](int d) { return mortonRecurse_0(lbeg, lcenter, split1, bits - 1, d); },
+                      [=](int d) { return mortonRecurse_0(lcenter, lend, split2, bits - 1, d); });
         return node;
       }
     }
     else
     {
-      NodeType* node = topdown(lbeg, lend);
+      NodeType* node = topdown(lbeg, lend, depth);
       return node;
     }
   }
@@ -669,7 +658,7 @@ typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::mortonRecurse_0(const N
 
 //==============================================================================
 template<typename BV>
-typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::mortonRecurse_1(const NodeVecIterator lbeg, const NodeVecIterator lend, const uint32& split, int bits)
+typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::mortonRecurse_1(const NodeVecIterator lbeg, const NodeVecIterator lend, const uint32& split, int bits, int depth)
 {
   int num_leaves = lend - lbeg;
   if(num_leaves > 1)
@@ -683,37 +672,31 @@ typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::mortonRecurse_1(const N
       if(lcenter == lbeg)
       {
         uint32 split2 = split | (1 << (bits - 1));
-        return mortonRecurse_1(lbeg, lend, split2, bits - 1);
+        return mortonRecurse_1(lbeg, lend, split2, bits - 1, depth);
       }
       else if(lcenter == lend)
       {
         uint32 split1 = (split & (~(1 << bits))) | (1 << (bits - 1));
-        return mortonRecurse_1(lbeg, lend, split1, bits - 1);
+        return mortonRecurse_1(lbeg, lend, split1, bits - 1, depth);
       }
       else
       {
         uint32 split1 = (split & (~(1 << bits))) | (1 << (bits - 1));
         uint32 split2 = split | (1 << (bits - 1));
 
-        NodeType* child1 = mortonRecurse_1(lbeg, lcenter, split1, bits - 1);
-        NodeType* child2 = mortonRecurse_1(lcenter, lend, split2, bits - 1);
         NodeType* node = createNode(nullptr, nullptr);
-        node->children[0] = child1;
-        node->children[1] = child2;
-        child1->parent = node;
-        child2->parent = node;
+        buildChildren(node, depth,
+                      [=](int d) { return mortonRecurse_1(lbeg, lcenter, split1, bits - 1, d); },
+                      [=](int d) { return mortonRecurse_1(lcenter, lend, split2, bits - 1, d); });
         return node;
       }
     }
     else
     {
-      NodeType* child1 = mortonRecurse_1(lbeg, lbeg + num_leaves / 2, 0, bits - 1);
-      NodeType* child2 = mortonRecurse_1(lbeg + num_leaves / 2, lend, 0, bits - 1);
       NodeType* node = createNode(nullptr, nullptr);
-      node->children[0] = child1;
-      node->children[1] = child2;
-      child1->parent = node;
-      child2->parent = node;
+      buildChildren(node, depth,
+                    [=](int d) { return mortonRecurse_1(lbeg, lbeg + num_leaves / 2, 0, bits - 1, d); },
+                    [=](int d) { return mortonRecurse_1(lbeg + num_leaves / 2, lend, 0, bits - 1, d); });
       return node;
     }
   }
@@ -723,24 +706,129 @@ typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::mortonRecurse_1(const N
 
 //==============================================================================
 template<typename BV>
-typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::mortonRecurse_2(const NodeVecIterator lbeg, const NodeVecIterator lend)
+typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::mortonRecurse_2(const NodeVecIterator lbeg, const NodeVecIterator lend, int depth)
 {
   int num_leaves = lend - lbeg;
   if(num_leaves > 1)
   {
-    NodeType* child1 = mortonRecurse_2(lbeg, lbeg + num_leaves / 2);
-    NodeType* child2 = mortonRecurse_2(lbeg + num_leaves / 2, lend);
     NodeType* node = createNode(nullptr, nullptr);
-    node->children[0] = child1;
-    node->children[1] = child2;
-    child1->parent = node;
-    child2->parent = node;
+    buildChildren(node, depth,
+                  [=](int d) { return mortonRecurse_2(lbeg, lbeg + num_leaves / 2, d); },
+                  [=](int d) { return mortonRecurse_2(lbeg + num_leaves / 2, lend, d); });
     return node;
   }
   else
     return *lbeg;
 }
 
+//==============================================================================
+template<typename BV>
+void HierarchyTree<BV>::sortByMorton(std::vector<NodeType*>& leaves, const morton_functor<S, uint32>& coder)
+{
+  const std::size_t n = leaves.size();
+  if(!thread_pool || thread_pool->size() < 2 || n < 2)
+  {
+    for(size_t i = 0; i < n; ++i)
+      leaves[i]->code = coder(leaves[i]->bv.center());
+    std::sort(leaves.begin(), leaves.end(), SortByMorton());
+    return;
+  }
+
+  // Sort one chunk per thread, then merge neighboring sorted runs pairwise
+  const std::size_t num_chunks = std::min<std::size_t>(thread_pool->size(), n);
+  std::vector<NodeVecIterator> bounds(num_chunks + 1);
+  for(std::size_t c = 0; c <= num_chunks; ++c)
+    bounds[c] = leaves.begin() + n * c / num_chunks;
+
+  thread_pool->run(num_chunks, [&](std::size_t c, unsigned int) {
+    for(NodeVecIterator it = bounds[c]; it < bounds[c + 1]; ++it)
+      (*it)->code = coder((*it)->bv.center());
+    std::sort(bounds[c], bounds[c + 1], SortByMorton());
+  });
+
+  for(std::size_t width = 1; width < num_chunks; width *= 2)
+  {
+    const std::size_t num_merges = (num_chunks + 2 * width - 1) / (2 * width);
+    thread_pool->run(num_merges, [&](std::size_t m, unsigned int) {
+      const std::size_t first = 2 * width * m;
+      const std::size_t middle = std::min(first + width, num_chunks);
+      const std::size_t last = std::min(first + 2 * width, num_chunks);
+      if(middle < last)
+        std::inplace_merge(bounds[first], bounds[middle], bounds[last], SortByMorton());
+    });
+  }
+}
+
+//==============================================================================
+template<typename BV>
+template<typename Build>
+typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::parallelBuild(Build build)
+{
+  if(!thread_pool || thread_pool->size() < 2)
+    return build(-1);
+
+  // createNode() only reads the one node cache once it is empty, so the tasks
+  // can create nodes concurrently.
+  delete free_node;
+  free_node = nullptr;
+
+  build_task_depth = taskDepth();
+  NodeType* root = build(0);
+  thread_pool->run(build_tasks.size(), [this](std::size_t i, unsigned int) {
+    build_tasks[i]();
+  });
+  build_tasks.clear();
+  return root;
+}
+
+//==============================================================================
+template<typename BV>
+template<typename Build0, typename Build1>
+void HierarchyTree<BV>::buildChildren(NodeType* node, int depth, const Build0& build0, const Build1& build1)
+{
+  if(depth == build_task_depth)
+  {
+    build_tasks.push_back([=]() {
+      node->children[0] = build0(-1);
+      node->children[0]->parent = node;
+    });
+    build_tasks.push_back([=]() {
+      node->children[1] = build1(-1);
+      node->children[1]->parent = node;
+    });
+    return;
+  }
+
+  const int child_depth = (depth < 0) ? -1 : depth + 1;
+  node->children[0] = build0(child_depth);
+  node->children[1] = build1(child_depth);
+  node->children[0]->parent = node;
+  node->children[1]->parent = node;
+}
+
+//==============================================================================
+template<typename BV>
+int HierarchyTree<BV>::taskDepth() const
+{
+  int depth = 3;
+  for(unsigned int n = 1; n < thread_pool->size(); n *= 2)
+    ++depth;
+  return depth;
+}
+
+//==============================================================================
+template<typename BV>
+void HierarchyTree<BV>::collectSubtrees(NodeType* node, int depth, std::vector<NodeType*>& subtrees) const
+{
+  if(node->isLeaf() || depth == 0)
+    subtrees.push_back(node);
+  else
+  {
+    collectSubtrees(node->children[0], depth - 1, subtrees);
+    collectSubtrees(node->children[1], depth - 1, subtrees);
+  }
+}
+
 //==============================================================================
 template<typename BV>
 void HierarchyTree<BV>::update_(NodeType* leaf, const BV& bv)
@@ -1045,6 +1133,18 @@ void HierarchyTree<BV>::recurseRefit(NodeType* node)
     return;
 }
 
+//==============================================================================
+template<typename BV>
+void HierarchyTree<BV>::recurseRefit(NodeType* node, int depth)
+{
+  if(!node->isLeaf() && depth > 0)
+  {
+    recurseRefit(node->children[0], depth - 1);
+    recurseRefit(node->children[1], depth - 1);
+    node->bv = node->children[0]->bv + node->children[1]->bv;
+  }
+}
+
 //==============================================================================
 template<typename BV>
 bool nodeBaseLess(NodeBase<BV>* a, NodeBase<BV>* b, int d)
@@ -1074,6 +1174,23 @@ struct SelectImpl
   }
 };
 
+//==============================================================================
+template <typename S, typename BV>
+struct FatBVImpl
+{
+  static BV run(const BV& bv, const Vector3<S>& /*vel*/, S /*margin*/)
+  {
+    return bv;
+  }
+};
+
+//==============================================================================
+template<typename BV>
+BV fatBV(const BV& bv, const Vector3<typename BV::S>& vel, typename BV::S margin)
+{
+  return FatBVImpl<typename BV::S, BV>::run(bv, vel, margin);
+}
+
 //==============================================================================
 template<typename BV>
 size_t select(
@@ -1131,6 +1248,25 @@ struct SelectImpl<S, AABB<S>>
   }
 };
 
+//==============================================================================
+template <typename S>
+struct FatBVImpl<S, AABB<S>>
+{
+  static AABB<S> run(const AABB<S>& bv, const Vector3<S>& vel, S margin)
+  {
+    AABB<S> fat(bv);
+    fat.expand(Vector3<S>::Constant(margin));
+    for(int i = 0; i < 3; ++i)
+    {
+      if(vel[i] > 0)
+        fat.max_[i] += vel[i];
+      else
+        fat.min_[i] += vel[i];
+    }
+    return fat;
+  }
+};
+
 } // namespace detail
 } // namespace fcl
 
@@ -43,6 +43,7 @@
 #include <functional>
 #include <iostream>
 #include "fcl/common/warning.h"
+#include "fcl/common/detail/thread_pool.h"
 #include "fcl/math/bv/AABB.h"
 #include "fcl/broadphase/detail/morton.h"
 #include "fcl/broadphase/detail/node_base.h"
@@ -102,10 +103,13 @@ public:
   /// @brief update the tree when the bounding volume of a given leaf has changed
   bool update(NodeType* leaf, const BV& bv);
 
-  /// @brief update one leaf's bounding volume, with prediction 
+  /// @brief update one leaf's bounding volume, with prediction: unless the
+  /// leaf's bounding volume still contains bv, reinsert the leaf with
+  /// fatBV(bv, vel, margin). Returns whether the leaf was reinserted.
   bool update(NodeType* leaf, const BV& bv, const Vector3<S>& vel, S margin);
 
-  /// @brief update one leaf's bounding volume, with prediction 
+  /// @brief update one leaf's bounding volume, with prediction but without
+  /// margin
   bool update(NodeType* leaf, const BV& bv, const Vector3<S>& vel);
 
   /// @brief get the max height of the tree
@@ -117,13 +121,16 @@ public:
   /// @brief balance the tree from bottom 
   void balanceBottomup();
 
-  /// @brief balance the tree from top 
+  /// @brief balance the tree from top. Like init(), it builds disjoint
+  /// subtrees in parallel if thread_pool is set.
   void balanceTopdown();
   
   /// @brief balance the tree in an incremental way 
   void balanceIncremental(int iterations);
   
-  /// @brief refit the tree, i.e., when the leaf nodes' bounding volumes change, update the entire tree in a bottom-up manner
+  /// @brief refit the tree, i.e., when the leaf nodes' bounding volumes change, update the entire tree in a bottom-up manner.
+  /// If thread_pool is set, the subtrees below the task depth are refit in
+  /// parallel before the levels above them.
   void refit();
 
   /// @brief extract all the leaves of the tree 
@@ -156,8 +163,9 @@ private:
   /// @brief construct a tree for a set of leaves from bottom -- very heavy way 
   void bottomup(const NodeVecIterator lbeg, const NodeVecIterator lend);
 
-  /// @brief construct a tree for a set of leaves from top 
-  NodeType* topdown(const NodeVecIterator lbeg, const NodeVecIterator lend);
+  /// @brief construct a tree for a set of leaves from top. depth is the depth
+  /// of the subtree root within a parallel build, -1 for a serial build.
+  NodeType* topdown(const NodeVecIterator lbeg, const NodeVecIterator lend, int depth = -1);
 
   /// @brief compute the maximum height of a subtree rooted from a given node
   size_t getMaxHeight(NodeType* node) const;
@@ -168,13 +176,13 @@ private:
   /// @brief construct a tree from a list of nodes stored in [lbeg, lend) in a topdown manner.
   /// During construction, first compute the best split axis as the axis along with the longest AABB<S> edge.
   /// Then compute the median of all nodes' center projection onto the axis and using it as the split threshold.
-  NodeType* topdown_0(const NodeVecIterator lbeg, const NodeVecIterator lend);
+  NodeType* topdown_0(const NodeVecIterator lbeg, const NodeVecIterator lend, int depth = -1);
 
   /// @brief construct a tree from a list of nodes stored in [lbeg, lend) in a topdown manner.
   /// During construction, first compute the best split thresholds for different axes as the average of all nodes' center.
   /// Then choose the split axis as the axis whose threshold can divide the nodes into two parts with almost similar size.
   /// This construction is more expensive then topdown_0, but also can provide tree with better quality.
-  NodeType* topdown_1(const NodeVecIterator lbeg, const NodeVecIterator lend);
+  NodeType* topdown_1(const NodeVecIterator lbeg, const NodeVecIterator lend, int depth = -1);
 
   /// @brief init tree from leaves in the topdown manner (topdown_0 or topdown_1)
   void init_0(std::vector<NodeType*>& leaves);
@@ -190,11 +198,37 @@ private:
   /// @brief init tree from leaves using morton code. It uses morton_2, i.e., for all nodes, we simply divide the leaves into parts with the same size simply using the node index.
   void init_3(std::vector<NodeType*>& leaves);
   
-  NodeType* mortonRecurse_0(const NodeVecIterator lbeg, const NodeVecIterator lend, const uint32& split, int bits);
+  NodeType* mortonRecurse_0(const NodeVecIterator lbeg, const NodeVecIterator lend, const uint32& split, int bits, int depth = -1);
 
-  NodeType* mortonRecurse_1(const NodeVecIterator lbeg, const NodeVecIterator lend, const uint32& split, int bits);
+  NodeType* mortonRecurse_1(const NodeVecIterator lbeg, const NodeVecIterator lend, const uint32& split, int bits, int depth = -1);
 
-  NodeType* mortonRecurse_2(const NodeVecIterator lbeg, const NodeVecIterator lend);
+  NodeType* mortonRecurse_2(const NodeVecIterator lbeg, const NodeVecIterator lend, int depth = -1);
+
+  /// @brief compute the morton codes of the leaves and sort the leaves by
+  /// them, in parallel chunks which are then merged if thread_pool is set
+  void sortByMorton(std::vector<NodeType*>& leaves, const morton_functor<S, uint32>& coder);
+
+  /// @brief return the root of a new tree built by build(depth). Without a
+  /// thread pool this is build(-1); with one, build(0) builds the levels above
+  /// the task depth and leaves the subtrees below it to buildChildren(),
+  /// whose tasks then run on the pool.
+  template <typename Build>
+  NodeType* parallelBuild(Build build);
+
+  /// @brief set the children of node, at the given depth of a parallel build
+  /// (-1 for a serial build), to the subtrees returned by build0(child_depth)
+  /// and build1(child_depth). At the task depth the two builds are deferred
+  /// to tasks of parallelBuild() instead.
+  template <typename Build0, typename Build1>
+  void buildChildren(NodeType* node, int depth, const Build0& build0, const Build1& build1);
+
+  /// @brief number of tree levels which parallelBuild() and refit() unfold
+  /// into tasks, so that every thread of the pool gets several of them
+  int taskDepth() const;
+
+  /// @brief collect the roots of the subtrees at the given depth below node,
+  /// and the leaves above it
+  void collectSubtrees(NodeType* node, int depth, std::vector<NodeType*>& subtrees) const;
 
   /// @brief update one leaf node's bounding volume 
   void update_(NodeType* leaf, const BV& bv);
@@ -243,6 +277,10 @@ private:
 
   void recurseRefit(NodeType* node);
 
+  /// @brief refit the levels of the subtree rooted at node above the given
+  /// depth, assuming the subtrees at that depth are already refit
+  void recurseRefit(NodeType* node, int depth);
+
 protected:
   NodeType* root_node;
 
@@ -254,19 +292,37 @@ protected:
   NodeType* free_node; 
 
   int max_lookahead_level;
-  
+
+  /// Task depth of the running parallelBuild() and the subtree builds it
+  /// deferred
+  int build_task_depth;
+  std::vector<std::function<void()>> build_tasks;
+
 public:
   /// @brief decide which topdown algorithm to use
   int topdown_level;
 
   /// @brief decide the depth to use expensive bottom-up algorithm
   int bu_threshold;
+
+  /// @brief pool used by init(), balanceTopdown() and refit() to build and
+  /// refit disjoint subtrees in parallel; nullptr (the default) runs them
+  /// serially. Apart from the order of leaves with equal morton codes, the
+  /// tree is the same as the serial one. The tree does not own the pool.
+  ThreadPool* thread_pool;
 };
 
 /// @brief Compare two nodes accoording to the d-th dimension of node center
 template<typename BV>
 bool nodeBaseLess(NodeBase<BV>* a, NodeBase<BV>* b, int d);
 
+/// @brief return bv enlarged by margin on every side and extended by the
+/// predicted displacement vel, the "fat" bounding volume with which a moving
+/// leaf is reinserted so that small motions do not need to move it again.
+/// Only AABB is enlarged; other bounding volumes are returned unchanged.
+template<typename BV>
+BV fatBV(const BV& bv, const Vector3<typename BV::S>& vel, typename BV::S margin);
+
 /// @brief select from node1 and node2 which is close to a given query. 0 for
 /// node1 and 1 for node2
 template<typename BV>
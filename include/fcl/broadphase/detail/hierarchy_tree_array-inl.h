@@ -40,6 +40,9 @@
 
 #include "fcl/broadphase/detail/hierarchy_tree_array.h"
 
+#include <algorithm>
+#include <cassert>
+
 #include "fcl/common/unused.h"
 
 namespace fcl
@@ -68,6 +71,10 @@ HierarchyTree<BV>::HierarchyTree(int bu_threshold_, int topdown_level_)
   max_lookahead_level = -1;
   bu_threshold = bu_threshold_;
   topdown_level = topdown_level_;
+  build_task_depth = 0;
+  parallel_build = false;
+  parallel_next_node = 0;
+  thread_pool = nullptr;
 }
 
 //==============================================================================
@@ -121,7 +128,9 @@ void HierarchyTree<BV>::init_0(NodeType* leaves, int n_leaves_)
   for(size_t i = 0; i < n_leaves; ++i)
     ids[i] = i;
 
-  root_node = topdown(ids, ids + n_leaves);
+  root_node = parallelBuild([&](int depth) {
+    return topdown(ids, ids + n_leaves, depth);
+  });
   delete [] ids;
 
   opath = 0;
@@ -153,20 +162,15 @@ void HierarchyTree<BV>::init_1(NodeType* leaves, int n_leaves_)
     bound_bv += nodes[i].bv;
 
   morton_functor<typename BV::S, uint32> coder(bound_bv);
-  for(size_t i = 0; i < n_leaves; ++i)
-    nodes[i].code = coder(nodes[i].bv.center());
-
 
   size_t* ids = new size_t[n_leaves];
   for(size_t i = 0; i < n_leaves; ++i)
     ids[i] = i;
 
-  FCL_SUPPRESS_MAYBE_UNINITIALIZED_BEGIN
-  SortByMorton comp;
-  FCL_SUPPRESS_MAYBE_UNINITIALIZED_END
-  comp.nodes = nodes;
-  std::sort(ids, ids + n_leaves, comp);
-  root_node = mortonRecurse_0(ids, ids + n_leaves, (1 << (coder.bits()-1)), coder.bits()-1);
+  sortByMorton(ids, coder);
+  root_node = parallelBuild([&](int depth) {
+    return mortonRecurse_0(ids, ids + n_leaves, (1 << (coder.bits()-1)), coder.bits()-1, depth);
+  });
   delete [] ids;
 
   refit();
@@ -200,20 +204,15 @@ void HierarchyTree<BV>::init_2(NodeType* leaves, int n_leaves_)
     bound_bv += nodes[i].bv;
 
   morton_functor<typename BV::S, uint32> coder(bound_bv);
-  for(size_t i = 0; i < n_leaves; ++i)
-    nodes[i].code = coder(nodes[i].bv.center());
-
 
   size_t* ids = new size_t[n_leaves];
   for(size_t i = 0; i < n_leaves; ++i)
     ids[i] = i;
 
-  FCL_SUPPRESS_MAYBE_UNINITIALIZED_BEGIN
-  SortByMorton comp;
-  FCL_SUPPRESS_MAYBE_UNINITIALIZED_END
-  comp.nodes = nodes;
-  std::sort(ids, ids + n_leaves, comp);
-  root_node = mortonRecurse_1(ids, ids + n_leaves, (1 << (coder.bits()-1)), coder.bits()-1);
+  sortByMorton(ids, coder);
+  root_node = parallelBuild([&](int depth) {
+    return mortonRecurse_1(ids, ids + n_leaves, (1 << (coder.bits()-1)), coder.bits()-1, depth);
+  });
   delete [] ids;
 
   refit();
@@ -247,20 +246,15 @@ void HierarchyTree<BV>::init_3(NodeType* leaves, int n_leaves_)
     bound_bv += nodes[i].bv;
 
   morton_functor<typename BV::S, uint32> coder(bound_bv);
-  for(size_t i = 0; i < n_leaves; ++i)
-    nodes[i].code = coder(nodes[i].bv.center());
-
 
   size_t* ids = new size_t[n_leaves];
   for(size_t i = 0; i < n_leaves; ++i)
     ids[i] = i;
 
-  FCL_SUPPRESS_MAYBE_UNINITIALIZED_BEGIN
-  SortByMorton comp;
-  FCL_SUPPRESS_MAYBE_UNINITIALIZED_END
-  comp.nodes = nodes;
-  std::sort(ids, ids + n_leaves, comp);
-  root_node = mortonRecurse_2(ids, ids + n_leaves);
+  sortByMorton(ids, coder);
+  root_node = parallelBuild([&](int depth) {
+    return mortonRecurse_2(ids, ids + n_leaves, depth);
+  });
   delete [] ids;
 
   refit();
@@ -344,12 +338,8 @@ bool HierarchyTree<BV>::update(size_t leaf, const BV& bv)
 template<typename BV>
 bool HierarchyTree<BV>::update(size_t leaf, const BV& bv, const Vector3<S>& vel, S margin)
 {
-  FCL_UNUSED(bv);
-  FCL_UNUSED(vel);
-  FCL_UNUSED(margin);
-
   if(nodes[leaf].bv.contain(bv)) return false;
-  update_(leaf, bv);
+  update_(leaf, fatBV(bv, vel, margin));
   return true;
 }
 
@@ -357,10 +347,8 @@ bool HierarchyTree<BV>::update(size_t leaf, const BV& bv, const Vector3<S>& vel,
 template<typename BV>
 bool HierarchyTree<BV>::update(size_t leaf, const BV& bv, const Vector3<S>& vel)
 {
-  FCL_UNUSED(vel);
-
   if(nodes[leaf].bv.contain(bv)) return false;
-  update_(leaf, bv);
+  update_(leaf, fatBV(bv, vel, S(0)));
   return true;
 }
 
@@ -434,7 +422,9 @@ void HierarchyTree<BV>::balanceTopdown()
     for(size_t i = 0; i < n_leaves; ++i)
       ids[i] = i;
 
-    root_node = topdown(ids, ids + n_leaves);
+    root_node = parallelBuild([&](int depth) {
+      return topdown(ids, ids + n_leaves, depth);
+    });
     delete [] ids;
   }
 }
@@ -465,7 +455,20 @@ void HierarchyTree<BV>::balanceIncremental(int iterations)
 template<typename BV>
 void HierarchyTree<BV>::refit()
 {
-  if(root_node != NULL_NODE)
+  if(root_node == NULL_NODE)
+    return;
+
+  if(thread_pool && thread_pool->size() > 1)
+  {
+    const int depth = taskDepth();
+    std::vector<size_t> subtrees;
+    collectSubtrees(root_node, depth, subtrees);
+    thread_pool->run(subtrees.size(), [&](std::size_t i, unsigned int) {
+      recurseRefit(subtrees[i]);
+    });
+    recurseRefit(root_node, depth);
+  }
+  else
     recurseRefit(root_node);
 }
 
@@ -589,24 +592,24 @@ void HierarchyTree<BV>::bottomup(size_t* lbeg, size_t* lend)
 
 //==============================================================================
 template<typename BV>
-size_t HierarchyTree<BV>::topdown(size_t* lbeg, size_t* lend)
+size_t HierarchyTree<BV>::topdown(size_t* lbeg, size_t* lend, int depth)
 {
   switch(topdown_level)
   {
   case 0:
-    return topdown_0(lbeg, lend);
+    return topdown_0(lbeg, lend, depth);
     break;
   case 1:
-    return topdown_1(lbeg, lend);
+    return topdown_1(lbeg, lend, depth);
     break;
   default:
-    return topdown_0(lbeg, lend);
+    return topdown_0(lbeg, lend, depth);
   }
 }
 
 //==============================================================================
 template<typename BV>
-size_t HierarchyTree<BV>::topdown_0(size_t* lbeg, size_t* lend)
+size_t HierarchyTree<BV>::topdown_0(size_t* lbeg, size_t* lend, int depth)
 {
   int num_leaves = lend - lbeg;
   if(num_leaves > 1)
@@ -627,10 +630,9 @@ size_t HierarchyTree<BV>::topdown_0(size_t* lbeg, size_t* lend)
       std::nth_element(lbeg, lcenter, lend, comp);
 
       size_t node = createNode(NULL_NODE, vol, nullptr);
-      nodes[node].children[0] = topdown_0(lbeg, lcenter);
-      nodes[node].children[1] = topdown_0(lcenter, lend);
-      nodes[nodes[node].children[0]].parent = node;
-      nodes[nodes[node].children[1]].parent = node;
+      buildChildren(node, depth,
+                    [=](int d) { return topdown_0(lbeg, lcenter, d); },
+                    [=](int d) { return topdown_0(lcenter, lend, d); });
       return node;
     }
     else
@@ -644,7 +646,7 @@ size_t HierarchyTree<BV>::topdown_0(size_t* lbeg, size_t* lend)
 
 //==============================================================================
 template<typename BV>
-size_t HierarchyTree<BV>::topdown_1(size_t* lbeg, size_t* lend)
+size_t HierarchyTree<BV>::topdown_1(size_t* lbeg, size_t* lend, int depth)
 {
   int num_leaves = lend - lbeg;
   if(num_leaves > 1)
@@ -698,10 +700,9 @@ size_t HierarchyTree<BV>::topdown_1(size_t* lbeg, size_t* lend)
       }
 
       size_t node = createNode(NULL_NODE, vol, nullptr);
-      nodes[node].children[0] = topdown_1(lbeg, lcenter);
-      nodes[node].children[1] = topdown_1(lcenter, lend);
-      nodes[nodes[node].children[0]].parent = node;
-      nodes[nodes[node].children[1]].parent = node;
+      buildChildren(node, depth,
+                    [=](int d) { return topdown_1(lbeg, lcenter, d); },
+                    [=](int d) { return topdown_1(lcenter, lend, d); });
       return node;
     }
     else
@@ -715,7 +716,7 @@ size_t HierarchyTree<BV>::topdown_1(size_t* lbeg, size_t* lend)
 
 //==============================================================================
 template<typename BV>
-size_t HierarchyTree<BV>::mortonRecurse_0(size_t* lbeg, size_t* lend, const uint32& split, int bits)
+size_t HierarchyTree<BV>::mortonRecurse_0(size_t* lbeg, size_t* lend, const uint32& split, int bits, int depth)
 {
   int num_leaves = lend - lbeg;
   if(num_leaves > 1)
@@ -730,31 +731,28 @@ size_t HierarchyTree<BV>::mortonRecurse_0(size_t* lbeg, size_t* lend, const uint
       if(lcenter == lbeg)
       {
         uint32 split2 = split | (1 << (bits - 1));
-        return mortonRecurse_0(lbeg, lend, split2, bits - 1);
+        return mortonRecurse_0(lbeg, lend, split2, bits - 1, depth);
       }
       else if(lcenter == lend)
       {
         uint32 split1 = (split & (~(1 << bits))) | (1 << (bits - 1));
-        return mortonRecurse_0(lbeg, lend, split1, bits - 1);
+        return mortonRecurse_0(lbeg, lend, split1, bits - 1, depth);
       }
       else
       {
         uint32 split1 = (split & (~(1 << bits))) | (1 << (bits - 1));
         uint32 split2 = split | (1 << (bits - 1));
 
-        size_t child1 = mortonRecurse_0(lbeg, lcenter, split1, bits - 1);
-        size_t child2 = mortonRecurse_0(lcenter, lend, split2, bits - 1);
         size_t node = createNode(NULL_NODE, nullptr);
-        nodes[node].children[0] = child1;
-        nodes[node].children[1] = child2;
-        nodes[child1].parent = node;
-        nodes[child2].parent = node;
+        buildChildren(node, depth,
+                      [=](int d) { return mortonRecurse_0(lbeg, lcenter, split1, bits - 1, d); },
+                      [=](int d) { return mortonRecurse_0(lcenter, lend, split2, bits - 1, d); });
         return node;
       }
     }
     else
     {
-      size_t node = topdown(lbeg, lend);
+      size_t node = topdown(lbeg, lend, depth);
       return node;
     }
   }
@@ -764,7 +762,7 @@ size_t HierarchyTree<BV>::mortonRecurse_0(size_t* lbeg, size_t* lend, const uint
 
 //==============================================================================
 template<typename BV>
-size_t HierarchyTree<BV>::mortonRecurse_1(size_t* lbeg, size_t* lend, const uint32& split, int bits)
+size_t HierarchyTree<BV>::mortonRecurse_1(size_t* lbeg, size_t* lend, const uint32& split, int bits, int depth)
 {
   int num_leaves = lend - lbeg;
   if(num_leaves > 1)
@@ -779,37 +777,31 @@ size_t HierarchyTree<BV>::mortonRecurse_1(size_t* lbeg, size_t* lend, const uint
       if(lcenter == lbeg)
       {
         uint32 split2 = split | (1 << (bits - 1));
-        return mortonRecurse_1(lbeg, lend, split2, bits - 1);
+        return mortonRecurse_1(lbeg, lend, split2, bits - 1, depth);
       }
       else if(lcenter == lend)
       {
         uint32 split1 = (split & (~(1 << bits))) | (1 << (bits - 1));
-        return mortonRecurse_1(lbeg, lend, split1, bits - 1);
+        return mortonRecurse_1(lbeg, lend, split1, bits - 1, depth);
       }
       else
       {
         uint32 split1 = (split & (~(1 << bits))) | (1 << (bits - 1));
         uint32 split2 = split | (1 << (bits - 1));
 
-        size_t child1 = mortonRecurse_1(lbeg, lcenter, split1, bits - 1);
-        size_t child2 = mortonRecurse_1(lcenter, lend, split2, bits - 1);
         size_t node = createNode(NULL_NODE, nullptr);
-        nodes[node].children[0] = child1;
-        nodes[node].children[1] = child2;
-        nodes[child1].parent = node;
-        nodes[child2].parent = node;
+        buildChildren(node, depth,
+                      [=](int d) { return mortonRecurse_1(lbeg, lcenter, split1, bits - 1, d); },
+                      [=](int d) { return mortonRecurse_1(lcenter, lend, split2, bits - 1, d); });
         return node;
       }
     }
     else
     {
-      size_t child1 = mortonRecurse_1(lbeg, lbeg + num_leaves / 2, 0, bits - 1);
-      size_t child2 = mortonRecurse_1(lbeg + num_leaves / 2, lend, 0, bits - 1);
       size_t node = createNode(NULL_NODE, nullptr);
-      nodes[node].children[0] = child1;
-      nodes[node].children[1] = child2;
-      nodes[child1].parent = node;
-      nodes[child2].parent = node;
+      buildChildren(node, depth,
+                    [=](int d) { return mortonRecurse_1(lbeg, lbeg + num_leaves / 2, 0, bits - 1, d); },
+                    [=](int d) { return mortonRecurse_1(lbeg + num_leaves / 2, lend, 0, bits - 1, d); });
       return node;
     }
   }
@@ -819,24 +811,149 @@ size_t HierarchyTree<BV>::mortonRecurse_1(size_t* lbeg, size_t* lend, const uint
 
 //==============================================================================
 template<typename BV>
-size_t HierarchyTree<BV>::mortonRecurse_2(size_t* lbeg, size_t* lend)
+size_t HierarchyTree<BV>::mortonRecurse_2(size_t* lbeg, size_t* lend, int depth)
 {
   int num_leaves = lend - lbeg;
   if(num_leaves > 1)
   {
-    size_t child1 = mortonRecurse_2(lbeg, lbeg + num_leaves / 2);
-    size_t child2 = mortonRecurse_2(lbeg + num_leaves / 2, lend);
     size_t node = createNode(NULL_NODE, nullptr);
-    nodes[node].children[0] = child1;
-    nodes[node].children[1] = child2;
-    nodes[child1].parent = node;
-    nodes[child2].parent = node;
+    buildChildren(node, depth,
+                  [=](int d) { return mortonRecurse_2(lbeg, lbeg + num_leaves / 2, d); },
+                  [=](int d) { return mortonRecurse_2(lbeg + num_leaves / 2, lend, d); });
     return node;
   }
   else
     return *lbeg;
 }
 
+//==============================================================================
+template<typename BV>
+void HierarchyTree<BV>::sortByMorton(size_t* ids, const morton_functor<S, uint32>& coder)
+{
+  FCL_SUPPRESS_MAYBE_UNINITIALIZED_BEGIN
+  SortByMorton comp;
+  FCL_SUPPRESS_MAYBE_UNINITIALIZED_END
+  comp.nodes = nodes;
+  comp.split = 0;
+
+  const size_t n = n_leaves;
+  if(!thread_pool || thread_pool->size() < 2 || n < 2)
+  {
+    for(size_t i = 0; i < n; ++i)
+      nodes[i].code = coder(nodes[i].bv.center());
+    std::sort(ids, ids + n, comp);
+    return;
+  }
+
+  // Sort one chunk per thread, then merge neighboring sorted runs pairwise
+  const size_t num_chunks = std::min<size_t>(thread_pool->size(), n);
+  std::vector<size_t> bounds(num_chunks + 1);
+  for(size_t c = 0; c <= num_chunks; ++c)
+    bounds[c] = n * c / num_chunks;
+
+  thread_pool->run(num_chunks, [&](std::size_t c, unsigned int) {
+    for(size_t i = bounds[c]; i < bounds[c + 1]; ++i)
+      nodes[i].code = coder(nodes[i].bv.center());
+    std::sort(ids + bounds[c], ids + bounds[c + 1], comp);
+  });
+
+  for(size_t width = 1; width < num_chunks; width *= 2)
+  {
+    const size_t num_merges = (num_chunks + 2 * width - 1) / (2 * width);
+    thread_pool->run(num_merges, [&](std::size_t m, unsigned int) {
+      const size_t first = 2 * width * m;
+      const size_t middle = std::min(first + width, num_chunks);
+      const size_t last = std::min(first + 2 * width, num_chunks);
+      if(middle < last)
+        std::inplace_merge(ids + bounds[first], ids + bounds[middle], ids + bounds[last], comp);
+    });
+  }
+}
+
+//==============================================================================
+template<typename BV>
+template<typename Build>
+size_t HierarchyTree<BV>::parallelBuild(Build build)
+{
+  if(!thread_pool || thread_pool->size() < 2)
+    return build(-1);
+
+  assert(n_leaves == 0 || n_nodes_alloc >= 2 * n_leaves - 1);
+#ifndef NDEBUG
+  for(size_t i = freelist; i != NULL_NODE; i = nodes[i].next)
+    assert(nodes[i].next == ((i + 1 < n_nodes_alloc) ? i + 1 : NULL_NODE));
+#endif
+
+  build_task_depth = taskDepth();
+  size_t root = build(0);
+  if(!build_tasks.empty())
+  {
+    // The nodes taken so far came from the front of the free chain, whose
+    // remainder the tasks now share through the atomic counter.
+    const size_t first_free = freelist;
+    parallel_next_node = first_free;
+    parallel_build = true;
+    thread_pool->run(build_tasks.size(), [this](std::size_t i, unsigned int) {
+      build_tasks[i]();
+    });
+    parallel_build = false;
+    build_tasks.clear();
+
+    const size_t next_free = parallel_next_node;
+    n_nodes += next_free - first_free;
+    freelist = (next_free < n_nodes_alloc) ? next_free : NULL_NODE;
+  }
+  return root;
+}
+
+//==============================================================================
+template<typename BV>
+template<typename Build0, typename Build1>
+void HierarchyTree<BV>::buildChildren(size_t node, int depth, const Build0& build0, const Build1& build1)
+{
+  if(depth == build_task_depth)
+  {
+    build_tasks.push_back([=]() {
+      nodes[node].children[0] = build0(-1);
+      nodes[nodes[node].children[0]].parent = node;
+    });
+    build_tasks.push_back([=]() {
+      nodes[node].children[1] = build1(-1);
+      nodes[nodes[node].children[1]].parent = node;
+    });
+    return;
+  }
+
+  const int child_depth = (depth < 0) ? -1 : depth + 1;
+  nodes[node].children[0] = build0(child_depth);
+  nodes[node].children[1] = build1(child_depth);
+  nodes[nodes[node].children[0]].parent = node;
+  nodes[nodes[node].children[1]].parent = node;
+}
+
+//==============================================================================
+template<typename BV>
+int HierarchyTree<BV>::taskDepth() const
+{
+  int depth = 3;
+  for(unsigned int n = 1; n < thread_pool->size(); n *= 2)
+    ++depth;
+  return depth;
+}
+
+//==============================================================================
+template<typename BV>
+void HierarchyTree<BV>::collectSubtrees(size_t node, int depth, std::vector<size_t>& subtrees) const
+{
+  if(nodes[node].isLeaf() || depth == 0)
+    subtrees.push_back(node);
+  else
+  {
+    collectSubtrees(nodes[node].children[0], depth - 1, subtrees);
+    collectSubtrees(nodes[node].children[1], depth - 1, subtrees);
+  }
+}
+
 //==============================================================================
 template<typename BV>
 void HierarchyTree<BV>::insertLeaf(size_t root, size_t leaf)
@@ -954,6 +1071,15 @@ size_t HierarchyTree<BV>::indexOf(size_t node)
 template<typename BV>
 size_t HierarchyTree<BV>::allocateNode()
 {
+  if(parallel_build)
+  {
+    const size_t node_id = parallel_next_node.fetch_add(1, std::memory_order_relaxed);
+    nodes[node_id].parent = NULL_NODE;
+    nodes[node_id].children[0] = NULL_NODE;
+    nodes[node_id].children[1] = NULL_NODE;
+    return node_id;
+  }
+
   if(freelist == NULL_NODE)
   {
     NodeType* old_nodes = nodes;
@@ -1038,6 +1164,18 @@ void HierarchyTree<BV>::recurseRefit(size_t node)
     return;
 }
 
+//==============================================================================
+template<typename BV>
+void HierarchyTree<BV>::recurseRefit(size_t node, int depth)
+{
+  if(!nodes[node].isLeaf() && depth > 0)
+  {
+    recurseRefit(nodes[node].children[0], depth - 1);
+    recurseRefit(nodes[node].children[1], depth - 1);
+    nodes[node].bv = nodes[nodes[node].children[0]].bv + nodes[nodes[node].children[1]].bv;
+  }
+}
+
 //==============================================================================
 template<typename BV>
 void HierarchyTree<BV>::fetchLeaves(size_t root, NodeType*& leaves, int depth)
@@ -38,12 +38,15 @@
 #ifndef FCL_HIERARCHY_TREE_ARRAY_H
 #define FCL_HIERARCHY_TREE_ARRAY_H
 
+#include <atomic>
 #include <vector>
 #include <map>
 #include <functional>
 #include <iostream>
 #include "fcl/common/warning.h"
+#include "fcl/common/detail/thread_pool.h"
 #include "fcl/math/bv/AABB.h"
+#include "fcl/broadphase/detail/hierarchy_tree.h"
 #include "fcl/broadphase/detail/morton.h"
 #include "fcl/broadphase/detail/node_base_array.h"
 
@@ -111,10 +114,13 @@ public:
   /// @brief update the tree when the bounding volume of a given leaf has changed
   bool update(size_t leaf, const BV& bv);
 
-  /// @brief update one leaf's bounding volume, with prediction 
+  /// @brief update one leaf's bounding volume, with prediction: unless the
+  /// leaf's bounding volume still contains bv, reinsert the leaf with
+  /// fatBV(bv, vel, margin). Returns whether the leaf was reinserted.
   bool update(size_t leaf, const BV& bv, const Vector3<S>& vel, S margin);
 
-  /// @brief update one leaf's bounding volume, with prediction 
+  /// @brief update one leaf's bounding volume, with prediction but without
+  /// margin
   bool update(size_t leaf, const BV& bv, const Vector3<S>& vel);
 
   /// @brief get the max height of the tree
@@ -126,13 +132,16 @@ public:
   /// @brief balance the tree from bottom 
   void balanceBottomup();
 
-  /// @brief balance the tree from top 
+  /// @brief balance the tree from top. Like init(), it builds disjoint
+  /// subtrees in parallel if thread_pool is set.
   void balanceTopdown();
 
   /// @brief balance the tree in an incremental way 
   void balanceIncremental(int iterations);
 
-  /// @brief refit the tree, i.e., when the leaf nodes' bounding volumes change, update the entire tree in a bottom-up manner
+  /// @brief refit the tree, i.e., when the leaf nodes' bounding volumes change, update the entire tree in a bottom-up manner.
+  /// If thread_pool is set, the subtrees below the task depth are refit in
+  /// parallel before the levels above them.
   void refit();
 
   /// @brief extract all the leaves of the tree 
@@ -155,8 +164,9 @@ private:
   /// @brief construct a tree for a set of leaves from bottom -- very heavy way 
   void bottomup(size_t* lbeg, size_t* lend);
   
-  /// @brief construct a tree for a set of leaves from top 
-  size_t topdown(size_t* lbeg, size_t* lend);
+  /// @brief construct a tree for a set of leaves from top. depth is the depth
+  /// of the subtree root within a parallel build, -1 for a serial build.
+  size_t topdown(size_t* lbeg, size_t* lend, int depth = -1);
 
   /// @brief compute the maximum height of a subtree rooted from a given node
   size_t getMaxHeight(size_t node) const;
@@ -167,13 +177,13 @@ private:
   /// @brief construct a tree from a list of nodes stored in [lbeg, lend) in a topdown manner.
   /// During construction, first compute the best split axis as the axis along with the longest AABB<S> edge.
   /// Then compute the median of all nodes' center projection onto the axis and using it as the split threshold.
-  size_t topdown_0(size_t* lbeg, size_t* lend);
+  size_t topdown_0(size_t* lbeg, size_t* lend, int depth = -1);
 
   /// @brief construct a tree from a list of nodes stored in [lbeg, lend) in a topdown manner.
   /// During construction, first compute the best split thresholds for different axes as the average of all nodes' center.
   /// Then choose the split axis as the axis whose threshold can divide the nodes into two parts with almost similar size.
   /// This construction is more expensive then topdown_0, but also can provide tree with better quality.
-  size_t topdown_1(size_t* lbeg, size_t* lend);
+  size_t topdown_1(size_t* lbeg, size_t* lend, int depth = -1);
 
   /// @brief init tree from leaves in the topdown manner (topdown_0 or topdown_1)
   void init_0(NodeType* leaves, int n_leaves_);
@@ -189,11 +199,43 @@ private:
   /// @brief init tree from leaves using morton code. It uses morton_2, i.e., for all nodes, we simply divide the leaves into parts with the same size simply using the node index.
   void init_3(NodeType* leaves, int n_leaves_);
 
-  size_t mortonRecurse_0(size_t* lbeg, size_t* lend, const uint32& split, int bits);
+  size_t mortonRecurse_0(size_t* lbeg, size_t* lend, const uint32& split, int bits, int depth = -1);
 
-  size_t mortonRecurse_1(size_t* lbeg, size_t* lend, const uint32& split, int bits);
+  size_t mortonRecurse_1(size_t* lbeg, size_t* lend, const uint32& split, int bits, int depth = -1);
 
-  size_t mortonRecurse_2(size_t* lbeg, size_t* lend);
+  size_t mortonRecurse_2(size_t* lbeg, size_t* lend, int depth = -1);
+
+  /// @brief compute the morton codes of the n_leaves leaves and sort their
+  /// ids by them, in parallel chunks which are then merged if thread_pool is
+  /// set
+  void sortByMorton(size_t* ids, const morton_functor<S, uint32>& coder);
+
+  /// @brief return the root of a new tree built by build(depth). Without a
+  /// thread pool this is build(-1); with one, build(0) builds the levels above
+  /// the task depth and leaves the subtrees below it to buildChildren(),
+  /// whose tasks then run on the pool. The tasks take their nodes from the
+  /// free chain by bumping the atomic counter parallel_next_node, which
+  /// neither follows the next links nor grows the node array. The free nodes
+  /// therefore have to form the contiguous chain freelist, freelist + 1, ...,
+  /// up to the end of an array of at least 2 * n_leaves - 1 nodes, as they do
+  /// after the leaves were copied into a fresh node array.
+  template <typename Build>
+  size_t parallelBuild(Build build);
+
+  /// @brief set the children of node, at the given depth of a parallel build
+  /// (-1 for a serial build), to the subtrees returned by build0(child_depth)
+  /// and build1(child_depth). At the task depth the two builds are deferred
+  /// to tasks of parallelBuild() instead.
+  template <typename Build0, typename Build1>
+  void buildChildren(size_t node, int depth, const Build0& build0, const Build1& build1);
+
+  /// @brief number of tree levels which parallelBuild() and refit() unfold
+  /// into tasks, so that every thread of the pool gets several of them
+  int taskDepth() const;
+
+  /// @brief collect the roots of the subtrees at the given depth below node,
+  /// and the leaves above it
+  void collectSubtrees(size_t node, int depth, std::vector<size_t>& subtrees) const;
 
   /// @brief update one leaf node's bounding volume 
   void update_(size_t leaf, const BV& bv);
@@ -229,6 +271,10 @@ private:
 
   void recurseRefit(size_t node);
 
+  /// @brief refit the levels of the subtree rooted at node above the given
+  /// depth, assuming the subtrees at that depth are already refit
+  void recurseRefit(size_t node, int depth);
+
 protected:
   size_t root_node;
   NodeType* nodes;
@@ -241,6 +287,14 @@ protected:
 
   int max_lookahead_level;
 
+  /// Task depth of the running parallelBuild() and the subtree builds it
+  /// deferred. While the deferred builds run, allocateNode() takes the nodes
+  /// of the free chain from the atomic counter parallel_next_node.
+  int build_task_depth;
+  std::vector<std::function<void()>> build_tasks;
+  bool parallel_build;
+  std::atomic<size_t> parallel_next_node;
+
 public:
   /// @brief decide which topdown algorithm to use
   int topdown_level;
@@ -248,6 +302,13 @@ public:
   /// @brief decide the depth to use expensive bottom-up algorithm
   int bu_threshold;
 
+  /// @brief pool used by init(), balanceTopdown() and refit() to build and
+  /// refit disjoint subtrees in parallel; nullptr (the default) runs them
+  /// serially. Apart from the order of leaves with equal morton codes and the
+  /// numbering of the internal nodes, the tree is the same as the serial one.
+  /// The tree does not own the pool.
+  ThreadPool* thread_pool;
+
 public:
   static const size_t NULL_NODE = -1;
 };
@@ -0,0 +1,273 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FCL_BROADPHASE_DETAIL_LINEARPROBINGTABLE_INL_H
+#define FCL_BROADPHASE_DETAIL_LINEARPROBINGTABLE_INL_H
+
+#include "fcl/broadphase/detail/linear_probing_table.h"
+
+namespace fcl
+{
+
+namespace detail
+{
+
+//==============================================================================
+template <typename Cell, typename Value>
+LinearProbingTable<Cell, Value>::LinearProbingTable()
+  : num_entries_(0), num_bits_(0)
+{
+  // Do nothing
+}
+
+//==============================================================================
+template <typename Cell, typename Value>
+void LinearProbingTable<Cell, Value>::init(std::size_t size)
+{
+  unsigned int num_bits = 1;
+  while((std::size_t(1) << num_bits) < size)
+    ++num_bits;
+
+  table_.assign(std::size_t(1) << num_bits, Entry());
+  num_entries_ = 0;
+  num_bits_ = num_bits;
+}
+
+//==============================================================================
+template <typename Cell, typename Value>
+void LinearProbingTable<Cell, Value>::insert(Cell cell, const Value& value)
+{
+  if(2 * (num_entries_ + 1) > table_.size())
+    rehash(num_bits_ + 1);
+
+  std::size_t i = home(cell);
+  const std::size_t mask = table_.size() - 1;
+  while(table_[i].occupied)
+    i = (i + 1) & mask;
+
+  table_[i].cell = cell;
+  table_[i].occupied = true;
+  table_[i].value = value;
+  ++num_entries_;
+}
+
+//==============================================================================
+template <typename Cell, typename Value>
+template <typename Pred>
+std::size_t LinearProbingTable<Cell, Value>::find(Cell cell, Pred pred) const
+{
+  if(num_entries_ == 0)
+    return table_.size();
+
+  const std::size_t mask = table_.size() - 1;
+  for(std::size_t i = home(cell); table_[i].occupied; i = (i + 1) & mask)
+  {
+    if(table_[i].cell == cell && pred(table_[i].value))
+      return i;
+  }
+
+  return table_.size();
+}
+
+//==============================================================================
+template <typename Cell, typename Value>
+template <typename F>
+void LinearProbingTable<Cell, Value>::visit(Cell cell, F f) const
+{
+  if(num_entries_ == 0)
+    return;
+
+  const std::size_t mask = table_.size() - 1;
+  for(std::size_t i = home(cell); table_[i].occupied; i = (i + 1) & mask)
+  {
+    if(table_[i].cell == cell)
+      f(table_[i].value);
+  }
+}
+
+//==============================================================================
+template <typename Cell, typename Value>
+void LinearProbingTable<Cell, Value>::erase(std::size_t slot)
+{
+  // Backward shift deletion: move up the entries of the cluster whose probe
+  // sequence passes through the freed slot, so that no tombstones are needed
+  const std::size_t mask = table_.size() - 1;
+  std::size_t i = slot;
+  std::size_t j = i;
+  while(true)
+  {
+    j = (j + 1) & mask;
+    if(!table_[j].occupied)
+      break;
+
+    const std::size_t k = home(table_[j].cell);
+    const bool stays = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+    if(stays)
+      continue;
+
+    table_[i] = table_[j];
+    i = j;
+  }
+
+  table_[i].occupied = false;
+  --num_entries_;
+}
+
+//==============================================================================
+template <typename Cell, typename Value>
+Value& LinearProbingTable<Cell, Value>::value(std::size_t slot)
+{
+  return table_[slot].value;
+}
+
+//==============================================================================
+template <typename Cell, typename Value>
+const Value& LinearProbingTable<Cell, Value>::value(std::size_t slot) const
+{
+  return table_[slot].value;
+}
+
+//==============================================================================
+template <typename Cell, typename Value>
+template <typename F>
+void LinearProbingTable<Cell, Value>::forEach(F f) const
+{
+  if(num_entries_ == 0)
+    return;
+
+  for(const auto& entry : table_)
+  {
+    if(entry.occupied)
+      f(entry.cell, entry.value);
+  }
+}
+
+//==============================================================================
+template <typename Cell, typename Value>
+template <typename F>
+void LinearProbingTable<Cell, Value>::forEach(F f)
+{
+  if(num_entries_ == 0)
+    return;
+
+  for(auto& entry : table_)
+  {
+    if(entry.occupied)
+      f(entry.cell, entry.value);
+  }
+}
+
+//==============================================================================
+template <typename Cell, typename Value>
+template <typename F>
+bool LinearProbingTable<Cell, Value>::findIf(F f) const
+{
+  if(num_entries_ == 0)
+    return false;
+
+  for(const auto& entry : table_)
+  {
+    if(entry.occupied && f(entry.cell, entry.value))
+      return true;
+  }
+
+  return false;
+}
+
+//==============================================================================
+template <typename Cell, typename Value>
+std::size_t LinearProbingTable<Cell, Value>::size() const
+{
+  return num_entries_;
+}
+
+//==============================================================================
+template <typename Cell, typename Value>
+bool LinearProbingTable<Cell, Value>::empty() const
+{
+  return num_entries_ == 0;
+}
+
+//==============================================================================
+template <typename Cell, typename Value>
+std::size_t LinearProbingTable<Cell, Value>::capacity() const
+{
+  return table_.size();
+}
+
+//==============================================================================
+template <typename Cell, typename Value>
+void LinearProbingTable<Cell, Value>::clear()
+{
+  for(auto& entry : table_)
+    entry.occupied = false;
+  num_entries_ = 0;
+}
+
+//==============================================================================
+template <typename Cell, typename Value>
+std::size_t LinearProbingTable<Cell, Value>::home(Cell cell) const
+{
+  // Fibonacci hashing: the high bits of the product mix all bits of the cell
+  return static_cast<std::size_t>(
+      (static_cast<std::uint64_t>(cell) * 0x9E3779B97F4A7C15ull)
+      >> (64 - num_bits_));
+}
+
+//==============================================================================
+template <typename Cell, typename Value>
+void LinearProbingTable<Cell, Value>::rehash(unsigned int num_bits)
+{
+  std::vector<Entry> old_table(std::size_t(1) << num_bits, Entry());
+  old_table.swap(table_);
+  num_bits_ = num_bits;
+
+  const std::size_t mask = table_.size() - 1;
+  for(const auto& entry : old_table)
+  {
+    if(!entry.occupied)
+      continue;
+
+    std::size_t i = home(entry.cell);
+    while(table_[i].occupied)
+      i = (i + 1) & mask;
+    table_[i] = entry;
+  }
+}
+
+} // namespace detail
+} // namespace fcl
+
+#endif
@@ -0,0 +1,147 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FCL_BROADPHASE_DETAIL_LINEARPROBINGTABLE_H
+#define FCL_BROADPHASE_DETAIL_LINEARPROBINGTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "fcl/export.h"
+
+namespace fcl
+{
+
+namespace detail
+{
+
+/// @brief (cell, value) entries stored in one flat array with open addressing
+/// (linear probing from the Fibonacci hash of the cell). Several entries may
+/// share a cell. Erasing shifts the following entries of the cluster back, so
+/// the table never accumulates tombstones and lookups stay short under heavy
+/// insert/erase traffic. Cell is an unsigned integer type. This is the storage
+/// of SimpleHashTable and PairHashSet.
+template <typename Cell, typename Value>
+class FCL_EXPORT LinearProbingTable
+{
+public:
+
+  LinearProbingTable();
+
+  /// @brief Reset the table to at least size slots. The table grows when it
+  /// gets half full.
+  void init(std::size_t size);
+
+  /// @brief Add the entry (cell, value), even if cell already has entries
+  void insert(Cell cell, const Value& value);
+
+  /// @brief Slot of the first entry of cell whose value satisfies pred, or
+  /// capacity() if there is none
+  template <typename Pred>
+  std::size_t find(Cell cell, Pred pred) const;
+
+  /// @brief Call f(value) for every entry of cell
+  template <typename F>
+  void visit(Cell cell, F f) const;
+
+  /// @brief Remove the entry in slot, as returned by find()
+  void erase(std::size_t slot);
+
+  /// @brief Value of the entry in slot, as returned by find()
+  Value& value(std::size_t slot);
+
+  /// @brief Value of the entry in slot, as returned by find()
+  const Value& value(std::size_t slot) const;
+
+  /// @brief Call f(cell, value) for every entry, in table order. The table
+  /// must not be modified from f.
+  template <typename F>
+  void forEach(F f) const;
+
+  /// @brief Call f(cell, value) for every entry, in table order, with the
+  /// value passed by reference so that f can change it. The table must not be
+  /// otherwise modified from f.
+  template <typename F>
+  void forEach(F f);
+
+  /// @brief Call f(cell, value) for the entries, in table order, until it
+  /// returns true. Returns whether it did. The table must not be modified
+  /// from f.
+  template <typename F>
+  bool findIf(F f) const;
+
+  /// @brief Number of entries
+  std::size_t size() const;
+
+  /// @brief Whether the table has no entries
+  bool empty() const;
+
+  /// @brief Number of slots
+  std::size_t capacity() const;
+
+  /// @brief Remove all the entries, keeping the allocated slots
+  void clear();
+
+private:
+
+  struct Entry
+  {
+    Cell cell;
+    bool occupied;
+    Value value;
+  };
+
+  /// @brief the slot at which the probe sequence of cell starts
+  std::size_t home(Cell cell) const;
+
+  /// @brief rebuild the table with num_bits bits of slot index
+  void rehash(unsigned int num_bits);
+
+  std::vector<Entry> table_;
+
+  /// @brief number of occupied entries
+  std::size_t num_entries_;
+
+  /// @brief log2 of table_.size()
+  unsigned int num_bits_;
+};
+
+} // namespace detail
+} // namespace fcl
+
+#include "fcl/broadphase/detail/linear_probing_table-inl.h"
+
+#endif
@@ -0,0 +1,143 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#ifndef FCL_BROADPHASE_DETAIL_PAIRHASHSET_H
+#define FCL_BROADPHASE_DETAIL_PAIRHASHSET_H
+
+#include <cstddef>
+
+#include "fcl/common/types.h"
+#include "fcl/broadphase/detail/linear_probing_table.h"
+
+namespace fcl
+{
+
+namespace detail
+{
+
+/// @brief Open-addressed hash set of unordered pairs of 32-bit ids, with a
+/// one-byte tag stored alongside every pair. The pairs are kept in a
+/// LinearProbingTable keyed by the pair.
+class FCL_EXPORT PairHashSet
+{
+public:
+
+  using Key = uint64;
+
+  PairHashSet();
+
+  /// @brief Key of the unordered pair {a, b}
+  static Key makeKey(uint32 a, uint32 b);
+
+  /// @brief Smaller id of the pair
+  static uint32 first(Key key);
+
+  /// @brief Larger id of the pair
+  static uint32 second(Key key);
+
+  /// @brief Insert the pair with the given tag. Returns false, leaving the
+  /// stored tag unchanged, if the pair was already present.
+  bool insert(Key key, unsigned char tag = 0);
+
+  /// @brief Remove the pair. Returns whether it was present, and its tag in
+  /// tag if given.
+  bool erase(Key key, unsigned char* tag = nullptr);
+
+  /// @brief Whether the pair is present
+  bool contains(Key key) const;
+
+  /// @brief Change the tag of a present pair. Returns whether it was present,
+  /// and its previous tag in old_tag if given.
+  bool setTag(Key key, unsigned char tag, unsigned char* old_tag = nullptr);
+
+  /// @brief Number of pairs in the set
+  std::size_t size() const;
+
+  /// @brief Whether the set is empty
+  bool empty() const;
+
+  /// @brief Remove all the pairs, keeping the allocated table
+  void clear();
+
+  /// @brief Call f(key, tag) for every pair, in table order. The set must
+  /// not be modified from f.
+  template <typename F>
+  void forEach(F f) const;
+
+  /// @brief Call f(key, tag) for every pair, in table order, with the tag
+  /// passed by reference so that f can change it. The set must not be
+  /// otherwise modified from f.
+  template <typename F>
+  void forEach(F f);
+
+  /// @brief Call f(key, tag) for the pairs, in table order, until it returns
+  /// true. Returns whether it did. The set must not be modified from f.
+  template <typename F>
+  bool findIf(F f) const;
+
+private:
+
+  /// @brief slot of the pair in table_, or table_.capacity() if absent
+  std::size_t findSlot(Key key) const;
+
+  LinearProbingTable<Key, unsigned char> table_;
+};
+
+//==============================================================================
+template <typename F>
+void PairHashSet::forEach(F f) const
+{
+  table_.forEach(f);
+}
+
+//==============================================================================
+template <typename F>
+void PairHashSet::forEach(F f)
+{
+  table_.forEach(f);
+}
+
+//==============================================================================
+template <typename F>
+bool PairHashSet::findIf(F f) const
+{
+  return table_.findIf(f);
+}
+
+} // namespace detail
+} // namespace fcl
+
+#endif
@@ -0,0 +1,128 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#ifndef FCL_BROADPHASE_DETAIL_QUERYBATCH_INL_H
+#define FCL_BROADPHASE_DETAIL_QUERYBATCH_INL_H
+
+#include "fcl/broadphase/detail/query_batch.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#include "fcl/broadphase/detail/morton.h"
+
+namespace fcl
+{
+
+namespace detail
+{
+
+//==============================================================================
+extern template
+struct QueryPacket<double>;
+
+//==============================================================================
+extern template
+void sortQueriesByMortonCode(
+    const std::vector<CollisionObject<double>*>& objs,
+    std::vector<std::size_t>& indices);
+
+//==============================================================================
+template <typename S>
+QueryPacket<S>::QueryPacket(
+    const std::vector<CollisionObject<S>*>& objs_,
+    const std::vector<void*>& cdata_,
+    const std::vector<std::size_t>& indices,
+    std::size_t begin,
+    std::size_t n)
+  : size(n)
+{
+  assert(n <= queryPacketSize());
+
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    const std::size_t id = indices[begin + i];
+    objs[i] = objs_[id];
+    cdata[i] = cdata_[id];
+    bvs[i] = objs_[id]->getAABB();
+  }
+
+  alive = all();
+}
+
+//==============================================================================
+template <typename S>
+uint32 QueryPacket<S>::all() const
+{
+  return (size == queryPacketSize()) ? ~uint32(0) : ((uint32(1) << size) - 1);
+}
+
+//==============================================================================
+template <typename S>
+void sortQueriesByMortonCode(
+    const std::vector<CollisionObject<S>*>& objs,
+    std::vector<std::size_t>& indices)
+{
+  if(indices.size() < 2) return;
+
+  AABB<S> bound(objs[indices[0]]->getAABB().center());
+  for(std::size_t i = 1; i < indices.size(); ++i)
+    bound += objs[indices[i]]->getAABB().center();
+
+  // Keep the extents non-degenerate, e.g. for queries lying in a plane
+  for(int i = 0; i < 3; ++i)
+  {
+    if(bound.max_[i] <= bound.min_[i])
+      bound.max_[i] = bound.min_[i] + 1;
+  }
+
+  morton_functor<S, uint32> coder(bound);
+
+  std::vector<std::pair<uint32, std::size_t>> codes(indices.size());
+  for(std::size_t i = 0; i < indices.size(); ++i)
+    codes[i] = std::make_pair(coder(objs[indices[i]]->getAABB().center()), indices[i]);
+
+  std::sort(codes.begin(), codes.end());
+
+  for(std::size_t i = 0; i < indices.size(); ++i)
+    indices[i] = codes[i].second;
+}
+
+} // namespace detail
+} // namespace fcl
+
+#endif
@@ -0,0 +1,96 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#ifndef FCL_BROADPHASE_DETAIL_QUERYBATCH_H
+#define FCL_BROADPHASE_DETAIL_QUERYBATCH_H
+
+#include <vector>
+
+#include "fcl/common/types.h"
+#include "fcl/narrowphase/collision_object.h"
+
+namespace fcl
+{
+
+namespace detail
+{
+
+/// @brief Number of queries the batch queries of the tree-based managers
+/// traverse together, so that the queries of a packet fit in a uint32 mask
+constexpr std::size_t queryPacketSize()
+{
+  return 32;
+}
+
+/// @brief A packet of queries of a batch query, together with a copy of their
+/// AABBs (contiguous for the traversal) and the mask of the queries whose
+/// callback has not asked to stop yet
+template <typename S>
+struct FCL_EXPORT QueryPacket
+{
+  /// @brief Gathers the queries indices[begin], ..., indices[begin + n - 1]
+  QueryPacket(
+      const std::vector<CollisionObject<S>*>& objs,
+      const std::vector<void*>& cdata,
+      const std::vector<std::size_t>& indices,
+      std::size_t begin,
+      std::size_t n);
+
+  /// @brief The mask with a bit set for every query of the packet
+  uint32 all() const;
+
+  std::size_t size;
+  CollisionObject<S>* objs[queryPacketSize()];
+  void* cdata[queryPacketSize()];
+  AABB<S> bvs[queryPacketSize()];
+  uint32 alive;
+};
+
+/// @brief Sorts the query indices by the Morton code of the center of the
+/// queries' AABBs, so that consecutive queries are close in space and a
+/// packet of them visits mostly the same tree nodes
+template <typename S>
+FCL_EXPORT
+void sortQueriesByMortonCode(
+    const std::vector<CollisionObject<S>*>& objs,
+    std::vector<std::size_t>& indices);
+
+} // namespace detail
+} // namespace fcl
+
+#include "fcl/broadphase/detail/query_batch-inl.h"
+
+#endif
@@ -40,7 +40,7 @@
 
 #include "fcl/broadphase/detail/simple_hash_table.h"
 
-#include <iterator>
+#include <algorithm>
 
 namespace fcl
 {
@@ -65,48 +65,60 @@ void SimpleHashTable<Key, Data, HashFnc>::init(size_t size)
     throw std::logic_error("SimpleHashTable must have non-zero size.");
   }
 
-  table_.resize(size);
-  table_size_ = size;
+  table_.init(size);
 }
 
 //==============================================================================
 template<typename Key, typename Data, typename HashFnc>
 void SimpleHashTable<Key, Data, HashFnc>::insert(Key key, Data value)
 {
-  std::vector<unsigned int> indices = h_(key);
-  size_t range = table_.size();
-  for(size_t i = 0; i < indices.size(); ++i)
-    table_[indices[i] % range].push_back(value);
+  h_.visitCells(key, [&](unsigned int cell) {
+    table_.insert(cell, value);
+  });
 }
 
 //==============================================================================
 template<typename Key, typename Data, typename HashFnc>
 std::vector<Data> SimpleHashTable<Key, Data, HashFnc>::query(Key key) const
 {
-  size_t range = table_.size();
-  std::vector<unsigned int> indices = h_(key);
-  std::set<Data> result;
-  for(size_t i = 0; i < indices.size(); ++i)
-  {
-    unsigned int index = indices[i] % range;
-    std::copy(table_[index].begin(), table_[index].end(),
-              std::inserter(result, result.end()));
-  }
+  std::vector<Data> result;
+  query(key, result);
+  return result;
+}
 
-  return std::vector<Data>(result.begin(), result.end());
+//==============================================================================
+template<typename Key, typename Data, typename HashFnc>
+void SimpleHashTable<Key, Data, HashFnc>::query(
+    Key key, std::vector<Data>& result) const
+{
+  result.clear();
+  if(table_.empty())
+    return;
+
+  h_.visitCells(key, [&](unsigned int cell) {
+    table_.visit(cell, [&](const Data& value) {
+      result.push_back(value);
+    });
+  });
+
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
 }
 
 //==============================================================================
 template<typename Key, typename Data, typename HashFnc>
 void SimpleHashTable<Key, Data, HashFnc>::remove(Key key, Data value)
 {
-  size_t range = table_.size();
-  std::vector<unsigned int> indices = h_(key);
-  for(size_t i = 0; i < indices.size(); ++i)
-  {
-    unsigned int index = indices[i] % range;
-    table_[index].remove(value);
-  }
+  if(table_.empty())
+    return;
+
+  h_.visitCells(key, [&](unsigned int cell) {
+    const size_t slot = table_.find(cell, [&](const Data& other) {
+      return other == value;
+    });
+    if(slot != table_.capacity())
+      table_.erase(slot);
+  });
 }
 
 //==============================================================================
@@ -114,7 +126,6 @@ template<typename Key, typename Data, typename HashFnc>
 void SimpleHashTable<Key, Data, HashFnc>::clear()
 {
   table_.clear();
-  table_.resize(table_size_);
 }
 
 } // namespace detail
@@ -39,9 +39,10 @@
 #define FCL_BROADPHASE_SIMPLEHASHTABLE_H
 
 #include <stdexcept>
-#include <set>
 #include <vector>
-#include <list>
+
+#include "fcl/export.h"
+#include "fcl/broadphase/detail/linear_probing_table.h"
 
 namespace fcl
 {
@@ -49,24 +50,24 @@ namespace fcl
 namespace detail
 {
 
-/// @brief A simple hash table implemented as multiple buckets. HashFnc is any
-/// extended hash function: HashFnc(key) = {index1, index2, ..., }
+/// @brief A simple hash table storing (cell, value) pairs in one flat array
+/// with open addressing (linear probing), see LinearProbingTable. HashFnc is
+/// any extended hash function which enumerates the cells of a key:
+/// HashFnc::visitCells(key, visit) calls visit(cell) for every cell index of
+/// key, e.g. SpatialHash.
 template<typename Key, typename Data, typename HashFnc>
 class FCL_EXPORT SimpleHashTable
 {
 protected:
-  typedef std::list<Data> Bin;
-
-  std::vector<Bin> table_;
+  LinearProbingTable<unsigned int, Data> table_;
 
   HashFnc h_;
 
-  size_t table_size_;
-
 public:
   SimpleHashTable(const HashFnc& h);
 
-  /// @brief Init the number of bins in the hash table
+  /// @brief Init the number of slots in the hash table. The table grows when
+  /// it gets half full.
   void init(size_t size);
 
   //// @brief Insert a key-value pair into the table
@@ -76,6 +77,12 @@ public:
   /// key.
   std::vector<Data> query(Key key) const;
 
+  /// @brief Find the elements in the hash table whose key is the same as query
+  /// key. The sorted, duplicate-free result is written to the caller-owned
+  /// buffer result, which is cleared first, so that repeated queries reuse
+  /// its memory.
+  void query(Key key, std::vector<Data>& result) const;
+
   /// @brief remove the key-value pair from the table
   void remove(Key key, Data value);
 
@@ -40,6 +40,8 @@
 
 #include "fcl/broadphase/detail/sparse_hash_table.h"
 
+#include <algorithm>
+
 namespace fcl
 {
 
@@ -68,9 +70,9 @@ template <typename Key, typename Data, typename HashFnc,
           template<typename, typename> class TableT>
 void SparseHashTable<Key, Data, HashFnc, TableT>::insert(Key key, Data value)
 {
-  std::vector<unsigned int> indices = h_(key);
-  for(size_t i = 0; i < indices.size(); ++i)
-    table_[indices[i]].push_back(value);
+  h_.visitCells(key, [&](unsigned int index) {
+    table_[index].push_back(value);
+  });
 }
 
 //==============================================================================
@@ -78,20 +80,26 @@ template <typename Key, typename Data, typename HashFnc,
           template<typename, typename> class TableT>
 std::vector<Data> SparseHashTable<Key, Data, HashFnc, TableT>::query(Key key) const
 {
-  std::vector<unsigned int> indices = h_(key);
-  std::set<Data> result;
-  for(size_t i = 0; i < indices.size(); ++i)
-  {
-    unsigned int index = indices[i];
+  std::vector<Data> result;
+  query(key, result);
+  return result;
+}
+
+//==============================================================================
+template <typename Key, typename Data, typename HashFnc,
+          template<typename, typename> class TableT>
+void SparseHashTable<Key, Data, HashFnc, TableT>::query(
+    Key key, std::vector<Data>& result) const
+{
+  result.clear();
+  h_.visitCells(key, [&](unsigned int index) {
     typename Table::const_iterator p = table_.find(index);
     if(p != table_.end())
-    {
-      std::copy((*p).second.begin(), (*p).second.end(), std
-                ::inserter(result, result.end()));
-    }
-  }
+      result.insert(result.end(), (*p).second.begin(), (*p).second.end());
+  });
 
-  return std::vector<Data>(result.begin(), result.end());
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
 }
 
 //==============================================================================
@@ -99,12 +107,10 @@ template <typename Key, typename Data, typename HashFnc,
           template<typename, typename> class TableT>
 void SparseHashTable<Key, Data, HashFnc, TableT>::remove(Key key, Data value)
 {
-  std::vector<unsigned int> indices = h_(key);
-  for(size_t i = 0; i < indices.size(); ++i)
-  {
-    unsigned int index = indices[i];
-    table_[index].remove(value);
-  }
+  h_.visitCells(key, [&](unsigned int index) {
+    Bin& bin = table_[index];
+    bin.erase(std::remove(bin.begin(), bin.end(), value), bin.end());
+  });
 }
 
 //==============================================================================
@@ -39,11 +39,11 @@
 #define FCL_BROADPHASE_SPARSEHASHTABLE_H
 
 #include <stdexcept>
-#include <set>
 #include <vector>
-#include <list>
 #include <unordered_map>
 
+#include "fcl/export.h"
+
 namespace fcl
 {
 
@@ -53,14 +53,15 @@ namespace detail
 template<typename U, typename V>
 class FCL_EXPORT unordered_map_hash_table : public std::unordered_map<U, V> {};
 
-/// @brief A hash table implemented using unordered_map
+/// @brief A hash table implemented using unordered_map, mapping every cell
+/// enumerated by HashFnc::visitCells() to a contiguous bin of values
 template <typename Key, typename Data, typename HashFnc,
           template<typename, typename> class TableT = unordered_map_hash_table>
 class FCL_EXPORT SparseHashTable
 {
 protected:
   HashFnc h_;
-  typedef std::list<Data> Bin;
+  typedef std::vector<Data> Bin;
   typedef TableT<size_t, Bin> Table;
   
   Table table_;
@@ -76,6 +77,11 @@ public:
   /// @brief find the elements whose key is the same as the query
   std::vector<Data> query(Key key) const;
 
+  /// @brief find the elements whose key is the same as the query. The sorted,
+  /// duplicate-free result is written to the caller-owned buffer result,
+  /// which is cleared first.
+  void query(Key key, std::vector<Data>& result) const;
+
   /// @brief remove one key-value pair from the hash table
   void remove(Key key, Data value);
 
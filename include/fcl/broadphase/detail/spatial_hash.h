@@ -38,6 +38,8 @@
 #ifndef FCL_BROADPHASE_SPATIALHASH_H
 #define FCL_BROADPHASE_SPATIALHASH_H
 
+#include <vector>
+
 #include "fcl/math/bv/AABB.h"
 
 namespace fcl
@@ -53,9 +55,15 @@ struct FCL_EXPORT SpatialHash
   using S = S_;
 
   SpatialHash(const AABB<S>& scene_limit_, S cell_size_);
-    
+
+  /// @brief The keys of all the cells overlapped by aabb
   std::vector<unsigned int> operator() (const AABB<S>& aabb) const;
 
+  /// @brief Calls visit(key) with the key of every cell overlapped by aabb,
+  /// in the order of operator(), without allocating
+  template <typename Visitor>
+  void visitCells(const AABB<S>& aabb, Visitor&& visit) const;
+
 private:
 
   S cell_size;
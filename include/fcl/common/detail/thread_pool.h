@@ -0,0 +1,122 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FCL_COMMON_DETAIL_THREADPOOL_H
+#define FCL_COMMON_DETAIL_THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "fcl/export.h"
+
+namespace fcl {
+namespace detail {
+
+/// @brief A small fork-join pool of worker threads with work stealing.
+///
+/// run() executes a batch of independent tasks, identified by their index,
+/// and returns once all of them have finished. The task indices are dealt
+/// round-robin into one deque per thread; each thread pops from the back of
+/// its own deque and, once that runs dry, steals from the front of the other
+/// threads' deques. The calling thread takes part in the work as thread 0, so
+/// a pool of size one runs everything serially on the caller.
+class FCL_EXPORT ThreadPool
+{
+public:
+  /// @brief The work to do: task(task_index, thread_index)
+  using Task = std::function<void(std::size_t, unsigned int)>;
+
+  /// @brief Creates a pool with num_threads threads in total (including the
+  /// calling thread); 0 means one thread per hardware core.
+  explicit ThreadPool(unsigned int num_threads = 0);
+
+  // non-copyable
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool();
+
+  /// @brief Number of threads taking part in run(), including the caller
+  unsigned int size() const;
+
+  /// @brief Runs task(i, thread) for every i in [0, num_tasks) and blocks
+  /// until all tasks are done. The first exception thrown by a task is
+  /// rethrown here after the batch has drained. Concurrent calls to run() are
+  /// serialized.
+  void run(std::size_t num_tasks, const Task& task);
+
+  /// @brief Resolves a requested thread count, mapping 0 to the number of
+  /// hardware cores (at least one)
+  static unsigned int resolveNumThreads(unsigned int num_threads);
+
+private:
+  struct TaskQueue
+  {
+    std::mutex mutex;
+    std::deque<std::size_t> tasks;
+  };
+
+  void workerLoop(unsigned int thread_id);
+
+  void drain(unsigned int thread_id);
+
+  bool popTask(unsigned int thread_id, std::size_t& task_id);
+
+  unsigned int num_threads_;
+  std::vector<std::thread> workers_;
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+
+  std::mutex run_mutex_;
+
+  std::mutex state_mutex_;
+  std::condition_variable start_cv_;
+  std::condition_variable done_cv_;
+  const Task* task_;
+  std::size_t generation_;
+  unsigned int active_workers_;
+  bool stop_;
+  std::exception_ptr exception_;
+};
+
+} // namespace detail
+} // namespace fcl
+
+#endif
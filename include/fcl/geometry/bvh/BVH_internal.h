@@ -71,6 +71,13 @@ enum BVHReturnCode
     BVH_ERR_UNKNOWN = -8                        /// Unknown failure
   };
 
+/// @brief Construction method for the bounding volume hierarchy of a BVH model
+enum BVHBuildMethod
+  {
+    BVH_BUILD_METHOD_TOP_DOWN,      /// @brief recursive top-down partition by the model's bv_splitter
+    BVH_BUILD_METHOD_LBVH           /// @brief linear BVH: primitives sorted by Morton code, radix tree built in parallel, BVs fitted bottom-up
+  };
+
 /// @brief BVH model type
 enum BVHModelType
   {
@@ -39,7 +39,12 @@
 #define FCL_BVH_MODEL_INL_H
 
 #include "fcl/geometry/bvh/BVH_model.h"
+#include <algorithm>
+#include <mutex>
 #include <new>
+#include <typeinfo>
+#include "fcl/broadphase/detail/morton.h"
+#include "fcl/geometry/bvh/detail/BVH_lbvh.h"
 
 namespace fcl
 {
@@ -66,6 +71,8 @@ BVHModel<BV>::BVHModel() : vertices(nullptr),
   build_state(BVH_BUILD_STATE_EMPTY),
   bv_splitter(new detail::BVSplitter<BV>(detail::SPLIT_METHOD_MEAN)),
   bv_fitter(new detail::BVFitter<BV>()),
+  build_method(BVH_BUILD_METHOD_TOP_DOWN),
+  build_num_threads(0),
   num_tris_allocated(0),
   num_vertices_allocated(0),
   num_bvs_allocated(0),
@@ -86,6 +93,8 @@ BVHModel<BV>::BVHModel(const BVHModel<BV>& other)
     build_state(other.build_state),
     bv_splitter(other.bv_splitter),
     bv_fitter(other.bv_fitter),
+    build_method(other.build_method),
+    build_num_threads(other.build_num_threads),
     num_tris_allocated(other.num_tris),
     num_vertices_allocated(other.num_vertices)
 {
@@ -752,6 +761,61 @@ int BVHModel<BV>::memUsage(int msg) const
   return BVH_OK;
 }
 
+//==============================================================================
+template <typename BV>
+BVHTreeQuality<typename BV::S> BVHModel<BV>::computeTreeQuality() const
+{
+  BVHTreeQuality<S> quality;
+  quality.sah_cost = 0;
+  quality.overlap_volume = 0;
+  quality.max_depth = 0;
+
+  if(num_bvs == 0)
+    return quality;
+
+  const BV& root = bvs[0].bv;
+  const S root_area = root.width() * root.height()
+      + root.height() * root.depth() + root.depth() * root.width();
+  computeTreeQualityRecurse(0, 0, root_area, quality);
+
+  return quality;
+}
+
+//==============================================================================
+template <typename BV>
+AABB<typename BV::S> BVHModel<BV>::computeTreeQualityRecurse(
+    int bv_id, int depth, S root_area, BVHTreeQuality<S>& quality) const
+{
+  const BVNode<BV>& node = bvs[bv_id];
+  const S area = node.bv.width() * node.bv.height()
+      + node.bv.height() * node.bv.depth() + node.bv.depth() * node.bv.width();
+  quality.sah_cost += (root_area > 0) ? area / root_area : 1;
+  quality.max_depth = std::max(quality.max_depth, depth);
+
+  if(node.isLeaf())
+  {
+    const int primitive_id = node.primitiveId();
+    if(getModelType() == BVH_MODEL_TRIANGLES)
+    {
+      const Triangle& triangle = tri_indices[primitive_id];
+      return AABB<S>(vertices[triangle[0]], vertices[triangle[1]],
+                     vertices[triangle[2]]);
+    }
+    return AABB<S>(vertices[primitive_id]);
+  }
+
+  const AABB<S> left = computeTreeQualityRecurse(
+        node.leftChild(), depth + 1, root_area, quality);
+  const AABB<S> right = computeTreeQualityRecurse(
+        node.rightChild(), depth + 1, root_area, quality);
+
+  AABB<S> overlap_part;
+  if(left.overlap(right, overlap_part))
+    quality.overlap_volume += overlap_part.volume();
+
+  return left + right;
+}
+
 //==============================================================================
 template <typename BV>
 void BVHModel<BV>::makeParentRelative()
@@ -831,13 +895,6 @@ Matrix3<typename BV::S> BVHModel<BV>::computeMomentofInertia() const
 template <typename BV>
 int BVHModel<BV>::buildTree()
 {
-  // set BVFitter
-  bv_fitter->set(vertices, tri_indices, getModelType());
-  // set SplitRule
-  bv_splitter->set(vertices, tri_indices, getModelType());
-
-  num_bvs = 1;
-
   int num_primitives = 0;
   switch(getModelType())
   {
@@ -852,6 +909,16 @@ int BVHModel<BV>::buildTree()
     return BVH_ERR_UNSUPPORTED_FUNCTION;
   }
 
+  if(build_method == BVH_BUILD_METHOD_LBVH)
+    return buildTreeLBVH(num_primitives);
+
+  // set BVFitter
+  bv_fitter->set(vertices, tri_indices, getModelType());
+  // set SplitRule
+  bv_splitter->set(vertices, tri_indices, getModelType());
+
+  num_bvs = 1;
+
   for(int i = 0; i < num_primitives; ++i)
     primitive_indices[i] = i;
   recursiveBuildTree(0, 0, num_primitives);
@@ -936,6 +1003,188 @@ int BVHModel<BV>::recursiveBuildTree(int bv_id, int first_primitive, int num_pri
   return BVH_OK;
 }
 
+//==============================================================================
+template <typename BV>
+int BVHModel<BV>::buildTreeLBVH(int num_primitives)
+{
+  const BVHModelType type = getModelType();
+  const std::size_t n = num_primitives;
+  if(n == 0)
+  {
+    num_bvs = 0;
+    return BVH_OK;
+  }
+
+  std::shared_ptr<detail::ThreadPool> pool = getBuildThreadPool_();
+
+  const std::size_t chunk = 1024;
+  auto parallelFor = [&](std::size_t begin, std::size_t end,
+                         const std::function<void(std::size_t)>& f) {
+    const std::size_t num_chunks = (end - begin + chunk - 1) / chunk;
+    pool->run(num_chunks, [&](std::size_t c, unsigned int) {
+      const std::size_t last = std::min(begin + (c + 1) * chunk, end);
+      for(std::size_t i = begin + c * chunk; i < last; ++i)
+        f(i);
+    });
+  };
+
+  // Morton codes of the primitive centroids, quantized in their bounding box
+  std::vector<Vector3<S>> centers(n);
+  parallelFor(0, n, [&](std::size_t i) {
+    if(type == BVH_MODEL_TRIANGLES)
+    {
+      const Triangle& t = tri_indices[i];
+      centers[i] = (vertices[t[0]] + vertices[t[1]] + vertices[t[2]]) / 3.0;
+    }
+    else
+      centers[i] = vertices[i];
+  });
+
+  AABB<S> bound(centers[0]);
+  for(std::size_t i = 1; i < n; ++i)
+    bound += centers[i];
+  for(int k = 0; k < 3; ++k)
+  {
+    if(bound.max_[k] <= bound.min_[k])
+      bound.max_[k] = bound.min_[k] + 1;
+  }
+
+  const detail::morton_functor<S, uint64> morton(bound);
+  std::vector<uint64> codes(n);
+  parallelFor(0, n, [&](std::size_t i) { codes[i] = morton(centers[i]); });
+
+  for(std::size_t i = 0; i < n; ++i)
+    primitive_indices[i] = i;
+  std::sort(primitive_indices, primitive_indices + n,
+            [&codes](unsigned int a, unsigned int b) {
+    return (codes[a] < codes[b]) || (codes[a] == codes[b] && a < b);
+  });
+
+  std::vector<uint64> sorted_codes(n);
+  for(std::size_t i = 0; i < n; ++i)
+    sorted_codes[i] = codes[primitive_indices[i]];
+
+  std::vector<detail::LBVHNode> nodes;
+  detail::buildLBVHRadixTree(sorted_codes, nodes, pool.get());
+
+  // Lay the radix tree out in the BV array in depth-first order, with the two
+  // children of a node next to each other as recursiveBuildTree() does.
+  struct Item
+  {
+    int bv_id;
+    bool leaf;
+    int index; // sorted primitive for a leaf, radix tree node otherwise
+    int depth;
+  };
+
+  std::vector<int> depths(2 * n - 1);
+  int max_depth = 0;
+  std::vector<Item> stack;
+  stack.push_back({0, n == 1, 0, 0});
+  num_bvs = 1;
+  while(!stack.empty())
+  {
+    const Item item = stack.back();
+    stack.pop_back();
+
+    BVNode<BV>& bvnode = bvs[item.bv_id];
+    depths[item.bv_id] = item.depth;
+    max_depth = std::max(max_depth, item.depth);
+
+    if(item.leaf)
+    {
+      bvnode.first_child = -static_cast<int>(primitive_indices[item.index] + 1);
+      bvnode.first_primitive = item.index;
+      bvnode.num_primitives = 1;
+    }
+    else
+    {
+      const detail::LBVHNode& node = nodes[item.index];
+      bvnode.first_child = num_bvs;
+      bvnode.first_primitive = node.first;
+      bvnode.num_primitives = node.last - node.first + 1;
+      num_bvs += 2;
+
+      stack.push_back({bvnode.first_child + 1, node.split + 1 == node.last,
+                       node.split + 1, item.depth + 1});
+      stack.push_back({bvnode.first_child, node.split == node.first,
+                       node.split, item.depth + 1});
+    }
+  }
+
+  // Group the BVs by depth level for the bottom-up merge
+  std::vector<int> level_begin(max_depth + 2, 0);
+  for(int i = 0; i < num_bvs; ++i)
+    ++level_begin[depths[i] + 1];
+  for(int d = 0; d <= max_depth; ++d)
+    level_begin[d + 1] += level_begin[d];
+  std::vector<int> level_nodes(num_bvs);
+  {
+    std::vector<int> offset(level_begin.begin(), level_begin.end() - 1);
+    for(int i = 0; i < num_bvs; ++i)
+      level_nodes[offset[depths[i]]++] = i;
+  }
+
+  // Fit the leaves first. The default fitter only reads the model, so every
+  // build thread gets a copy of its own; any other fitter is called from the
+  // calling thread alone.
+  if(typeid(*bv_fitter) == typeid(detail::BVFitter<BV>))
+  {
+    std::vector<detail::BVFitter<BV>> fitters(pool->size());
+    for(auto& fitter : fitters)
+      fitter.set(vertices, tri_indices, type);
+
+    const std::size_t num_chunks = (num_bvs + chunk - 1) / chunk;
+    pool->run(num_chunks, [&](std::size_t c, unsigned int thread) {
+      const std::size_t last = std::min((c + 1) * chunk, std::size_t(num_bvs));
+      for(std::size_t i = c * chunk; i < last; ++i)
+      {
+        BVNode<BV>& bvnode = bvs[i];
+        if(bvnode.isLeaf())
+          bvnode.bv = fitters[thread].fit(
+                primitive_indices + bvnode.first_primitive, 1);
+      }
+    });
+  }
+  else
+  {
+    bv_fitter->set(vertices, tri_indices, type);
+    for(int i = 0; i < num_bvs; ++i)
+    {
+      BVNode<BV>& bvnode = bvs[i];
+      if(bvnode.isLeaf())
+        bvnode.bv = bv_fitter->fit(primitive_indices + bvnode.first_primitive, 1);
+    }
+    bv_fitter->clear();
+  }
+
+  // Merge the inner BVs bottom-up, one depth level at a time, in parallel
+  // within each level.
+  for(int d = max_depth; d >= 0; --d)
+  {
+    parallelFor(level_begin[d], level_begin[d + 1], [&](std::size_t k) {
+      BVNode<BV>& bvnode = bvs[level_nodes[k]];
+      if(!bvnode.isLeaf())
+        bvnode.bv = bvs[bvnode.leftChild()].bv + bvs[bvnode.rightChild()].bv;
+    });
+  }
+
+  return BVH_OK;
+}
+
+//==============================================================================
+template <typename BV>
+std::shared_ptr<detail::ThreadPool> BVHModel<BV>::getBuildThreadPool_() const
+{
+  // Shared by all the models, which keeps them copy-assignable
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> lock(mutex);
+  const unsigned int n = detail::ThreadPool::resolveNumThreads(build_num_threads);
+  if(!build_thread_pool_ || build_thread_pool_->size() != n)
+    build_thread_pool_ = std::make_shared<detail::ThreadPool>(n);
+  return build_thread_pool_;
+}
+
 //==============================================================================
 template <typename BV>
 int BVHModel<BV>::refitTree(bool bottomup)
@@ -48,10 +48,30 @@
 #include "fcl/geometry/bvh/BV_node.h"
 #include "fcl/geometry/bvh/detail/BV_splitter.h"
 #include "fcl/geometry/bvh/detail/BV_fitter.h"
+#include "fcl/common/detail/thread_pool.h"
 
 namespace fcl
 {
 
+/// @brief Quality measures of a built bounding volume hierarchy, used to
+/// compare split rules and build methods
+template <typename S>
+struct FCL_EXPORT BVHTreeQuality
+{
+  /// @brief Surface area heuristic cost: the sum over all nodes of the node's
+  /// BV area relative to the root's, i.e. the expected number of node visits
+  /// plus primitive tests for a query that hits the root's BV
+  S sah_cost;
+
+  /// @brief Sum over all internal nodes of the volume shared by the
+  /// axis-aligned boxes of the primitives below its two children; zero for a
+  /// hierarchy whose siblings never overlap
+  S overlap_volume;
+
+  /// @brief Depth of the deepest leaf, the root having depth 0
+  int max_depth;
+};
+
 /// @brief A class describing the bounding hierarchy of a mesh model or a point cloud model (which is viewed as a degraded version of mesh)
 template <typename BV>
 class FCL_EXPORT BVHModel : public CollisionGeometry<typename BV::S>
@@ -147,6 +167,10 @@ public:
   /// @brief Check the number of memory used
   int memUsage(int msg) const;
 
+  /// @brief Compute the quality measures of the current hierarchy. The BV
+  /// areas are those of the BVs' width/height/depth boxes.
+  BVHTreeQuality<S> computeTreeQuality() const;
+
   /// @brief This is a special acceleration: BVH_model default stores the BV's transform in world coordinate. However, we can also store each BV's transform related to its parent 
   /// BV node. When traversing the BVH, this can save one matrix transformation.
   void makeParentRelative();
@@ -182,6 +206,18 @@ public:
   /// @brief Fitting rule to fit a BV node to a set of geometry primitives
   std::shared_ptr<detail::BVFitterBase<BV>> bv_fitter;
 
+  /// @brief How the hierarchy is built by endModel() and by
+  /// endUpdateModel(false). BVH_BUILD_METHOD_LBVH ignores bv_splitter: it
+  /// orders the primitives by the Morton code of their centroids, fits the
+  /// leaf BVs with bv_fitter and merges them bottom-up as refitting does,
+  /// which is much faster to build but gives looser oriented BVs. The leaves
+  /// are fitted in parallel only with the default detail::BVFitter.
+  BVHBuildMethod build_method;
+
+  /// @brief Number of threads used by the LBVH build, including the calling
+  /// thread; 0 means one thread per hardware core
+  unsigned int build_num_threads;
+
 private:
 
   int num_tris_allocated;
@@ -211,6 +247,20 @@ private:
   /// @brief Recursive kernel for hierarchy construction
   int recursiveBuildTree(int bv_id, int first_primitive, int num_primitives);
 
+  /// @brief Linear BVH construction over num_primitives primitives
+  int buildTreeLBVH(int num_primitives);
+
+  /// @brief Returns the pool for the LBVH build, (re)created to match
+  /// build_num_threads
+  std::shared_ptr<detail::ThreadPool> getBuildThreadPool_() const;
+
+  mutable std::shared_ptr<detail::ThreadPool> build_thread_pool_;
+
+  /// @brief Recursive kernel for computeTreeQuality(); returns the box of the
+  /// primitives below bv_id
+  AABB<S> computeTreeQualityRecurse(
+      int bv_id, int depth, S root_area, BVHTreeQuality<S>& quality) const;
+
   /// @brief Recursive kernel for bottomup refitting 
   int recursiveRefitTree_bottomup(int bv_id);
 
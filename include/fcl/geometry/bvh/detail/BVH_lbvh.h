@@ -0,0 +1,76 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#ifndef FCL_BVH_DETAIL_BVHLBVH_H
+#define FCL_BVH_DETAIL_BVHLBVH_H
+
+#include <vector>
+
+#include "fcl/common/types.h"
+#include "fcl/common/detail/thread_pool.h"
+
+namespace fcl
+{
+
+namespace detail
+{
+
+/// @brief Internal node of a linear BVH (LBVH). It covers the sorted keys
+/// [first, last]; its children cover [first, split] and [split + 1, last]. A
+/// child covering a single key is the leaf of that key, otherwise it is the
+/// internal node whose index is split (left child) or split + 1 (right child).
+struct FCL_EXPORT LBVHNode
+{
+  int first;
+  int last;
+  int split;
+};
+
+/// @brief Builds the n - 1 internal nodes of the binary radix tree over n >= 2
+/// sorted Morton codes (Karras, "Maximizing parallelism in the construction of
+/// BVHs, octrees, and k-d trees", 2012). Node 0 is the root. Duplicate codes
+/// are disambiguated by their position. Every node is found independently of
+/// the others, so the work is spread over pool when one is given.
+FCL_EXPORT
+void buildLBVHRadixTree(
+    const std::vector<uint64>& sorted_codes,
+    std::vector<LBVHNode>& nodes,
+    ThreadPool* pool = nullptr);
+
+} // namespace detail
+} // namespace fcl
+
+#endif
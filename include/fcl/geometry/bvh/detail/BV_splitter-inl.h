@@ -89,6 +89,9 @@ void BVSplitter<BV>::computeRule(
   case SPLIT_METHOD_BV_CENTER:
     computeRule_bvcenter(bv, primitive_indices, num_primitives);
     break;
+  case SPLIT_METHOD_SAH:
+    computeRule_sah(bv, primitive_indices, num_primitives);
+    break;
   default:
     std::cerr << "Split method not supported" << std::endl;
   }
@@ -255,6 +258,32 @@ void BVSplitter<BV>::computeRule_median(
         *this, bv, primitive_indices, num_primitives);
 }
 
+//==============================================================================
+template <typename S, typename BV>
+struct ComputeRuleSAHImpl
+{
+  static void run(
+      BVSplitter<BV>& splitter,
+      const BV& /*bv*/,
+      unsigned int* primitive_indices,
+      int num_primitives)
+  {
+    computeSplitValue_sah<S>(
+          Matrix3<S>::Identity(), splitter.vertices, splitter.tri_indices,
+          primitive_indices, num_primitives, splitter.type,
+          splitter.split_axis, splitter.split_value);
+  }
+};
+
+//==============================================================================
+template <typename BV>
+void BVSplitter<BV>::computeRule_sah(
+    const BV& bv, unsigned int* primitive_indices, int num_primitives)
+{
+  ComputeRuleSAHImpl<S, BV>::run(
+        *this, bv, primitive_indices, num_primitives);
+}
+
 //==============================================================================
 template <typename S>
 struct ComputeRuleCenterImpl<S, OBB<S>>
@@ -304,6 +333,24 @@ struct ComputeRuleMedianImpl<S, OBB<S>>
   }
 };
 
+//==============================================================================
+template <typename S>
+struct ComputeRuleSAHImpl<S, OBB<S>>
+{
+  static void run(
+      BVSplitter<OBB<S>>& splitter,
+      const OBB<S>& bv,
+      unsigned int* primitive_indices,
+      int num_primitives)
+  {
+    int axis = 0;
+    computeSplitValue_sah<S>(
+          bv.axis, splitter.vertices, splitter.tri_indices, primitive_indices,
+          num_primitives, splitter.type, axis, splitter.split_value);
+    splitter.split_vector = bv.axis.col(axis);
+  }
+};
+
 //==============================================================================
 template <typename S>
 struct ComputeRuleCenterImpl<S, RSS<S>>
@@ -353,6 +400,24 @@ struct ComputeRuleMedianImpl<S, RSS<S>>
   }
 };
 
+//==============================================================================
+template <typename S>
+struct ComputeRuleSAHImpl<S, RSS<S>>
+{
+  static void run(
+      BVSplitter<RSS<S>>& splitter,
+      const RSS<S>& bv,
+      unsigned int* primitive_indices,
+      int num_primitives)
+  {
+    int axis = 0;
+    computeSplitValue_sah<S>(
+          bv.axis, splitter.vertices, splitter.tri_indices, primitive_indices,
+          num_primitives, splitter.type, axis, splitter.split_value);
+    splitter.split_vector = bv.axis.col(axis);
+  }
+};
+
 //==============================================================================
 template <typename S>
 struct ComputeRuleCenterImpl<S, kIOS<S>>
@@ -402,6 +467,24 @@ struct ComputeRuleMedianImpl<S, kIOS<S>>
   }
 };
 
+//==============================================================================
+template <typename S>
+struct ComputeRuleSAHImpl<S, kIOS<S>>
+{
+  static void run(
+      BVSplitter<kIOS<S>>& splitter,
+      const kIOS<S>& bv,
+      unsigned int* primitive_indices,
+      int num_primitives)
+  {
+    int axis = 0;
+    computeSplitValue_sah<S>(
+          bv.obb.axis, splitter.vertices, splitter.tri_indices, primitive_indices,
+          num_primitives, splitter.type, axis, splitter.split_value);
+    splitter.split_vector = bv.obb.axis.col(axis);
+  }
+};
+
 //==============================================================================
 template <typename S>
 struct ComputeRuleCenterImpl<S, OBBRSS<S>>
@@ -451,6 +534,24 @@ struct ComputeRuleMedianImpl<S, OBBRSS<S>>
   }
 };
 
+//==============================================================================
+template <typename S>
+struct ComputeRuleSAHImpl<S, OBBRSS<S>>
+{
+  static void run(
+      BVSplitter<OBBRSS<S>>& splitter,
+      const OBBRSS<S>& bv,
+      unsigned int* primitive_indices,
+      int num_primitives)
+  {
+    int axis = 0;
+    computeSplitValue_sah<S>(
+          bv.obb.axis, splitter.vertices, splitter.tri_indices, primitive_indices,
+          num_primitives, splitter.type, axis, splitter.split_value);
+    splitter.split_vector = bv.obb.axis.col(axis);
+  }
+};
+
 //==============================================================================
 template <typename S>
 struct ApplyImpl<S, OBB<S>>
@@ -679,6 +780,122 @@ void computeSplitValue_median(
   }
 }
 
+//==============================================================================
+template <typename S>
+void computeSplitValue_sah(
+    const Matrix3<S>& axes,
+    Vector3<S>* vertices,
+    Triangle* triangles,
+    unsigned int* primitive_indices,
+    int num_primitives,
+    BVHModelType type,
+    int& split_axis,
+    S& split_value)
+{
+  constexpr int num_bins = 16;
+
+  // Box of each primitive and its centroid, both in the frame of axes
+  std::vector<AABB<S>> boxes(num_primitives);
+  std::vector<Vector3<S>> centroids(num_primitives);
+  AABB<S> centroid_bound;
+  for(int i = 0; i < num_primitives; ++i)
+  {
+    if(type == BVH_MODEL_TRIANGLES)
+    {
+      const Triangle& t = triangles[primitive_indices[i]];
+      const Vector3<S> p1 = axes.transpose() * vertices[t[0]];
+      const Vector3<S> p2 = axes.transpose() * vertices[t[1]];
+      const Vector3<S> p3 = axes.transpose() * vertices[t[2]];
+      boxes[i] = AABB<S>(p1, p2, p3);
+      centroids[i] = (p1 + p2 + p3) / 3;
+    }
+    else
+    {
+      centroids[i] = axes.transpose() * vertices[primitive_indices[i]];
+      boxes[i] = AABB<S>(centroids[i]);
+    }
+
+    if(i == 0)
+      centroid_bound = AABB<S>(centroids[0]);
+    else
+      centroid_bound += centroids[i];
+  }
+
+  auto area = [](const AABB<S>& box) {
+    const S w = box.width();
+    const S h = box.height();
+    const S d = box.depth();
+    return w * h + h * d + d * w;
+  };
+
+  S best_cost = std::numeric_limits<S>::max();
+  split_axis = -1;
+
+  for(int axis = 0; axis < 3; ++axis)
+  {
+    const S min = centroid_bound.min_[axis];
+    const S extent = centroid_bound.max_[axis] - min;
+    if(extent <= 0)
+      continue;
+
+    AABB<S> bin_boxes[num_bins];
+    int bin_counts[num_bins] = {0};
+    const S scale = num_bins / extent;
+    for(int i = 0; i < num_primitives; ++i)
+    {
+      const int b = std::min(
+            static_cast<int>((centroids[i][axis] - min) * scale), num_bins - 1);
+      if(bin_counts[b]++ == 0)
+        bin_boxes[b] = boxes[i];
+      else
+        bin_boxes[b] += boxes[i];
+    }
+
+    // Sweep from the right to get the area and count right of each boundary
+    S right_cost[num_bins];
+    AABB<S> right_box;
+    int right_count = 0;
+    for(int b = num_bins - 1; b > 0; --b)
+    {
+      if(bin_counts[b] > 0)
+      {
+        right_box = right_count ? right_box + bin_boxes[b] : bin_boxes[b];
+        right_count += bin_counts[b];
+      }
+      right_cost[b] = right_count ? area(right_box) * right_count : 0;
+    }
+
+    AABB<S> left_box;
+    int left_count = 0;
+    for(int b = 0; b < num_bins - 1; ++b)
+    {
+      if(bin_counts[b] > 0)
+      {
+        left_box = left_count ? left_box + bin_boxes[b] : bin_boxes[b];
+        left_count += bin_counts[b];
+      }
+      if(left_count == 0 || left_count == num_primitives)
+        continue;
+
+      const S cost = area(left_box) * left_count + right_cost[b + 1];
+      if(cost < best_cost)
+      {
+        best_cost = cost;
+        split_axis = axis;
+        split_value = min + (b + 1) / scale;
+      }
+    }
+  }
+
+  if(split_axis == -1)
+  {
+    // All centroids coincide; any threshold gives a degenerate split, which
+    // the builder resolves by halving the primitive range.
+    split_axis = 0;
+    split_value = centroid_bound.min_[0];
+  }
+}
+
 } // namespace detail
 } // namespace fcl
 
@@ -38,9 +38,12 @@
 #ifndef FCL_BV_SPLITTER_H
 #define FCL_BV_SPLITTER_H
 
+#include <algorithm>
+#include <limits>
 #include <vector>
 #include <iostream>
 #include "fcl/math/triangle.h"
+#include "fcl/math/bv/AABB.h"
 #include "fcl/math/bv/kIOS.h"
 #include "fcl/math/bv/OBBRSS.h"
 #include "fcl/geometry/bvh/BVH_internal.h"
@@ -52,12 +55,13 @@ namespace fcl
 namespace detail
 {
 
-/// @brief Three types of split algorithms are provided in FCL as default
+/// @brief Four types of split algorithms are provided in FCL as default
 enum SplitMethodType
 {
   SPLIT_METHOD_MEAN,
   SPLIT_METHOD_MEDIAN,
-  SPLIT_METHOD_BV_CENTER
+  SPLIT_METHOD_BV_CENTER,
+  SPLIT_METHOD_SAH
 };
 
 /// @brief A class describing the split rule that splits each BV node
@@ -128,6 +132,11 @@ private:
   void computeRule_median(
       const BV& bv, unsigned int* primitive_indices, int num_primitives);
 
+  /// @brief Split algorithm 4: Split the node at the bin boundary minimizing
+  /// the surface area heuristic (SAH) cost of the two children
+  void computeRule_sah(
+      const BV& bv, unsigned int* primitive_indices, int num_primitives);
+
   template <typename, typename>
   friend struct ApplyImpl;
 
@@ -139,6 +148,9 @@ private:
 
   template <typename, typename>
   friend struct ComputeRuleMedianImpl;
+
+  template <typename, typename>
+  friend struct ComputeRuleSAHImpl;
 };
 
 template <typename S, typename BV>
@@ -169,6 +181,22 @@ void computeSplitValue_median(
     const Vector3<S>& split_vector,
     S& split_value);
 
+/// @brief Binned SAH split along the three directions given by the columns of
+/// axes. Primitive centroids are binned along each direction; the bin boundary
+/// minimizing area(left) * n(left) + area(right) * n(right), with the areas
+/// measured on the primitives' boxes in the frame of axes, is returned as the
+/// column index split_axis and the projected threshold split_value.
+template <typename S>
+void computeSplitValue_sah(
+    const Matrix3<S>& axes,
+    Vector3<S>* vertices,
+    Triangle* triangles,
+    unsigned int* primitive_indices,
+    int num_primitives,
+    BVHModelType type,
+    int& split_axis,
+    S& split_value);
+
 } // namespace detail
 } // namespace fcl
 
@@ -41,6 +41,8 @@
 
 #include "fcl/geometry/shape/convex.h"
 
+#include <algorithm>
+
 namespace fcl
 {
 
@@ -66,6 +68,8 @@ Convex<S>::Convex(
     sum += vertex;
   }
   interior_point_ = sum * (S)(1.0 / vertices_->size());
+
+  buildVertexNeighbors();
 }
 
 //==============================================================================
@@ -248,6 +252,131 @@ std::vector<Vector3<S>> Convex<S>::getBoundVertices(
   return result;
 }
 
+//==============================================================================
+template <typename S>
+int Convex<S>::findExtremeVertexIndex(const Vector3<S>& dir,
+                                      int start_index) const {
+  const std::vector<Vector3<S>>& vertices = *vertices_;
+  const int num_vertices = static_cast<int>(vertices.size());
+
+  if (!find_extreme_via_neighbors_) return findExtremeVertexIndexLinear(dir);
+
+  // Move to the best neighbor as long as it improves on the current vertex.
+  // Every step strictly increases the projection, so the walk terminates.
+  int best = (start_index >= 0 && start_index < num_vertices) ? start_index : 0;
+  S max_dot = dir.dot(vertices[best]);
+  int current = -1;
+  while (current != best) {
+    current = best;
+    for (int k = neighbor_offsets_[current];
+         k < neighbor_offsets_[current + 1]; ++k) {
+      const int neighbor = neighbors_[k];
+      const S dot = dir.dot(vertices[neighbor]);
+      if (dot > max_dot) {
+        best = neighbor;
+        max_dot = dot;
+      }
+    }
+  }
+
+  // The climb stops at the first vertex of a plateau, e.g. a face normal to
+  // dir, so which tied vertex it returns depends on start_index. Visit the
+  // vertices connected to it whose projections are within rounding of the
+  // maximum and pick the one the linear scan would: the largest projection,
+  // then the smallest index. The plateau is gathered on the stack; one too
+  // large for it, i.e. a finely tessellated flat patch, is left to the linear
+  // scan.
+  const S tolerance = 16 * constants<S>::eps() * dir.norm()
+      * vertices[best].norm();
+  int plateau[kMaxPlateauSize];
+  int plateau_size = 0;
+  for (int i = 0; i <= plateau_size; ++i) {
+    const int vertex = (i == 0) ? best : plateau[i - 1];
+    for (int k = neighbor_offsets_[vertex];
+         k < neighbor_offsets_[vertex + 1]; ++k) {
+      const int neighbor = neighbors_[k];
+      const S dot = dir.dot(vertices[neighbor]);
+      if (dot < max_dot - tolerance || neighbor == best ||
+          std::find(plateau, plateau + plateau_size, neighbor) !=
+              plateau + plateau_size)
+        continue;
+      if (plateau_size == kMaxPlateauSize)
+        return findExtremeVertexIndexLinear(dir);
+      plateau[plateau_size++] = neighbor;
+    }
+  }
+  int result = best;
+  for (int i = 0; i < plateau_size; ++i) {
+    const int vertex = plateau[i];
+    const S dot = dir.dot(vertices[vertex]);
+    if (dot > max_dot || (dot == max_dot && vertex < result)) {
+      result = vertex;
+      max_dot = dot;
+    }
+  }
+  return result;
+}
+
+//==============================================================================
+template <typename S>
+int Convex<S>::findExtremeVertexIndexLinear(const Vector3<S>& dir) const {
+  const std::vector<Vector3<S>>& vertices = *vertices_;
+  const int num_vertices = static_cast<int>(vertices.size());
+
+  int best = 0;
+  S max_dot = -std::numeric_limits<S>::max();
+  for (int i = 0; i < num_vertices; ++i) {
+    const S dot = dir.dot(vertices[i]);
+    if (dot > max_dot) {
+      best = i;
+      max_dot = dot;
+    }
+  }
+  return best;
+}
+
+//==============================================================================
+template <typename S>
+void Convex<S>::buildVertexNeighbors() {
+  const std::vector<int>& faces = *faces_;
+  const int num_vertices = static_cast<int>(vertices_->size());
+
+  // Both directions of every face edge; an edge shared by two faces appears
+  // twice and is deduplicated below.
+  std::vector<std::vector<int>> adjacency(num_vertices);
+  int face_index = 0;
+  for (int i = 0; i < num_faces_; ++i) {
+    const int vertex_count = faces[face_index];
+    for (int j = 0; j < vertex_count; ++j) {
+      const int a = faces[face_index + 1 + j];
+      const int b = faces[face_index + 1 + (j + 1) % vertex_count];
+      adjacency[a].push_back(b);
+      adjacency[b].push_back(a);
+    }
+    face_index += vertex_count + 1;
+  }
+
+  neighbor_offsets_.assign(1, 0);
+  neighbor_offsets_.reserve(num_vertices + 1);
+  neighbors_.clear();
+  // Hill climbing needs the full edge graph of the polytope; a vertex with
+  // fewer than three neighbors means the faces do not provide it.
+  bool complete = true;
+  for (auto& vertex_neighbors : adjacency) {
+    std::sort(vertex_neighbors.begin(), vertex_neighbors.end());
+    vertex_neighbors.erase(
+        std::unique(vertex_neighbors.begin(), vertex_neighbors.end()),
+        vertex_neighbors.end());
+    if (vertex_neighbors.size() < 3) complete = false;
+    neighbors_.insert(neighbors_.end(), vertex_neighbors.begin(),
+                      vertex_neighbors.end());
+    neighbor_offsets_.push_back(static_cast<int>(neighbors_.size()));
+  }
+
+  find_extreme_via_neighbors_ =
+      complete && num_vertices >= kMinVertexCountForHillClimbing;
+}
+
 } // namespace fcl
 
 #endif
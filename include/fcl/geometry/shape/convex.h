@@ -117,6 +117,13 @@ public:
   /// @brief Gets the vertex positions in the geometry's frame G.
   const std::vector<Vector3<S>>& getVertices() const { return *vertices_; }
 
+  /// @brief Gets the shared vertex list, e.g. to tell whether data indexing
+  /// the vertices still refers to this list.
+  const std::shared_ptr<const std::vector<Vector3<S>>>& getSharedVertices()
+      const {
+    return vertices_;
+  }
+
   /// @brief Gets the total number of faces in the convex mesh.
   int getFaceCount() const { return num_faces_; }
 
@@ -160,6 +167,24 @@ public:
   /// a specific configuration
   std::vector<Vector3<S>> getBoundVertices(const Transform3<S>& tf) const;
 
+  /// @brief Finds the index of a vertex with the largest projection on `dir`
+  /// (the support vertex in direction `dir`).
+  ///
+  /// For polytopes with many vertices, the search climbs the vertex adjacency
+  /// graph from `start_index` to a neighbor with a larger projection until
+  /// none remains; on a convex polytope that vertex is a global maximum. The
+  /// cost is roughly O(√V) from an arbitrary start, and much less when
+  /// `start_index` is the support vertex of a nearby direction, e.g. the
+  /// previous one in a GJK or EPA iteration. Ties, e.g. for the normal of a
+  /// face, are broken as the linear scan does (the smallest index), so the
+  /// result does not depend on `start_index`. Small polytopes, and polytopes
+  /// whose faces leave a vertex with fewer than three neighbors, are scanned
+  /// linearly instead.
+  ///
+  /// @param dir          The direction in the geometry's frame G.
+  /// @param start_index  The vertex to start from; ignored if out of range.
+  int findExtremeVertexIndex(const Vector3<S>& dir, int start_index = 0) const;
+
   friend
   std::ostream& operator<<(std::ostream& out, const Convex& convex) {
     out << "Convex(v count: " << convex.vertices_->size() << ", f count: "
@@ -172,6 +197,28 @@ private:
   const int num_faces_;
   const std::shared_ptr<const std::vector<int>> faces_;
   Vector3<S> interior_point_;
+
+  // Builds the vertex adjacency graph from the face edges.
+  void buildVertexNeighbors();
+
+  // The vertex with the largest projection on dir, found by visiting them
+  // all; ties go to the smallest index.
+  int findExtremeVertexIndexLinear(const Vector3<S>& dir) const;
+
+  // The neighbors of vertex i are neighbors_[neighbor_offsets_[i]] to
+  // neighbors_[neighbor_offsets_[i + 1] - 1].
+  std::vector<int> neighbor_offsets_;
+  std::vector<int> neighbors_;
+
+  // Whether findExtremeVertexIndex() climbs the adjacency graph.
+  bool find_extreme_via_neighbors_{false};
+
+  // The vertex count below which a linear scan beats hill climbing.
+  static constexpr int kMinVertexCountForHillClimbing = 32;
+
+  // The largest plateau findExtremeVertexIndex() resolves by climbing; larger
+  // ones fall back to the linear scan.
+  static constexpr int kMaxPlateauSize = 64;
 };
 
 // Workaround for https://gcc.gnu.org/bugzilla/show_bug.cgi?id=57728 which
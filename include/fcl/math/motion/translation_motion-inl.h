@@ -40,8 +40,6 @@
 
 #include "fcl/math/motion/translation_motion.h"
 
-#include "fcl/common/unused.h"
-
 namespace fcl
 {
 
@@ -115,11 +113,13 @@ void TranslationMotion<S>::getCurrentTransform(Transform3<S>& tf_) const
 template <typename S>
 void TranslationMotion<S>::getTaylorModel(TMatrix3<S>& tm, TVector3<S>& tv) const
 {
-  FCL_UNUSED(tm);
-  FCL_UNUSED(tv);
+  tm = TMatrix3<S>(rot.toRotationMatrix(), this->getTimeInterval());
 
-  // Do nothing
-  // TODO(JS): Not implemented?
+  TaylorModel<S> a(this->getTimeInterval()), b(this->getTimeInterval()), c(this->getTimeInterval());
+  generateTaylorModelForLinearFunc(a, trans_start[0], trans_range[0]);
+  generateTaylorModelForLinearFunc(b, trans_start[1], trans_range[1]);
+  generateTaylorModelForLinearFunc(c, trans_start[2], trans_range[2]);
+  tv = TVector3<S>(a, b, c);
 }
 
 //==============================================================================
@@ -67,6 +67,50 @@ std::size_t collide(
     const CollisionRequest<double>& request,
     CollisionResult<double>& result);
 
+//==============================================================================
+extern template
+FCL_EXPORT
+std::size_t collide(
+    const CollisionObject<double>* o1,
+    const CollisionObject<double>* o2,
+    const CollisionRequest<double>& request,
+    CollisionResult<double>& result,
+    QueryContext<double>& context);
+
+//==============================================================================
+extern template
+FCL_EXPORT
+std::size_t collide(
+    const CollisionGeometry<double>* o1,
+    const Transform3<double>& tf1,
+    const CollisionGeometry<double>* o2,
+    const Transform3<double>& tf2,
+    const CollisionRequest<double>& request,
+    CollisionResult<double>& result,
+    QueryContext<double>& context);
+
+//==============================================================================
+extern template
+FCL_EXPORT
+std::size_t collide(
+    const CollisionObject<double>* o1,
+    const CollisionObject<double>* o2,
+    const CollisionRequest<double>& request,
+    CollisionResult<double>& result,
+    GJKSimplexCache<double>& cache);
+
+//==============================================================================
+extern template
+FCL_EXPORT
+std::size_t collide(
+    const CollisionGeometry<double>* o1,
+    const Transform3<double>& tf1,
+    const CollisionGeometry<double>* o2,
+    const Transform3<double>& tf2,
+    const CollisionRequest<double>& request,
+    CollisionResult<double>& result,
+    GJKSimplexCache<double>& cache);
+
 //==============================================================================
 template<typename GJKSolver>
 detail::CollisionFunctionMatrix<GJKSolver>& getCollisionFunctionLookTable()
@@ -206,6 +250,97 @@ std::size_t collide(
   }
 }
 
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+std::size_t collide(const CollisionObject<S>* o1, const CollisionObject<S>* o2,
+                    const CollisionRequest<S>& request, CollisionResult<S>& result,
+                    QueryContext<S>& context)
+{
+  switch(request.gjk_solver_type)
+  {
+  case GST_LIBCCD:
+    return collide(o1, o2, &context.getLibccdSolver(request), request, result);
+  case GST_INDEP:
+    return collide(o1, o2, &context.getIndepSolver(request), request, result);
+  default:
+    return -1; // error
+  }
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+std::size_t collide(
+    const CollisionGeometry<S>* o1,
+    const Transform3<S>& tf1,
+    const CollisionGeometry<S>* o2,
+    const Transform3<S>& tf2,
+    const CollisionRequest<S>& request,
+    CollisionResult<S>& result,
+    QueryContext<S>& context)
+{
+  switch(request.gjk_solver_type)
+  {
+  case GST_LIBCCD:
+    return collide(o1, tf1, o2, tf2, &context.getLibccdSolver(request),
+                   request, result);
+  case GST_INDEP:
+    return collide(o1, tf1, o2, tf2, &context.getIndepSolver(request),
+                   request, result);
+  default:
+    std::cerr << "Warning! Invalid GJK solver" << std::endl;
+    return -1; // error
+  }
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+std::size_t collide(const CollisionObject<S>* o1, const CollisionObject<S>* o2,
+                    const CollisionRequest<S>& request,
+                    CollisionResult<S>& result,
+                    GJKSimplexCache<S>& cache)
+{
+  return collide(o1->collisionGeometry().get(), o1->getTransform(),
+                 o2->collisionGeometry().get(), o2->getTransform(),
+                 request, result, cache);
+}
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+std::size_t collide(
+    const CollisionGeometry<S>* o1,
+    const Transform3<S>& tf1,
+    const CollisionGeometry<S>* o2,
+    const Transform3<S>& tf2,
+    const CollisionRequest<S>& request,
+    CollisionResult<S>& result,
+    GJKSimplexCache<S>& cache)
+{
+  switch(request.gjk_solver_type)
+  {
+  case GST_LIBCCD:
+    {
+      detail::GJKSolver_libccd<S> solver;
+      solver.collision_tolerance = request.gjk_tolerance;
+      return collide(o1, tf1, o2, tf2, &solver, request, result);
+    }
+  case GST_INDEP:
+    {
+      detail::GJKSolver_indep<S> solver;
+      solver.gjk_tolerance = request.gjk_tolerance;
+      solver.epa_tolerance = request.gjk_tolerance;
+      solver.gjk_simplex_cache = &cache;
+      return collide(o1, tf1, o2, tf2, &solver, request, result);
+    }
+  default:
+    std::cerr << "Warning! Invalid GJK solver" << std::endl;
+    return -1; // error
+  }
+}
+
 } // namespace fcl
 
 #endif
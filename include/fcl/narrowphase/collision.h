@@ -41,6 +41,8 @@
 #include "fcl/narrowphase/collision_object.h"
 #include "fcl/narrowphase/collision_request.h"
 #include "fcl/narrowphase/collision_result.h"
+#include "fcl/narrowphase/gjk_simplex_cache.h"
+#include "fcl/narrowphase/query_context.h"
 
 namespace fcl
 {
@@ -65,6 +67,41 @@ std::size_t collide(const CollisionGeometry<S>* o1, const Transform3<S>& tf1,
                     const CollisionRequest<S>& request,
                     CollisionResult<S>& result);
 
+/// @brief Same as collide() above, but reuses the solver and scratch storage
+/// held by context instead of setting them up for every call
+template <typename S>
+FCL_EXPORT
+std::size_t collide(const CollisionObject<S>* o1, const CollisionObject<S>* o2,
+                    const CollisionRequest<S>& request,
+                    CollisionResult<S>& result,
+                    QueryContext<S>& context);
+
+template <typename S>
+FCL_EXPORT
+std::size_t collide(const CollisionGeometry<S>* o1, const Transform3<S>& tf1,
+                    const CollisionGeometry<S>* o2, const Transform3<S>& tf2,
+                    const CollisionRequest<S>& request,
+                    CollisionResult<S>& result,
+                    QueryContext<S>& context);
+
+/// @brief Same as collide() above for a pair of objects queried over and
+/// over, e.g., every control cycle: GJK starts from the simplex that the
+/// previous query with the same cache ended with. See GJKSimplexCache.
+template <typename S>
+FCL_EXPORT
+std::size_t collide(const CollisionObject<S>* o1, const CollisionObject<S>* o2,
+                    const CollisionRequest<S>& request,
+                    CollisionResult<S>& result,
+                    GJKSimplexCache<S>& cache);
+
+template <typename S>
+FCL_EXPORT
+std::size_t collide(const CollisionGeometry<S>* o1, const Transform3<S>& tf1,
+                    const CollisionGeometry<S>* o2, const Transform3<S>& tf2,
+                    const CollisionRequest<S>& request,
+                    CollisionResult<S>& result,
+                    GJKSimplexCache<S>& cache);
+
 } // namespace fcl
 
 #include "fcl/narrowphase/collision-inl.h"
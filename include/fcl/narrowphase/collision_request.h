@@ -93,6 +93,17 @@ struct FCL_EXPORT CollisionRequest
   /// a value that is consistent with the precision of `S`.
   Real gjk_tolerance{1e-6};
 
+  /// @brief If true, mesh-mesh queries split the traversal of the bounding
+  /// volume test tree into subtasks that run on a thread pool. The contacts
+  /// found are the same, but their order (and, when num_max_contacts stops the
+  /// query early, their selection) may differ from the serial traversal.
+  bool enable_parallel_traversal{false};
+
+  /// @brief Number of threads used by the parallel traversal, including the
+  /// calling thread; 0 means one thread per hardware core. All the queries
+  /// share one pool, and a query finding it in use traverses serially.
+  unsigned int num_traversal_threads{0};
+
   /// @brief Default constructor
   CollisionRequest(size_t num_max_contacts_ = 1,
                    bool enable_contact_ = false,
@@ -40,16 +40,27 @@
 
 #include "fcl/narrowphase/continuous_collision.h"
 
+#include <atomic>
+#include <cassert>
+#include <memory>
+
 #include "fcl/common/unused.h"
+#include "fcl/math/constants.h"
 
 #include "fcl/math/motion/translation_motion.h"
 #include "fcl/math/motion/interp_motion.h"
 #include "fcl/math/motion/screw_motion.h"
 #include "fcl/math/motion/spline_motion.h"
+#include "fcl/math/motion/tbv_motion_bound_visitor.h"
+
+#include "fcl/geometry/shape/utility.h"
 
 #include "fcl/narrowphase/collision.h"
 #include "fcl/narrowphase/collision_result.h"
+#include "fcl/narrowphase/distance.h"
 #include "fcl/narrowphase/detail/traversal/collision_node.h"
+#include "fcl/narrowphase/detail/traversal/parallel_traversal.h"
+#include "fcl/narrowphase/detail/convexity_based_algorithm/gjk_raycast.h"
 
 namespace fcl
 {
@@ -86,6 +97,16 @@ double continuousCollide(
     const ContinuousCollisionRequest<double>& request,
     ContinuousCollisionResult<double>& result);
 
+//==============================================================================
+extern template
+double continuousCollideTrajectory(
+    const CollisionObject<double>* o1,
+    const aligned_vector<Transform3<double>>& waypoints1,
+    const CollisionObject<double>* o2,
+    const aligned_vector<Transform3<double>>& waypoints2,
+    const ContinuousCollisionRequest<double>& request,
+    TrajectoryCollisionResult<double>& result);
+
 //==============================================================================
 extern template
 double collide(
@@ -130,6 +151,268 @@ MotionBasePtr<S> getMotionBase(
   }
 }
 
+namespace detail
+{
+
+//==============================================================================
+template <typename BV>
+FCL_EXPORT
+void computeBVHModelLocalAABB(
+    const CollisionGeometry<typename BV::S>* geom, AABB<typename BV::S>& aabb)
+{
+  const BVHModel<BV>* model = static_cast<const BVHModel<BV>*>(geom);
+
+  aabb = AABB<typename BV::S>();
+  for(int i = 0; i < model->num_vertices; ++i)
+    aabb += model->vertices[i];
+}
+
+//==============================================================================
+template <typename Shape>
+FCL_EXPORT
+void computeShapeLocalAABB(
+    const CollisionGeometry<typename Shape::S>* geom,
+    AABB<typename Shape::S>& aabb)
+{
+  using S = typename Shape::S;
+
+  computeBV(*static_cast<const Shape*>(geom), Transform3<S>::Identity(), aabb);
+}
+
+//==============================================================================
+/// @brief Compute a bound of the geometry in its local frame without touching
+/// its cached aabb_local, which is only set up by CollisionObject. Returns
+/// false for unbounded or unsupported geometry.
+template <typename S>
+FCL_EXPORT
+bool computeLocalAABB(const CollisionGeometry<S>* geom, AABB<S>& aabb)
+{
+  switch(geom->getNodeType())
+  {
+  case BV_AABB:
+    computeBVHModelLocalAABB<AABB<S>>(geom, aabb);
+    break;
+  case BV_OBB:
+    computeBVHModelLocalAABB<OBB<S>>(geom, aabb);
+    break;
+  case BV_RSS:
+    computeBVHModelLocalAABB<RSS<S>>(geom, aabb);
+    break;
+  case BV_kIOS:
+    computeBVHModelLocalAABB<kIOS<S>>(geom, aabb);
+    break;
+  case BV_OBBRSS:
+    computeBVHModelLocalAABB<OBBRSS<S>>(geom, aabb);
+    break;
+  case BV_KDOP16:
+    computeBVHModelLocalAABB<KDOP<S, 16>>(geom, aabb);
+    break;
+  case BV_KDOP18:
+    computeBVHModelLocalAABB<KDOP<S, 18>>(geom, aabb);
+    break;
+  case BV_KDOP24:
+    computeBVHModelLocalAABB<KDOP<S, 24>>(geom, aabb);
+    break;
+  case GEOM_BOX:
+    computeShapeLocalAABB<Box<S>>(geom, aabb);
+    break;
+  case GEOM_SPHERE:
+    computeShapeLocalAABB<Sphere<S>>(geom, aabb);
+    break;
+  case GEOM_ELLIPSOID:
+    computeShapeLocalAABB<Ellipsoid<S>>(geom, aabb);
+    break;
+  case GEOM_CAPSULE:
+    computeShapeLocalAABB<Capsule<S>>(geom, aabb);
+    break;
+  case GEOM_CONE:
+    computeShapeLocalAABB<Cone<S>>(geom, aabb);
+    break;
+  case GEOM_CYLINDER:
+    computeShapeLocalAABB<Cylinder<S>>(geom, aabb);
+    break;
+  case GEOM_CONVEX:
+    computeShapeLocalAABB<Convex<S>>(geom, aabb);
+    break;
+  case GEOM_TRIANGLE:
+    computeShapeLocalAABB<TriangleP<S>>(geom, aabb);
+    break;
+  default:
+    return false;
+  }
+
+  return (aabb.min_.array() <= aabb.max_.array()).all();
+}
+
+//==============================================================================
+/// @brief Upper bound on how far any point inside the box, given in the local
+/// frame of the moving object, travels per unit of motion time from the
+/// current time of the motion on. The directional motion bounds are taken
+/// along the signed world axes and combined, so the bound is direction-free
+/// and holds for non-convex geometry too.
+template <typename S>
+FCL_EXPORT
+S computeMaxDisplacementRate(const MotionBase<S>* motion, const AABB<S>& aabb)
+{
+  // RSS covering the box: a rectangle through its middle, swept by a sphere
+  // of half its depth
+  RSS<S> bv;
+  bv.axis.setIdentity();
+  bv.To << aabb.min_[0], aabb.min_[1], aabb.center()[2];
+  bv.l[0] = aabb.width();
+  bv.l[1] = aabb.height();
+  bv.r = 0.5 * aabb.depth();
+
+  S bound = 0;
+  for(int i = 0; i < 3; ++i)
+  {
+    const Vector3<S> n = Vector3<S>::Unit(i);
+    const S positive = motion->computeMotionBound(
+          TBVMotionBoundVisitor<RSS<S>>(bv, n));
+    const S negative = motion->computeMotionBound(
+          TBVMotionBoundVisitor<RSS<S>>(bv, -n));
+    const S axis_bound = std::max(std::max(positive, negative), S(0));
+    bound += axis_bound * axis_bound;
+  }
+
+  return std::sqrt(bound);
+}
+
+//==============================================================================
+/// @brief Move both objects to time t and test them for collision
+template <typename S>
+FCL_EXPORT
+bool collideAtTime(
+    const CollisionGeometry<S>* o1,
+    const MotionBase<S>* motion1,
+    const CollisionGeometry<S>* o2,
+    const MotionBase<S>* motion2,
+    S t,
+    const CollisionRequest<S>& request,
+    CollisionResult<S>& result,
+    QueryContext<S>& context,
+    Transform3<S>& tf1,
+    Transform3<S>& tf2)
+{
+  motion1->integrate(t);
+  motion2->integrate(t);
+
+  motion1->getCurrentTransform(tf1);
+  motion2->getCurrentTransform(tf2);
+
+  result.clear();
+  return collide(o1, tf1, o2, tf2, request, result, context) > 0;
+}
+
+//==============================================================================
+/// @brief Adaptive variant of continuousCollideNaive().
+///
+/// Walks the same grid of samples, but from every collision-free time t it
+/// first certifies [t, t + d / v] as collision-free, where d is the distance
+/// between the objects at t and v bounds how fast they can approach each
+/// other. A sample is only tested if the certified interval stops short of
+/// it. Once a sample collides, the first contact is bisected between the last
+/// certified time and that sample down to toc_err.
+template <typename S>
+FCL_EXPORT
+S continuousCollideNaiveAdaptive(
+    const CollisionGeometry<S>* o1,
+    const MotionBase<S>* motion1,
+    const CollisionGeometry<S>* o2,
+    const MotionBase<S>* motion2,
+    const ContinuousCollisionRequest<S>& request,
+    ContinuousCollisionResult<S>& result)
+{
+  std::size_t n_iter = std::min(request.num_max_iterations, (std::size_t)ceil(1 / request.toc_err));
+  const S step = (n_iter > 1) ? 1 / (S) (n_iter - 1) : S(1);
+
+  AABB<S> aabb1;
+  AABB<S> aabb2;
+  const bool bounded
+      = computeLocalAABB(o1, aabb1) && computeLocalAABB(o2, aabb2);
+
+  QueryContext<S> context;
+  CollisionRequest<S> c_request;
+  c_request.gjk_solver_type = request.gjk_solver_type;
+  CollisionResult<S> c_result;
+  DistanceRequest<S> d_request;
+  d_request.gjk_solver_type = request.gjk_solver_type;
+  DistanceResult<S> d_result;
+
+  Transform3<S> cur_tf1, cur_tf2;
+  S t = 0;
+  S t_free = 0;
+  bool is_collide = collideAtTime(o1, motion1, o2, motion2, t, c_request,
+                                  c_result, context, cur_tf1, cur_tf2);
+
+  while(!is_collide && t < 1)
+  {
+    // The motions and cur_tf1/cur_tf2 are at the collision-free time t here.
+    t_free = t;
+    if(bounded)
+    {
+      d_result.clear();
+      const S d = std::max(
+            distance(o1, cur_tf1, o2, cur_tf2, d_request, d_result, context),
+            S(0));
+      const S rate = computeMaxDisplacementRate(motion1, aabb1)
+          + computeMaxDisplacementRate(motion2, aabb2);
+
+      if(rate <= d)
+        break;
+
+      t_free = std::min(t + d / rate, S(1));
+    }
+
+    const S next = std::min(std::max(t_free, t + step), S(1));
+    if(next <= t_free)
+    {
+      motion1->integrate(next);
+      motion2->integrate(next);
+      motion1->getCurrentTransform(cur_tf1);
+      motion2->getCurrentTransform(cur_tf2);
+    }
+    else
+    {
+      is_collide = collideAtTime(o1, motion1, o2, motion2, next, c_request,
+                                 c_result, context, cur_tf1, cur_tf2);
+    }
+    t = next;
+  }
+
+  if(!is_collide)
+  {
+    result.is_collide = false;
+    result.time_of_contact = S(1);
+    return result.time_of_contact;
+  }
+
+  // Bisect [t_free, t], keeping t as the earliest colliding time found
+  S lo = t_free;
+  while(t - lo > request.toc_err)
+  {
+    const S mid = 0.5 * (lo + t);
+    if(collideAtTime(o1, motion1, o2, motion2, mid, c_request, c_result,
+                     context, cur_tf1, cur_tf2))
+      t = mid;
+    else
+      lo = mid;
+  }
+
+  motion1->integrate(t);
+  motion2->integrate(t);
+  motion1->getCurrentTransform(cur_tf1);
+  motion2->getCurrentTransform(cur_tf2);
+
+  result.is_collide = true;
+  result.time_of_contact = t;
+  result.contact_tf1 = cur_tf1;
+  result.contact_tf2 = cur_tf2;
+  return t;
+}
+
+} // namespace detail
+
 //==============================================================================
 template <typename S>
 FCL_EXPORT
@@ -141,21 +424,26 @@ S continuousCollideNaive(
     const ContinuousCollisionRequest<S>& request,
     ContinuousCollisionResult<S>& result)
 {
+  if(request.use_adaptive_sampling)
+  {
+    return detail::continuousCollideNaiveAdaptive(
+          o1, motion1, o2, motion2, request, result);
+  }
+
   std::size_t n_iter = std::min(request.num_max_iterations, (std::size_t)ceil(1 / request.toc_err));
   Transform3<S> cur_tf1, cur_tf2;
+
+  // All samples share one solver and one result buffer.
+  QueryContext<S> context;
+  CollisionRequest<S> c_request;
+  CollisionResult<S> c_result;
+
   for(std::size_t i = 0; i < n_iter; ++i)
   {
     S t = i / (S) (n_iter - 1);
-    motion1->integrate(t);
-    motion2->integrate(t);
-
-    motion1->getCurrentTransform(cur_tf1);
-    motion2->getCurrentTransform(cur_tf2);
 
-    CollisionRequest<S> c_request;
-    CollisionResult<S> c_result;
-
-    if(collide(o1, cur_tf1, o2, cur_tf2, c_request, c_result))
+    if(detail::collideAtTime(o1, motion1, o2, motion2, t, c_request, c_result,
+                             context, cur_tf1, cur_tf2))
     {
       result.is_collide = true;
       result.time_of_contact = t;
@@ -188,12 +476,12 @@ typename BV::S continuousCollideBVHPolynomial(
 
   using S = typename BV::S;
 
-  const BVHModel<BV>* o1__ = static_cast<const BVHModel<BV>*>(o1_);
-  const BVHModel<BV>* o2__ = static_cast<const BVHModel<BV>*>(o2_);
+  const BVHModel<BV>* o1 = static_cast<const BVHModel<BV>*>(o1_);
+  const BVHModel<BV>* o2 = static_cast<const BVHModel<BV>*>(o2_);
 
-  // ugly, but lets do it now.
-  BVHModel<BV>* o1 = const_cast<BVHModel<BV>*>(o1__);
-  BVHModel<BV>* o2 = const_cast<BVHModel<BV>*>(o2__);
+  // The end-of-motion vertices and the BVs bounding the swept primitives live
+  // in per-query overlays, so the models are shared read-only and concurrent
+  // queries on the same geometry are safe.
   std::vector<Vector3<S>> new_v1(o1->num_vertices);
   std::vector<Vector3<S>> new_v2(o2->num_vertices);
 
@@ -202,13 +490,10 @@ typename BV::S continuousCollideBVHPolynomial(
   for(std::size_t i = 0; i < new_v2.size(); ++i)
     new_v2[i] = o2->vertices[i] + motion2->getVelocity();
 
-  o1->beginUpdateModel();
-  o1->updateSubModel(new_v1);
-  o1->endUpdateModel(true, true);
-
-  o2->beginUpdateModel();
-  o2->updateSubModel(new_v2);
-  o2->endUpdateModel(true, true);
+  std::vector<BV> swept_bvs1;
+  std::vector<BV> swept_bvs2;
+  computeSweptBVs(*o1, new_v1.data(), swept_bvs1);
+  computeSweptBVs(*o2, new_v2.data(), swept_bvs2);
 
   MeshContinuousCollisionTraversalNode<BV> node;
   CollisionRequest<S> c_request;
@@ -219,7 +504,8 @@ typename BV::S continuousCollideBVHPolynomial(
   Transform3<S> tf2;
   motion1->getCurrentTransform(tf1);
   motion2->getCurrentTransform(tf2);
-  if(!initialize<BV>(node, *o1, tf1, *o2, tf2, c_request))
+  if(!initialize<BV>(node, *o1, tf1, new_v1.data(), swept_bvs1,
+                     *o2, tf2, new_v2.data(), swept_bvs2, c_request))
     return -1.0;
 
   collide(&node);
@@ -381,6 +667,72 @@ S continuousCollideConservativeAdvancement(
   }
 }
 
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+S continuousCollideRayShooting(
+    const CollisionGeometry<S>* o1,
+    const TranslationMotion<S>* motion1,
+    const CollisionGeometry<S>* o2,
+    const TranslationMotion<S>* motion2,
+    const ContinuousCollisionRequest<S>& request,
+    ContinuousCollisionResult<S>& result)
+{
+  for(NODE_TYPE node_type : {o1->getNodeType(), o2->getNodeType()})
+  {
+    if(node_type == GEOM_PLANE || node_type == GEOM_HALFSPACE)
+    {
+      std::cerr << "Warning: ray shooting CCD does not support node type " << node_type << std::endl;
+      return -1;
+    }
+  }
+
+  Transform3<S> tf1;
+  Transform3<S> tf2;
+  motion1->integrate(0);
+  motion2->integrate(0);
+  motion1->getCurrentTransform(tf1);
+  motion2->getCurrentTransform(tf2);
+
+  detail::MinkowskiDiff<S> shape;
+  shape.shapes[0] = static_cast<const ShapeBase<S>*>(o1);
+  shape.shapes[1] = static_cast<const ShapeBase<S>*>(o2);
+  shape.toshape1.noalias() = tf2.linear().transpose() * tf1.linear();
+  shape.toshape0 = tf1.inverse(Eigen::Isometry) * tf2;
+
+  // Translation of o2 relative to o1 over the motion, in o1's frame; the time
+  // error maps to a distance error along it.
+  const Vector3<S> ray = tf1.linear().transpose()
+      * (motion2->getVelocity() - motion1->getVelocity());
+  const S tolerance = std::max(request.toc_err * ray.norm(),
+                               constants<S>::eps_34());
+
+  // num_max_iterations defaults to the handful of samples meant for the naive
+  // solver; curved shapes need a few dozen support evaluations to converge.
+  const unsigned int max_iterations = static_cast<unsigned int>(
+      std::max<std::size_t>(request.num_max_iterations, 64));
+
+  S toi;
+  Vector3<S> normal;
+  if(detail::gjkRaycast(shape, ray, tolerance, max_iterations, toi, normal))
+  {
+    motion1->integrate(toi);
+    motion2->integrate(toi);
+    motion1->getCurrentTransform(tf1);
+    motion2->getCurrentTransform(tf2);
+
+    result.is_collide = true;
+    result.time_of_contact = toi;
+    result.contact_tf1 = tf1;
+    result.contact_tf2 = tf2;
+    return toi;
+  }
+
+  result.is_collide = false;
+  result.time_of_contact = S(1);
+  return result.time_of_contact;
+}
+
 //==============================================================================
 template <typename S>
 FCL_EXPORT
@@ -409,7 +761,9 @@ S continuousCollide(
   case CCDC_RAY_SHOOTING:
     if(o1->getObjectType() == OT_GEOM && o2->getObjectType() == OT_GEOM && request.ccd_motion_type == CCDM_TRANS)
     {
-
+      return continuousCollideRayShooting(o1, (const TranslationMotion<S>*)motion1,
+                                          o2, (const TranslationMotion<S>*)motion2,
+                                          request, result);
     }
     else
       std::cerr << "Warning! Invalid continuous collision setting" << std::endl;
@@ -466,6 +820,199 @@ S continuousCollide(
                            request, result);
 }
 
+namespace detail
+{
+
+//==============================================================================
+/// @brief Check one trajectory segment, with the motions kept on the stack
+/// instead of being allocated by getMotionBase()
+template <typename Motion, typename S>
+FCL_EXPORT
+void continuousCollideSegment(
+    const CollisionGeometry<S>* o1,
+    const Transform3<S>& tf1_beg,
+    const Transform3<S>& tf1_end,
+    const CollisionGeometry<S>* o2,
+    const Transform3<S>& tf2_beg,
+    const Transform3<S>& tf2_end,
+    const ContinuousCollisionRequest<S>& request,
+    ContinuousCollisionResult<S>& result)
+{
+  const Motion motion1(tf1_beg, tf1_end);
+  const Motion motion2(tf2_beg, tf2_end);
+
+  continuousCollide(o1, &motion1, o2, &motion2, request, result);
+}
+
+//==============================================================================
+/// @brief Compute the bounding box of every waypoint that contains the object
+/// placed with any rotation at that waypoint. Under translation and linear
+/// interpolation the object's origin moves along the straight segment, so
+/// the union of two adjacent boxes bounds the volume swept by the segment
+/// between them, and each box serves both segments it ends.
+template <typename S>
+FCL_EXPORT
+void computeWaypointAABBs(
+    const AABB<S>& local_aabb,
+    const aligned_vector<Transform3<S>>& waypoints,
+    std::size_t num_waypoints,
+    std::vector<AABB<S>>& aabbs)
+{
+  const S radius = local_aabb.min_.cwiseAbs().cwiseMax(
+        local_aabb.max_.cwiseAbs()).norm();
+  const Vector3<S> extent = Vector3<S>::Constant(radius);
+
+  aabbs.resize(num_waypoints);
+  for(std::size_t i = 0; i < num_waypoints; ++i)
+  {
+    const Vector3<S>& T
+        = waypoints[std::min(i, waypoints.size() - 1)].translation();
+    aabbs[i] = AABB<S>(T - extent, T + extent);
+  }
+}
+
+} // namespace detail
+
+//==============================================================================
+template <typename S>
+FCL_EXPORT
+S continuousCollideTrajectory(
+    const CollisionObject<S>* o1,
+    const aligned_vector<Transform3<S>>& waypoints1,
+    const CollisionObject<S>* o2,
+    const aligned_vector<Transform3<S>>& waypoints2,
+    const ContinuousCollisionRequest<S>& request,
+    TrajectoryCollisionResult<S>& result)
+{
+  result = TrajectoryCollisionResult<S>();
+
+  const std::size_t n1 = waypoints1.size();
+  const std::size_t n2 = waypoints2.size();
+  if(n1 == 0 || n2 == 0 || (n1 != n2 && n1 != 1 && n2 != 1))
+  {
+    std::cerr << "Warning: trajectories with " << n1 << " and " << n2
+              << " waypoints can not be checked against each other" << std::endl;
+    return -1;
+  }
+
+  const std::size_t num_segments = std::max(std::max(n1, n2), std::size_t(2)) - 1;
+  const CollisionGeometry<S>* g1 = o1->collisionGeometry().get();
+  const CollisionGeometry<S>* g2 = o2->collisionGeometry().get();
+
+  const auto waypoint1 = [&](std::size_t i) -> const Transform3<S>&
+  {
+    return waypoints1[std::min(i, n1 - 1)];
+  };
+  const auto waypoint2 = [&](std::size_t i) -> const Transform3<S>&
+  {
+    return waypoints2[std::min(i, n2 - 1)];
+  };
+
+  // Segments whose swept volumes are apart are skipped without building any
+  // motion. The waypoint bounds are computed once and shared by the two
+  // segments meeting at each waypoint.
+  AABB<S> local_aabb1;
+  AABB<S> local_aabb2;
+  std::vector<AABB<S>> waypoint_aabbs1;
+  std::vector<AABB<S>> waypoint_aabbs2;
+  const bool cull = (request.ccd_motion_type == CCDM_TRANS
+                     || request.ccd_motion_type == CCDM_LINEAR)
+      && detail::computeLocalAABB(g1, local_aabb1)
+      && detail::computeLocalAABB(g2, local_aabb2);
+  if(cull)
+  {
+    detail::computeWaypointAABBs(
+          local_aabb1, waypoints1, num_segments + 1, waypoint_aabbs1);
+    detail::computeWaypointAABBs(
+          local_aabb2, waypoints2, num_segments + 1, waypoint_aabbs2);
+  }
+
+  aligned_vector<ContinuousCollisionResult<S>> segment_results(num_segments);
+  std::atomic<std::size_t> first_hit(num_segments);
+
+  const auto check_segment = [&](std::size_t i)
+  {
+    // A segment after a known contact can not be the earliest one.
+    if(i > first_hit.load())
+      return;
+
+    if(cull)
+    {
+      const AABB<S> swept1 = waypoint_aabbs1[i] + waypoint_aabbs1[i + 1];
+      const AABB<S> swept2 = waypoint_aabbs2[i] + waypoint_aabbs2[i + 1];
+      if(!swept1.overlap(swept2))
+        return;
+    }
+
+    ContinuousCollisionResult<S>& segment_result = segment_results[i];
+    switch(request.ccd_motion_type)
+    {
+    case CCDM_TRANS:
+      detail::continuousCollideSegment<TranslationMotion<S>>(
+            g1, waypoint1(i), waypoint1(i + 1), g2, waypoint2(i), waypoint2(i + 1),
+            request, segment_result);
+      break;
+    case CCDM_LINEAR:
+      detail::continuousCollideSegment<InterpMotion<S>>(
+            g1, waypoint1(i), waypoint1(i + 1), g2, waypoint2(i), waypoint2(i + 1),
+            request, segment_result);
+      break;
+    case CCDM_SCREW:
+      detail::continuousCollideSegment<ScrewMotion<S>>(
+            g1, waypoint1(i), waypoint1(i + 1), g2, waypoint2(i), waypoint2(i + 1),
+            request, segment_result);
+      break;
+    case CCDM_SPLINE:
+      detail::continuousCollideSegment<SplineMotion<S>>(
+            g1, waypoint1(i), waypoint1(i + 1), g2, waypoint2(i), waypoint2(i + 1),
+            request, segment_result);
+      break;
+    default:
+      return;
+    }
+
+    if(segment_result.is_collide)
+    {
+      std::size_t current = first_hit.load();
+      while(i < current && !first_hit.compare_exchange_weak(current, i))
+        ;
+    }
+  };
+
+  std::shared_ptr<detail::ThreadPool> pool;
+  if(num_segments > 1)
+    pool = detail::acquireTraversalThreadPool(request.num_trajectory_threads);
+
+  if(!pool)
+  {
+    for(std::size_t i = 0; i < num_segments && first_hit.load() == num_segments; ++i)
+      check_segment(i);
+  }
+  else
+  {
+    pool->run(num_segments, [&](std::size_t task, unsigned int)
+    {
+      check_segment(task);
+    });
+  }
+
+  const std::size_t segment = first_hit.load();
+  if(segment == num_segments)
+  {
+    assert(!result.is_collide && result.segment == -1);
+    return static_cast<S>(num_segments);
+  }
+
+  const ContinuousCollisionResult<S>& segment_result = segment_results[segment];
+  result.is_collide = true;
+  result.segment = static_cast<int>(segment);
+  result.time_of_contact = segment_result.time_of_contact;
+  result.contact_tf1 = segment_result.contact_tf1;
+  result.contact_tf2 = segment_result.contact_tf2;
+
+  return segment + result.time_of_contact;
+}
+
 //==============================================================================
 template <typename S>
 FCL_EXPORT
@@ -82,6 +82,25 @@ S continuousCollide(
     const ContinuousCollisionRequest<S>& request,
     ContinuousCollisionResult<S>& result);
 
+/// @brief Continuous collision checking between two objects moving along
+/// piecewise-linear trajectories. Segment i moves each object from
+/// waypoints[i] to waypoints[i + 1] with request.ccd_motion_type; both
+/// trajectories must have the same number of waypoints, except that a single
+/// waypoint keeps its object in place. The segments are checked with the
+/// request's solver, on request.num_trajectory_threads threads, and the
+/// earliest colliding one is reported. Returns the trajectory time of the
+/// contact, segment + time_of_contact, the number of segments if the
+/// trajectories are collision-free, or -1 on invalid input.
+template <typename S>
+FCL_EXPORT
+S continuousCollideTrajectory(
+    const CollisionObject<S>* o1,
+    const aligned_vector<Transform3<S>>& waypoints1,
+    const CollisionObject<S>* o2,
+    const aligned_vector<Transform3<S>>& waypoints2,
+    const ContinuousCollisionRequest<S>& request,
+    TrajectoryCollisionResult<S>& result);
+
 template <typename S>
 FCL_EXPORT
 S collide(
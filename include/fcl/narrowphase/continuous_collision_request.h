@@ -65,12 +65,26 @@ struct FCL_EXPORT ContinuousCollisionRequest
 
   /// @brief ccd solver type
   CCDSolverType ccd_solver_type;
+
+  /// @brief Whether CCDC_NAIVE skips the intervals that distance queries and
+  /// motion bounds prove collision-free, and bisects the first contact down
+  /// to toc_err, instead of testing every one of its num_max_iterations
+  /// uniform samples
+  bool use_adaptive_sampling;
+
+  /// @brief Number of threads continuousCollideTrajectory() checks segments
+  /// on; 0 means one per hardware core and 1 checks them serially. The
+  /// threads come from the pool shared with the parallel traversals, and the
+  /// segments are checked serially while another query holds it.
+  unsigned int num_trajectory_threads;
   
   ContinuousCollisionRequest(std::size_t num_max_iterations_ = 10,
                              S toc_err_ = 0.0001,
                              CCDMotionType ccd_motion_type_ = CCDM_TRANS,
                              GJKSolverType gjk_solver_type_ = GST_LIBCCD,
-                             CCDSolverType ccd_solver_type_ = CCDC_NAIVE);
+                             CCDSolverType ccd_solver_type_ = CCDC_NAIVE,
+                             bool use_adaptive_sampling_ = false,
+                             unsigned int num_trajectory_threads_ = 1);
   
 };
 
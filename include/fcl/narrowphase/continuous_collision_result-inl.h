@@ -47,6 +47,10 @@ namespace fcl
 extern template
 struct ContinuousCollisionResult<double>;
 
+//==============================================================================
+extern template
+struct TrajectoryCollisionResult<double>;
+
 //==============================================================================
 template <typename S>
 ContinuousCollisionResult<S>::ContinuousCollisionResult()
@@ -55,6 +59,14 @@ ContinuousCollisionResult<S>::ContinuousCollisionResult()
   // Do nothing
 }
 
+//==============================================================================
+template <typename S>
+TrajectoryCollisionResult<S>::TrajectoryCollisionResult()
+  : is_collide(false), segment(-1), time_of_contact(1.0)
+{
+  // Do nothing
+}
+
 } // namespace fcl
 
 #endif
@@ -65,6 +65,33 @@ struct FCL_EXPORT ContinuousCollisionResult
 using ContinuousCollisionResultf = ContinuousCollisionResult<float>;
 using ContinuousCollisionResultd = ContinuousCollisionResult<double>;
 
+/// @brief continuous collision result for a pair of piecewise-linear
+/// trajectories
+template <typename S>
+struct FCL_EXPORT TrajectoryCollisionResult
+{
+  /// @brief collision or not
+  bool is_collide;
+
+  /// @brief index of the earliest colliding segment, i.e. the motion from
+  /// waypoint segment to waypoint segment + 1; -1 if no segment collides
+  int segment;
+
+  /// @brief time of contact within that segment in [0, 1]
+  S time_of_contact;
+
+  Transform3<S> contact_tf1;
+
+  Transform3<S> contact_tf2;
+
+  TrajectoryCollisionResult();
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+using TrajectoryCollisionResultf = TrajectoryCollisionResult<float>;
+using TrajectoryCollisionResultd = TrajectoryCollisionResult<double>;
+
 } // namespace fcl
 
 #include "fcl/narrowphase/continuous_collision_result-inl.h"
@@ -59,6 +59,7 @@
 #include "fcl/geometry/shape/utility.h"
 
 #include "fcl/narrowphase/detail/traversal/collision_node.h"
+#include "fcl/narrowphase/detail/traversal/parallel_traversal.h"
 
 #include "fcl/narrowphase/detail/traversal/collision/bvh_collision_traversal_node.h"
 #include "fcl/narrowphase/detail/traversal/collision/bvh_shape_collision_traversal_node.h"
@@ -544,7 +545,10 @@ struct BVHCollideImpl
     Transform3<S> tf2_tmp = tf2;
 
     initialize(node, *obj1_tmp, tf1_tmp, *obj2_tmp, tf2_tmp, request, result);
-    collide(&node);
+    if(request.enable_parallel_traversal)
+      collideParallel(&node, request.num_traversal_threads);
+    else
+      collide(&node);
 
     delete obj1_tmp;
     delete obj2_tmp;
@@ -584,7 +588,10 @@ std::size_t orientedMeshCollide(
   const BVHModel<BV>* obj2 = static_cast<const BVHModel<BV>* >(o2);
 
   initialize(node, *obj1, tf1, *obj2, tf2, request, result);
-  collide(&node);
+  if(request.enable_parallel_traversal)
+    collideParallel(&node, request.num_traversal_threads);
+  else
+    collide(&node);
 
   return result.numContacts();
 }
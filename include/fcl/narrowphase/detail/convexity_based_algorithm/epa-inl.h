@@ -123,6 +123,30 @@ void EPA<S>::initialize()
     stock.append(&fc_store[max_face_num-i-1]);
 }
 
+//==============================================================================
+template <typename S>
+void EPA<S>::reset(
+    unsigned int max_face_num_,
+    unsigned int max_vertex_num_,
+    unsigned int max_iterations_,
+    S tolerance_)
+{
+  max_iterations = max_iterations_;
+  tolerance = tolerance_;
+
+  if(max_face_num == max_face_num_ && max_vertex_num == max_vertex_num_)
+    return;
+
+  delete [] sv_store;
+  delete [] fc_store;
+
+  max_face_num = max_face_num_;
+  max_vertex_num = max_vertex_num_;
+  hull = SimplexList();
+  stock = SimplexList();
+  initialize();
+}
+
 //==============================================================================
 template <typename S>
 bool EPA<S>::getEdgeDist(SimplexF* face, SimplexV* a, SimplexV* b, S& dist)
@@ -157,9 +181,9 @@ bool EPA<S>::getEdgeDist(SimplexF* face, SimplexV* a, SimplexV* b, S& dist)
 //==============================================================================
 template <typename S>
 typename EPA<S>::SimplexF* EPA<S>::newFace(
-      typename GJK<S>::SimplexV* a,
-      typename GJK<S>::SimplexV* b,
-      typename GJK<S>::SimplexV* c,
+      typename GJKBase<S>::SimplexV* a,
+      typename GJKBase<S>::SimplexV* b,
+      typename GJKBase<S>::SimplexV* c,
       bool forced)
 {
   if(stock.root)
@@ -222,9 +246,10 @@ typename EPA<S>::SimplexF* EPA<S>::findBest()
 
 //==============================================================================
 template <typename S>
-typename EPA<S>::Status EPA<S>::evaluate(GJK<S>& gjk, const Vector3<S>& guess)
+template <typename GJKType>
+typename EPA<S>::Status EPA<S>::evaluate(GJKType& gjk, const Vector3<S>& guess)
 {
-  typename GJK<S>::Simplex& simplex = *gjk.getSimplex();
+  typename GJKBase<S>::Simplex& simplex = *gjk.getSimplex();
   if((simplex.rank > 1) && gjk.encloseOrigin())
   {
     while(hull.root)
@@ -57,7 +57,7 @@ template <typename S>
 struct FCL_EXPORT EPA
 {
 private:
-  using SimplexV = typename GJK<S>::SimplexV;
+  using SimplexV = typename GJKBase<S>::SimplexV;
 
   struct SimplexF
   {
@@ -103,7 +103,7 @@ public:
   enum Status {Valid, Touching, Degenerated, NonConvex, InvalidHull, OutOfFaces, OutOfVertices, AccuracyReached, FallBack, Failed};
   
   Status status;
-  typename GJK<S>::Simplex result;
+  typename GJKBase<S>::Simplex result;
   Vector3<S> normal;
   S depth;
   SimplexV* sv_store;
@@ -121,6 +121,14 @@ public:
 
   void initialize();
 
+  /// @brief Reconfigure the algorithm so that it can be reused for another
+  /// query. The polytope storage is only reallocated when its capacity changes.
+  void reset(
+      unsigned int max_face_num_,
+      unsigned int max_vertex_num_,
+      unsigned int max_iterations_,
+      S tolerance_);
+
   bool getEdgeDist(SimplexF* face, SimplexV* a, SimplexV* b, S& dist);
 
   SimplexF* newFace(SimplexV* a, SimplexV* b, SimplexV* c, bool forced);
@@ -128,7 +136,9 @@ public:
   /// @brief Find the best polytope face to split
   SimplexF* findBest();
 
-  Status evaluate(GJK<S>& gjk, const Vector3<S>& guess);
+  /// @brief GJKType is a GJK on any Minkowski difference type
+  template <typename GJKType>
+  Status evaluate(GJKType& gjk, const Vector3<S>& guess);
 
   /// @brief the goal is to add a face connecting vertex w and face edge f[e] 
   bool expand(size_t pass, SimplexV* w, SimplexF* f, size_t e, SimplexHorizon& horizon);  
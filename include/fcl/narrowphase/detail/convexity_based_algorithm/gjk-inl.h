@@ -46,21 +46,25 @@ namespace fcl
 namespace detail
 {
 
+//==============================================================================
+extern template
+struct GJKBase<double>;
+
 //==============================================================================
 extern template
 struct GJK<double>;
 
 //==============================================================================
-template <typename S>
-GJK<S>::GJK(unsigned int max_iterations_, S tolerance_)
-  : max_iterations(max_iterations_), tolerance(tolerance_)
+template <typename S, typename MinkowskiDiffT>
+GJK<S, MinkowskiDiffT>::GJK(unsigned int max_iterations_, S tolerance_)
+  : max_iterations(max_iterations_), tolerance(tolerance_), iterations(0)
 {
   initialize();
 }
 
 //==============================================================================
-template <typename S>
-void GJK<S>::initialize()
+template <typename S, typename MinkowskiDiffT>
+void GJK<S, MinkowskiDiffT>::initialize()
 {
   ray.setZero();
   nfree = 0;
@@ -71,17 +75,28 @@ void GJK<S>::initialize()
 }
 
 //==============================================================================
-template <typename S>
-Vector3<S> GJK<S>::getGuessFromSimplex() const
+template <typename S, typename MinkowskiDiffT>
+Vector3<S> GJK<S, MinkowskiDiffT>::getGuessFromSimplex() const
 {
   return ray;
 }
 
 //==============================================================================
-template <typename S>
-typename GJK<S>::Status GJK<S>::evaluate(const MinkowskiDiff<S>& shape_, const Vector3<S>& guess)
+template <typename S, typename MinkowskiDiffT>
+typename GJK<S, MinkowskiDiffT>::Status GJK<S, MinkowskiDiffT>::evaluate(const MinkowskiDiffT& shape_, const Vector3<S>& guess)
+{
+  return evaluate(shape_, guess, nullptr, 0);
+}
+
+//==============================================================================
+template <typename S, typename MinkowskiDiffT>
+typename GJK<S, MinkowskiDiffT>::Status GJK<S, MinkowskiDiffT>::evaluate(
+    const MinkowskiDiffT& shape_,
+    const Vector3<S>& guess,
+    const Vector3<S>* seed_directions,
+    size_t seed_rank)
 {
-  size_t iterations = 0;
+  iterations = 0;
   S alpha = 0;
   Vector3<S> lastw[4];
   size_t clastw = 0;
@@ -99,16 +114,17 @@ typename GJK<S>::Status GJK<S>::evaluate(const MinkowskiDiff<S>& shape_, const V
   simplices[0].rank = 0;
   ray = guess;
 
-  appendVertex(simplices[0], (ray.squaredNorm() > 0) ? (-ray).eval() : Vector3<S>::UnitX());
-  simplices[0].p[0] = 1;
-  ray = simplices[0].c[0]->w;
-  lastw[0] = lastw[1] = lastw[2] = lastw[3] = ray; // cache previous support points, the new support point will compare with it to avoid too close support points
+  if(seed_rank == 0 || !seedSimplex(seed_directions, seed_rank, lastw, clastw))
+  {
+    appendVertex(simplices[0], (ray.squaredNorm() > 0) ? (-ray).eval() : Vector3<S>::UnitX());
+    simplices[0].p[0] = 1;
+    ray = simplices[0].c[0]->w;
+    lastw[0] = lastw[1] = lastw[2] = lastw[3] = ray; // cache previous support points, the new support point will compare with it to avoid too close support points
+  }
 
-  do
+  while(status == Valid)
   {
-    size_t next = 1 - current;
     Simplex& curr_simplex = simplices[current];
-    Simplex& next_simplex = simplices[next];
 
     // check A: when origin is near the existing simplex, stop
     S rl = ray.norm();
@@ -150,36 +166,7 @@ typename GJK<S>::Status GJK<S>::evaluate(const MinkowskiDiff<S>& shape_, const V
       break;
     }
 
-    typename Project<S>::ProjectResult project_res;
-    switch(curr_simplex.rank)
-    {
-    case 2:
-      project_res = Project<S>::projectLineOrigin(curr_simplex.c[0]->w, curr_simplex.c[1]->w); break;
-    case 3:
-      project_res = Project<S>::projectTriangleOrigin(curr_simplex.c[0]->w, curr_simplex.c[1]->w, curr_simplex.c[2]->w); break;
-    case 4:
-      project_res = Project<S>::projectTetrahedraOrigin(curr_simplex.c[0]->w, curr_simplex.c[1]->w, curr_simplex.c[2]->w, curr_simplex.c[3]->w); break;
-    }
-
-    if(project_res.sqr_distance >= 0)
-    {
-      next_simplex.rank = 0;
-      ray.setZero();
-      current = next;
-      for(size_t i = 0; i < curr_simplex.rank; ++i)
-      {
-        if(project_res.encode & (1 << i))
-        {
-          next_simplex.c[next_simplex.rank] = curr_simplex.c[i];
-          next_simplex.p[next_simplex.rank++] = project_res.parameterization[i]; // weights[i];
-          ray += curr_simplex.c[i]->w * project_res.parameterization[i]; // weights[i];
-        }
-        else
-          free_v[nfree++] = curr_simplex.c[i];
-      }
-      if(project_res.encode == 15) status = Inside; // the origin is within the 4-simplex, collision
-    }
-    else
+    if(!projectOrigin())
     {
       removeVertex(simplices[current]);
       break;
@@ -187,7 +174,7 @@ typename GJK<S>::Status GJK<S>::evaluate(const MinkowskiDiff<S>& shape_, const V
 
     status = ((++iterations) < max_iterations) ? status : Failed;
 
-  } while(status == Valid);
+  }
 
   simplex = &simplices[current];
   switch(status)
@@ -200,31 +187,133 @@ typename GJK<S>::Status GJK<S>::evaluate(const MinkowskiDiff<S>& shape_, const V
 }
 
 //==============================================================================
-template <typename S>
-void GJK<S>::getSupport(const Vector3<S>& d, SimplexV& sv) const
+template <typename S, typename MinkowskiDiffT>
+bool GJK<S, MinkowskiDiffT>::seedSimplex(
+    const Vector3<S>* seed_directions,
+    size_t seed_rank,
+    Vector3<S>* lastw,
+    size_t& clastw)
+{
+  Simplex& seed = simplices[current];
+  for(size_t i = 0; i < std::min<size_t>(seed_rank, 4); ++i)
+  {
+    appendVertex(seed, seed_directions[i]);
+
+    // Keep the new vertex only if it is farther than the tolerance from the
+    // affine hull of the previous ones, so that the projection below never
+    // sees a degenerate simplex.
+    const Vector3<S>& w0 = seed.c[0]->w;
+    const Vector3<S> e = seed.c[seed.rank - 1]->w - w0;
+    bool extends = true;
+    switch(seed.rank)
+    {
+    case 2:
+      extends = e.norm() > tolerance;
+      break;
+    case 3:
+      {
+        const Vector3<S> e1 = seed.c[1]->w - w0;
+        extends = e1.cross(e).norm() > tolerance * e1.norm();
+      }
+      break;
+    case 4:
+      {
+        const Vector3<S> n
+            = (seed.c[1]->w - w0).cross(seed.c[2]->w - w0);
+        extends = std::abs(n.dot(e)) > tolerance * n.norm();
+      }
+      break;
+    }
+    if(!extends)
+      removeVertex(seed);
+  }
+
+  for(size_t i = 0; i < 4; ++i)
+    lastw[i] = seed.c[std::min(i, seed.rank - 1)]->w;
+  clastw = seed.rank - 1;
+
+  if(seed.rank == 1)
+  {
+    seed.p[0] = 1;
+    ray = seed.c[0]->w;
+    return true;
+  }
+
+  if(projectOrigin())
+    return true;
+
+  while(seed.rank)
+    removeVertex(seed);
+  return false;
+}
+
+//==============================================================================
+template <typename S, typename MinkowskiDiffT>
+bool GJK<S, MinkowskiDiffT>::projectOrigin()
+{
+  const size_t next = 1 - current;
+  Simplex& curr_simplex = simplices[current];
+  Simplex& next_simplex = simplices[next];
+
+  typename Project<S>::ProjectResult project_res;
+  switch(curr_simplex.rank)
+  {
+  case 2:
+    project_res = Project<S>::projectLineOrigin(curr_simplex.c[0]->w, curr_simplex.c[1]->w); break;
+  case 3:
+    project_res = Project<S>::projectTriangleOrigin(curr_simplex.c[0]->w, curr_simplex.c[1]->w, curr_simplex.c[2]->w); break;
+  case 4:
+    project_res = Project<S>::projectTetrahedraOrigin(curr_simplex.c[0]->w, curr_simplex.c[1]->w, curr_simplex.c[2]->w, curr_simplex.c[3]->w); break;
+  }
+
+  if(project_res.sqr_distance < 0)
+    return false;
+
+  next_simplex.rank = 0;
+  ray.setZero();
+  current = next;
+  for(size_t i = 0; i < curr_simplex.rank; ++i)
+  {
+    if(project_res.encode & (1 << i))
+    {
+      next_simplex.c[next_simplex.rank] = curr_simplex.c[i];
+      next_simplex.p[next_simplex.rank++] = project_res.parameterization[i]; // weights[i];
+      ray += curr_simplex.c[i]->w * project_res.parameterization[i]; // weights[i];
+    }
+    else
+      free_v[nfree++] = curr_simplex.c[i];
+  }
+  if(project_res.encode == 15) status = Inside; // the origin is within the 4-simplex, collision
+
+  return true;
+}
+
+//==============================================================================
+template <typename S, typename MinkowskiDiffT>
+void GJK<S, MinkowskiDiffT>::getSupport(const Vector3<S>& d, SimplexV& sv) const
 {
   sv.d = d.normalized();
   sv.w = shape.support(sv.d);
 }
 
 //==============================================================================
-template <typename S>
-void GJK<S>::getSupport(const Vector3<S>& d, const Vector3<S>& v, SimplexV& sv) const
+template <typename S, typename MinkowskiDiffT>
+void GJK<S, MinkowskiDiffT>::getSupport(const Vector3<S>& d, const Vector3<S>& v, SimplexV& sv) const
 {
   sv.d = d.normalized();
   sv.w = shape.support(sv.d, v);
 }
 
 //==============================================================================
-template <typename S>
-void GJK<S>::removeVertex(Simplex& simplex)
+template <typename S, typename MinkowskiDiffT>
+void GJK<S, MinkowskiDiffT>::removeVertex(Simplex& simplex)
 {
   free_v[nfree++] = simplex.c[--simplex.rank];
 }
 
 //==============================================================================
-template <typename S>
-void GJK<S>::appendVertex(Simplex& simplex, const Vector3<S>& v)
+template <typename S, typename MinkowskiDiffT>
+void GJK<S, MinkowskiDiffT>::appendVertex(Simplex& simplex, const Vector3<S>& v)
 {
   simplex.p[simplex.rank] = 0; // initial weight 0
   simplex.c[simplex.rank] = free_v[--nfree]; // set the memory
@@ -232,8 +321,8 @@ void GJK<S>::appendVertex(Simplex& simplex, const Vector3<S>& v)
 }
 
 //==============================================================================
-template <typename S>
-bool GJK<S>::encloseOrigin()
+template <typename S, typename MinkowskiDiffT>
+bool GJK<S, MinkowskiDiffT>::encloseOrigin()
 {
   switch(simplex->rank)
   {
@@ -298,15 +387,36 @@ bool GJK<S>::encloseOrigin()
 }
 
 //==============================================================================
-template <typename S>
-typename GJK<S>::Simplex* GJK<S>::getSimplex() const
+template <typename S, typename MinkowskiDiffT>
+unsigned int GJK<S, MinkowskiDiffT>::getIterations() const
+{
+  return iterations;
+}
+
+//==============================================================================
+template <typename S, typename MinkowskiDiffT>
+unsigned int GJK<S, MinkowskiDiffT>::getMaxIterations() const
+{
+  return max_iterations;
+}
+
+//==============================================================================
+template <typename S, typename MinkowskiDiffT>
+S GJK<S, MinkowskiDiffT>::getTolerance() const
+{
+  return tolerance;
+}
+
+//==============================================================================
+template <typename S, typename MinkowskiDiffT>
+typename GJK<S, MinkowskiDiffT>::Simplex* GJK<S, MinkowskiDiffT>::getSimplex() const
 {
   return simplex;
 }
 
 //==============================================================================
 template <typename S>
-GJK<S>::Simplex::Simplex()
+GJKBase<S>::Simplex::Simplex()
   : rank(0)
 {
   // Do nothing
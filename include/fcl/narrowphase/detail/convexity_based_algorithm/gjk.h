@@ -47,9 +47,10 @@ namespace fcl
 namespace detail
 {
 
-/// @brief class for GJK algorithm
+/// @brief the simplex and status types of the GJK algorithm, which do not
+/// depend on the Minkowski difference it runs on
 template <typename S>
-struct FCL_EXPORT GJK
+struct FCL_EXPORT GJKBase
 {
   struct SimplexV
   {
@@ -72,8 +73,22 @@ struct FCL_EXPORT GJK
   };
 
   enum Status {Valid, Inside, Failed};
+};
 
-  MinkowskiDiff<S> shape;
+/// @brief class for GJK algorithm. MinkowskiDiffT is either MinkowskiDiff<S>,
+/// which dispatches on the shape types at runtime, or a TypedMinkowskiDiff,
+/// whose support functions are resolved at compile time.
+template <typename S, typename MinkowskiDiffT = MinkowskiDiff<S>>
+struct FCL_EXPORT GJK : public GJKBase<S>
+{
+  using typename GJKBase<S>::SimplexV;
+  using typename GJKBase<S>::Simplex;
+  using typename GJKBase<S>::Status;
+  using GJKBase<S>::Valid;
+  using GJKBase<S>::Inside;
+  using GJKBase<S>::Failed;
+
+  MinkowskiDiffT shape;
   Vector3<S> ray;
   S distance;
   Simplex simplices[2];
@@ -83,7 +98,18 @@ struct FCL_EXPORT GJK
   void initialize();
 
   /// @brief GJK algorithm, given the initial value guess
-  Status evaluate(const MinkowskiDiff<S>& shape_, const Vector3<S>& guess);
+  Status evaluate(const MinkowskiDiffT& shape_, const Vector3<S>& guess);
+
+  /// @brief GJK algorithm, warm started from the simplex spanned by the
+  /// supports along the seed_rank (at most 4) seed_directions, e.g., the
+  /// directions of the final simplex of an earlier query on the same pair of
+  /// shapes. Seed directions whose supports do not extend the simplex are
+  /// skipped; if none is left, this starts from guess like evaluate() above.
+  Status evaluate(
+      const MinkowskiDiffT& shape_,
+      const Vector3<S>& guess,
+      const Vector3<S>* seed_directions,
+      size_t seed_rank);
 
   /// @brief apply the support function along a direction, the result is return in sv
   void getSupport(const Vector3<S>& d, SimplexV& sv) const;
@@ -106,6 +132,15 @@ struct FCL_EXPORT GJK
   /// @brief get the guess from current simplex
   Vector3<S> getGuessFromSimplex() const;
 
+  /// @brief the number of iterations that the last evaluate() ran
+  unsigned int getIterations() const;
+
+  /// @brief the iteration limit given at construction
+  unsigned int getMaxIterations() const;
+
+  /// @brief the tolerance given at construction
+  S getTolerance() const;
+
 private:
   SimplexV store_v[4];
   SimplexV* free_v[4];
@@ -116,6 +151,22 @@ private:
 
   unsigned int max_iterations;
   S tolerance;
+  unsigned int iterations;
+
+  /// @brief set up the simplex spanned by the supports along the seed
+  /// directions, skipping the ones that do not extend it, and project the
+  /// origin onto it. The supports are also cached in lastw. Returns false,
+  /// with GJK reset for a cold start, if no usable simplex is left.
+  bool seedSimplex(
+      const Vector3<S>* seed_directions,
+      size_t seed_rank,
+      Vector3<S>* lastw,
+      size_t& clastw);
+
+  /// @brief reduce simplices[current] to the sub-simplex that is closest to
+  /// the origin, which becomes the current simplex, and update ray. Returns
+  /// false if the projection fails.
+  bool projectOrigin();
 
 };
 
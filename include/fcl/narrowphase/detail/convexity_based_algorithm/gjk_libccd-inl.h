@@ -95,6 +95,23 @@ void* triCreateGJKObject(
     const Vector3d& P3,
     const Transform3d& tf);
 
+//==============================================================================
+extern template
+void triInitGJKObject(
+    const Vector3d& P1,
+    const Vector3d& P2,
+    const Vector3d& P3,
+    ccd_triangle_t* o);
+
+//==============================================================================
+extern template
+void triInitGJKObject(
+    const Vector3d& P1,
+    const Vector3d& P2,
+    const Vector3d& P3,
+    const Transform3d& tf,
+    ccd_triangle_t* o);
+
 //==============================================================================
 extern template
 bool GJKCollide(
@@ -135,54 +152,6 @@ bool GJKSignedDistance(
     Vector3d* p1,
     Vector3d* p2);
 
-struct ccd_obj_t
-{
-  ccd_vec3_t pos;
-  ccd_quat_t rot, rot_inv;
-};
-
-struct ccd_box_t : public ccd_obj_t
-{
-  ccd_real_t dim[3];
-};
-
-struct ccd_cap_t : public ccd_obj_t
-{
-  ccd_real_t radius, height;
-};
-
-struct ccd_cyl_t : public ccd_obj_t
-{
-  ccd_real_t radius, height;
-};
-
-struct ccd_cone_t : public ccd_obj_t
-{
-  ccd_real_t radius, height;
-};
-
-struct ccd_sphere_t : public ccd_obj_t
-{
-  ccd_real_t radius;
-};
-
-struct ccd_ellipsoid_t : public ccd_obj_t
-{
-  ccd_real_t radii[3];
-};
-
-template <typename S>
-struct ccd_convex_t : public ccd_obj_t
-{
-  const Convex<S>* convex;
-};
-
-struct ccd_triangle_t : public ccd_obj_t
-{
-  ccd_vec3_t p[3];
-  ccd_vec3_t c;
-};
-
 namespace libccd_extension
 {
 
@@ -2338,6 +2307,7 @@ static void convexToGJK(const Convex<S>& s, const Transform3<S>& tf,
 {
   shapeToGJK(s, tf, conv);
   conv->convex = &s;
+  conv->support_hint = 0;
 }
 
 /** Support functions */
@@ -2499,25 +2469,16 @@ static void supportConvex(const void* obj, const ccd_vec3_t* dir_,
                           ccd_vec3_t* v)
 {
   const auto* c = (const ccd_convex_t<S>*)obj;
-  ccd_vec3_t dir, p;
-  ccd_real_t maxdot, dot;
-  const auto& center = c->convex->getInteriorPoint();
+  ccd_vec3_t dir;
 
   ccdVec3Copy(&dir, dir_);
   ccdQuatRotVec(&dir, &c->rot_inv);
 
-  maxdot = -CCD_REAL_MAX;
-
-  for (const auto& vertex : c->convex->getVertices())
-  {
-    ccdVec3Set(&p, vertex[0] - center[0], vertex[1] - center[1],
-               vertex[2] - center[2]);
-    dot = ccdVec3Dot(&dir, &p);
-    if (dot > maxdot) {
-      ccdVec3Set(v, vertex[0], vertex[1], vertex[2]);
-      maxdot = dot;
-    }
-  }
+  c->support_hint = c->convex->findExtremeVertexIndex(
+      Vector3<S>(ccdVec3X(&dir), ccdVec3Y(&dir), ccdVec3Z(&dir)),
+      c->support_hint);
+  const Vector3<S>& vertex = c->convex->getVertices()[c->support_hint];
+  ccdVec3Set(v, vertex[0], vertex[1], vertex[2]);
 
   // transform support vertex
   ccdQuatRotVec(v, &c->rot);
@@ -2737,6 +2698,14 @@ void* GJKInitializer<S, Cylinder<S>>::createGJKObject(const Cylinder<S>& s,
   return o;
 }
 
+template <typename S>
+void GJKInitializer<S, Cylinder<S>>::initGJKObject(const Cylinder<S>& s,
+                                                   const Transform3<S>& tf,
+                                                   GJKObject* o)
+{
+  cylToGJK(s, tf, o);
+}
+
 template <typename S>
 void GJKInitializer<S, Cylinder<S>>::deleteGJKObject(void* o_)
 {
@@ -2765,6 +2734,14 @@ void* GJKInitializer<S, Sphere<S>>::createGJKObject(const Sphere<S>& s,
   return o;
 }
 
+template <typename S>
+void GJKInitializer<S, Sphere<S>>::initGJKObject(const Sphere<S>& s,
+                                                 const Transform3<S>& tf,
+                                                 GJKObject* o)
+{
+  sphereToGJK(s, tf, o);
+}
+
 template <typename S>
 void GJKInitializer<S, Sphere<S>>::deleteGJKObject(void* o_)
 {
@@ -2793,6 +2770,14 @@ void* GJKInitializer<S, Ellipsoid<S>>::createGJKObject(const Ellipsoid<S>& s,
   return o;
 }
 
+template <typename S>
+void GJKInitializer<S, Ellipsoid<S>>::initGJKObject(const Ellipsoid<S>& s,
+                                                    const Transform3<S>& tf,
+                                                    GJKObject* o)
+{
+  ellipsoidToGJK(s, tf, o);
+}
+
 template <typename S>
 void GJKInitializer<S, Ellipsoid<S>>::deleteGJKObject(void* o_)
 {
@@ -2821,6 +2806,14 @@ void* GJKInitializer<S, Box<S>>::createGJKObject(const Box<S>& s,
   return o;
 }
 
+template <typename S>
+void GJKInitializer<S, Box<S>>::initGJKObject(const Box<S>& s,
+                                              const Transform3<S>& tf,
+                                              GJKObject* o)
+{
+  boxToGJK(s, tf, o);
+}
+
 template <typename S>
 void GJKInitializer<S, Box<S>>::deleteGJKObject(void* o_)
 {
@@ -2849,6 +2842,14 @@ void* GJKInitializer<S, Capsule<S>>::createGJKObject(const Capsule<S>& s,
   return o;
 }
 
+template <typename S>
+void GJKInitializer<S, Capsule<S>>::initGJKObject(const Capsule<S>& s,
+                                                  const Transform3<S>& tf,
+                                                  GJKObject* o)
+{
+  capToGJK(s, tf, o);
+}
+
 template <typename S>
 void GJKInitializer<S, Capsule<S>>::deleteGJKObject(void* o_)
 {
@@ -2877,6 +2878,14 @@ void* GJKInitializer<S, Cone<S>>::createGJKObject(const Cone<S>& s,
   return o;
 }
 
+template <typename S>
+void GJKInitializer<S, Cone<S>>::initGJKObject(const Cone<S>& s,
+                                               const Transform3<S>& tf,
+                                               GJKObject* o)
+{
+  coneToGJK(s, tf, o);
+}
+
 template <typename S>
 void GJKInitializer<S, Cone<S>>::deleteGJKObject(void* o_)
 {
@@ -2905,6 +2914,14 @@ void* GJKInitializer<S, Convex<S>>::createGJKObject(const Convex<S>& s,
   return o;
 }
 
+template <typename S>
+void GJKInitializer<S, Convex<S>>::initGJKObject(const Convex<S>& s,
+                                                 const Transform3<S>& tf,
+                                                 GJKObject* o)
+{
+  convexToGJK(s, tf, o);
+}
+
 template <typename S>
 void GJKInitializer<S, Convex<S>>::deleteGJKObject(void* o_)
 {
@@ -2927,6 +2944,23 @@ void* triCreateGJKObject(const Vector3<S>& P1, const Vector3<S>& P2,
                          const Vector3<S>& P3)
 {
   ccd_triangle_t* o = new ccd_triangle_t;
+  triInitGJKObject(P1, P2, P3, o);
+  return o;
+}
+
+template <typename S>
+void* triCreateGJKObject(const Vector3<S>& P1, const Vector3<S>& P2,
+                         const Vector3<S>& P3, const Transform3<S>& tf)
+{
+  ccd_triangle_t* o = new ccd_triangle_t;
+  triInitGJKObject(P1, P2, P3, tf, o);
+  return o;
+}
+
+template <typename S>
+void triInitGJKObject(const Vector3<S>& P1, const Vector3<S>& P2,
+                      const Vector3<S>& P3, ccd_triangle_t* o)
+{
   Vector3<S> center((P1[0] + P2[0] + P3[0]) / 3, (P1[1] + P2[1] + P3[1]) / 3,
       (P1[2] + P2[2] + P3[2]) / 3);
 
@@ -2937,15 +2971,13 @@ void* triCreateGJKObject(const Vector3<S>& P1, const Vector3<S>& P2,
   ccdVec3Set(&o->pos, 0., 0., 0.);
   ccdQuatSet(&o->rot, 0., 0., 0., 1.);
   ccdQuatInvert2(&o->rot_inv, &o->rot);
-
-  return o;
 }
 
 template <typename S>
-void* triCreateGJKObject(const Vector3<S>& P1, const Vector3<S>& P2,
-                         const Vector3<S>& P3, const Transform3<S>& tf)
+void triInitGJKObject(const Vector3<S>& P1, const Vector3<S>& P2,
+                      const Vector3<S>& P3, const Transform3<S>& tf,
+                      ccd_triangle_t* o)
 {
-  ccd_triangle_t* o = new ccd_triangle_t;
   Vector3<S> center((P1[0] + P2[0] + P3[0]) / 3, (P1[1] + P2[1] + P3[1]) / 3,
       (P1[2] + P2[2] + P3[2]) / 3);
 
@@ -2958,8 +2990,6 @@ void* triCreateGJKObject(const Vector3<S>& P1, const Vector3<S>& P2,
   ccdVec3Set(&o->pos, T[0], T[1], T[2]);
   ccdQuatSet(&o->rot, q.x(), q.y(), q.z(), q.w());
   ccdQuatInvert2(&o->rot_inv, &o->rot);
-
-  return o;
 }
 
 inline void triDeleteGJKObject(void* o_)
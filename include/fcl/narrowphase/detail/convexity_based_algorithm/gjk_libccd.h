@@ -72,11 +72,67 @@ namespace detail
 using GJKSupportFunction = void (*)(const void* obj, const ccd_vec3_t* dir_, ccd_vec3_t* v);
 using GJKCenterFunction = void (*)(const void* obj, ccd_vec3_t* c);
 
+/// @brief GJK objects: the shape parameters and pose that the support and
+/// center functions read
+struct ccd_obj_t
+{
+  ccd_vec3_t pos;
+  ccd_quat_t rot, rot_inv;
+};
+
+struct ccd_box_t : public ccd_obj_t
+{
+  ccd_real_t dim[3];
+};
+
+struct ccd_cap_t : public ccd_obj_t
+{
+  ccd_real_t radius, height;
+};
+
+struct ccd_cyl_t : public ccd_obj_t
+{
+  ccd_real_t radius, height;
+};
+
+struct ccd_cone_t : public ccd_obj_t
+{
+  ccd_real_t radius, height;
+};
+
+struct ccd_sphere_t : public ccd_obj_t
+{
+  ccd_real_t radius;
+};
+
+struct ccd_ellipsoid_t : public ccd_obj_t
+{
+  ccd_real_t radii[3];
+};
+
+template <typename S>
+struct ccd_convex_t : public ccd_obj_t
+{
+  const Convex<S>* convex;
+
+  // The last support vertex, from which the next support search starts
+  mutable int support_hint;
+};
+
+struct ccd_triangle_t : public ccd_obj_t
+{
+  ccd_vec3_t p[3];
+  ccd_vec3_t c;
+};
+
 /// @brief initialize GJK stuffs
 template <typename S, typename T>
 class FCL_EXPORT GJKInitializer
 {
 public:
+  /// @brief The type of the GJK object of the shape
+  using GJKObject = ccd_obj_t;
+
   /// @brief Get GJK support function
   static GJKSupportFunction getSupportFunction() { return nullptr; }
 
@@ -88,6 +144,11 @@ public:
   /// Gloal transformation are considered later
   static void* createGJKObject(const T& /* s */, const Transform3<S>& /*tf*/) { return nullptr; }
 
+  /// @brief Set up the GJK object of a shape in storage provided by the
+  /// caller (e.g., on the stack), which avoids the heap allocation of
+  /// createGJKObject(). Only local transformation is applied.
+  static void initGJKObject(const T& /* s */, const Transform3<S>& /*tf*/, GJKObject* /*o*/) {}
+
   /// @brief Delete GJK object
   static void deleteGJKObject(void* o) { FCL_UNUSED(o); }
 };
@@ -97,9 +158,11 @@ template <typename S>
 class FCL_EXPORT GJKInitializer<S, Cylinder<S>>
 {
 public:
+  using GJKObject = ccd_cyl_t;
   static GJKSupportFunction getSupportFunction();
   static GJKCenterFunction getCenterFunction();
   static void* createGJKObject(const Cylinder<S>& s, const Transform3<S>& tf);
+  static void initGJKObject(const Cylinder<S>& s, const Transform3<S>& tf, GJKObject* o);
   static void deleteGJKObject(void* o);
 };
 
@@ -108,9 +171,11 @@ template <typename S>
 class FCL_EXPORT GJKInitializer<S, Sphere<S>>
 {
 public:
+  using GJKObject = ccd_sphere_t;
   static GJKSupportFunction getSupportFunction();
   static GJKCenterFunction getCenterFunction();
   static void* createGJKObject(const Sphere<S>& s, const Transform3<S>& tf);
+  static void initGJKObject(const Sphere<S>& s, const Transform3<S>& tf, GJKObject* o);
   static void deleteGJKObject(void* o);
 };
 
@@ -119,9 +184,11 @@ template <typename S>
 class FCL_EXPORT GJKInitializer<S, Ellipsoid<S>>
 {
 public:
+  using GJKObject = ccd_ellipsoid_t;
   static GJKSupportFunction getSupportFunction();
   static GJKCenterFunction getCenterFunction();
   static void* createGJKObject(const Ellipsoid<S>& s, const Transform3<S>& tf);
+  static void initGJKObject(const Ellipsoid<S>& s, const Transform3<S>& tf, GJKObject* o);
   static void deleteGJKObject(void* o);
 };
 
@@ -130,9 +197,11 @@ template <typename S>
 class FCL_EXPORT GJKInitializer<S, Box<S>>
 {
 public:
+  using GJKObject = ccd_box_t;
   static GJKSupportFunction getSupportFunction();
   static GJKCenterFunction getCenterFunction();
   static void* createGJKObject(const Box<S>& s, const Transform3<S>& tf);
+  static void initGJKObject(const Box<S>& s, const Transform3<S>& tf, GJKObject* o);
   static void deleteGJKObject(void* o);
 };
 
@@ -141,9 +210,11 @@ template <typename S>
 class FCL_EXPORT GJKInitializer<S, Capsule<S>>
 {
 public:
+  using GJKObject = ccd_cap_t;
   static GJKSupportFunction getSupportFunction();
   static GJKCenterFunction getCenterFunction();
   static void* createGJKObject(const Capsule<S>& s, const Transform3<S>& tf);
+  static void initGJKObject(const Capsule<S>& s, const Transform3<S>& tf, GJKObject* o);
   static void deleteGJKObject(void* o);
 };
 
@@ -152,9 +223,11 @@ template <typename S>
 class FCL_EXPORT GJKInitializer<S, Cone<S>>
 {
 public:
+  using GJKObject = ccd_cone_t;
   static GJKSupportFunction getSupportFunction();
   static GJKCenterFunction getCenterFunction();
   static void* createGJKObject(const Cone<S>& s, const Transform3<S>& tf);
+  static void initGJKObject(const Cone<S>& s, const Transform3<S>& tf, GJKObject* o);
   static void deleteGJKObject(void* o);
 };
 
@@ -163,9 +236,11 @@ template <typename S>
 class FCL_EXPORT GJKInitializer<S, Convex<S>>
 {
 public:
+  using GJKObject = ccd_convex_t<S>;
   static GJKSupportFunction getSupportFunction();
   static GJKCenterFunction getCenterFunction();
   static void* createGJKObject(const Convex<S>& s, const Transform3<S>& tf);
+  static void initGJKObject(const Convex<S>& s, const Transform3<S>& tf, GJKObject* o);
   static void deleteGJKObject(void* o);
 };
 
@@ -184,6 +259,16 @@ template <typename S>
 FCL_EXPORT
 void* triCreateGJKObject(const Vector3<S>& P1, const Vector3<S>& P2, const Vector3<S>& P3, const Transform3<S>& tf);
 
+/// @brief Set up the GJK object of a triangle in storage provided by the
+/// caller, without a heap allocation
+template <typename S>
+FCL_EXPORT
+void triInitGJKObject(const Vector3<S>& P1, const Vector3<S>& P2, const Vector3<S>& P3, ccd_triangle_t* o);
+
+template <typename S>
+FCL_EXPORT
+void triInitGJKObject(const Vector3<S>& P1, const Vector3<S>& P2, const Vector3<S>& P3, const Transform3<S>& tf, ccd_triangle_t* o);
+
 FCL_EXPORT
 void triDeleteGJKObject(void* o);
 
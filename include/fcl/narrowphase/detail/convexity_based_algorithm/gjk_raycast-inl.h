@@ -0,0 +1,211 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#ifndef FCL_NARROWPHASE_DETAIL_GJKRAYCAST_INL_H
+#define FCL_NARROWPHASE_DETAIL_GJKRAYCAST_INL_H
+
+#include "fcl/narrowphase/detail/convexity_based_algorithm/gjk_raycast.h"
+
+namespace fcl
+{
+
+namespace detail
+{
+
+//==============================================================================
+extern template
+bool gjkRaycast(
+    const MinkowskiDiff<double>& shape,
+    const Vector3<double>& ray,
+    double tolerance,
+    unsigned int max_iterations,
+    double& toi,
+    Vector3<double>& normal);
+
+//==============================================================================
+template <typename S>
+bool gjkRaycast(
+    const MinkowskiDiff<S>& shape,
+    const Vector3<S>& ray,
+    S tolerance,
+    unsigned int max_iterations,
+    S& toi,
+    Vector3<S>& normal)
+{
+  S lambda = 0;
+  Vector3<S> x = Vector3<S>::Zero();
+  normal.setZero();
+
+  // The simplex is kept as support points of the difference; the search
+  // runs on the points x - p, which move along with x.
+  Vector3<S> points[4];
+  int rank = 0;
+
+  Vector3<S> v = x - shape.support(Vector3<S>::UnitX());
+  const S tolerance2 = tolerance * tolerance;
+
+  for(unsigned int i = 0; i < max_iterations && v.squaredNorm() > tolerance2; ++i)
+  {
+    const Vector3<S> p = shape.support(v.normalized());
+    const Vector3<S> w = x - p;
+
+    const S vw = v.dot(w);
+    if(vw > 0)
+    {
+      // The plane through p with normal v separates x from the difference:
+      // advance x to that plane, or report a miss if the ray never gets there.
+      const S vr = v.dot(ray);
+      if(vr >= 0)
+        return false;
+
+      lambda -= vw / vr;
+      if(lambda > 1)
+        return false;
+
+      x = lambda * ray;
+      normal = v;
+    }
+
+    // After x advances, the new support point may coincide with one already
+    // in the simplex; it then only needs the projection redone.
+    bool duplicate = false;
+    for(int k = 0; k < rank; ++k)
+    {
+      if((points[k] - p).squaredNorm() <= tolerance2)
+        duplicate = true;
+    }
+    if(!duplicate)
+      points[rank++] = p;
+
+    Vector3<S> y[4];
+    for(int k = 0; k < rank; ++k)
+      y[k] = x - points[k];
+
+    if(rank == 1)
+    {
+      v = y[0];
+      continue;
+    }
+
+    const typename Project<S>::ProjectResult project_res
+        = projectSimplexOrigin(y, rank);
+
+    // The new support point added nothing the search could move on with.
+    if(project_res.sqr_distance < 0)
+      return false;
+
+    int new_rank = 0;
+    v.setZero();
+    for(int k = 0; k < rank; ++k)
+    {
+      if(project_res.encode & (1 << k))
+      {
+        v += project_res.parameterization[k] * y[k];
+        points[new_rank++] = points[k];
+      }
+    }
+    rank = new_rank;
+
+    if(project_res.encode == 15)
+      v.setZero();
+  }
+
+  // Running out of iterations before x is within tolerance is no hit either
+  if(v.squaredNorm() > tolerance2)
+    return false;
+
+  toi = lambda;
+  return true;
+}
+
+//==============================================================================
+template <typename S>
+typename Project<S>::ProjectResult projectSimplexOrigin(
+    const Vector3<S>* y, int rank)
+{
+  typename Project<S>::ProjectResult res;
+  switch(rank)
+  {
+  case 2:
+    return Project<S>::projectLineOrigin(y[0], y[1]);
+  case 3:
+    res = Project<S>::projectTriangleOrigin(y[0], y[1], y[2]); break;
+  default:
+    res = Project<S>::projectTetrahedraOrigin(y[0], y[1], y[2], y[3]); break;
+  }
+
+  if(res.sqr_distance >= 0)
+    return res;
+
+  // Each face leaves out one vertex; map its result back to the simplex.
+  for(int skip = 0; skip < rank; ++skip)
+  {
+    Vector3<S> face[3];
+    int face_to_simplex[3];
+    int n = 0;
+    for(int k = 0; k < rank; ++k)
+    {
+      if(k == skip)
+        continue;
+      face[n] = y[k];
+      face_to_simplex[n++] = k;
+    }
+
+    const typename Project<S>::ProjectResult face_res
+        = projectSimplexOrigin(face, rank - 1);
+    if(face_res.sqr_distance < 0
+       || (res.sqr_distance >= 0 && face_res.sqr_distance >= res.sqr_distance))
+      continue;
+
+    res.sqr_distance = face_res.sqr_distance;
+    res.encode = 0;
+    for(int k = 0; k < 4; ++k)
+      res.parameterization[k] = 0;
+    for(int k = 0; k < rank - 1; ++k)
+    {
+      if(face_res.encode & (1 << k))
+        res.encode |= 1 << face_to_simplex[k];
+      res.parameterization[face_to_simplex[k]] = face_res.parameterization[k];
+    }
+  }
+
+  return res;
+}
+
+} // namespace detail
+} // namespace fcl
+
+#endif
@@ -0,0 +1,92 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#ifndef FCL_NARROWPHASE_DETAIL_GJKRAYCAST_H
+#define FCL_NARROWPHASE_DETAIL_GJKRAYCAST_H
+
+#include "fcl/narrowphase/detail/convexity_based_algorithm/minkowski_diff.h"
+
+namespace fcl
+{
+
+namespace detail
+{
+
+/// @brief Casts the ray lambda * ray, lambda in [0, 1], from the origin
+/// against the Minkowski difference shape (GJK ray cast, as in van den Bergen,
+/// "Ray Casting against General Convex Objects with Application to Continuous
+/// Collision Detection").
+///
+/// If shape1 translates by ray relative to shape0 (in shape0's frame), this
+/// is the time of first contact of the two shapes. lambda only ever advances
+/// to a point proven to be outside the difference, so toi never exceeds the
+/// exact time of contact; the search ends once the ray point is within
+/// tolerance of the difference. Running out of max_iterations before that is
+/// reported as no hit.
+///
+/// @param[out] toi the smallest lambda found in the difference, only set on a
+/// hit
+/// @param[out] normal the separating direction at toi, pointing from the
+/// difference towards the ray origin side; zero if the shapes overlap at
+/// lambda = 0
+/// @return true if the ray hits the difference for some lambda in [0, 1], as
+/// established within max_iterations
+template <typename S>
+FCL_EXPORT
+bool gjkRaycast(
+    const MinkowskiDiff<S>& shape,
+    const Vector3<S>& ray,
+    S tolerance,
+    unsigned int max_iterations,
+    S& toi,
+    Vector3<S>& normal);
+
+/// @brief Projects the origin onto the simplex y[0], ..., y[rank - 1], rank in
+/// [2, 4]. A simplex that is flat, so that the origin may lie in its plane or
+/// on its line, is projected onto the closest of its faces instead.
+/// @return the projection, with sqr_distance < 0 only if every face is
+/// degenerate as well
+template <typename S>
+FCL_EXPORT
+typename Project<S>::ProjectResult projectSimplexOrigin(
+    const Vector3<S>* y, int rank);
+
+} // namespace detail
+} // namespace fcl
+
+#include "fcl/narrowphase/detail/convexity_based_algorithm/gjk_raycast-inl.h"
+
+#endif
@@ -61,12 +61,203 @@ namespace detail
 extern template
 struct MinkowskiDiff<double>;
 
+//==============================================================================
+extern template
+class SupportVertexCache<double>;
+
+//==============================================================================
+template <typename S, typename Shape>
+template <typename Derived>
+Vector3<S> ShapeSupportImpl<S, Shape>::run(
+    const Shape& /*shape*/,
+    const Eigen::MatrixBase<Derived>& /*dir*/,
+    int* /*vertex_hint*/)
+{
+  return Vector3<S>::Zero();
+}
+
+//==============================================================================
+template <typename S>
+struct ShapeSupportImpl<S, TriangleP<S>>
+{
+  template <typename Derived>
+  static Vector3<S> run(
+      const TriangleP<S>& triangle,
+      const Eigen::MatrixBase<Derived>& dir,
+      int* /*vertex_hint*/)
+  {
+    S dota = dir.dot(triangle.a);
+    S dotb = dir.dot(triangle.b);
+    S dotc = dir.dot(triangle.c);
+    if(dota > dotb)
+    {
+      if(dotc > dota)
+        return triangle.c;
+      else
+        return triangle.a;
+    }
+    else
+    {
+      if(dotc > dotb)
+        return triangle.c;
+      else
+        return triangle.b;
+    }
+  }
+};
+
+//==============================================================================
+template <typename S>
+struct ShapeSupportImpl<S, Box<S>>
+{
+  template <typename Derived>
+  static Vector3<S> run(
+      const Box<S>& box,
+      const Eigen::MatrixBase<Derived>& dir,
+      int* /*vertex_hint*/)
+  {
+    return Vector3<S>((dir[0]>0)?(box.side[0]/2):(-box.side[0]/2),
+                 (dir[1]>0)?(box.side[1]/2):(-box.side[1]/2),
+                 (dir[2]>0)?(box.side[2]/2):(-box.side[2]/2));
+  }
+};
+
+//==============================================================================
+template <typename S>
+struct ShapeSupportImpl<S, Sphere<S>>
+{
+  template <typename Derived>
+  static Vector3<S> run(
+      const Sphere<S>& sphere,
+      const Eigen::MatrixBase<Derived>& dir,
+      int* /*vertex_hint*/)
+  {
+    return dir * sphere.radius;
+  }
+};
+
+//==============================================================================
+template <typename S>
+struct ShapeSupportImpl<S, Ellipsoid<S>>
+{
+  template <typename Derived>
+  static Vector3<S> run(
+      const Ellipsoid<S>& ellipsoid,
+      const Eigen::MatrixBase<Derived>& dir,
+      int* /*vertex_hint*/)
+  {
+    const S a2 = ellipsoid.radii[0] * ellipsoid.radii[0];
+    const S b2 = ellipsoid.radii[1] * ellipsoid.radii[1];
+    const S c2 = ellipsoid.radii[2] * ellipsoid.radii[2];
+
+    const Vector3<S> v(a2 * dir[0], b2 * dir[1], c2 * dir[2]);
+    const S d = std::sqrt(v.dot(dir));
+
+    return v / d;
+  }
+};
+
+//==============================================================================
+template <typename S>
+struct ShapeSupportImpl<S, Capsule<S>>
+{
+  template <typename Derived>
+  static Vector3<S> run(
+      const Capsule<S>& capsule,
+      const Eigen::MatrixBase<Derived>& dir,
+      int* /*vertex_hint*/)
+  {
+    S half_h = capsule.lz * 0.5;
+    Vector3<S> pos1(0, 0, half_h);
+    Vector3<S> pos2(0, 0, -half_h);
+    Vector3<S> v = dir * capsule.radius;
+    pos1 += v;
+    pos2 += v;
+    if(dir.dot(pos1) > dir.dot(pos2))
+      return pos1;
+    else return pos2;
+  }
+};
+
+//==============================================================================
+template <typename S>
+struct ShapeSupportImpl<S, Cone<S>>
+{
+  template <typename Derived>
+  static Vector3<S> run(
+      const Cone<S>& cone,
+      const Eigen::MatrixBase<Derived>& dir,
+      int* /*vertex_hint*/)
+  {
+    S zdist = dir[0] * dir[0] + dir[1] * dir[1];
+    S len = zdist + dir[2] * dir[2];
+    zdist = std::sqrt(zdist);
+    len = std::sqrt(len);
+    S half_h = cone.lz * 0.5;
+    S radius = cone.radius;
+
+    S sin_a = radius / std::sqrt(radius * radius + 4 * half_h * half_h);
+
+    if(dir[2] > len * sin_a)
+      return Vector3<S>(0, 0, half_h);
+    else if(zdist > 0)
+    {
+      S rad = radius / zdist;
+      return Vector3<S>(rad * dir[0], rad * dir[1], -half_h);
+    }
+    else
+      return Vector3<S>(0, 0, -half_h);
+  }
+};
+
+//==============================================================================
+template <typename S>
+struct ShapeSupportImpl<S, Cylinder<S>>
+{
+  template <typename Derived>
+  static Vector3<S> run(
+      const Cylinder<S>& cylinder,
+      const Eigen::MatrixBase<Derived>& dir,
+      int* /*vertex_hint*/)
+  {
+    S zdist = std::sqrt(dir[0] * dir[0] + dir[1] * dir[1]);
+    S half_h = cylinder.lz * 0.5;
+    if(zdist == 0.0)
+    {
+      return Vector3<S>(0, 0, (dir[2]>0)? half_h:-half_h);
+    }
+    else
+    {
+      S d = cylinder.radius / zdist;
+      return Vector3<S>(d * dir[0], d * dir[1], (dir[2]>0)?half_h:-half_h);
+    }
+  }
+};
+
+//==============================================================================
+template <typename S>
+struct ShapeSupportImpl<S, Convex<S>>
+{
+  template <typename Derived>
+  static Vector3<S> run(
+      const Convex<S>& convex,
+      const Eigen::MatrixBase<Derived>& dir,
+      int* vertex_hint)
+  {
+    const int index = convex.findExtremeVertexIndex(
+          dir, vertex_hint ? *vertex_hint : 0);
+    if(vertex_hint) *vertex_hint = index;
+    return convex.getVertices()[index];
+  }
+};
+
 //==============================================================================
 template <typename S, typename Derived>
 FCL_EXPORT
 Vector3<S> getSupport(
     const ShapeBase<S>* shape,
-    const Eigen::MatrixBase<Derived>& dir)
+    const Eigen::MatrixBase<Derived>& dir,
+    int* vertex_hint)
 {
   // Check the number of rows is 6 at compile time
   EIGEN_STATIC_ASSERT(
@@ -77,125 +268,29 @@ Vector3<S> getSupport(
   switch(shape->getNodeType())
   {
   case GEOM_TRIANGLE:
-    {
-      const auto* triangle = static_cast<const TriangleP<S>*>(shape);
-      S dota = dir.dot(triangle->a);
-      S dotb = dir.dot(triangle->b);
-      S dotc = dir.dot(triangle->c);
-      if(dota > dotb)
-      {
-        if(dotc > dota)
-          return triangle->c;
-        else
-          return triangle->a;
-      }
-      else
-      {
-        if(dotc > dotb)
-          return triangle->c;
-        else
-          return triangle->b;
-      }
-    }
-    break;
+    return ShapeSupportImpl<S, TriangleP<S>>::run(
+          *static_cast<const TriangleP<S>*>(shape), dir, vertex_hint);
   case GEOM_BOX:
-    {
-      const Box<S>* box = static_cast<const Box<S>*>(shape);
-      return Vector3<S>((dir[0]>0)?(box->side[0]/2):(-box->side[0]/2),
-                   (dir[1]>0)?(box->side[1]/2):(-box->side[1]/2),
-                   (dir[2]>0)?(box->side[2]/2):(-box->side[2]/2));
-    }
-    break;
+    return ShapeSupportImpl<S, Box<S>>::run(
+          *static_cast<const Box<S>*>(shape), dir, vertex_hint);
   case GEOM_SPHERE:
-    {
-      const Sphere<S>* sphere = static_cast<const Sphere<S>*>(shape);
-      return dir * sphere->radius;
-    }
-    break;
+    return ShapeSupportImpl<S, Sphere<S>>::run(
+          *static_cast<const Sphere<S>*>(shape), dir, vertex_hint);
   case GEOM_ELLIPSOID:
-    {
-      const Ellipsoid<S>* ellipsoid = static_cast<const Ellipsoid<S>*>(shape);
-
-      const S a2 = ellipsoid->radii[0] * ellipsoid->radii[0];
-      const S b2 = ellipsoid->radii[1] * ellipsoid->radii[1];
-      const S c2 = ellipsoid->radii[2] * ellipsoid->radii[2];
-
-      const Vector3<S> v(a2 * dir[0], b2 * dir[1], c2 * dir[2]);
-      const S d = std::sqrt(v.dot(dir));
-
-      return v / d;
-    }
-    break;
+    return ShapeSupportImpl<S, Ellipsoid<S>>::run(
+          *static_cast<const Ellipsoid<S>*>(shape), dir, vertex_hint);
   case GEOM_CAPSULE:
-    {
-      const Capsule<S>* capsule = static_cast<const Capsule<S>*>(shape);
-      S half_h = capsule->lz * 0.5;
-      Vector3<S> pos1(0, 0, half_h);
-      Vector3<S> pos2(0, 0, -half_h);
-      Vector3<S> v = dir * capsule->radius;
-      pos1 += v;
-      pos2 += v;
-      if(dir.dot(pos1) > dir.dot(pos2))
-        return pos1;
-      else return pos2;
-    }
-    break;
+    return ShapeSupportImpl<S, Capsule<S>>::run(
+          *static_cast<const Capsule<S>*>(shape), dir, vertex_hint);
   case GEOM_CONE:
-    {
-      const Cone<S>* cone = static_cast<const Cone<S>*>(shape);
-      S zdist = dir[0] * dir[0] + dir[1] * dir[1];
-      S len = zdist + dir[2] * dir[2];
-      zdist = std::sqrt(zdist);
-      len = std::sqrt(len);
-      S half_h = cone->lz * 0.5;
-      S radius = cone->radius;
-
-      S sin_a = radius / std::sqrt(radius * radius + 4 * half_h * half_h);
-
-      if(dir[2] > len * sin_a)
-        return Vector3<S>(0, 0, half_h);
-      else if(zdist > 0)
-      {
-        S rad = radius / zdist;
-        return Vector3<S>(rad * dir[0], rad * dir[1], -half_h);
-      }
-      else
-        return Vector3<S>(0, 0, -half_h);
-    }
-    break;
+    return ShapeSupportImpl<S, Cone<S>>::run(
+          *static_cast<const Cone<S>*>(shape), dir, vertex_hint);
   case GEOM_CYLINDER:
-    {
-      const Cylinder<S>* cylinder = static_cast<const Cylinder<S>*>(shape);
-      S zdist = std::sqrt(dir[0] * dir[0] + dir[1] * dir[1]);
-      S half_h = cylinder->lz * 0.5;
-      if(zdist == 0.0)
-      {
-        return Vector3<S>(0, 0, (dir[2]>0)? half_h:-half_h);
-      }
-      else
-      {
-        S d = cylinder->radius / zdist;
-        return Vector3<S>(d * dir[0], d * dir[1], (dir[2]>0)?half_h:-half_h);
-      }
-    }
-    break;
+    return ShapeSupportImpl<S, Cylinder<S>>::run(
+          *static_cast<const Cylinder<S>*>(shape), dir, vertex_hint);
   case GEOM_CONVEX:
-    {
-      const Convex<S>* convex = static_cast<const Convex<S>*>(shape);
-      S maxdot = - std::numeric_limits<S>::max();
-      Vector3<S> bestv = Vector3<S>::Zero();
-      for(const auto& vertex : convex->getVertices())
-      {
-        S dot = dir.dot(vertex);
-        if(dot > maxdot)
-        {
-          bestv = vertex;
-          maxdot = dot;
-        }
-      }
-      return bestv;
-    }
-    break;
+    return ShapeSupportImpl<S, Convex<S>>::run(
+          *static_cast<const Convex<S>*>(shape), dir, vertex_hint);
   case GEOM_PLANE:
   break;
   default:
@@ -209,21 +304,22 @@ Vector3<S> getSupport(
 template <typename S>
 MinkowskiDiff<S>::MinkowskiDiff()
 {
-  // Do nothing
+  support_hints[0] = 0;
+  support_hints[1] = 0;
 }
 
 //==============================================================================
 template <typename S>
 Vector3<S> MinkowskiDiff<S>::support0(const Vector3<S>& d) const
 {
-  return getSupport(shapes[0], d);
+  return getSupport(shapes[0], d, &support_hints[0]);
 }
 
 //==============================================================================
 template <typename S>
 Vector3<S> MinkowskiDiff<S>::support1(const Vector3<S>& d) const
 {
-  return toshape0 * getSupport(shapes[1], toshape1 * d);
+  return toshape0 * getSupport(shapes[1], toshape1 * d, &support_hints[1]);
 }
 
 //==============================================================================
@@ -248,9 +344,9 @@ template <typename S>
 Vector3<S> MinkowskiDiff<S>::support0(const Vector3<S>& d, const Vector3<S>& v) const
 {
   if(d.dot(v) <= 0)
-    return getSupport(shapes[0], d);
+    return getSupport(shapes[0], d, &support_hints[0]);
   else
-    return getSupport(shapes[0], d) + v;
+    return getSupport(shapes[0], d, &support_hints[0]) + v;
 }
 
 //==============================================================================
@@ -270,6 +366,147 @@ Vector3<S> MinkowskiDiff<S>::support(const Vector3<S>& d, const Vector3<S>& v, s
     return support0(d, v);
 }
 
+//==============================================================================
+template <typename Shape1, typename Shape2>
+Vector3<typename Shape1::S> TypedMinkowskiDiff<Shape1, Shape2>::support0(
+    const Vector3<S>& d) const
+{
+  return ShapeSupportImpl<S, Shape1>::run(
+        *static_cast<const Shape1*>(this->shapes[0]), d,
+        &this->support_hints[0]);
+}
+
+//==============================================================================
+template <typename Shape1, typename Shape2>
+Vector3<typename Shape1::S> TypedMinkowskiDiff<Shape1, Shape2>::support1(
+    const Vector3<S>& d) const
+{
+  return this->toshape0 * ShapeSupportImpl<S, Shape2>::run(
+        *static_cast<const Shape2*>(this->shapes[1]), this->toshape1 * d,
+        &this->support_hints[1]);
+}
+
+//==============================================================================
+template <typename Shape1, typename Shape2>
+Vector3<typename Shape1::S> TypedMinkowskiDiff<Shape1, Shape2>::support(
+    const Vector3<S>& d) const
+{
+  return support0(d) - support1(-d);
+}
+
+//==============================================================================
+template <typename Shape1, typename Shape2>
+Vector3<typename Shape1::S> TypedMinkowskiDiff<Shape1, Shape2>::support(
+    const Vector3<S>& d, size_t index) const
+{
+  if(index)
+    return support1(d);
+  else
+    return support0(d);
+}
+
+//==============================================================================
+template <typename Shape1, typename Shape2>
+Vector3<typename Shape1::S> TypedMinkowskiDiff<Shape1, Shape2>::support0(
+    const Vector3<S>& d, const Vector3<S>& v) const
+{
+  if(d.dot(v) <= 0)
+    return support0(d);
+  else
+    return support0(d) + v;
+}
+
+//==============================================================================
+template <typename Shape1, typename Shape2>
+Vector3<typename Shape1::S> TypedMinkowskiDiff<Shape1, Shape2>::support(
+    const Vector3<S>& d, const Vector3<S>& v) const
+{
+  return support0(d, v) - support1(-d);
+}
+
+//==============================================================================
+template <typename Shape1, typename Shape2>
+Vector3<typename Shape1::S> TypedMinkowskiDiff<Shape1, Shape2>::support(
+    const Vector3<S>& d, const Vector3<S>& v, size_t index) const
+{
+  if(index)
+    return support1(d);
+  else
+    return support0(d, v);
+}
+
+//==============================================================================
+template <typename S>
+constexpr std::size_t SupportVertexCache<S>::max_size;
+
+//==============================================================================
+template <typename S>
+void SupportVertexCache<S>::load(MinkowskiDiff<S>& shape) const
+{
+  const auto it = hints_.find(ShapePair(shape.shapes[0], shape.shapes[1]));
+  if(it == hints_.end())
+    return;
+
+  for(int i = 0; i < 2; ++i)
+  {
+    const auto* vertices = getVertices(shape.shapes[i]);
+    if(vertices && it->second.vertices[i].lock() == *vertices)
+      shape.support_hints[i] = it->second.hints[i];
+  }
+}
+
+//==============================================================================
+template <typename S>
+void SupportVertexCache<S>::store(const MinkowskiDiff<S>& shape)
+{
+  const auto* vertices0 = getVertices(shape.shapes[0]);
+  const auto* vertices1 = getVertices(shape.shapes[1]);
+  if(!vertices0 && !vertices1)
+    return;
+
+  const ShapePair key(shape.shapes[0], shape.shapes[1]);
+  auto it = hints_.find(key);
+  if(it == hints_.end())
+  {
+    if(hints_.size() >= max_size)
+      hints_.clear();
+    it = hints_.emplace(key, Entry()).first;
+  }
+
+  Entry& entry = it->second;
+  entry.hints[0] = shape.support_hints[0];
+  entry.hints[1] = shape.support_hints[1];
+  entry.vertices[0].reset();
+  entry.vertices[1].reset();
+  if(vertices0) entry.vertices[0] = *vertices0;
+  if(vertices1) entry.vertices[1] = *vertices1;
+}
+
+//==============================================================================
+template <typename S>
+void SupportVertexCache<S>::clear()
+{
+  hints_.clear();
+}
+
+//==============================================================================
+template <typename S>
+std::size_t SupportVertexCache<S>::size() const
+{
+  return hints_.size();
+}
+
+//==============================================================================
+template <typename S>
+const std::shared_ptr<const std::vector<Vector3<S>>>*
+SupportVertexCache<S>::getVertices(const ShapeBase<S>* shape)
+{
+  if(shape->getNodeType() != GEOM_CONVEX)
+    return nullptr;
+
+  return &static_cast<const Convex<S>*>(shape)->getSharedVertices();
+}
+
 } // namespace detail
 } // namespace fcl
 
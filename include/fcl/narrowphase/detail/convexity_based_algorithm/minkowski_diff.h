@@ -38,6 +38,12 @@
 #ifndef FCL_NARROWPHASE_DETAIL_MINKOWSKIDIFF_H
 #define FCL_NARROWPHASE_DETAIL_MINKOWSKIDIFF_H
 
+#include <array>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "fcl/math/detail/project.h"
 #include "fcl/geometry/shape/shape_base.h"
 
@@ -47,11 +53,27 @@ namespace fcl
 namespace detail
 {
 
-/// @brief the support function for shape
+/// @brief the support function for shape. For a Convex, the search for the
+/// support vertex starts from *vertex_hint if given, which is then set to the
+/// vertex found.
 template <typename S, typename Derived>
 Vector3<S> getSupport(
     const ShapeBase<S>* shape,
-    const Eigen::MatrixBase<Derived>& dir);
+    const Eigen::MatrixBase<Derived>& dir,
+    int* vertex_hint = nullptr);
+
+/// @brief the support function for a shape whose type Shape is known at
+/// compile time; a vertex_hint is only used by Convex. Shapes without a
+/// support function (e.g., Halfspace and Plane) return the origin.
+template <typename S, typename Shape>
+struct ShapeSupportImpl
+{
+  template <typename Derived>
+  static Vector3<S> run(
+      const Shape& shape,
+      const Eigen::MatrixBase<Derived>& dir,
+      int* vertex_hint);
+};
 
 /// @brief Minkowski difference class of two shapes
 template <typename S>
@@ -66,6 +88,10 @@ struct FCL_EXPORT MinkowskiDiff
   /// @brief transform from shape1 to shape0 
   Transform3<S> toshape0;
 
+  /// @brief for each shape that is a Convex, the vertex where the next search
+  /// for a support vertex starts: the last support vertex found
+  mutable int support_hints[2];
+
   MinkowskiDiff();
 
   /// @brief support function for shape0
@@ -95,6 +121,87 @@ struct FCL_EXPORT MinkowskiDiff
 using MinkowskiDifff = MinkowskiDiff<float>;
 using MinkowskiDiffd = MinkowskiDiff<double>;
 
+/// @brief Minkowski difference of a Shape1 and a Shape2, whose support
+/// functions are resolved at compile time instead of dispatching on the node
+/// types of the shapes on every call, so that GJK and EPA can inline them.
+/// shapes[0] and shapes[1] must point to a Shape1 and a Shape2.
+template <typename Shape1, typename Shape2>
+struct FCL_EXPORT TypedMinkowskiDiff
+    : public MinkowskiDiff<typename Shape1::S>
+{
+  using S = typename Shape1::S;
+
+  /// @brief support function for shape0
+  Vector3<S> support0(const Vector3<S>& d) const;
+
+  /// @brief support function for shape1
+  Vector3<S> support1(const Vector3<S>& d) const;
+
+  /// @brief support function for the pair of shapes
+  Vector3<S> support(const Vector3<S>& d) const;
+
+  /// @brief support function for the d-th shape (d = 0 or 1)
+  Vector3<S> support(const Vector3<S>& d, size_t index) const;
+
+  /// @brief support function for translating shape0, which is translating at velocity v
+  Vector3<S> support0(const Vector3<S>& d, const Vector3<S>& v) const;
+
+  /// @brief support function for the pair of shapes, where shape0 is translating at velocity v
+  Vector3<S> support(const Vector3<S>& d, const Vector3<S>& v) const;
+
+  /// @brief support function for the d-th shape (d = 0 or 1), where shape0 is translating at velocity v
+  Vector3<S> support(const Vector3<S>& d, const Vector3<S>& v, size_t index) const;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+/// @brief The support vertices of the Convex shapes of the shape pairs seen
+/// so far, from which the searches of later queries on the same pairs start.
+/// The pairs are remembered by address, together with the vertex list each
+/// hint indexes, so that a shape created at the address of a destroyed one
+/// does not pick up its hints. At most max_size pairs are remembered; a new
+/// pair beyond that forgets all the others.
+template <typename S>
+class FCL_EXPORT SupportVertexCache
+{
+public:
+
+  /// @brief the number of pairs remembered before the cache starts over
+  static constexpr std::size_t max_size = 1024;
+
+  /// @brief set the support hints of shape to those remembered for its pair
+  void load(MinkowskiDiff<S>& shape) const;
+
+  /// @brief remember the support hints of shape if one of its shapes is a
+  /// Convex
+  void store(const MinkowskiDiff<S>& shape);
+
+  /// @brief forget all pairs
+  void clear();
+
+  /// @brief the number of pairs remembered
+  std::size_t size() const;
+
+private:
+
+  using ShapePair = std::pair<const ShapeBase<S>*, const ShapeBase<S>*>;
+
+  struct Entry
+  {
+    std::array<int, 2> hints;
+
+    /// @brief the vertex lists indexed by the hints, empty for a shape that is
+    /// not a Convex
+    std::array<std::weak_ptr<const std::vector<Vector3<S>>>, 2> vertices;
+  };
+
+  /// @brief the vertex list of shape if it is a Convex, nullptr otherwise
+  static const std::shared_ptr<const std::vector<Vector3<S>>>* getVertices(
+      const ShapeBase<S>* shape);
+
+  std::map<ShapePair, Entry> hints_;
+};
+
 } // namespace detail
 } // namespace fcl
 
@@ -48,6 +48,7 @@
 #include "fcl/narrowphase/collision_object.h"
 
 #include "fcl/narrowphase/detail/traversal/collision_node.h"
+#include "fcl/narrowphase/detail/traversal/parallel_traversal.h"
 #include "fcl/narrowphase/detail/gjk_solver_indep.h"
 #include "fcl/narrowphase/detail/gjk_solver_libccd.h"
 
@@ -361,7 +362,10 @@ struct BVHDistanceImpl
     Transform3<S> tf2_tmp = tf2;
 
     initialize(node, *obj1_tmp, tf1_tmp, *obj2_tmp, tf2_tmp, request, result);
-    distance(&node);
+    if(request.enable_parallel_traversal)
+      distanceParallel(&node, request.num_traversal_threads);
+    else
+      distance(&node);
     delete obj1_tmp;
     delete obj2_tmp;
 
@@ -398,7 +402,10 @@ typename BV::S orientedMeshDistance(
   const BVHModel<BV>* obj2 = static_cast<const BVHModel<BV>* >(o2);
 
   initialize(node, *obj1, tf1, *obj2, tf2, request, result);
-  distance(&node);
+  if(request.enable_parallel_traversal)
+    distanceParallel(&node, request.num_traversal_threads);
+  else
+    distance(&node);
 
   return result.min_distance;
 }
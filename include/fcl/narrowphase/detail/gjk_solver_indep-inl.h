@@ -58,6 +58,7 @@
 #include "fcl/narrowphase/detail/primitive_shape_algorithm/halfspace.h"
 #include "fcl/narrowphase/detail/primitive_shape_algorithm/plane.h"
 #include "fcl/narrowphase/detail/failed_at_this_configuration.h"
+#include "fcl/narrowphase/gjk_simplex_cache.h"
 
 namespace fcl
 {
@@ -122,22 +123,30 @@ struct ShapeIntersectIndepImpl
     Vector3<S> guess(1, 0, 0);
     if(gjkSolver.enable_cached_guess) guess = gjkSolver.cached_guess;
 
-    detail::MinkowskiDiff<S> shape;
+    using MinkowskiDiffType = detail::TypedMinkowskiDiff<Shape1, Shape2>;
+    MinkowskiDiffType shape;
     shape.shapes[0] = &s1;
     shape.shapes[1] = &s2;
     shape.toshape1.noalias() = tf2.linear().transpose() * tf1.linear();
     shape.toshape0 = tf1.inverse(Eigen::Isometry) * tf2;
+    if(gjkSolver.support_vertex_cache) gjkSolver.support_vertex_cache->load(shape);
 
-    detail::GJK<S> gjk(gjkSolver.gjk_max_iterations, gjkSolver.gjk_tolerance);
-    typename detail::GJK<S>::Status gjk_status = gjk.evaluate(shape, -guess);
+    detail::GJK<S, MinkowskiDiffType> gjk(
+        gjkSolver.gjk_max_iterations, gjkSolver.gjk_tolerance);
+    typename detail::GJK<S>::Status gjk_status = gjkSolver.gjk_simplex_cache
+        ? gjkSolver.gjk_simplex_cache->evaluate(gjk, shape, -guess)
+        : gjk.evaluate(shape, -guess);
     if(gjkSolver.enable_cached_guess) gjkSolver.cached_guess = gjk.getGuessFromSimplex();
+    if(gjkSolver.support_vertex_cache) gjkSolver.support_vertex_cache->store(gjk.shape);
 
     switch(gjk_status)
     {
     case detail::GJK<S>::Inside:
       {
-        detail::EPA<S> epa(gjkSolver.epa_max_face_num, gjkSolver.epa_max_vertex_num, gjkSolver.epa_max_iterations, gjkSolver.epa_tolerance);
+        std::unique_ptr<detail::EPA<S>> local_epa;
+        detail::EPA<S>& epa = gjkSolver.getEPA(local_epa);
         typename detail::EPA<S>::Status epa_status = epa.evaluate(gjk, -guess);
+        if(gjkSolver.support_vertex_cache) gjkSolver.support_vertex_cache->store(gjk.shape);
         if(epa_status != detail::EPA<S>::Failed)
         {
           Vector3<S> w0 = Vector3<S>::Zero();
@@ -368,13 +377,15 @@ struct ShapeTriangleIntersectIndepImpl
     Vector3<S> guess(1, 0, 0);
     if(gjkSolver.enable_cached_guess) guess = gjkSolver.cached_guess;
 
-    detail::MinkowskiDiff<S> shape;
+    using MinkowskiDiffType = detail::TypedMinkowskiDiff<Shape, TriangleP<S>>;
+    MinkowskiDiffType shape;
     shape.shapes[0] = &s;
     shape.shapes[1] = &tri;
     shape.toshape1 = tf.linear();
     shape.toshape0 = tf.inverse(Eigen::Isometry);
 
-    detail::GJK<S> gjk(gjkSolver.gjk_max_iterations, gjkSolver.gjk_tolerance);
+    detail::GJK<S, MinkowskiDiffType> gjk(
+        gjkSolver.gjk_max_iterations, gjkSolver.gjk_tolerance);
     typename detail::GJK<S>::Status gjk_status = gjk.evaluate(shape, -guess);
     if(gjkSolver.enable_cached_guess) gjkSolver.cached_guess = gjk.getGuessFromSimplex();
 
@@ -382,7 +393,8 @@ struct ShapeTriangleIntersectIndepImpl
     {
     case detail::GJK<S>::Inside:
       {
-        detail::EPA<S> epa(gjkSolver.epa_max_face_num, gjkSolver.epa_max_vertex_num, gjkSolver.epa_max_iterations, gjkSolver.epa_tolerance);
+        std::unique_ptr<detail::EPA<S>> local_epa;
+        detail::EPA<S>& epa = gjkSolver.getEPA(local_epa);
         typename detail::EPA<S>::Status epa_status = epa.evaluate(gjk, -guess);
         if(epa_status != detail::EPA<S>::Failed)
         {
@@ -465,13 +477,15 @@ struct ShapeTransformedTriangleIntersectIndepImpl
     Vector3<S> guess(1, 0, 0);
     if(gjkSolver.enable_cached_guess) guess = gjkSolver.cached_guess;
 
-    detail::MinkowskiDiff<S> shape;
+    using MinkowskiDiffType = detail::TypedMinkowskiDiff<Shape, TriangleP<S>>;
+    MinkowskiDiffType shape;
     shape.shapes[0] = &s;
     shape.shapes[1] = &tri;
     shape.toshape1.noalias() = tf2.linear().transpose() * tf1.linear();
     shape.toshape0 = tf1.inverse(Eigen::Isometry) * tf2;
 
-    detail::GJK<S> gjk(gjkSolver.gjk_max_iterations, gjkSolver.gjk_tolerance);
+    detail::GJK<S, MinkowskiDiffType> gjk(
+        gjkSolver.gjk_max_iterations, gjkSolver.gjk_tolerance);
     typename detail::GJK<S>::Status gjk_status = gjk.evaluate(shape, -guess);
     if(gjkSolver.enable_cached_guess) gjkSolver.cached_guess = gjk.getGuessFromSimplex();
 
@@ -479,7 +493,8 @@ struct ShapeTransformedTriangleIntersectIndepImpl
     {
     case detail::GJK<S>::Inside:
       {
-        detail::EPA<S> epa(gjkSolver.epa_max_face_num, gjkSolver.epa_max_vertex_num, gjkSolver.epa_max_iterations, gjkSolver.epa_tolerance);
+        std::unique_ptr<detail::EPA<S>> local_epa;
+        detail::EPA<S>& epa = gjkSolver.getEPA(local_epa);
         typename detail::EPA<S>::Status epa_status = epa.evaluate(gjk, -guess);
         if(epa_status != detail::EPA<S>::Failed)
         {
@@ -606,15 +621,21 @@ struct ShapeDistanceIndepImpl
     Vector3<S> guess(1, 0, 0);
     if(gjkSolver.enable_cached_guess) guess = gjkSolver.cached_guess;
 
-    detail::MinkowskiDiff<S> shape;
+    using MinkowskiDiffType = detail::TypedMinkowskiDiff<Shape1, Shape2>;
+    MinkowskiDiffType shape;
     shape.shapes[0] = &s1;
     shape.shapes[1] = &s2;
     shape.toshape1.noalias() = tf2.linear().transpose() * tf1.linear();
     shape.toshape0 = tf1.inverse(Eigen::Isometry) * tf2;
+    if(gjkSolver.support_vertex_cache) gjkSolver.support_vertex_cache->load(shape);
 
-    detail::GJK<S> gjk(gjkSolver.gjk_max_iterations, gjkSolver.gjk_tolerance);
-    typename detail::GJK<S>::Status gjk_status = gjk.evaluate(shape, -guess);
+    detail::GJK<S, MinkowskiDiffType> gjk(
+        gjkSolver.gjk_max_iterations, gjkSolver.gjk_tolerance);
+    typename detail::GJK<S>::Status gjk_status = gjkSolver.gjk_simplex_cache
+        ? gjkSolver.gjk_simplex_cache->evaluate(gjk, shape, -guess)
+        : gjk.evaluate(shape, -guess);
     if(gjkSolver.enable_cached_guess) gjkSolver.cached_guess = gjk.getGuessFromSimplex();
+    if(gjkSolver.support_vertex_cache) gjkSolver.support_vertex_cache->store(gjk.shape);
 
     if(gjk_status == detail::GJK<S>::Valid)
     {
@@ -870,13 +891,15 @@ struct ShapeTriangleDistanceIndepImpl
     Vector3<S> guess(1, 0, 0);
     if(gjkSolver.enable_cached_guess) guess = gjkSolver.cached_guess;
 
-    detail::MinkowskiDiff<S> shape;
+    using MinkowskiDiffType = detail::TypedMinkowskiDiff<Shape, TriangleP<S>>;
+    MinkowskiDiffType shape;
     shape.shapes[0] = &s;
     shape.shapes[1] = &tri;
     shape.toshape1 = tf.linear();
     shape.toshape0 = tf.inverse(Eigen::Isometry);
 
-    detail::GJK<S> gjk(gjkSolver.gjk_max_iterations, gjkSolver.gjk_tolerance);
+    detail::GJK<S, MinkowskiDiffType> gjk(
+        gjkSolver.gjk_max_iterations, gjkSolver.gjk_tolerance);
     typename detail::GJK<S>::Status gjk_status = gjk.evaluate(shape, -guess);
     if(gjkSolver.enable_cached_guess) gjkSolver.cached_guess = gjk.getGuessFromSimplex();
 
@@ -961,13 +984,15 @@ struct ShapeTransformedTriangleDistanceIndepImpl
     Vector3<S> guess(1, 0, 0);
     if(gjkSolver.enable_cached_guess) guess = gjkSolver.cached_guess;
 
-    detail::MinkowskiDiff<S> shape;
+    using MinkowskiDiffType = detail::TypedMinkowskiDiff<Shape, TriangleP<S>>;
+    MinkowskiDiffType shape;
     shape.shapes[0] = &s;
     shape.shapes[1] = &tri;
     shape.toshape1.noalias() = tf2.linear().transpose() * tf1.linear();
     shape.toshape0 = tf1.inverse(Eigen::Isometry) * tf2;
 
-    detail::GJK<S> gjk(gjkSolver.gjk_max_iterations, gjkSolver.gjk_tolerance);
+    detail::GJK<S, MinkowskiDiffType> gjk(
+        gjkSolver.gjk_max_iterations, gjkSolver.gjk_tolerance);
     typename detail::GJK<S>::Status gjk_status = gjk.evaluate(shape, -guess);
     if(gjkSolver.enable_cached_guess) gjkSolver.cached_guess = gjk.getGuessFromSimplex();
 
@@ -1046,6 +1071,9 @@ GJKSolver_indep<S>::GJKSolver_indep()
   epa_tolerance = constants<S>::gjk_default_tolerance();
   enable_cached_guess = false;
   cached_guess = Vector3<S>(1, 0, 0);
+  epa_workspace = nullptr;
+  support_vertex_cache = nullptr;
+  gjk_simplex_cache = nullptr;
 }
 
 //==============================================================================
@@ -1069,6 +1097,22 @@ Vector3<S> GJKSolver_indep<S>::getCachedGuess() const
   return cached_guess;
 }
 
+//==============================================================================
+template <typename S>
+EPA<S>& GJKSolver_indep<S>::getEPA(std::unique_ptr<EPA<S>>& local) const
+{
+  if(epa_workspace)
+  {
+    epa_workspace->reset(epa_max_face_num, epa_max_vertex_num,
+                         epa_max_iterations, epa_tolerance);
+    return *epa_workspace;
+  }
+
+  local.reset(new EPA<S>(epa_max_face_num, epa_max_vertex_num,
+                         epa_max_iterations, epa_tolerance));
+  return *local;
+}
+
 } // namespace detail
 } // namespace fcl
 
@@ -39,6 +39,7 @@
 #define FCL_NARROWPHASE_GJKSOLVERINDEP_H
 
 #include <iostream>
+#include <memory>
 
 #include "fcl/common/types.h"
 #include "fcl/narrowphase/contact_point.h"
@@ -46,9 +47,18 @@
 namespace fcl
 {
 
+template <typename S>
+class GJKSimplexCache;
+
 namespace detail
 {
 
+template <typename S>
+struct EPA;
+
+template <typename S>
+class SupportVertexCache;
+
 /// @brief collision and distance solver based on GJK algorithm implemented in fcl (rewritten the code from the GJK in bullet)
 template <typename S_>
 struct FCL_EXPORT GJKSolver_indep
@@ -158,6 +168,11 @@ struct FCL_EXPORT GJKSolver_indep
 
   Vector3<S> getCachedGuess() const;
 
+  /// @brief Returns the EPA to use for a penetration query: the workspace
+  /// reconfigured to the current EPA settings if one is attached, otherwise a
+  /// new EPA owned by local.
+  EPA<S>& getEPA(std::unique_ptr<EPA<S>>& local) const;
+
   /// @brief maximum number of simplex face used in EPA algorithm
   unsigned int epa_max_face_num;
 
@@ -182,6 +197,21 @@ struct FCL_EXPORT GJKSolver_indep
   /// @brief smart guess
   mutable Vector3<S> cached_guess;
 
+  /// @brief Optional EPA storage reused across penetration queries instead of
+  /// allocating a new polytope each time. Not owned; a solver with a workspace
+  /// must not be shared between threads.
+  EPA<S>* epa_workspace;
+
+  /// @brief Optional cache of the Convex support vertices of the shape pairs,
+  /// from which GJK and EPA on the same pair resume in later queries. Not
+  /// owned; the same threading rule as for epa_workspace applies.
+  SupportVertexCache<S>* support_vertex_cache;
+
+  /// @brief Optional simplex of the previous query on the same pair of
+  /// shapes, from which GJK is warm started. Only used by the shape pairs
+  /// solved with GJK; not owned.
+  GJKSimplexCache<S>* gjk_simplex_cache;
+
   friend
   std::ostream& operator<<(std::ostream& out, const GJKSolver_indep& solver) {
     out << "GjkSolver_indep"
@@ -117,8 +117,10 @@ struct ShapeIntersectLibccdImpl
       const Shape2& s2, const Transform3<S>& tf2,
       std::vector<ContactPoint<S>>* contacts)
   {
-    void* o1 = detail::GJKInitializer<S, Shape1>::createGJKObject(s1, tf1);
-    void* o2 = detail::GJKInitializer<S, Shape2>::createGJKObject(s2, tf2);
+    typename detail::GJKInitializer<S, Shape1>::GJKObject o1{};
+    detail::GJKInitializer<S, Shape1>::initGJKObject(s1, tf1, &o1);
+    typename detail::GJKInitializer<S, Shape2>::GJKObject o2{};
+    detail::GJKInitializer<S, Shape2>::initGJKObject(s2, tf2, &o2);
 
     bool res;
 
@@ -128,10 +130,10 @@ struct ShapeIntersectLibccdImpl
       Vector3<S> point;
       S depth;
       res = detail::GJKCollide<S>(
-            o1,
+            &o1,
             detail::GJKInitializer<S, Shape1>::getSupportFunction(),
             detail::GJKInitializer<S, Shape1>::getCenterFunction(),
-            o2, detail::GJKInitializer<S, Shape2>::getSupportFunction(),
+            &o2, detail::GJKInitializer<S, Shape2>::getSupportFunction(),
             detail::GJKInitializer<S, Shape2>::getCenterFunction(),
             gjkSolver.max_collision_iterations,
             gjkSolver.collision_tolerance,
@@ -143,10 +145,10 @@ struct ShapeIntersectLibccdImpl
     else
     {
       res = detail::GJKCollide<S>(
-            o1,
+            &o1,
             detail::GJKInitializer<S, Shape1>::getSupportFunction(),
             detail::GJKInitializer<S, Shape1>::getCenterFunction(),
-            o2,
+            &o2,
             detail::GJKInitializer<S, Shape2>::getSupportFunction(),
             detail::GJKInitializer<S, Shape2>::getCenterFunction(),
             gjkSolver.max_collision_iterations,
@@ -156,9 +158,6 @@ struct ShapeIntersectLibccdImpl
             nullptr);
     }
 
-    detail::GJKInitializer<S, Shape1>::deleteGJKObject(o1);
-    detail::GJKInitializer<S, Shape2>::deleteGJKObject(o2);
-
     return res;
   }
 };
@@ -359,14 +358,16 @@ struct ShapeTriangleIntersectLibccdImpl
       S* penetration_depth,
       Vector3<S>* normal)
   {
-    void* o1 = detail::GJKInitializer<S, Shape>::createGJKObject(s, tf);
-    void* o2 = detail::triCreateGJKObject(P1, P2, P3);
+    typename detail::GJKInitializer<S, Shape>::GJKObject o1{};
+    detail::GJKInitializer<S, Shape>::initGJKObject(s, tf, &o1);
+    detail::ccd_triangle_t o2{};
+    detail::triInitGJKObject(P1, P2, P3, &o2);
 
     bool res = detail::GJKCollide<S>(
-          o1,
+          &o1,
           detail::GJKInitializer<S, Shape>::getSupportFunction(),
           detail::GJKInitializer<S, Shape>::getCenterFunction(),
-          o2,
+          &o2,
           detail::triGetSupportFunction(),
           detail::triGetCenterFunction(),
           gjkSolver.max_collision_iterations,
@@ -375,9 +376,6 @@ struct ShapeTriangleIntersectLibccdImpl
           penetration_depth,
           normal);
 
-    detail::GJKInitializer<S, Shape>::deleteGJKObject(o1);
-    detail::triDeleteGJKObject(o2);
-
     return res;
   }
 };
@@ -434,14 +432,16 @@ struct ShapeTransformedTriangleIntersectLibccdImpl
       S* penetration_depth,
       Vector3<S>* normal)
   {
-    void* o1 = detail::GJKInitializer<S, Shape>::createGJKObject(s, tf1);
-    void* o2 = detail::triCreateGJKObject(P1, P2, P3, tf2);
+    typename detail::GJKInitializer<S, Shape>::GJKObject o1{};
+    detail::GJKInitializer<S, Shape>::initGJKObject(s, tf1, &o1);
+    detail::ccd_triangle_t o2{};
+    detail::triInitGJKObject(P1, P2, P3, tf2, &o2);
 
     bool res = detail::GJKCollide<S>(
-          o1,
+          &o1,
           detail::GJKInitializer<S, Shape>::getSupportFunction(),
           detail::GJKInitializer<S, Shape>::getCenterFunction(),
-          o2,
+          &o2,
           detail::triGetSupportFunction(),
           detail::triGetCenterFunction(),
           gjkSolver.max_collision_iterations,
@@ -450,9 +450,6 @@ struct ShapeTransformedTriangleIntersectLibccdImpl
           penetration_depth,
           normal);
 
-    detail::GJKInitializer<S, Shape>::deleteGJKObject(o1);
-    detail::triDeleteGJKObject(o2);
-
     return res;
   }
 };
@@ -557,13 +554,15 @@ struct ShapeSignedDistanceLibccdImpl
       Vector3<S>* p1,
       Vector3<S>* p2)
   {
-    void* o1 = detail::GJKInitializer<S, Shape1>::createGJKObject(s1, tf1);
-    void* o2 = detail::GJKInitializer<S, Shape2>::createGJKObject(s2, tf2);
+    typename detail::GJKInitializer<S, Shape1>::GJKObject o1{};
+    detail::GJKInitializer<S, Shape1>::initGJKObject(s1, tf1, &o1);
+    typename detail::GJKInitializer<S, Shape2>::GJKObject o2{};
+    detail::GJKInitializer<S, Shape2>::initGJKObject(s2, tf2, &o2);
 
     bool res = detail::GJKSignedDistance(
-          o1,
+          &o1,
           detail::GJKInitializer<S, Shape1>::getSupportFunction(),
-          o2,
+          &o2,
           detail::GJKInitializer<S, Shape2>::getSupportFunction(),
           gjkSolver.max_distance_iterations,
           gjkSolver.distance_tolerance,
@@ -571,9 +570,6 @@ struct ShapeSignedDistanceLibccdImpl
           p1,
           p2);
 
-    detail::GJKInitializer<S, Shape1>::deleteGJKObject(o1);
-    detail::GJKInitializer<S, Shape2>::deleteGJKObject(o2);
-
     return res;
   }
 };
@@ -614,13 +610,15 @@ struct ShapeDistanceLibccdImpl
       Vector3<S>* p1,
       Vector3<S>* p2)
   {
-    void* o1 = detail::GJKInitializer<S, Shape1>::createGJKObject(s1, tf1);
-    void* o2 = detail::GJKInitializer<S, Shape2>::createGJKObject(s2, tf2);
+    typename detail::GJKInitializer<S, Shape1>::GJKObject o1{};
+    detail::GJKInitializer<S, Shape1>::initGJKObject(s1, tf1, &o1);
+    typename detail::GJKInitializer<S, Shape2>::GJKObject o2{};
+    detail::GJKInitializer<S, Shape2>::initGJKObject(s2, tf2, &o2);
 
     bool res =  detail::GJKDistance(
-          o1,
+          &o1,
           detail::GJKInitializer<S, Shape1>::getSupportFunction(),
-          o2,
+          &o2,
           detail::GJKInitializer<S, Shape2>::getSupportFunction(),
           gjkSolver.max_distance_iterations,
           gjkSolver.distance_tolerance,
@@ -628,9 +626,6 @@ struct ShapeDistanceLibccdImpl
           p1,
           p2);
 
-    detail::GJKInitializer<S, Shape1>::deleteGJKObject(o1);
-    detail::GJKInitializer<S, Shape2>::deleteGJKObject(o2);
-
     return res;
   }
 };
@@ -833,13 +828,15 @@ struct ShapeTriangleDistanceLibccdImpl
       Vector3<S>* p1,
       Vector3<S>* p2)
   {
-    void* o1 = detail::GJKInitializer<S, Shape>::createGJKObject(s, tf);
-    void* o2 = detail::triCreateGJKObject(P1, P2, P3);
+    typename detail::GJKInitializer<S, Shape>::GJKObject o1{};
+    detail::GJKInitializer<S, Shape>::initGJKObject(s, tf, &o1);
+    detail::ccd_triangle_t o2{};
+    detail::triInitGJKObject(P1, P2, P3, &o2);
 
     bool res = detail::GJKDistance(
-          o1,
+          &o1,
           detail::GJKInitializer<S, Shape>::getSupportFunction(),
-          o2,
+          &o2,
           detail::triGetSupportFunction(),
           gjkSolver.max_distance_iterations,
           gjkSolver.distance_tolerance,
@@ -847,9 +844,6 @@ struct ShapeTriangleDistanceLibccdImpl
           p1,
           p2);
 
-    detail::GJKInitializer<S, Shape>::deleteGJKObject(o1);
-    detail::triDeleteGJKObject(o2);
-
     return res;
   }
 };
@@ -906,13 +900,15 @@ struct ShapeTransformedTriangleDistanceLibccdImpl
       Vector3<S>* p1,
       Vector3<S>* p2)
   {
-    void* o1 = detail::GJKInitializer<S, Shape>::createGJKObject(s, tf1);
-    void* o2 = detail::triCreateGJKObject(P1, P2, P3, tf2);
+    typename detail::GJKInitializer<S, Shape>::GJKObject o1{};
+    detail::GJKInitializer<S, Shape>::initGJKObject(s, tf1, &o1);
+    detail::ccd_triangle_t o2{};
+    detail::triInitGJKObject(P1, P2, P3, tf2, &o2);
 
     bool res = detail::GJKDistance(
-          o1,
+          &o1,
           detail::GJKInitializer<S, Shape>::getSupportFunction(),
-          o2,
+          &o2,
           detail::triGetSupportFunction(),
           gjkSolver.max_distance_iterations,
           gjkSolver.distance_tolerance,
@@ -920,9 +916,6 @@ struct ShapeTransformedTriangleDistanceLibccdImpl
           p1,
           p2);
 
-    detail::GJKInitializer<S, Shape>::deleteGJKObject(o1);
-    detail::triDeleteGJKObject(o2);
-
     return res;
   }
 };
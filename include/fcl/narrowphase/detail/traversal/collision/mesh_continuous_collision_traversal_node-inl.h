@@ -40,6 +40,7 @@
 
 #include "fcl/narrowphase/detail/traversal/collision/mesh_continuous_collision_traversal_node.h"
 
+#include "fcl/math/bv/utility.h"
 #include "fcl/narrowphase/detail/traversal/collision/intersect.h"
 
 namespace fcl
@@ -79,12 +80,44 @@ MeshContinuousCollisionTraversalNode<BV>::MeshContinuousCollisionTraversalNode()
   tri_indices2 = nullptr;
   prev_vertices1 = nullptr;
   prev_vertices2 = nullptr;
+  swept_bvs1 = nullptr;
+  swept_bvs2 = nullptr;
 
   num_vf_tests = 0;
   num_ee_tests = 0;
   time_of_contact = 1;
 }
 
+//==============================================================================
+template <typename BV>
+bool MeshContinuousCollisionTraversalNode<BV>::BVTesting(int b1, int b2) const
+{
+  if(!swept_bvs1 || !swept_bvs2)
+    return BVHCollisionTraversalNode<BV>::BVTesting(b1, b2);
+
+  if(this->enable_statistics) this->num_bv_tests++;
+  return !swept_bvs1[b1].overlap(swept_bvs2[b2]);
+}
+
+//==============================================================================
+template <typename BV>
+bool MeshContinuousCollisionTraversalNode<BV>::firstOverSecond(
+    int b1, int b2) const
+{
+  if(!swept_bvs1 || !swept_bvs2)
+    return BVHCollisionTraversalNode<BV>::firstOverSecond(b1, b2);
+
+  S sz1 = swept_bvs1[b1].size();
+  S sz2 = swept_bvs2[b2].size();
+
+  bool l1 = this->model1->getBV(b1).isLeaf();
+  bool l2 = this->model2->getBV(b2).isLeaf();
+
+  if(l2 || (!l1 && (sz1 > sz2)))
+    return true;
+  return false;
+}
+
 //==============================================================================
 template <typename BV>
 void MeshContinuousCollisionTraversalNode<BV>::leafTesting(int b1, int b2) const
@@ -207,6 +240,96 @@ bool initialize(
   return true;
 }
 
+//==============================================================================
+template <typename BV>
+void computeSweptBVsRecurse(
+    const BVHModel<BV>& model,
+    const Vector3<typename BV::S>* end_vertices,
+    int bv_id,
+    std::vector<BV>& swept_bvs)
+{
+  using S = typename BV::S;
+
+  const BVNode<BV>& bvnode = model.getBV(bv_id);
+  if(bvnode.isLeaf())
+  {
+    int primitive_id = bvnode.primitiveId();
+    if(model.getModelType() == BVH_MODEL_POINTCLOUD)
+    {
+      Vector3<S> v[2];
+      v[0] = model.vertices[primitive_id];
+      v[1] = end_vertices[primitive_id];
+      fit(v, 2, swept_bvs[bv_id]);
+    }
+    else
+    {
+      const Triangle& triangle = model.tri_indices[primitive_id];
+      Vector3<S> v[6];
+      for(int i = 0; i < 3; ++i)
+      {
+        v[i] = model.vertices[triangle[i]];
+        v[i + 3] = end_vertices[triangle[i]];
+      }
+      fit(v, 6, swept_bvs[bv_id]);
+    }
+  }
+  else
+  {
+    computeSweptBVsRecurse(model, end_vertices, bvnode.leftChild(), swept_bvs);
+    computeSweptBVsRecurse(model, end_vertices, bvnode.rightChild(), swept_bvs);
+    swept_bvs[bv_id] =
+        swept_bvs[bvnode.leftChild()] + swept_bvs[bvnode.rightChild()];
+  }
+}
+
+//==============================================================================
+template <typename BV>
+void computeSweptBVs(
+    const BVHModel<BV>& model,
+    const Vector3<typename BV::S>* end_vertices,
+    std::vector<BV>& swept_bvs)
+{
+  swept_bvs.resize(model.getNumBVs());
+  if(model.getNumBVs() > 0)
+    computeSweptBVsRecurse(model, end_vertices, 0, swept_bvs);
+}
+
+//==============================================================================
+template <typename BV>
+bool initialize(
+    MeshContinuousCollisionTraversalNode<BV>& node,
+    const BVHModel<BV>& model1,
+    const Transform3<typename BV::S>& tf1,
+    const Vector3<typename BV::S>* end_vertices1,
+    const std::vector<BV>& swept_bvs1,
+    const BVHModel<BV>& model2,
+    const Transform3<typename BV::S>& tf2,
+    const Vector3<typename BV::S>* end_vertices2,
+    const std::vector<BV>& swept_bvs2,
+    const CollisionRequest<typename BV::S>& request)
+{
+  if(model1.getModelType() != BVH_MODEL_TRIANGLES
+     || model2.getModelType() != BVH_MODEL_TRIANGLES)
+    return false;
+
+  if(swept_bvs1.size() != static_cast<std::size_t>(model1.getNumBVs())
+     || swept_bvs2.size() != static_cast<std::size_t>(model2.getNumBVs()))
+    return false;
+
+  initialize(node, model1, tf1, model2, tf2, request);
+
+  // The traversal only reads through these pointers.
+  node.prev_vertices1 = model1.vertices;
+  node.prev_vertices2 = model2.vertices;
+  node.vertices1 = const_cast<Vector3<typename BV::S>*>(end_vertices1);
+  node.vertices2 = const_cast<Vector3<typename BV::S>*>(end_vertices2);
+
+  node.swept_bvs1 = swept_bvs1.data();
+  node.swept_bvs2 = swept_bvs2.data();
+
+  return true;
+}
+
 } // namespace detail
 } // namespace fcl
 
@@ -38,6 +38,8 @@
 #ifndef FCL_TRAVERSAL_MESHCONTINUOUSCOLLISIONTRAVERSALNODE_H
 #define FCL_TRAVERSAL_MESHCONTINUOUSCOLLISIONTRAVERSALNODE_H
 
+#include <vector>
+
 #include "fcl/narrowphase/detail/traversal/collision/bvh_collision_traversal_node.h"
 
 namespace fcl
@@ -75,6 +77,12 @@ public:
 
   MeshContinuousCollisionTraversalNode();
 
+  /// @brief BV culling test in one BVTT node, using the swept BVs if given
+  bool BVTesting(int b1, int b2) const;
+
+  /// @brief Alternates traversal by the size of the swept BVs if given
+  bool firstOverSecond(int b1, int b2) const;
+
   /// @brief Intersection testing between leaves (two triangles)
   void leafTesting(int b1, int b2) const;
 
@@ -90,6 +98,12 @@ public:
   Vector3<S>* prev_vertices1;
   Vector3<S>* prev_vertices2;
 
+  /// @brief Per-query BVs bounding the swept primitives, indexed like the
+  /// models' BVs. When null, the models' own BVs are used, which then must
+  /// have been refit over prev_vertices and vertices.
+  const BV* swept_bvs1;
+  const BV* swept_bvs2;
+
   mutable int num_vf_tests;
   mutable int num_ee_tests;
 
@@ -110,6 +124,34 @@ bool initialize(
     const Transform3<typename BV::S>& tf2,
     const CollisionRequest<typename BV::S>& request);
 
+/// @brief Compute, for every node of the model's hierarchy, a BV bounding its
+/// primitives as their vertices move linearly from model.vertices to
+/// end_vertices. The model itself is left untouched.
+template <typename BV>
+FCL_EXPORT
+void computeSweptBVs(
+    const BVHModel<BV>& model,
+    const Vector3<typename BV::S>* end_vertices,
+    std::vector<BV>& swept_bvs);
+
+/// @brief Initialize traversal node for continuous collision detection between
+/// two meshes whose end-of-motion state is held in per-query overlays, so that
+/// the same models can be queried concurrently. end_vertices and swept_bvs
+/// must outlive the traversal.
+template <typename BV>
+FCL_EXPORT
+bool initialize(
+    MeshContinuousCollisionTraversalNode<BV>& node,
+    const BVHModel<BV>& model1,
+    const Transform3<typename BV::S>& tf1,
+    const Vector3<typename BV::S>* end_vertices1,
+    const std::vector<BV>& swept_bvs1,
+    const BVHModel<BV>& model2,
+    const Transform3<typename BV::S>& tf2,
+    const Vector3<typename BV::S>* end_vertices2,
+    const std::vector<BV>& swept_bvs2,
+    const CollisionRequest<typename BV::S>& request);
+
 } // namespace detail
 } // namespace fcl
 
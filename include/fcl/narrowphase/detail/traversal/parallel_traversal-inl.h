@@ -0,0 +1,319 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#ifndef FCL_TRAVERSAL_PARALLELTRAVERSAL_INL_H
+#define FCL_TRAVERSAL_PARALLELTRAVERSAL_INL_H
+
+#include "fcl/narrowphase/detail/traversal/parallel_traversal.h"
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace fcl
+{
+
+namespace detail
+{
+
+//==============================================================================
+template <typename Node>
+ParallelCollisionTraversalNode<Node>::ParallelCollisionTraversalNode(
+    const Node& node,
+    CollisionResult<S>* local_result,
+    std::atomic<std::size_t>* shared_num_contacts_)
+  : Node(node), shared_num_contacts(shared_num_contacts_)
+{
+  this->result = local_result;
+}
+
+//==============================================================================
+template <typename Node>
+void ParallelCollisionTraversalNode<Node>::leafTesting(int b1, int b2) const
+{
+  const std::size_t num_contacts = this->result->numContacts();
+  Node::leafTesting(b1, b2);
+  const std::size_t num_added = this->result->numContacts() - num_contacts;
+  if(num_added > 0)
+    shared_num_contacts->fetch_add(num_added, std::memory_order_relaxed);
+}
+
+//==============================================================================
+template <typename Node>
+bool ParallelCollisionTraversalNode<Node>::canStop() const
+{
+  if(Node::canStop())
+    return true;
+
+  return !this->request.enable_cost
+      && shared_num_contacts->load(std::memory_order_relaxed)
+      >= this->request.num_max_contacts;
+}
+
+//==============================================================================
+template <typename Node>
+ParallelDistanceTraversalNode<Node>::ParallelDistanceTraversalNode(
+    const Node& node,
+    DistanceResult<S>* local_result,
+    std::atomic<S>* shared_min_distance_)
+  : Node(node), shared_min_distance(shared_min_distance_)
+{
+  this->result = local_result;
+}
+
+//==============================================================================
+template <typename Node>
+void ParallelDistanceTraversalNode<Node>::leafTesting(int b1, int b2) const
+{
+  Node::leafTesting(b1, b2);
+
+  const S d = this->result->min_distance;
+  S best = shared_min_distance->load(std::memory_order_relaxed);
+  while(d < best && !shared_min_distance->compare_exchange_weak(
+          best, d, std::memory_order_relaxed))
+  {
+    // best was reloaded by the failed exchange
+  }
+}
+
+//==============================================================================
+template <typename Node>
+bool ParallelDistanceTraversalNode<Node>::canStop(S c) const
+{
+  if(Node::canStop(c))
+    return true;
+
+  const S best = shared_min_distance->load(std::memory_order_relaxed);
+  return (c >= best - this->abs_err) && (c * (1 + this->rel_err) >= best);
+}
+
+//==============================================================================
+template <typename Node>
+void collideParallel(Node* node, unsigned int num_threads)
+{
+  using S = typename Node::S;
+
+  std::shared_ptr<ThreadPool> pool = acquireTraversalThreadPool(num_threads);
+  if(!pool)
+  {
+    collide(node);
+    return;
+  }
+
+  // Expand the test tree breadth-first, as collisionRecurse() would descend
+  // it, until there are enough overlapping pairs to keep every thread busy.
+  // Each of them is the root of one task.
+  const std::size_t num_tasks_wanted = 8 * pool->size();
+  std::deque<std::pair<int, int>> open;
+  std::vector<std::pair<int, int>> tasks;
+  if(!node->BVTesting(0, 0))
+    open.emplace_back(0, 0);
+  while(!open.empty() && open.size() + tasks.size() < num_tasks_wanted)
+  {
+    const int b1 = open.front().first;
+    const int b2 = open.front().second;
+    open.pop_front();
+
+    if(node->isFirstNodeLeaf(b1) && node->isSecondNodeLeaf(b2))
+    {
+      tasks.emplace_back(b1, b2);
+      continue;
+    }
+
+    int c1[2];
+    int c2[2];
+    if(node->firstOverSecond(b1, b2))
+    {
+      c1[0] = node->getFirstLeftChild(b1);
+      c1[1] = node->getFirstRightChild(b1);
+      c2[0] = b2;
+      c2[1] = b2;
+    }
+    else
+    {
+      c1[0] = b1;
+      c1[1] = b1;
+      c2[0] = node->getSecondLeftChild(b2);
+      c2[1] = node->getSecondRightChild(b2);
+    }
+
+    for(int i = 0; i < 2; ++i)
+    {
+      if(!node->BVTesting(c1[i], c2[i]))
+        open.emplace_back(c1[i], c2[i]);
+    }
+  }
+  tasks.insert(tasks.end(), open.begin(), open.end());
+  if(tasks.empty())
+    return;
+
+  // One copy of the node per thread, each collecting into its own result
+  std::atomic<std::size_t> shared_num_contacts(node->result->numContacts());
+  std::vector<CollisionResult<S>> local_results(pool->size());
+  std::vector<std::unique_ptr<ParallelCollisionTraversalNode<Node>>>
+      local_nodes(pool->size());
+  for(unsigned int i = 0; i < pool->size(); ++i)
+  {
+    local_nodes[i].reset(new ParallelCollisionTraversalNode<Node>(
+        *node, &local_results[i], &shared_num_contacts));
+  }
+
+  pool->run(tasks.size(), [&](std::size_t task, unsigned int thread) {
+    ParallelCollisionTraversalNode<Node>* local = local_nodes[thread].get();
+    if(local->canStop())
+      return;
+    collisionRecurse<S>(local, tasks[task].first, tasks[task].second, nullptr);
+  });
+
+  for(CollisionResult<S>& local_result : local_results)
+  {
+    for(std::size_t i = 0; i < local_result.numContacts(); ++i)
+    {
+      if(node->result->numContacts() >= node->request.num_max_contacts)
+        break;
+      node->result->addContact(local_result.getContact(i));
+    }
+
+    std::vector<CostSource<S>> cost_sources;
+    local_result.getCostSources(cost_sources);
+    for(const CostSource<S>& cost_source : cost_sources)
+      node->result->addCostSource(cost_source,
+                                  node->request.num_max_cost_sources);
+  }
+}
+
+//==============================================================================
+template <typename Node>
+void distanceParallel(Node* node, unsigned int num_threads)
+{
+  using S = typename Node::S;
+
+  std::shared_ptr<ThreadPool> pool = acquireTraversalThreadPool(num_threads);
+  if(!pool)
+  {
+    distance(node);
+    return;
+  }
+
+  node->preprocess();
+
+  struct Task
+  {
+    S distance;
+    int b1;
+    int b2;
+  };
+
+  // Expand the test tree breadth-first until there are enough pairs to keep
+  // every thread busy, dropping those already farther than the seed distance
+  // found by preprocess().
+  const std::size_t num_tasks_wanted = 8 * pool->size();
+  std::deque<Task> open;
+  std::vector<Task> tasks;
+  open.push_back({node->BVTesting(0, 0), 0, 0});
+  while(!open.empty() && open.size() + tasks.size() < num_tasks_wanted)
+  {
+    const Task task = open.front();
+    open.pop_front();
+
+    if(node->isFirstNodeLeaf(task.b1) && node->isSecondNodeLeaf(task.b2))
+    {
+      tasks.push_back(task);
+      continue;
+    }
+
+    Task children[2];
+    if(node->firstOverSecond(task.b1, task.b2))
+    {
+      children[0] = {0, node->getFirstLeftChild(task.b1), task.b2};
+      children[1] = {0, node->getFirstRightChild(task.b1), task.b2};
+    }
+    else
+    {
+      children[0] = {0, task.b1, node->getSecondLeftChild(task.b2)};
+      children[1] = {0, task.b1, node->getSecondRightChild(task.b2)};
+    }
+
+    for(Task& child : children)
+    {
+      child.distance = node->BVTesting(child.b1, child.b2);
+      if(!node->canStop(child.distance))
+        open.push_back(child);
+    }
+  }
+  tasks.insert(tasks.end(), open.begin(), open.end());
+  std::sort(tasks.begin(), tasks.end(), [](const Task& a, const Task& b) {
+    return a.distance < b.distance;
+  });
+
+  // One copy of the node per thread, each starting from the seed result
+  std::atomic<S> shared_min_distance(node->result->min_distance);
+  std::vector<DistanceResult<S>> local_results(pool->size(), *node->result);
+  std::vector<std::unique_ptr<ParallelDistanceTraversalNode<Node>>>
+      local_nodes(pool->size());
+  for(unsigned int i = 0; i < pool->size(); ++i)
+  {
+    local_nodes[i].reset(new ParallelDistanceTraversalNode<Node>(
+        *node, &local_results[i], &shared_min_distance));
+  }
+
+  // The pool deals task indices round-robin and every thread works from the
+  // back of its own share, so the tasks are handed out in reverse to visit
+  // the nearest pairs first and tighten the shared bound early.
+  const std::size_t num_tasks = tasks.size();
+  pool->run(num_tasks, [&](std::size_t k, unsigned int thread) {
+    const Task& task = tasks[num_tasks - 1 - k];
+    ParallelDistanceTraversalNode<Node>* local = local_nodes[thread].get();
+    if(local->canStop(task.distance))
+      return;
+    distanceRecurse<S>(local, task.b1, task.b2, nullptr);
+  });
+
+  for(const DistanceResult<S>& local_result : local_results)
+  {
+    if(local_result.min_distance < node->result->min_distance)
+      *node->result = local_result;
+  }
+
+  node->postprocess();
+}
+
+} // namespace detail
+} // namespace fcl
+
+#endif
@@ -0,0 +1,129 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#ifndef FCL_TRAVERSAL_PARALLELTRAVERSAL_H
+#define FCL_TRAVERSAL_PARALLELTRAVERSAL_H
+
+#include <atomic>
+#include <memory>
+
+#include "fcl/common/detail/thread_pool.h"
+#include "fcl/narrowphase/detail/traversal/collision_node.h"
+
+namespace fcl
+{
+
+namespace detail
+{
+
+/// @brief Takes the process-wide pool for parallel traversals, resized to
+/// num_threads threads (0 for one per hardware core), for the lifetime of the
+/// returned pointer. Returns nullptr, and the caller runs serially, when
+/// num_threads resolves to a single thread or another query holds the pool;
+/// this also covers queries issued from inside the pool's own tasks. All the
+/// queries thus share at most one set of worker threads.
+FCL_EXPORT
+std::shared_ptr<ThreadPool> acquireTraversalThreadPool(unsigned int num_threads);
+
+/// @brief Copy of a collision traversal node that records its contacts in its
+/// own result and stops once all the copies together have found enough
+/// contacts
+template <typename Node>
+class FCL_EXPORT ParallelCollisionTraversalNode : public Node
+{
+public:
+
+  using S = typename Node::S;
+
+  ParallelCollisionTraversalNode(
+      const Node& node,
+      CollisionResult<S>* local_result,
+      std::atomic<std::size_t>* shared_num_contacts);
+
+  /// @brief Leaf test that publishes the contacts it adds
+  void leafTesting(int b1, int b2) const override;
+
+  /// @brief Whether the traversal can stop, counting every copy's contacts
+  bool canStop() const override;
+
+  std::atomic<std::size_t>* shared_num_contacts;
+};
+
+/// @brief Copy of a mesh distance traversal node that records its closest
+/// pair in its own result and prunes against the smallest distance found by
+/// any of the copies
+template <typename Node>
+class FCL_EXPORT ParallelDistanceTraversalNode : public Node
+{
+public:
+
+  using S = typename Node::S;
+
+  ParallelDistanceTraversalNode(
+      const Node& node,
+      DistanceResult<S>* local_result,
+      std::atomic<S>* shared_min_distance);
+
+  /// @brief Leaf test that publishes any distance it improves on
+  void leafTesting(int b1, int b2) const override;
+
+  /// @brief Whether the traversal can stop, given the best distance found by
+  /// any copy
+  bool canStop(S c) const override;
+
+  std::atomic<S>* shared_min_distance;
+};
+
+/// @brief Collision on a mesh-mesh traversal node, running the subtrees of
+/// the top levels of the bounding volume test tree as parallel tasks. Falls
+/// back to collide() for a single thread.
+template <typename Node>
+FCL_EXPORT
+void collideParallel(Node* node, unsigned int num_threads);
+
+/// @brief Distance on a mesh-mesh traversal node, running the subtrees of the
+/// top levels of the bounding volume test tree as parallel tasks, nearest
+/// first. Falls back to distance() for a single thread.
+template <typename Node>
+FCL_EXPORT
+void distanceParallel(Node* node, unsigned int num_threads);
+
+} // namespace detail
+} // namespace fcl
+
+#include "fcl/narrowphase/detail/traversal/parallel_traversal-inl.h"
+
+#endif
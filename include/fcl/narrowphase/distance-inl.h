@@ -60,6 +60,40 @@ double distance(
     const CollisionGeometry<double>* o2, const Transform3<double>& tf2,
     const DistanceRequest<double>& request, DistanceResult<double>& result);
 
+//==============================================================================
+extern template
+double distance(
+    const CollisionObject<double>* o1,
+    const CollisionObject<double>* o2,
+    const DistanceRequest<double>& request,
+    DistanceResult<double>& result,
+    QueryContext<double>& context);
+
+//==============================================================================
+extern template
+double distance(
+    const CollisionGeometry<double>* o1, const Transform3<double>& tf1,
+    const CollisionGeometry<double>* o2, const Transform3<double>& tf2,
+    const DistanceRequest<double>& request, DistanceResult<double>& result,
+    QueryContext<double>& context);
+
+//==============================================================================
+extern template
+double distance(
+    const CollisionObject<double>* o1,
+    const CollisionObject<double>* o2,
+    const DistanceRequest<double>& request,
+    DistanceResult<double>& result,
+    GJKSimplexCache<double>& cache);
+
+//==============================================================================
+extern template
+double distance(
+    const CollisionGeometry<double>* o1, const Transform3<double>& tf1,
+    const CollisionGeometry<double>* o2, const Transform3<double>& tf2,
+    const DistanceRequest<double>& request, DistanceResult<double>& result,
+    GJKSimplexCache<double>& cache);
+
 //==============================================================================
 template <typename GJKSolver>
 detail::DistanceFunctionMatrix<GJKSolver>& getDistanceFunctionLookTable()
@@ -245,6 +279,89 @@ S distance(
   }
 }
 
+//==============================================================================
+template <typename S>
+S distance(
+    const CollisionObject<S>* o1,
+    const CollisionObject<S>* o2,
+    const DistanceRequest<S>& request,
+    DistanceResult<S>& result,
+    QueryContext<S>& context)
+{
+  switch(request.gjk_solver_type)
+  {
+  case GST_LIBCCD:
+    return distance(o1, o2, &context.getLibccdSolver(request), request, result);
+  case GST_INDEP:
+    return distance(o1, o2, &context.getIndepSolver(request), request, result);
+  default:
+    return -1;
+  }
+}
+
+//==============================================================================
+template <typename S>
+S distance(
+    const CollisionGeometry<S>* o1, const Transform3<S>& tf1,
+    const CollisionGeometry<S>* o2, const Transform3<S>& tf2,
+    const DistanceRequest<S>& request, DistanceResult<S>& result,
+    QueryContext<S>& context)
+{
+  switch(request.gjk_solver_type)
+  {
+  case GST_LIBCCD:
+    return distance(o1, tf1, o2, tf2, &context.getLibccdSolver(request),
+                    request, result);
+  case GST_INDEP:
+    return distance(o1, tf1, o2, tf2, &context.getIndepSolver(request),
+                    request, result);
+  default:
+    return -1;
+  }
+}
+
+//==============================================================================
+template <typename S>
+S distance(
+    const CollisionObject<S>* o1,
+    const CollisionObject<S>* o2,
+    const DistanceRequest<S>& request,
+    DistanceResult<S>& result,
+    GJKSimplexCache<S>& cache)
+{
+  return distance(o1->collisionGeometry().get(), o1->getTransform(),
+                  o2->collisionGeometry().get(), o2->getTransform(),
+                  request, result, cache);
+}
+
+//==============================================================================
+template <typename S>
+S distance(
+    const CollisionGeometry<S>* o1, const Transform3<S>& tf1,
+    const CollisionGeometry<S>* o2, const Transform3<S>& tf2,
+    const DistanceRequest<S>& request, DistanceResult<S>& result,
+    GJKSimplexCache<S>& cache)
+{
+  switch(request.gjk_solver_type)
+  {
+  case GST_LIBCCD:
+    {
+      detail::GJKSolver_libccd<S> solver;
+      solver.distance_tolerance = request.distance_tolerance;
+      return distance(o1, tf1, o2, tf2, &solver, request, result);
+    }
+  case GST_INDEP:
+    {
+      detail::GJKSolver_indep<S> solver;
+      solver.gjk_tolerance = request.distance_tolerance;
+      solver.gjk_simplex_cache = &cache;
+      return distance(o1, tf1, o2, tf2, &solver, request, result);
+    }
+  default:
+    return -1;
+  }
+}
+
 } // namespace fcl
 
 #endif
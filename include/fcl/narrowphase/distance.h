@@ -42,6 +42,8 @@
 #include "fcl/narrowphase/detail/distance_func_matrix.h"
 #include "fcl/narrowphase/detail/gjk_solver_indep.h"
 #include "fcl/narrowphase/detail/gjk_solver_libccd.h"
+#include "fcl/narrowphase/gjk_simplex_cache.h"
+#include "fcl/narrowphase/query_context.h"
 
 namespace fcl
 {
@@ -61,6 +63,41 @@ S distance(
     const CollisionGeometry<S>* o2, const Transform3<S>& tf2,
     const DistanceRequest<S>& request, DistanceResult<S>& result);
 
+/// @brief Same as distance() above, but reuses the solver and scratch storage
+/// held by context instead of setting them up for every call
+template <typename S>
+FCL_EXPORT
+S distance(
+    const CollisionObject<S>* o1, const CollisionObject<S>* o2,
+    const DistanceRequest<S>& request, DistanceResult<S>& result,
+    QueryContext<S>& context);
+
+template <typename S>
+FCL_EXPORT
+S distance(
+    const CollisionGeometry<S>* o1, const Transform3<S>& tf1,
+    const CollisionGeometry<S>* o2, const Transform3<S>& tf2,
+    const DistanceRequest<S>& request, DistanceResult<S>& result,
+    QueryContext<S>& context);
+
+/// @brief Same as distance() above for a pair of objects queried over and
+/// over, e.g., every control cycle: GJK starts from the simplex that the
+/// previous query with the same cache ended with. See GJKSimplexCache.
+template <typename S>
+FCL_EXPORT
+S distance(
+    const CollisionObject<S>* o1, const CollisionObject<S>* o2,
+    const DistanceRequest<S>& request, DistanceResult<S>& result,
+    GJKSimplexCache<S>& cache);
+
+template <typename S>
+FCL_EXPORT
+S distance(
+    const CollisionGeometry<S>* o1, const Transform3<S>& tf1,
+    const CollisionGeometry<S>* o2, const Transform3<S>& tf2,
+    const DistanceRequest<S>& request, DistanceResult<S>& result,
+    GJKSimplexCache<S>& cache);
+
 } // namespace fcl
 
 #include "fcl/narrowphase/distance-inl.h"
@@ -101,6 +101,16 @@ struct FCL_EXPORT DistanceRequest
   /// @brief narrow phase solver type
   GJKSolverType gjk_solver_type;
 
+  /// @brief If true, mesh-mesh queries split the traversal of the bounding
+  /// volume test tree into subtasks that run on a thread pool, sharing the
+  /// best distance found so far between them for pruning
+  bool enable_parallel_traversal{false};
+
+  /// @brief Number of threads used by the parallel traversal, including the
+  /// calling thread; 0 means one thread per hardware core. All the queries
+  /// share one pool, and a query finding it in use traverses serially.
+  unsigned int num_traversal_threads{0};
+
   explicit DistanceRequest(
       bool enable_nearest_points_ = false,
       bool enable_signed_distance = false,
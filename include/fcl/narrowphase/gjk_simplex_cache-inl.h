@@ -0,0 +1,167 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#ifndef FCL_NARROWPHASE_GJKSIMPLEXCACHE_INL_H
+#define FCL_NARROWPHASE_GJKSIMPLEXCACHE_INL_H
+
+#include "fcl/narrowphase/gjk_simplex_cache.h"
+
+namespace fcl
+{
+
+//==============================================================================
+extern template
+class FCL_EXPORT GJKSimplexCache<double>;
+
+//==============================================================================
+template <typename S>
+GJKSimplexCache<S>::GJKSimplexCache()
+  : measure_iterations_saved_(false)
+{
+  clear();
+}
+
+//==============================================================================
+template <typename S>
+void GJKSimplexCache<S>::clear()
+{
+  shapes_[0] = nullptr;
+  shapes_[1] = nullptr;
+  rank_ = 0;
+  query_count_ = 0;
+  warm_start_count_ = 0;
+  last_iterations_ = 0;
+  iterations_saved_ = 0;
+}
+
+//==============================================================================
+template <typename S>
+std::size_t GJKSimplexCache<S>::getQueryCount() const
+{
+  return query_count_;
+}
+
+//==============================================================================
+template <typename S>
+std::size_t GJKSimplexCache<S>::getWarmStartCount() const
+{
+  return warm_start_count_;
+}
+
+//==============================================================================
+template <typename S>
+unsigned int GJKSimplexCache<S>::getLastIterations() const
+{
+  return last_iterations_;
+}
+
+//==============================================================================
+template <typename S>
+void GJKSimplexCache<S>::setMeasureIterationsSaved(bool enabled)
+{
+  measure_iterations_saved_ = enabled;
+}
+
+//==============================================================================
+template <typename S>
+long GJKSimplexCache<S>::getIterationsSaved() const
+{
+  return iterations_saved_;
+}
+
+//==============================================================================
+template <typename S>
+template <typename GJKType, typename MinkowskiDiffT>
+typename detail::GJKBase<S>::Status GJKSimplexCache<S>::evaluate(
+    GJKType& gjk, const MinkowskiDiffT& shape, const Vector3<S>& guess)
+{
+  const bool warm = rank_ > 0
+      && shapes_[0] == shape.shapes[0] && shapes_[1] == shape.shapes[1];
+
+  if(warm && measure_iterations_saved_)
+  {
+    GJKType cold_gjk(gjk.getMaxIterations(), gjk.getTolerance());
+    cold_gjk.evaluate(shape, guess);
+    iterations_saved_ += cold_gjk.getIterations();
+  }
+
+  typename detail::GJKBase<S>::Status status
+      = gjk.evaluate(shape, guess, directions_, warm ? rank_ : 0);
+  unsigned int iterations = gjk.getIterations();
+
+  // EPA grows the simplex that GJK ends with, and the contact it reports
+  // depends on that simplex: a warm run that ends inside is redone cold, so
+  // that the cache never changes the contact of a penetrating pair.
+  if(warm && status == detail::GJKBase<S>::Inside)
+  {
+    status = gjk.evaluate(shape, guess);
+    iterations += gjk.getIterations();
+  }
+
+  ++query_count_;
+  last_iterations_ = iterations;
+  if(warm)
+  {
+    ++warm_start_count_;
+    if(measure_iterations_saved_)
+      iterations_saved_ -= last_iterations_;
+  }
+
+  shapes_[0] = shape.shapes[0];
+  shapes_[1] = shape.shapes[1];
+  // For the same reason, a penetrating pair starts its next query cold
+  if(status == detail::GJKBase<S>::Inside)
+    rank_ = 0;
+  else
+    update(gjk);
+
+  return status;
+}
+
+//==============================================================================
+template <typename S>
+template <typename GJKType>
+void GJKSimplexCache<S>::update(const GJKType& gjk)
+{
+  const typename detail::GJKBase<S>::Simplex& simplex = *gjk.getSimplex();
+  rank_ = simplex.rank;
+  for(std::size_t i = 0; i < rank_; ++i)
+    directions_[i] = simplex.c[i]->d;
+}
+
+} // namespace fcl
+
+#endif
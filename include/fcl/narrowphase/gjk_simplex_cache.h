@@ -0,0 +1,132 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#ifndef FCL_NARROWPHASE_GJKSIMPLEXCACHE_H
+#define FCL_NARROWPHASE_GJKSIMPLEXCACHE_H
+
+#include "fcl/common/types.h"
+#include "fcl/geometry/shape/shape_base.h"
+#include "fcl/narrowphase/detail/convexity_based_algorithm/gjk.h"
+
+namespace fcl
+{
+
+/// @brief GJK state of one pair of shapes, carried from one query to the next.
+///
+/// Pass the same cache to the collide() or distance() calls on a pair of
+/// shapes that moves little between calls, e.g., two robot links checked
+/// every control cycle. A GST_INDEP query that solves the pair with GJK then
+/// starts from the final simplex of the previous query, re-evaluated at the
+/// new poses, instead of from a single support point. Pairs solved in closed
+/// form (e.g., sphere-sphere) and GST_LIBCCD queries do not use the cache. A
+/// cache holds one pair; given another pair, it starts over cold.
+///
+/// The contact EPA reports for a penetrating pair depends on the simplex it
+/// starts from, so GJK runs that find the shapes penetrating are redone from
+/// a cold start and not stored: the cache speeds up separated pairs and
+/// leaves the results of penetrating ones unchanged.
+template <typename S>
+class FCL_EXPORT GJKSimplexCache
+{
+public:
+
+  GJKSimplexCache();
+
+  /// @brief forget the simplex and the statistics
+  void clear();
+
+  /// @brief the number of GJK runs made with this cache
+  std::size_t getQueryCount() const;
+
+  /// @brief the number of GJK runs that were warm started
+  std::size_t getWarmStartCount() const;
+
+  /// @brief the number of iterations of the last GJK run
+  unsigned int getLastIterations() const;
+
+  /// @brief whether to repeat every warm started GJK run from a cold start,
+  /// which measures getIterationsSaved(). Off by default: it is meant for
+  /// profiling, as it doubles the GJK work of warm started runs.
+  void setMeasureIterationsSaved(bool enabled);
+
+  /// @brief the GJK iterations that warm starting saved, summed over the warm
+  /// started runs made while setMeasureIterationsSaved() was on. Negative if
+  /// the warm starts needed more iterations than cold starts.
+  long getIterationsSaved() const;
+
+  /// @brief run gjk on shape, warm started from the simplex stored for the
+  /// same pair of shapes, then store the final simplex of gjk
+  template <typename GJKType, typename MinkowskiDiffT>
+  typename detail::GJKBase<S>::Status evaluate(
+      GJKType& gjk, const MinkowskiDiffT& shape, const Vector3<S>& guess);
+
+private:
+
+  /// @brief store the current simplex of gjk
+  template <typename GJKType>
+  void update(const GJKType& gjk);
+
+  const ShapeBase<S>* shapes_[2];
+
+  /// @brief support directions of the stored simplex, in the frame of the
+  /// first shape
+  Vector3<S> directions_[4];
+
+  std::size_t rank_;
+
+  std::size_t query_count_;
+
+  std::size_t warm_start_count_;
+
+  unsigned int last_iterations_;
+
+  bool measure_iterations_saved_;
+
+  long iterations_saved_;
+
+public:
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+using GJKSimplexCachef = GJKSimplexCache<float>;
+using GJKSimplexCached = GJKSimplexCache<double>;
+
+} // namespace fcl
+
+#include "fcl/narrowphase/gjk_simplex_cache-inl.h"
+
+#endif
@@ -0,0 +1,572 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#ifndef FCL_NARROWPHASE_PRIMITIVEBATCH_INL_H
+#define FCL_NARROWPHASE_PRIMITIVEBATCH_INL_H
+
+#include "fcl/narrowphase/primitive_batch.h"
+
+#include <algorithm>
+
+#include "fcl/math/constants.h"
+
+namespace fcl
+{
+
+//==============================================================================
+extern template
+class FCL_EXPORT SphereSphereBatch<double>;
+
+//==============================================================================
+extern template
+class FCL_EXPORT SphereCapsuleBatch<double>;
+
+//==============================================================================
+extern template
+class FCL_EXPORT CapsuleCapsuleBatch<double>;
+
+//==============================================================================
+extern template
+class FCL_EXPORT SphereBoxBatch<double>;
+
+//==============================================================================
+extern template
+void batchDistance(const SphereSphereBatch<double>& batch,
+                   std::vector<double>& distances);
+
+//==============================================================================
+extern template
+void batchDistance(const SphereCapsuleBatch<double>& batch,
+                   std::vector<double>& distances);
+
+//==============================================================================
+extern template
+void batchDistance(const CapsuleCapsuleBatch<double>& batch,
+                   std::vector<double>& distances);
+
+//==============================================================================
+extern template
+void batchDistance(const SphereBoxBatch<double>& batch,
+                   std::vector<double>& distances);
+
+//==============================================================================
+extern template
+std::size_t batchCollide(const SphereSphereBatch<double>& batch,
+                         std::vector<std::size_t>& colliding);
+
+//==============================================================================
+extern template
+std::size_t batchCollide(const SphereCapsuleBatch<double>& batch,
+                         std::vector<std::size_t>& colliding);
+
+//==============================================================================
+extern template
+std::size_t batchCollide(const CapsuleCapsuleBatch<double>& batch,
+                         std::vector<std::size_t>& colliding);
+
+//==============================================================================
+extern template
+std::size_t batchCollide(const SphereBoxBatch<double>& batch,
+                         std::vector<std::size_t>& colliding);
+
+namespace detail
+{
+
+/// @brief the number of pairs the batched queries evaluate at a time; the
+/// temporaries of one block stay on the stack and in the L1 cache
+constexpr int kPrimitiveBatchBlockSize = 64;
+
+template <typename S>
+using BatchBlock = Eigen::Array<S, Eigen::Dynamic, 1, Eigen::ColMajor,
+                                kPrimitiveBatchBlockSize, 1>;
+
+//==============================================================================
+template <typename S>
+Eigen::Map<const Eigen::Array<S, Eigen::Dynamic, 1>> batchSegment(
+    const std::vector<S>& v, std::size_t begin, Eigen::Index length)
+{
+  return Eigen::Map<const Eigen::Array<S, Eigen::Dynamic, 1>>(
+        v.data() + begin, length);
+}
+
+//==============================================================================
+template <typename S>
+Eigen::Map<Eigen::Array<S, Eigen::Dynamic, 1>> batchSegment(
+    std::vector<S>& v, std::size_t begin, Eigen::Index length)
+{
+  return Eigen::Map<Eigen::Array<S, Eigen::Dynamic, 1>>(
+        v.data() + begin, length);
+}
+
+//==============================================================================
+inline Eigen::Index batchBlockLength(std::size_t size, std::size_t begin)
+{
+  return static_cast<Eigen::Index>(
+        std::min<std::size_t>(kPrimitiveBatchBlockSize, size - begin));
+}
+
+//==============================================================================
+template <typename S>
+std::size_t collectCollidingPairs(const std::vector<S>& distances,
+                                  std::vector<std::size_t>& colliding)
+{
+  colliding.clear();
+  for(std::size_t i = 0; i < distances.size(); ++i)
+  {
+    if(distances[i] <= 0)
+      colliding.push_back(i);
+  }
+  return colliding.size();
+}
+
+} // namespace detail
+
+//==============================================================================
+template <typename S>
+void SphereSphereBatch<S>::add(const Sphere<S>& s1, const Transform3<S>& tf1,
+                               const Sphere<S>& s2, const Transform3<S>& tf2)
+{
+  x1.push_back(tf1.translation()[0]);
+  y1.push_back(tf1.translation()[1]);
+  z1.push_back(tf1.translation()[2]);
+  radius1.push_back(s1.radius);
+
+  x2.push_back(tf2.translation()[0]);
+  y2.push_back(tf2.translation()[1]);
+  z2.push_back(tf2.translation()[2]);
+  radius2.push_back(s2.radius);
+}
+
+//==============================================================================
+template <typename S>
+void SphereSphereBatch<S>::clear()
+{
+  for(auto* v : {&x1, &y1, &z1, &radius1, &x2, &y2, &z2, &radius2})
+    v->clear();
+}
+
+//==============================================================================
+template <typename S>
+void SphereSphereBatch<S>::reserve(std::size_t n)
+{
+  for(auto* v : {&x1, &y1, &z1, &radius1, &x2, &y2, &z2, &radius2})
+    v->reserve(n);
+}
+
+//==============================================================================
+template <typename S>
+std::size_t SphereSphereBatch<S>::size() const
+{
+  return radius1.size();
+}
+
+//==============================================================================
+template <typename S>
+void SphereCapsuleBatch<S>::add(const Sphere<S>& s1, const Transform3<S>& tf1,
+                                const Capsule<S>& s2, const Transform3<S>& tf2)
+{
+  x1.push_back(tf1.translation()[0]);
+  y1.push_back(tf1.translation()[1]);
+  z1.push_back(tf1.translation()[2]);
+  radius1.push_back(s1.radius);
+
+  const Vector3<S> half_axis = tf2.linear().col(2) * (s2.lz / 2);
+  x2.push_back(tf2.translation()[0]);
+  y2.push_back(tf2.translation()[1]);
+  z2.push_back(tf2.translation()[2]);
+  ax2.push_back(half_axis[0]);
+  ay2.push_back(half_axis[1]);
+  az2.push_back(half_axis[2]);
+  radius2.push_back(s2.radius);
+}
+
+//==============================================================================
+template <typename S>
+void SphereCapsuleBatch<S>::clear()
+{
+  for(auto* v : {&x1, &y1, &z1, &radius1,
+                 &x2, &y2, &z2, &ax2, &ay2, &az2, &radius2})
+    v->clear();
+}
+
+//==============================================================================
+template <typename S>
+void SphereCapsuleBatch<S>::reserve(std::size_t n)
+{
+  for(auto* v : {&x1, &y1, &z1, &radius1,
+                 &x2, &y2, &z2, &ax2, &ay2, &az2, &radius2})
+    v->reserve(n);
+}
+
+//==============================================================================
+template <typename S>
+std::size_t SphereCapsuleBatch<S>::size() const
+{
+  return radius1.size();
+}
+
+//==============================================================================
+template <typename S>
+void CapsuleCapsuleBatch<S>::add(const Capsule<S>& s1, const Transform3<S>& tf1,
+                                 const Capsule<S>& s2, const Transform3<S>& tf2)
+{
+  const Vector3<S> half_axis_1 = tf1.linear().col(2) * (s1.lz / 2);
+  x1.push_back(tf1.translation()[0]);
+  y1.push_back(tf1.translation()[1]);
+  z1.push_back(tf1.translation()[2]);
+  ax1.push_back(half_axis_1[0]);
+  ay1.push_back(half_axis_1[1]);
+  az1.push_back(half_axis_1[2]);
+  radius1.push_back(s1.radius);
+
+  const Vector3<S> half_axis_2 = tf2.linear().col(2) * (s2.lz / 2);
+  x2.push_back(tf2.translation()[0]);
+  y2.push_back(tf2.translation()[1]);
+  z2.push_back(tf2.translation()[2]);
+  ax2.push_back(half_axis_2[0]);
+  ay2.push_back(half_axis_2[1]);
+  az2.push_back(half_axis_2[2]);
+  radius2.push_back(s2.radius);
+}
+
+//==============================================================================
+template <typename S>
+void CapsuleCapsuleBatch<S>::clear()
+{
+  for(auto* v : {&x1, &y1, &z1, &ax1, &ay1, &az1, &radius1,
+                 &x2, &y2, &z2, &ax2, &ay2, &az2, &radius2})
+    v->clear();
+}
+
+//==============================================================================
+template <typename S>
+void CapsuleCapsuleBatch<S>::reserve(std::size_t n)
+{
+  for(auto* v : {&x1, &y1, &z1, &ax1, &ay1, &az1, &radius1,
+                 &x2, &y2, &z2, &ax2, &ay2, &az2, &radius2})
+    v->reserve(n);
+}
+
+//==============================================================================
+template <typename S>
+std::size_t CapsuleCapsuleBatch<S>::size() const
+{
+  return radius1.size();
+}
+
+//==============================================================================
+template <typename S>
+void SphereBoxBatch<S>::add(const Sphere<S>& s1, const Transform3<S>& tf1,
+                            const Box<S>& s2, const Transform3<S>& tf2)
+{
+  x1.push_back(tf1.translation()[0]);
+  y1.push_back(tf1.translation()[1]);
+  z1.push_back(tf1.translation()[2]);
+  radius1.push_back(s1.radius);
+
+  x2.push_back(tf2.translation()[0]);
+  y2.push_back(tf2.translation()[1]);
+  z2.push_back(tf2.translation()[2]);
+  for(int i = 0; i < 3; ++i)
+  {
+    for(int j = 0; j < 3; ++j)
+      rotation2[3 * i + j].push_back(tf2.linear()(i, j));
+  }
+  hx2.push_back(s2.side[0] / 2);
+  hy2.push_back(s2.side[1] / 2);
+  hz2.push_back(s2.side[2] / 2);
+}
+
+//==============================================================================
+template <typename S>
+void SphereBoxBatch<S>::clear()
+{
+  for(auto* v : {&x1, &y1, &z1, &radius1, &x2, &y2, &z2, &hx2, &hy2, &hz2})
+    v->clear();
+  for(auto& v : rotation2)
+    v.clear();
+}
+
+//==============================================================================
+template <typename S>
+void SphereBoxBatch<S>::reserve(std::size_t n)
+{
+  for(auto* v : {&x1, &y1, &z1, &radius1, &x2, &y2, &z2, &hx2, &hy2, &hz2})
+    v->reserve(n);
+  for(auto& v : rotation2)
+    v.reserve(n);
+}
+
+//==============================================================================
+template <typename S>
+std::size_t SphereBoxBatch<S>::size() const
+{
+  return radius1.size();
+}
+
+//==============================================================================
+template <typename S>
+void batchDistance(const SphereSphereBatch<S>& batch,
+                   std::vector<S>& distances)
+{
+  using Block = detail::BatchBlock<S>;
+
+  const std::size_t n = batch.size();
+  distances.resize(n);
+
+  for(std::size_t begin = 0; begin < n;
+      begin += detail::kPrimitiveBatchBlockSize)
+  {
+    const Eigen::Index m = detail::batchBlockLength(n, begin);
+    auto in = [&](const std::vector<S>& v)
+    { return detail::batchSegment(v, begin, m); };
+
+    // Same as sphereSphereDistance(), with the penetration depth of
+    // sphereSphereIntersect() when the spheres overlap.
+    const Block dx = in(batch.x2) - in(batch.x1);
+    const Block dy = in(batch.y2) - in(batch.y1);
+    const Block dz = in(batch.z2) - in(batch.z1);
+    detail::batchSegment(distances, begin, m)
+        = (dx.square() + dy.square() + dz.square()).sqrt()
+        - in(batch.radius1) - in(batch.radius2);
+  }
+}
+
+//==============================================================================
+template <typename S>
+void batchDistance(const SphereCapsuleBatch<S>& batch,
+                   std::vector<S>& distances)
+{
+  using Block = detail::BatchBlock<S>;
+
+  const std::size_t n = batch.size();
+  distances.resize(n);
+
+  for(std::size_t begin = 0; begin < n;
+      begin += detail::kPrimitiveBatchBlockSize)
+  {
+    const Eigen::Index m = detail::batchBlockLength(n, begin);
+    auto in = [&](const std::vector<S>& v)
+    { return detail::batchSegment(v, begin, m); };
+
+    // Same as lineSegmentPointClosestToPoint() on the segment from the +z end
+    // (center + half axis) to the -z end of the capsule's center line.
+    const Block wx = in(batch.x1) - in(batch.x2) - in(batch.ax2);
+    const Block wy = in(batch.y1) - in(batch.y2) - in(batch.ay2);
+    const Block wz = in(batch.z1) - in(batch.z2) - in(batch.az2);
+    const Block c1 = S(-2) * (wx * in(batch.ax2) + wy * in(batch.ay2)
+                              + wz * in(batch.az2));
+    const Block c2 = S(4) * (in(batch.ax2).square() + in(batch.ay2).square()
+                             + in(batch.az2).square());
+    const Block t = (c1 / (c2 > S(0)).select(c2, S(1))).max(S(0)).min(S(1));
+
+    // The sphere center relative to the nearest point on the segment is
+    // w - v * t, with v = -2 * half axis.
+    const Block ex = wx + S(2) * t * in(batch.ax2);
+    const Block ey = wy + S(2) * t * in(batch.ay2);
+    const Block ez = wz + S(2) * t * in(batch.az2);
+    detail::batchSegment(distances, begin, m)
+        = (ex.square() + ey.square() + ez.square()).sqrt()
+        - in(batch.radius1) - in(batch.radius2);
+  }
+}
+
+//==============================================================================
+template <typename S>
+void batchDistance(const CapsuleCapsuleBatch<S>& batch,
+                   std::vector<S>& distances)
+{
+  using Block = detail::BatchBlock<S>;
+
+  const std::size_t n = batch.size();
+  distances.resize(n);
+
+  const S kEps = constants<S>::eps_78();
+  const S kEpsSquared = kEps * kEps;
+
+  for(std::size_t begin = 0; begin < n;
+      begin += detail::kPrimitiveBatchBlockSize)
+  {
+    const Eigen::Index m = detail::batchBlockLength(n, begin);
+    auto in = [&](const std::vector<S>& v)
+    { return detail::batchSegment(v, begin, m); };
+
+    // closestPtSegmentSegment() on the segments P1Q1 and P2Q2, where P is the
+    // +z end of a center line and Q the -z end, evaluated for all its cases
+    // and then blended by the conditions that pick the case.
+    const Block d1x = S(-2) * in(batch.ax1);
+    const Block d1y = S(-2) * in(batch.ay1);
+    const Block d1z = S(-2) * in(batch.az1);
+    const Block d2x = S(-2) * in(batch.ax2);
+    const Block d2y = S(-2) * in(batch.ay2);
+    const Block d2z = S(-2) * in(batch.az2);
+    const Block rx
+        = in(batch.x1) + in(batch.ax1) - in(batch.x2) - in(batch.ax2);
+    const Block ry
+        = in(batch.y1) + in(batch.ay1) - in(batch.y2) - in(batch.ay2);
+    const Block rz
+        = in(batch.z1) + in(batch.az1) - in(batch.z2) - in(batch.az2);
+
+    const Block a = d1x.square() + d1y.square() + d1z.square();
+    const Block e = d2x.square() + d2y.square() + d2z.square();
+    const Block f = d2x * rx + d2y * ry + d2z * rz;
+    const Block c = d1x * rx + d1y * ry + d1z * rz;
+    const Block b = d1x * d2x + d1y * d2y + d1z * d2z;
+    const Block denom = (a * e - b * b).max(S(0));
+
+    // Reciprocals with the degenerate denominators replaced by one; the
+    // results that used them are discarded by the selects below.
+    const Block inv_a = (a > kEpsSquared).select(a, S(1)).inverse();
+    const Block inv_e = (e > kEpsSquared).select(e, S(1)).inverse();
+    const Block inv_denom
+        = (denom > kEpsSquared).select(denom, S(1)).inverse();
+
+    Block s = (denom > kEpsSquared).select(
+          ((b * f - c * e) * inv_denom).max(S(0)).min(S(1)), S(0));
+    Block t = (b * s + f) * inv_e;
+    const Block s_at_t0 = (-c * inv_a).max(S(0)).min(S(1));
+    const Block s_at_t1 = ((b - c) * inv_a).max(S(0)).min(S(1));
+    s = (t < S(0)).select(s_at_t0, (t > S(1)).select(s_at_t1, s));
+    t = t.max(S(0)).min(S(1));
+
+    // Segment 2 degenerates into a point.
+    s = (e > kEpsSquared).select(s, s_at_t0);
+    t = (e > kEpsSquared).select(t, S(0));
+
+    // Segment 1 degenerates into a point, possibly with segment 2 as well.
+    const Block t_at_s0 = (f * inv_e).max(S(0)).min(S(1));
+    t = (a > kEpsSquared).select(
+          t, (e > kEpsSquared).select(t_at_s0, S(0)));
+    s = (a > kEpsSquared).select(s, S(0));
+
+    const Block wx = rx + d1x * s - d2x * t;
+    const Block wy = ry + d1y * s - d2y * t;
+    const Block wz = rz + d1z * s - d2z * t;
+    detail::batchSegment(distances, begin, m)
+        = (wx.square() + wy.square() + wz.square()).sqrt()
+        - in(batch.radius1) - in(batch.radius2);
+  }
+}
+
+//==============================================================================
+template <typename S>
+void batchDistance(const SphereBoxBatch<S>& batch, std::vector<S>& distances)
+{
+  using Block = detail::BatchBlock<S>;
+
+  const std::size_t n = batch.size();
+  distances.resize(n);
+
+  for(std::size_t begin = 0; begin < n;
+      begin += detail::kPrimitiveBatchBlockSize)
+  {
+    const Eigen::Index m = detail::batchBlockLength(n, begin);
+    auto in = [&](const std::vector<S>& v)
+    { return detail::batchSegment(v, begin, m); };
+    auto rotation = [&](int i, int j)
+    { return in(batch.rotation2[3 * i + j]); };
+
+    // The sphere center C in the box frame B: p_BC = R_FB^T * (p_FC - p_FB).
+    const Block dx = in(batch.x1) - in(batch.x2);
+    const Block dy = in(batch.y1) - in(batch.y2);
+    const Block dz = in(batch.z1) - in(batch.z2);
+    const Block px
+        = rotation(0, 0) * dx + rotation(1, 0) * dy + rotation(2, 0) * dz;
+    const Block py
+        = rotation(0, 1) * dx + rotation(1, 1) * dy + rotation(2, 1) * dz;
+    const Block pz
+        = rotation(0, 2) * dx + rotation(1, 2) * dy + rotation(2, 2) * dz;
+
+    // As in sphereBoxIntersect(): if the center is outside the box, the
+    // distance is measured to the nearest point in the box; if it is inside,
+    // the penetration depth is the distance to the nearest face plus the
+    // radius.
+    const Block qx = px - px.max(-in(batch.hx2)).min(in(batch.hx2));
+    const Block qy = py - py.max(-in(batch.hy2)).min(in(batch.hy2));
+    const Block qz = pz - pz.max(-in(batch.hz2)).min(in(batch.hz2));
+    const Block outside_squared = qx.square() + qy.square() + qz.square();
+    const Block inside = (in(batch.hx2) - px.abs())
+        .min(in(batch.hy2) - py.abs())
+        .min(in(batch.hz2) - pz.abs());
+    detail::batchSegment(distances, begin, m)
+        = (outside_squared > S(0)).select(outside_squared.sqrt(), -inside)
+        - in(batch.radius1);
+  }
+}
+
+//==============================================================================
+template <typename S>
+std::size_t batchCollide(const SphereSphereBatch<S>& batch,
+                         std::vector<std::size_t>& colliding)
+{
+  std::vector<S> distances;
+  batchDistance(batch, distances);
+  return detail::collectCollidingPairs(distances, colliding);
+}
+
+//==============================================================================
+template <typename S>
+std::size_t batchCollide(const SphereCapsuleBatch<S>& batch,
+                         std::vector<std::size_t>& colliding)
+{
+  std::vector<S> distances;
+  batchDistance(batch, distances);
+  return detail::collectCollidingPairs(distances, colliding);
+}
+
+//==============================================================================
+template <typename S>
+std::size_t batchCollide(const CapsuleCapsuleBatch<S>& batch,
+                         std::vector<std::size_t>& colliding)
+{
+  std::vector<S> distances;
+  batchDistance(batch, distances);
+  return detail::collectCollidingPairs(distances, colliding);
+}
+
+//==============================================================================
+template <typename S>
+std::size_t batchCollide(const SphereBoxBatch<S>& batch,
+                         std::vector<std::size_t>& colliding)
+{
+  std::vector<S> distances;
+  batchDistance(batch, distances);
+  return detail::collectCollidingPairs(distances, colliding);
+}
+
+} // namespace fcl
+
+#endif
@@ -0,0 +1,249 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+#ifndef FCL_NARROWPHASE_PRIMITIVEBATCH_H
+#define FCL_NARROWPHASE_PRIMITIVEBATCH_H
+
+#include <vector>
+
+#include "fcl/common/types.h"
+#include "fcl/geometry/shape/box.h"
+#include "fcl/geometry/shape/capsule.h"
+#include "fcl/geometry/shape/sphere.h"
+
+namespace fcl
+{
+
+/** @name       Batched primitive queries
+
+ These classes and functions evaluate many sphere-sphere, sphere-capsule,
+ capsule-capsule, or sphere-box pairs in one call, without going through
+ collide() or distance() for every pair. Each batch stores its pairs as a
+ structure of arrays (entry i of every array belongs to pair i) in a common
+ frame F, so the queries run block by block on Eigen arrays and use the SIMD
+ instructions the library is compiled with.
+
+ The queries report the signed distance of every pair: the separating distance
+ if the shapes are apart and minus the penetration depth if they overlap, with
+ the same values as the closed-form algorithms in primitive_shape_algorithm.
+ Touching counts as collision. Contact points and normals are not computed;
+ call the per-pair algorithms (e.g., collide()) for the colliding pairs that
+ need them.
+ */
+
+//@{
+
+/// @brief A batch of sphere-sphere pairs.
+template <typename S_>
+class FCL_EXPORT SphereSphereBatch
+{
+public:
+
+  using S = S_;
+
+  /// @brief add the pair (s1 posed at tf1, s2 posed at tf2)
+  void add(const Sphere<S>& s1, const Transform3<S>& tf1,
+           const Sphere<S>& s2, const Transform3<S>& tf2);
+
+  /// @brief remove all the pairs
+  void clear();
+
+  /// @brief reserve space for n pairs
+  void reserve(std::size_t n);
+
+  /// @brief the number of pairs
+  std::size_t size() const;
+
+  /// @brief centers and radii of the first spheres
+  std::vector<S> x1, y1, z1, radius1;
+
+  /// @brief centers and radii of the second spheres
+  std::vector<S> x2, y2, z2, radius2;
+};
+
+/// @brief A batch of sphere-capsule pairs.
+template <typename S_>
+class FCL_EXPORT SphereCapsuleBatch
+{
+public:
+
+  using S = S_;
+
+  /// @brief add the pair (s1 posed at tf1, s2 posed at tf2)
+  void add(const Sphere<S>& s1, const Transform3<S>& tf1,
+           const Capsule<S>& s2, const Transform3<S>& tf2);
+
+  /// @brief remove all the pairs
+  void clear();
+
+  /// @brief reserve space for n pairs
+  void reserve(std::size_t n);
+
+  /// @brief the number of pairs
+  std::size_t size() const;
+
+  /// @brief centers and radii of the spheres
+  std::vector<S> x1, y1, z1, radius1;
+
+  /// @brief centers, half axes (from the center to the +z end of the center
+  /// line), and radii of the capsules
+  std::vector<S> x2, y2, z2, ax2, ay2, az2, radius2;
+};
+
+/// @brief A batch of capsule-capsule pairs.
+template <typename S_>
+class FCL_EXPORT CapsuleCapsuleBatch
+{
+public:
+
+  using S = S_;
+
+  /// @brief add the pair (s1 posed at tf1, s2 posed at tf2)
+  void add(const Capsule<S>& s1, const Transform3<S>& tf1,
+           const Capsule<S>& s2, const Transform3<S>& tf2);
+
+  /// @brief remove all the pairs
+  void clear();
+
+  /// @brief reserve space for n pairs
+  void reserve(std::size_t n);
+
+  /// @brief the number of pairs
+  std::size_t size() const;
+
+  /// @brief centers, half axes, and radii of the first capsules
+  std::vector<S> x1, y1, z1, ax1, ay1, az1, radius1;
+
+  /// @brief centers, half axes, and radii of the second capsules
+  std::vector<S> x2, y2, z2, ax2, ay2, az2, radius2;
+};
+
+/// @brief A batch of sphere-box pairs.
+template <typename S_>
+class FCL_EXPORT SphereBoxBatch
+{
+public:
+
+  using S = S_;
+
+  /// @brief add the pair (s1 posed at tf1, s2 posed at tf2)
+  void add(const Sphere<S>& s1, const Transform3<S>& tf1,
+           const Box<S>& s2, const Transform3<S>& tf2);
+
+  /// @brief remove all the pairs
+  void clear();
+
+  /// @brief reserve space for n pairs
+  void reserve(std::size_t n);
+
+  /// @brief the number of pairs
+  std::size_t size() const;
+
+  /// @brief centers and radii of the spheres
+  std::vector<S> x1, y1, z1, radius1;
+
+  /// @brief centers of the boxes
+  std::vector<S> x2, y2, z2;
+
+  /// @brief rotations of the boxes; rotation2[3 * i + j] holds entry (i, j) of
+  /// the rotation matrices
+  std::vector<S> rotation2[9];
+
+  /// @brief half sizes of the boxes
+  std::vector<S> hx2, hy2, hz2;
+};
+
+/// @brief compute the signed distance of every pair of the batch
+/// @param[out] distances resized to batch.size()
+template <typename S>
+FCL_EXPORT
+void batchDistance(const SphereSphereBatch<S>& batch,
+                   std::vector<S>& distances);
+
+template <typename S>
+FCL_EXPORT
+void batchDistance(const SphereCapsuleBatch<S>& batch,
+                   std::vector<S>& distances);
+
+template <typename S>
+FCL_EXPORT
+void batchDistance(const CapsuleCapsuleBatch<S>& batch,
+                   std::vector<S>& distances);
+
+template <typename S>
+FCL_EXPORT
+void batchDistance(const SphereBoxBatch<S>& batch,
+                   std::vector<S>& distances);
+
+/// @brief find the colliding pairs of the batch
+/// @param[out] colliding the indices of the colliding pairs, in increasing
+/// order
+/// @return the number of colliding pairs
+template <typename S>
+FCL_EXPORT
+std::size_t batchCollide(const SphereSphereBatch<S>& batch,
+                         std::vector<std::size_t>& colliding);
+
+template <typename S>
+FCL_EXPORT
+std::size_t batchCollide(const SphereCapsuleBatch<S>& batch,
+                         std::vector<std::size_t>& colliding);
+
+template <typename S>
+FCL_EXPORT
+std::size_t batchCollide(const CapsuleCapsuleBatch<S>& batch,
+                         std::vector<std::size_t>& colliding);
+
+template <typename S>
+FCL_EXPORT
+std::size_t batchCollide(const SphereBoxBatch<S>& batch,
+                         std::vector<std::size_t>& colliding);
+
+//@}
+
+using SphereSphereBatchf = SphereSphereBatch<float>;
+using SphereSphereBatchd = SphereSphereBatch<double>;
+using SphereCapsuleBatchf = SphereCapsuleBatch<float>;
+using SphereCapsuleBatchd = SphereCapsuleBatch<double>;
+using CapsuleCapsuleBatchf = CapsuleCapsuleBatch<float>;
+using CapsuleCapsuleBatchd = CapsuleCapsuleBatch<double>;
+using SphereBoxBatchf = SphereBoxBatch<float>;
+using SphereBoxBatchd = SphereBoxBatch<double>;
+
+} // namespace fcl
+
+#include "fcl/narrowphase/primitive_batch-inl.h"
+
+#endif
@@ -0,0 +1,122 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#ifndef FCL_NARROWPHASE_QUERYCONTEXT_INL_H
+#define FCL_NARROWPHASE_QUERYCONTEXT_INL_H
+
+#include "fcl/narrowphase/query_context.h"
+
+namespace fcl
+{
+
+//==============================================================================
+extern template
+class FCL_EXPORT QueryContext<double>;
+
+//==============================================================================
+template <typename S>
+QueryContext<S>::QueryContext()
+  : epa_(indep_solver_.epa_max_face_num,
+         indep_solver_.epa_max_vertex_num,
+         indep_solver_.epa_max_iterations,
+         indep_solver_.epa_tolerance)
+{
+  indep_solver_.epa_workspace = &epa_;
+  indep_solver_.support_vertex_cache = &support_vertex_cache_;
+}
+
+//==============================================================================
+template <typename S>
+const detail::GJKSolver_libccd<S>& QueryContext<S>::getLibccdSolver(
+    const CollisionRequest<S>& request)
+{
+  libccd_solver_ = detail::GJKSolver_libccd<S>();
+  libccd_solver_.collision_tolerance = request.gjk_tolerance;
+  return libccd_solver_;
+}
+
+//==============================================================================
+template <typename S>
+const detail::GJKSolver_libccd<S>& QueryContext<S>::getLibccdSolver(
+    const DistanceRequest<S>& request)
+{
+  libccd_solver_ = detail::GJKSolver_libccd<S>();
+  libccd_solver_.distance_tolerance = request.distance_tolerance;
+  return libccd_solver_;
+}
+
+//==============================================================================
+template <typename S>
+const detail::GJKSolver_indep<S>& QueryContext<S>::getIndepSolver(
+    const CollisionRequest<S>& request)
+{
+  resetIndepSolver();
+  indep_solver_.gjk_tolerance = request.gjk_tolerance;
+  indep_solver_.epa_tolerance = request.gjk_tolerance;
+  return indep_solver_;
+}
+
+//==============================================================================
+template <typename S>
+const detail::GJKSolver_indep<S>& QueryContext<S>::getIndepSolver(
+    const DistanceRequest<S>& request)
+{
+  resetIndepSolver();
+  indep_solver_.gjk_tolerance = request.distance_tolerance;
+  return indep_solver_;
+}
+
+//==============================================================================
+template <typename S>
+void QueryContext<S>::resetIndepSolver()
+{
+  // Start from the defaults each time so that a query never inherits settings
+  // (e.g., a cached guess) left behind by the previous one.
+  indep_solver_ = detail::GJKSolver_indep<S>();
+  indep_solver_.epa_workspace = &epa_;
+  indep_solver_.support_vertex_cache = &support_vertex_cache_;
+}
+
+//==============================================================================
+template <typename S>
+detail::SupportVertexCache<S>& QueryContext<S>::getSupportVertexCache()
+{
+  return support_vertex_cache_;
+}
+
+} // namespace fcl
+
+#endif
@@ -0,0 +1,110 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#ifndef FCL_NARROWPHASE_QUERYCONTEXT_H
+#define FCL_NARROWPHASE_QUERYCONTEXT_H
+
+#include "fcl/narrowphase/collision_request.h"
+#include "fcl/narrowphase/distance_request.h"
+#include "fcl/narrowphase/detail/gjk_solver_indep.h"
+#include "fcl/narrowphase/detail/gjk_solver_libccd.h"
+#include "fcl/narrowphase/detail/convexity_based_algorithm/epa.h"
+#include "fcl/narrowphase/detail/convexity_based_algorithm/minkowski_diff.h"
+
+namespace fcl
+{
+
+/// @brief Scratch state reused by consecutive collide() and distance() calls.
+///
+/// The plain query functions set up a new narrow phase solver, and for
+/// penetrating GST_INDEP queries a new EPA polytope, on every call. A context
+/// keeps both alive so that a thread issuing many queries only pays for them
+/// once. A context is not thread-safe; use one per thread.
+template <typename S>
+class FCL_EXPORT QueryContext
+{
+public:
+
+  QueryContext();
+
+  QueryContext(const QueryContext&) = delete;
+
+  QueryContext& operator=(const QueryContext&) = delete;
+
+  /// @brief libccd solver configured as collide() would for the request
+  const detail::GJKSolver_libccd<S>& getLibccdSolver(
+      const CollisionRequest<S>& request);
+
+  /// @brief libccd solver configured as distance() would for the request
+  const detail::GJKSolver_libccd<S>& getLibccdSolver(
+      const DistanceRequest<S>& request);
+
+  /// @brief Built-in GJK solver configured as collide() would for the
+  /// request, backed by the EPA workspace of this context
+  const detail::GJKSolver_indep<S>& getIndepSolver(
+      const CollisionRequest<S>& request);
+
+  /// @brief Built-in GJK solver configured as distance() would for the
+  /// request, backed by the EPA workspace of this context
+  const detail::GJKSolver_indep<S>& getIndepSolver(
+      const DistanceRequest<S>& request);
+
+  /// @brief The support vertices of the Convex shapes that the GST_INDEP
+  /// queries of this context found last, per shape pair. The GJK and EPA of a
+  /// later query on the same pair start their support searches from them.
+  detail::SupportVertexCache<S>& getSupportVertexCache();
+
+private:
+
+  void resetIndepSolver();
+
+  detail::GJKSolver_libccd<S> libccd_solver_;
+
+  detail::GJKSolver_indep<S> indep_solver_;
+
+  detail::EPA<S> epa_;
+
+  detail::SupportVertexCache<S> support_vertex_cache_;
+};
+
+using QueryContextf = QueryContext<float>;
+using QueryContextd = QueryContext<double>;
+
+} // namespace fcl
+
+#include "fcl/narrowphase/query_context-inl.h"
+
+#endif
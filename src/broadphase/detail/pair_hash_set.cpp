@@ -0,0 +1,141 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#include "fcl/broadphase/detail/pair_hash_set.h"
+
+#include <utility>
+
+namespace fcl
+{
+
+namespace detail
+{
+
+//==============================================================================
+PairHashSet::PairHashSet()
+{
+  // Do nothing
+}
+
+//==============================================================================
+PairHashSet::Key PairHashSet::makeKey(uint32 a, uint32 b)
+{
+  if(a > b)
+    std::swap(a, b);
+  return (static_cast<Key>(a) << 32) | b;
+}
+
+//==============================================================================
+uint32 PairHashSet::first(Key key)
+{
+  return static_cast<uint32>(key >> 32);
+}
+
+//==============================================================================
+uint32 PairHashSet::second(Key key)
+{
+  return static_cast<uint32>(key & 0xFFFFFFFFu);
+}
+
+//==============================================================================
+bool PairHashSet::insert(Key key, unsigned char tag)
+{
+  if(contains(key))
+    return false;
+
+  table_.insert(key, tag);
+  return true;
+}
+
+//==============================================================================
+bool PairHashSet::erase(Key key, unsigned char* tag)
+{
+  const std::size_t slot = findSlot(key);
+  if(slot == table_.capacity())
+    return false;
+
+  if(tag)
+    *tag = table_.value(slot);
+  table_.erase(slot);
+  return true;
+}
+
+//==============================================================================
+bool PairHashSet::contains(Key key) const
+{
+  return findSlot(key) != table_.capacity();
+}
+
+//==============================================================================
+bool PairHashSet::setTag(Key key, unsigned char tag, unsigned char* old_tag)
+{
+  const std::size_t slot = findSlot(key);
+  if(slot == table_.capacity())
+    return false;
+
+  if(old_tag)
+    *old_tag = table_.value(slot);
+  table_.value(slot) = tag;
+  return true;
+}
+
+//==============================================================================
+std::size_t PairHashSet::size() const
+{
+  return table_.size();
+}
+
+//==============================================================================
+bool PairHashSet::empty() const
+{
+  return table_.empty();
+}
+
+//==============================================================================
+void PairHashSet::clear()
+{
+  table_.clear();
+}
+
+//==============================================================================
+std::size_t PairHashSet::findSlot(Key key) const
+{
+  // A pair is stored at most once, whatever its tag
+  return table_.find(key, [](unsigned char) { return true; });
+}
+
+} // namespace detail
+} // namespace fcl
@@ -0,0 +1,211 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "fcl/common/detail/thread_pool.h"
+
+namespace fcl {
+namespace detail {
+
+//==============================================================================
+ThreadPool::ThreadPool(unsigned int num_threads)
+  : num_threads_(resolveNumThreads(num_threads)),
+    task_(nullptr),
+    generation_(0),
+    active_workers_(0),
+    stop_(false)
+{
+  queues_.reserve(num_threads_);
+  for (unsigned int i = 0; i < num_threads_; ++i)
+    queues_.emplace_back(new TaskQueue);
+
+  workers_.reserve(num_threads_ - 1);
+  for (unsigned int i = 1; i < num_threads_; ++i)
+    workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+//==============================================================================
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    stop_ = true;
+  }
+  start_cv_.notify_all();
+
+  for (auto& worker : workers_)
+    worker.join();
+}
+
+//==============================================================================
+unsigned int ThreadPool::size() const
+{
+  return num_threads_;
+}
+
+//==============================================================================
+void ThreadPool::run(std::size_t num_tasks, const Task& task)
+{
+  if (num_tasks == 0)
+    return;
+
+  std::lock_guard<std::mutex> run_lock(run_mutex_);
+
+  if (num_threads_ == 1 || num_tasks == 1)
+  {
+    for (std::size_t i = 0; i < num_tasks; ++i)
+      task(i, 0);
+    return;
+  }
+
+  for (std::size_t i = 0; i < num_tasks; ++i)
+  {
+    TaskQueue& queue = *queues_[i % num_threads_];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(i);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    task_ = &task;
+    exception_ = nullptr;
+    active_workers_ = num_threads_ - 1;
+    ++generation_;
+  }
+  start_cv_.notify_all();
+
+  drain(0);
+
+  std::exception_ptr exception;
+  {
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    done_cv_.wait(lock, [this] { return active_workers_ == 0; });
+    task_ = nullptr;
+    exception = exception_;
+    exception_ = nullptr;
+  }
+
+  if (exception)
+    std::rethrow_exception(exception);
+}
+
+//==============================================================================
+unsigned int ThreadPool::resolveNumThreads(unsigned int num_threads)
+{
+  if (num_threads > 0)
+    return num_threads;
+
+  const unsigned int hardware_threads = std::thread::hardware_concurrency();
+  return (hardware_threads > 0) ? hardware_threads : 1;
+}
+
+//==============================================================================
+void ThreadPool::workerLoop(unsigned int thread_id)
+{
+  std::size_t seen_generation = 0;
+
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(state_mutex_);
+      start_cv_.wait(lock, [this, seen_generation] {
+        return stop_ || generation_ != seen_generation;
+      });
+      if (stop_)
+        return;
+      seen_generation = generation_;
+    }
+
+    drain(thread_id);
+
+    {
+      std::lock_guard<std::mutex> lock(state_mutex_);
+      --active_workers_;
+    }
+    done_cv_.notify_one();
+  }
+}
+
+//==============================================================================
+void ThreadPool::drain(unsigned int thread_id)
+{
+  std::size_t task_id;
+  while (popTask(thread_id, task_id))
+  {
+    try
+    {
+      (*task_)(task_id, thread_id);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(state_mutex_);
+      if (!exception_)
+        exception_ = std::current_exception();
+    }
+  }
+}
+
+//==============================================================================
+bool ThreadPool::popTask(unsigned int thread_id, std::size_t& task_id)
+{
+  // Own work first, newest task first
+  {
+    TaskQueue& queue = *queues_[thread_id];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty())
+    {
+      task_id = queue.tasks.back();
+      queue.tasks.pop_back();
+      return true;
+    }
+  }
+
+  // Then steal the oldest task of another thread
+  for (unsigned int i = 1; i < num_threads_; ++i)
+  {
+    TaskQueue& queue = *queues_[(thread_id + i) % num_threads_];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty())
+    {
+      task_id = queue.tasks.front();
+      queue.tasks.pop_front();
+      return true;
+    }
+  }
+
+  return false;
+}
+
+} // namespace detail
+} // namespace fcl
@@ -0,0 +1,147 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#include "fcl/geometry/bvh/detail/BVH_lbvh.h"
+
+#include <algorithm>
+
+namespace fcl
+{
+
+namespace detail
+{
+
+namespace
+{
+
+//==============================================================================
+int countLeadingZeros(uint64 x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return x ? __builtin_clzll(x) : 64;
+#else
+  int n = 0;
+  for(uint64 bit = uint64(1) << 63; bit && !(x & bit); bit >>= 1)
+    ++n;
+  return n;
+#endif
+}
+
+//==============================================================================
+/// Length of the common prefix of the keys i and j, or -1 when j is out of
+/// range. Equal codes are extended by their position to keep keys unique.
+int commonPrefix(const std::vector<uint64>& codes, int i, int j)
+{
+  if(j < 0 || j >= static_cast<int>(codes.size()))
+    return -1;
+
+  if(codes[i] == codes[j])
+    return 64 + countLeadingZeros(static_cast<uint64>(i ^ j));
+
+  return countLeadingZeros(codes[i] ^ codes[j]);
+}
+
+//==============================================================================
+LBVHNode computeNode(const std::vector<uint64>& codes, int i)
+{
+  // direction of the range covered by node i
+  const int d = (commonPrefix(codes, i, i + 1)
+                 - commonPrefix(codes, i, i - 1)) >= 0 ? 1 : -1;
+
+  // upper bound for the length of the range, then its exact other end
+  const int min_prefix = commonPrefix(codes, i, i - d);
+  int max_length = 2;
+  while(commonPrefix(codes, i, i + max_length * d) > min_prefix)
+    max_length *= 2;
+
+  int length = 0;
+  for(int t = max_length / 2; t >= 1; t /= 2)
+  {
+    if(commonPrefix(codes, i, i + (length + t) * d) > min_prefix)
+      length += t;
+  }
+  const int j = i + length * d;
+
+  // the split is where the common prefix of the range changes
+  const int node_prefix = commonPrefix(codes, i, j);
+  int s = 0;
+  int t = length;
+  do
+  {
+    t = (t + 1) / 2;
+    if(commonPrefix(codes, i, i + (s + t) * d) > node_prefix)
+      s += t;
+  } while(t > 1);
+
+  LBVHNode node;
+  node.first = std::min(i, j);
+  node.last = std::max(i, j);
+  node.split = i + s * d + std::min(d, 0);
+  return node;
+}
+
+} // namespace
+
+//==============================================================================
+void buildLBVHRadixTree(
+    const std::vector<uint64>& sorted_codes,
+    std::vector<LBVHNode>& nodes,
+    ThreadPool* pool)
+{
+  const int num_internal = static_cast<int>(sorted_codes.size()) - 1;
+  nodes.resize(std::max(num_internal, 0));
+  if(num_internal <= 0)
+    return;
+
+  if(!pool)
+  {
+    for(int i = 0; i < num_internal; ++i)
+      nodes[i] = computeNode(sorted_codes, i);
+    return;
+  }
+
+  const int chunk = 1024;
+  const int num_chunks = (num_internal + chunk - 1) / chunk;
+  pool->run(num_chunks, [&](std::size_t c, unsigned int) {
+    const int begin = static_cast<int>(c) * chunk;
+    const int end = std::min(begin + chunk, num_internal);
+    for(int i = begin; i < end; ++i)
+      nodes[i] = computeNode(sorted_codes, i);
+  });
+}
+
+} // namespace detail
+} // namespace fcl
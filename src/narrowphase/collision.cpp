@@ -58,4 +58,44 @@ std::size_t collide(
     const CollisionRequest<double>& request,
     CollisionResult<double>& result);
 
+//==============================================================================
+template
+std::size_t collide(
+    const CollisionObject<double>* o1,
+    const CollisionObject<double>* o2,
+    const CollisionRequest<double>& request,
+    CollisionResult<double>& result,
+    QueryContext<double>& context);
+
+//==============================================================================
+template
+std::size_t collide(
+    const CollisionGeometry<double>* o1,
+    const Transform3<double>& tf1,
+    const CollisionGeometry<double>* o2,
+    const Transform3<double>& tf2,
+    const CollisionRequest<double>& request,
+    CollisionResult<double>& result,
+    QueryContext<double>& context);
+
+//==============================================================================
+template
+std::size_t collide(
+    const CollisionObject<double>* o1,
+    const CollisionObject<double>* o2,
+    const CollisionRequest<double>& request,
+    CollisionResult<double>& result,
+    GJKSimplexCache<double>& cache);
+
+//==============================================================================
+template
+std::size_t collide(
+    const CollisionGeometry<double>* o1,
+    const Transform3<double>& tf1,
+    const CollisionGeometry<double>* o2,
+    const Transform3<double>& tf2,
+    const CollisionRequest<double>& request,
+    CollisionResult<double>& result,
+    GJKSimplexCache<double>& cache);
+
 } // namespace fcl
@@ -72,6 +72,16 @@ double continuousCollide(
     const ContinuousCollisionRequest<double>& request,
     ContinuousCollisionResult<double>& result);
 
+//==============================================================================
+template
+double continuousCollideTrajectory(
+    const CollisionObject<double>* o1,
+    const aligned_vector<Transform3<double>>& waypoints1,
+    const CollisionObject<double>* o2,
+    const aligned_vector<Transform3<double>>& waypoints2,
+    const ContinuousCollisionRequest<double>& request,
+    TrajectoryCollisionResult<double>& result);
+
 //==============================================================================
 template
 double collide(
@@ -43,4 +43,7 @@ namespace fcl
 template
 struct ContinuousCollisionResult<double>;
 
+template
+struct TrajectoryCollisionResult<double>;
+
 } // namespace fcl
@@ -43,6 +43,9 @@ namespace fcl
 namespace detail
 {
 
+template
+struct GJKBase<double>;
+
 template
 struct GJK<double>;
 
@@ -84,6 +84,23 @@ void* triCreateGJKObject(
     const Vector3d& P3,
     const Transform3d& tf);
 
+//==============================================================================
+template
+void triInitGJKObject(
+    const Vector3d& P1,
+    const Vector3d& P2,
+    const Vector3d& P3,
+    ccd_triangle_t* o);
+
+//==============================================================================
+template
+void triInitGJKObject(
+    const Vector3d& P1,
+    const Vector3d& P2,
+    const Vector3d& P3,
+    const Transform3d& tf,
+    ccd_triangle_t* o);
+
 //==============================================================================
 template
 bool GJKCollide(
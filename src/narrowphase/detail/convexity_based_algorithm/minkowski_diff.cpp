@@ -46,5 +46,8 @@ namespace detail
 template
 struct MinkowskiDiff<double>;
 
+template
+class SupportVertexCache<double>;
+
 } // namespace detail
 } // namespace fcl
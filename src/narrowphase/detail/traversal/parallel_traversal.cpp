@@ -0,0 +1,92 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#include "fcl/narrowphase/detail/traversal/parallel_traversal.h"
+
+#include <memory>
+#include <mutex>
+
+namespace fcl
+{
+
+namespace detail
+{
+
+namespace
+{
+
+struct TraversalThreadPool
+{
+  std::mutex mutex;
+  std::unique_ptr<ThreadPool> pool;
+  bool in_use{false};
+};
+
+TraversalThreadPool& getSharedTraversalThreadPool()
+{
+  // Never destroyed, so that no worker has to be joined during static
+  // destruction
+  static TraversalThreadPool* shared = new TraversalThreadPool;
+  return *shared;
+}
+
+} // namespace
+
+//==============================================================================
+std::shared_ptr<ThreadPool> acquireTraversalThreadPool(unsigned int num_threads)
+{
+  const unsigned int n = ThreadPool::resolveNumThreads(num_threads);
+  if(n == 1)
+    return nullptr;
+
+  TraversalThreadPool& shared = getSharedTraversalThreadPool();
+  std::lock_guard<std::mutex> lock(shared.mutex);
+  if(shared.in_use)
+    return nullptr;
+
+  if(!shared.pool || shared.pool->size() != n)
+    shared.pool.reset(new ThreadPool(n));
+  shared.in_use = true;
+
+  return std::shared_ptr<ThreadPool>(shared.pool.get(), [](ThreadPool*) {
+    TraversalThreadPool& shared = getSharedTraversalThreadPool();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    shared.in_use = false;
+  });
+}
+
+} // namespace detail
+} // namespace fcl
@@ -0,0 +1,98 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#include "fcl/narrowphase/primitive_batch-inl.h"
+
+namespace fcl
+{
+
+//==============================================================================
+template
+class SphereSphereBatch<double>;
+
+//==============================================================================
+template
+class SphereCapsuleBatch<double>;
+
+//==============================================================================
+template
+class CapsuleCapsuleBatch<double>;
+
+//==============================================================================
+template
+class SphereBoxBatch<double>;
+
+//==============================================================================
+template
+void batchDistance(const SphereSphereBatch<double>& batch,
+                   std::vector<double>& distances);
+
+//==============================================================================
+template
+void batchDistance(const SphereCapsuleBatch<double>& batch,
+                   std::vector<double>& distances);
+
+//==============================================================================
+template
+void batchDistance(const CapsuleCapsuleBatch<double>& batch,
+                   std::vector<double>& distances);
+
+//==============================================================================
+template
+void batchDistance(const SphereBoxBatch<double>& batch,
+                   std::vector<double>& distances);
+
+//==============================================================================
+template
+std::size_t batchCollide(const SphereSphereBatch<double>& batch,
+                         std::vector<std::size_t>& colliding);
+
+//==============================================================================
+template
+std::size_t batchCollide(const SphereCapsuleBatch<double>& batch,
+                         std::vector<std::size_t>& colliding);
+
+//==============================================================================
+template
+std::size_t batchCollide(const CapsuleCapsuleBatch<double>& batch,
+                         std::vector<std::size_t>& colliding);
+
+//==============================================================================
+template
+std::size_t batchCollide(const SphereBoxBatch<double>& batch,
+                         std::vector<std::size_t>& colliding);
+
+} // namespace fcl
@@ -0,0 +1,492 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+/// Performance harness for the broadphase collision managers.
+///
+/// For every BroadPhaseCollisionManager implementation, scene size, geometry
+/// kind and motion pattern, the harness times registration, setup, update,
+/// self-collision, one-vs-many queries and manager-vs-manager queries, and
+/// writes the results as JSON. The collision callback only counts the pairs
+/// with overlapping AABBs, so the timings cover the broadphase alone; the pair
+/// counts let managers and runs (e.g. two FCL versions) be checked for
+/// agreement. The managers with OBB or k-DOP leaves report fewer pairs, and
+/// the difference is the narrowphase work they remove; the robot geometry
+/// (chains of long thin links) shows it best.
+///
+/// Usage: fcl_benchmarks [--sizes 100,1000] [--geometry shape,mesh,robot]
+///                       [--motion static,jitter,teleport] [--steps N]
+///                       [--queries N] [--managers name,...] [--seed N]
+///                       [--output file.json]
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "fcl/config.h"
+#include "fcl/broadphase/broadphase_bruteforce.h"
+#include "fcl/broadphase/broadphase_spatialhash.h"
+#include "fcl/broadphase/broadphase_SaP.h"
+#include "fcl/broadphase/broadphase_SaP_array.h"
+#include "fcl/broadphase/broadphase_SSaP.h"
+#include "fcl/broadphase/broadphase_interval_tree.h"
+#include "fcl/broadphase/broadphase_dynamic_AABB_tree.h"
+#include "fcl/broadphase/broadphase_dynamic_AABB_tree_array.h"
+#include "fcl/broadphase/broadphase_dynamic_AABB_tree_leaf_BV.h"
+#include "fcl/geometry/shape/box.h"
+#include "fcl/geometry/shape/capsule.h"
+#include "fcl/geometry/geometric_shape_to_BVH_model.h"
+#include "test_fcl_utility.h"
+
+using namespace fcl;
+
+using S = double;
+
+namespace {
+
+//==============================================================================
+struct Options
+{
+  std::vector<std::size_t> sizes = {100, 1000};
+  std::vector<std::string> geometries = {"shape", "mesh", "robot"};
+  std::vector<std::string> motions = {"static", "jitter", "teleport"};
+  std::vector<std::string> managers;
+  std::size_t steps = 10;
+  std::size_t queries = 100;
+  unsigned int seed = 1;
+  std::string output;
+};
+
+//==============================================================================
+struct ManagerFactory
+{
+  std::string name;
+  std::function<BroadPhaseCollisionManager<S>*(
+      std::vector<CollisionObject<S>*>&)> create;
+};
+
+//==============================================================================
+struct Result
+{
+  std::string manager;
+  std::string geometry;
+  std::string motion;
+  std::size_t num_objects = 0;
+  double register_ms = 0;
+  double setup_ms = 0;
+  double update_ms = 0;
+  double self_collide_ms = 0;
+  std::size_t self_collide_pairs = 0;
+  double one_vs_many_ms = 0;
+  std::size_t one_vs_many_pairs = 0;
+  double manager_vs_manager_ms = 0;
+  std::size_t manager_vs_manager_pairs = 0;
+};
+
+//==============================================================================
+bool countPairs(CollisionObject<S>* o1, CollisionObject<S>* o2, void* cdata)
+{
+  // Managers may report pairs whose AABBs do not overlap (e.g. the naive
+  // manager reports all of them); only count the real candidates so that the
+  // numbers agree across managers.
+  if(o1->getAABB().overlap(o2->getAABB()))
+    ++*static_cast<std::size_t*>(cdata);
+  return false;
+}
+
+//==============================================================================
+std::vector<std::string> split(const std::string& list)
+{
+  std::vector<std::string> items;
+  std::stringstream ss(list);
+  std::string item;
+  while(std::getline(ss, item, ','))
+  {
+    if(!item.empty())
+      items.push_back(item);
+  }
+  return items;
+}
+
+//==============================================================================
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+  for(int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if(i + 1 >= argc)
+    {
+      std::cerr << "Missing value for " << arg << std::endl;
+      return false;
+    }
+    const std::string value = argv[++i];
+
+    if(arg == "--sizes")
+    {
+      options.sizes.clear();
+      for(const auto& size : split(value))
+        options.sizes.push_back(std::stoul(size));
+    }
+    else if(arg == "--geometry")
+      options.geometries = split(value);
+    else if(arg == "--motion")
+      options.motions = split(value);
+    else if(arg == "--managers")
+      options.managers = split(value);
+    else if(arg == "--steps")
+      options.steps = std::stoul(value);
+    else if(arg == "--queries")
+      options.queries = std::stoul(value);
+    else if(arg == "--seed")
+      options.seed = static_cast<unsigned int>(std::stoul(value));
+    else if(arg == "--output")
+      options.output = value;
+    else
+    {
+      std::cerr << "Unknown option " << arg << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+//==============================================================================
+std::vector<ManagerFactory> managerFactories()
+{
+  std::vector<ManagerFactory> factories;
+
+  factories.push_back({"NaiveCollisionManager",
+    [](std::vector<CollisionObject<S>*>&) -> BroadPhaseCollisionManager<S>* {
+      return new NaiveCollisionManager<S>(); }});
+  factories.push_back({"SSaPCollisionManager",
+    [](std::vector<CollisionObject<S>*>&) -> BroadPhaseCollisionManager<S>* {
+      return new SSaPCollisionManager<S>(); }});
+  factories.push_back({"SaPCollisionManager",
+    [](std::vector<CollisionObject<S>*>&) -> BroadPhaseCollisionManager<S>* {
+      return new SaPCollisionManager<S>(); }});
+  factories.push_back({"SaPCollisionManager_Array",
+    [](std::vector<CollisionObject<S>*>&) -> BroadPhaseCollisionManager<S>* {
+      return new SaPCollisionManager_Array<S>(); }});
+  factories.push_back({"IntervalTreeCollisionManager",
+    [](std::vector<CollisionObject<S>*>&) -> BroadPhaseCollisionManager<S>* {
+      return new IntervalTreeCollisionManager<S>(); }});
+  factories.push_back({"SpatialHashingCollisionManager",
+    [](std::vector<CollisionObject<S>*>& env) -> BroadPhaseCollisionManager<S>* {
+      Vector3<S> lower_limit, upper_limit;
+      SpatialHashingCollisionManager<S>::computeBound(env, lower_limit, upper_limit);
+      const Vector3<S> range = upper_limit - lower_limit;
+      const S cell_size = range.minCoeff() / 20;
+      return new SpatialHashingCollisionManager<S>(cell_size, lower_limit, upper_limit); }});
+  factories.push_back({"DynamicAABBTreeCollisionManager",
+    [](std::vector<CollisionObject<S>*>&) -> BroadPhaseCollisionManager<S>* {
+      return new DynamicAABBTreeCollisionManager<S>(); }});
+  factories.push_back({"DynamicAABBTreeCollisionManager_Array",
+    [](std::vector<CollisionObject<S>*>&) -> BroadPhaseCollisionManager<S>* {
+      return new DynamicAABBTreeCollisionManager_Array<S>(); }});
+  factories.push_back({"DynamicAABBTreeOBBCollisionManager",
+    [](std::vector<CollisionObject<S>*>&) -> BroadPhaseCollisionManager<S>* {
+      return new DynamicAABBTreeLeafBVCollisionManager<OBB<S>>(); }});
+  factories.push_back({"DynamicAABBTreeKDOP18CollisionManager",
+    [](std::vector<CollisionObject<S>*>&) -> BroadPhaseCollisionManager<S>* {
+      return new DynamicAABBTreeLeafBVCollisionManager<KDOP<S, 18>>(); }});
+
+  return factories;
+}
+
+//==============================================================================
+void generateRobots(std::size_t n, S env_scale,
+                    std::vector<CollisionObject<S>*>& env)
+{
+  // Arms of six links, alternately capsules and boxes, each link turned by
+  // random joint angles relative to the previous one
+  const std::size_t num_links = 6;
+  const S link_length = 0.2 * env_scale;
+  const S link_radius = 0.01 * env_scale;
+  auto capsule = std::make_shared<Capsule<S>>(link_radius, link_length);
+  auto box = std::make_shared<Box<S>>(
+        2 * link_radius, 2 * link_radius, link_length);
+  auto random = [](S max) { return 2 * (rand() / (S)RAND_MAX - 0.5) * max; };
+
+  const std::size_t num_robots = std::max<std::size_t>(1, n / num_links);
+  for(std::size_t i = 0; i < num_robots; ++i)
+  {
+    Transform3<S> joint = Transform3<S>::Identity();
+    joint.translation() = Vector3<S>(
+          random(env_scale), random(env_scale), random(env_scale));
+    for(std::size_t j = 0; j < num_links; ++j)
+    {
+      joint.linear() = joint.linear()
+          * Matrix3<S>(AngleAxis<S>(random(constants<S>::pi()), Vector3<S>::UnitZ())
+                       * AngleAxis<S>(random(constants<S>::pi() / 2), Vector3<S>::UnitY()));
+      Transform3<S> link = joint;
+      link.translation() = joint * Vector3<S>(0, 0, link_length / 2);
+
+      CollisionObject<S>* obj = (j % 2 == 0)
+          ? new CollisionObject<S>(capsule, link)
+          : new CollisionObject<S>(box, link);
+      env.push_back(obj);
+
+      const Vector3<S> next_joint = joint * Vector3<S>(0, 0, link_length);
+      joint.translation() = next_joint;
+    }
+  }
+}
+
+//==============================================================================
+void generateScene(const std::string& geometry, std::size_t n, S env_scale,
+                   std::vector<CollisionObject<S>*>& env)
+{
+  if(geometry == "robot")
+  {
+    generateRobots(n, env_scale, env);
+    return;
+  }
+
+  // The generators create n boxes, n spheres and n cylinders
+  const std::size_t n_per_kind = std::max<std::size_t>(1, n / 3);
+  if(geometry == "mesh")
+    test::generateEnvironmentsMesh(env, env_scale, n_per_kind);
+  else
+    test::generateEnvironments(env, env_scale, n_per_kind);
+}
+
+//==============================================================================
+void moveObjects(const std::string& motion, S env_scale,
+                 std::vector<CollisionObject<S>*>& env)
+{
+  if(motion == "jitter")
+  {
+    const S delta_angle_max = 10 / 360.0 * 2 * constants<S>::pi();
+    const S delta_trans_max = 0.01 * env_scale;
+    for(auto* obj : env)
+    {
+      auto random = [](S max) { return 2 * (rand() / (S)RAND_MAX - 0.5) * max; };
+      const Matrix3<S> dR(
+            AngleAxis<S>(random(delta_angle_max), Vector3<S>::UnitX())
+            * AngleAxis<S>(random(delta_angle_max), Vector3<S>::UnitY())
+            * AngleAxis<S>(random(delta_angle_max), Vector3<S>::UnitZ()));
+      const Vector3<S> dT(random(delta_trans_max), random(delta_trans_max),
+                          random(delta_trans_max));
+      obj->setTransform(dR * obj->getRotation(), dR * obj->getTranslation() + dT);
+      obj->computeAABB();
+    }
+  }
+  else if(motion == "teleport")
+  {
+    S extents[] = {-env_scale, env_scale, -env_scale, env_scale, -env_scale, env_scale};
+    aligned_vector<Transform3<S>> transforms;
+    test::generateRandomTransforms(extents, transforms, env.size());
+    for(std::size_t i = 0; i < env.size(); ++i)
+    {
+      env[i]->setTransform(transforms[i]);
+      env[i]->computeAABB();
+    }
+  }
+}
+
+//==============================================================================
+Result runBenchmark(const ManagerFactory& factory, const std::string& geometry,
+                    const std::string& motion, std::size_t size,
+                    const Options& options)
+{
+  const S env_scale = 100;
+
+  // Each configuration starts from the same seed so that every manager sees
+  // the same scene and the same motion.
+  srand(options.seed);
+  std::vector<CollisionObject<S>*> env;
+  generateScene(geometry, size, env_scale, env);
+  std::vector<CollisionObject<S>*> queries;
+  generateScene(geometry, options.queries, env_scale, queries);
+
+  Result result;
+  result.manager = factory.name;
+  result.geometry = geometry;
+  result.motion = motion;
+  result.num_objects = env.size();
+
+  test::Timer timer;
+  std::unique_ptr<BroadPhaseCollisionManager<S>> manager(factory.create(env));
+
+  timer.start();
+  manager->registerObjects(env);
+  timer.stop();
+  result.register_ms = timer.getElapsedTime();
+
+  timer.start();
+  manager->setup();
+  timer.stop();
+  result.setup_ms = timer.getElapsedTime();
+
+  std::unique_ptr<BroadPhaseCollisionManager<S>> other(factory.create(queries));
+  other->registerObjects(queries);
+  other->setup();
+
+  const std::size_t steps = std::max<std::size_t>(1, options.steps);
+  for(std::size_t step = 0; step < steps; ++step)
+  {
+    moveObjects(motion, env_scale, env);
+
+    timer.start();
+    manager->update();
+    timer.stop();
+    result.update_ms += timer.getElapsedTime();
+
+    std::size_t pairs = 0;
+    timer.start();
+    manager->collide(&pairs, countPairs);
+    timer.stop();
+    result.self_collide_ms += timer.getElapsedTime();
+    result.self_collide_pairs += pairs;
+
+    pairs = 0;
+    timer.start();
+    for(auto* query : queries)
+      manager->collide(query, &pairs, countPairs);
+    timer.stop();
+    result.one_vs_many_ms += timer.getElapsedTime();
+    result.one_vs_many_pairs += pairs;
+
+    pairs = 0;
+    timer.start();
+    manager->collide(other.get(), &pairs, countPairs);
+    timer.stop();
+    result.manager_vs_manager_ms += timer.getElapsedTime();
+    result.manager_vs_manager_pairs += pairs;
+  }
+
+  result.update_ms /= steps;
+  result.self_collide_ms /= steps;
+  result.one_vs_many_ms /= steps;
+  result.manager_vs_manager_ms /= steps;
+
+  for(auto* obj : env)
+    delete obj;
+  for(auto* obj : queries)
+    delete obj;
+
+  return result;
+}
+
+//==============================================================================
+void writeJson(std::ostream& out, const Options& options,
+               const std::vector<Result>& results)
+{
+  out << "{\n"
+      << "  \"fcl_version\": \"" << FCL_VERSION << "\",\n"
+      << "  \"scalar\": \"double\",\n"
+      << "  \"steps\": " << options.steps << ",\n"
+      << "  \"queries\": " << options.queries << ",\n"
+      << "  \"seed\": " << options.seed << ",\n"
+      << "  \"results\": [";
+
+  for(std::size_t i = 0; i < results.size(); ++i)
+  {
+    const Result& r = results[i];
+    out << (i ? ",\n" : "\n")
+        << "    {\"manager\": \"" << r.manager << "\""
+        << ", \"geometry\": \"" << r.geometry << "\""
+        << ", \"motion\": \"" << r.motion << "\""
+        << ", \"num_objects\": " << r.num_objects
+        << ", \"register_ms\": " << r.register_ms
+        << ", \"setup_ms\": " << r.setup_ms
+        << ", \"update_ms\": " << r.update_ms
+        << ", \"self_collide_ms\": " << r.self_collide_ms
+        << ", \"self_collide_pairs\": " << r.self_collide_pairs
+        << ", \"one_vs_many_ms\": " << r.one_vs_many_ms
+        << ", \"one_vs_many_pairs\": " << r.one_vs_many_pairs
+        << ", \"manager_vs_manager_ms\": " << r.manager_vs_manager_ms
+        << ", \"manager_vs_manager_pairs\": " << r.manager_vs_manager_pairs
+        << "}";
+  }
+
+  out << "\n  ]\n}\n";
+}
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+  Options options;
+  if(!parseOptions(argc, argv, options))
+    return 1;
+
+  std::vector<Result> results;
+  for(const auto& factory : managerFactories())
+  {
+    if(!options.managers.empty()
+       && std::find(options.managers.begin(), options.managers.end(),
+                    factory.name) == options.managers.end())
+      continue;
+
+    for(const auto& geometry : options.geometries)
+    {
+      for(const auto size : options.sizes)
+      {
+        for(const auto& motion : options.motions)
+        {
+          std::cerr << factory.name << " " << geometry << " " << size << " "
+                    << motion << std::endl;
+          results.push_back(
+                runBenchmark(factory, geometry, motion, size, options));
+        }
+      }
+    }
+  }
+
+  if(options.output.empty())
+  {
+    writeJson(std::cout, options, results);
+  }
+  else
+  {
+    std::ofstream out(options.output);
+    if(!out)
+    {
+      std::cerr << "Cannot open " << options.output << std::endl;
+      return 1;
+    }
+    writeJson(out, options, results);
+  }
+
+  return 0;
+}
@@ -0,0 +1,387 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+/** Tests the flat-array sweep and prune collision manager. */
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fcl/broadphase/broadphase_SaP_array.h"
+#include "fcl/broadphase/detail/pair_hash_set.h"
+#include "fcl/geometry/shape/box.h"
+#include "fcl/geometry/shape/sphere.h"
+
+using fcl::CollisionObjectd;
+using fcl::Vector3d;
+using PairSet = std::set<std::pair<CollisionObjectd*, CollisionObjectd*>>;
+
+// Orders the objects of a pair so that pairs can be compared as sets.
+std::pair<CollisionObjectd*, CollisionObjectd*> ordered(
+    CollisionObjectd* a, CollisionObjectd* b) {
+  return a < b ? std::make_pair(a, b) : std::make_pair(b, a);
+}
+
+PairSet toSet(const std::vector<std::pair<CollisionObjectd*,
+                                          CollisionObjectd*>>& pairs) {
+  PairSet set;
+  for (const auto& pair : pairs) {
+    EXPECT_TRUE(set.insert(ordered(pair.first, pair.second)).second);
+  }
+  return set;
+}
+
+// Collects the pairs reported by the self collision of a manager.
+bool collectPair(CollisionObjectd* o1, CollisionObjectd* o2, void* data) {
+  PairSet* pairs = static_cast<PairSet*>(data);
+  EXPECT_TRUE(pairs->insert(ordered(o1, o2)).second);
+  return false;
+}
+
+PairSet bruteForcePairs(const std::vector<CollisionObjectd*>& objs) {
+  PairSet pairs;
+  for (size_t i = 0; i < objs.size(); ++i) {
+    for (size_t j = i + 1; j < objs.size(); ++j) {
+      if (objs[i]->getAABB().overlap(objs[j]->getAABB()))
+        pairs.insert(ordered(objs[i], objs[j]));
+    }
+  }
+  return pairs;
+}
+
+// Checks the hash set against std::set under a random mix of insertions and
+// erasures dense enough to exercise the backward shift of the clusters.
+GTEST_TEST(PairHashSet, matches_std_set) {
+  using fcl::detail::PairHashSet;
+
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<fcl::uint32> id(0, 40);
+  std::set<PairHashSet::Key> reference;
+  PairHashSet set;
+
+  for (int i = 0; i < 20000; ++i) {
+    const fcl::uint32 a = id(rng);
+    const fcl::uint32 b = id(rng);
+    const PairHashSet::Key key = PairHashSet::makeKey(a, b);
+    EXPECT_EQ(key, PairHashSet::makeKey(b, a));
+    EXPECT_EQ(std::min(a, b), PairHashSet::first(key));
+    EXPECT_EQ(std::max(a, b), PairHashSet::second(key));
+
+    if (i % 3 == 0) {
+      unsigned char tag = 0;
+      EXPECT_EQ(reference.erase(key) == 1, set.erase(key, &tag));
+    } else {
+      const unsigned char tag = static_cast<unsigned char>(a);
+      EXPECT_EQ(reference.insert(key).second, set.insert(key, tag));
+    }
+  }
+
+  GTEST_ASSERT_EQ(reference.size(), set.size());
+  for (PairHashSet::Key key : reference) EXPECT_TRUE(set.contains(key));
+
+  size_t visited = 0;
+  set.forEach([&](PairHashSet::Key key, unsigned char tag) {
+    EXPECT_EQ(1u, reference.count(key));
+    // The first insertion of a pair set its tag, later ones left it alone
+    EXPECT_TRUE(tag == PairHashSet::first(key) ||
+                tag == PairHashSet::second(key));
+    ++visited;
+  });
+  EXPECT_EQ(reference.size(), visited);
+
+  set.clear();
+  EXPECT_TRUE(set.empty());
+  EXPECT_FALSE(set.contains(*reference.begin()));
+}
+
+// Moves three spheres apart and together and checks the reported changes of
+// the overlapping pairs.
+GTEST_TEST(SaPCollisionManager_Array, pair_deltas) {
+  auto sphere = std::make_shared<fcl::Sphered>(1.0);
+  CollisionObjectd a(sphere);
+  CollisionObjectd b(sphere);
+  CollisionObjectd c(sphere);
+  auto place = [](CollisionObjectd& obj, double x) {
+    obj.setTranslation(Vector3d(x, 0, 0));
+    obj.computeAABB();
+  };
+  place(a, 0);
+  place(b, 1.5);
+  place(c, 10);
+
+  fcl::SaPCollisionManager_Arrayd manager;
+  manager.registerObjects({&a, &b, &c});
+  manager.setup();
+  EXPECT_EQ(PairSet({ordered(&a, &b)}), toSet(manager.getAddedPairs()));
+  EXPECT_TRUE(manager.getRemovedPairs().empty());
+
+  // c joins b; a leaves b
+  place(a, -5);
+  place(c, 3);
+  manager.update();
+  EXPECT_EQ(PairSet({ordered(&b, &c)}), toSet(manager.getAddedPairs()));
+  EXPECT_EQ(PairSet({ordered(&a, &b)}), toSet(manager.getRemovedPairs()));
+  EXPECT_EQ(1u, manager.numOverlapPairs());
+
+  // Nothing moved
+  manager.update();
+  EXPECT_TRUE(manager.getAddedPairs().empty());
+  EXPECT_TRUE(manager.getRemovedPairs().empty());
+
+  // b leaves and comes back between two publications
+  manager.unregisterObject(&b);
+  manager.registerObject(&b);
+  manager.update();
+  EXPECT_TRUE(manager.getAddedPairs().empty());
+  EXPECT_TRUE(manager.getRemovedPairs().empty());
+
+  // Touching boxes count as overlapping, as in AABB::overlap()
+  place(a, -0.5);
+  manager.update(&a);
+  EXPECT_EQ(PairSet({ordered(&a, &b)}), toSet(manager.getAddedPairs()));
+
+  // Unregistering reports the pairs of the object as removed
+  manager.unregisterObject(&b);
+  manager.update();
+  EXPECT_TRUE(manager.getAddedPairs().empty());
+  EXPECT_EQ(PairSet({ordered(&a, &b), ordered(&b, &c)}),
+            toSet(manager.getRemovedPairs()));
+  EXPECT_EQ(0u, manager.numOverlapPairs());
+  EXPECT_EQ(2u, manager.size());
+}
+
+// Moves a few hundred boxes by small random steps, registering and
+// unregistering some of them, and checks that the pairs and their reported
+// changes always agree with a brute force overlap test.
+GTEST_TEST(SaPCollisionManager_Array, pairs_match_brute_force) {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> position(-10, 10);
+  std::uniform_real_distribution<double> step(-0.2, 0.2);
+  std::uniform_real_distribution<double> side(0.2, 1.5);
+
+  std::vector<std::unique_ptr<CollisionObjectd>> storage;
+  for (int i = 0; i < 300; ++i) {
+    auto box = std::make_shared<fcl::Boxd>(side(rng), side(rng), side(rng));
+    storage.emplace_back(new CollisionObjectd(box));
+    storage.back()->setTranslation(
+        Vector3d(position(rng), position(rng), position(rng)));
+    storage.back()->computeAABB();
+  }
+
+  std::vector<CollisionObjectd*> registered;
+  for (int i = 0; i < 200; ++i) registered.push_back(storage[i].get());
+  std::vector<CollisionObjectd*> unregistered;
+  for (int i = 200; i < 300; ++i) unregistered.push_back(storage[i].get());
+
+  fcl::SaPCollisionManager_Arrayd manager;
+  manager.registerObjects(registered);
+  manager.setup();
+
+  PairSet previous;
+  for (int iteration = 0; iteration < 30; ++iteration) {
+    if (iteration > 0) {
+      for (CollisionObjectd* obj : registered) {
+        obj->setTranslation(obj->getTranslation() +
+                            Vector3d(step(rng), step(rng), step(rng)));
+        obj->computeAABB();
+      }
+
+      // Swap a few objects in and out of the manager
+      for (int k = 0; k < 5; ++k) {
+        std::swap(registered[(iteration * 7 + k) % registered.size()],
+                  unregistered[(iteration * 3 + k) % unregistered.size()]);
+        manager.unregisterObject(
+            unregistered[(iteration * 3 + k) % unregistered.size()]);
+        manager.registerObject(
+            registered[(iteration * 7 + k) % registered.size()]);
+      }
+
+      if (iteration % 2 == 0)
+        manager.update();
+      else
+        manager.update(registered);
+    }
+
+    const PairSet expected = bruteForcePairs(registered);
+    PairSet reported;
+    manager.collide(&reported, collectPair);
+    EXPECT_EQ(expected, reported);
+    EXPECT_EQ(expected.size(), manager.numOverlapPairs());
+
+    // A callback returning true stops the self collision
+    int num_calls = 0;
+    manager.collide(&num_calls, [](CollisionObjectd*, CollisionObjectd*,
+                                   void* data) {
+      ++*static_cast<int*>(data);
+      return true;
+    });
+    EXPECT_EQ(expected.empty() ? 0 : 1, num_calls);
+
+    // previous + added - removed == current
+    PairSet reconstructed = previous;
+    for (const auto& pair : toSet(manager.getRemovedPairs()))
+      EXPECT_EQ(1u, reconstructed.erase(pair));
+    for (const auto& pair : toSet(manager.getAddedPairs()))
+      EXPECT_TRUE(reconstructed.insert(pair).second);
+    EXPECT_EQ(expected, reconstructed);
+
+    // Queries by objects outside the manager, which start from a binary
+    // search of the first interval that may overlap them
+    for (CollisionObjectd* query : unregistered) {
+      PairSet expected_query;
+      for (CollisionObjectd* obj : registered) {
+        if (query->getAABB().overlap(obj->getAABB()))
+          expected_query.insert(ordered(query, obj));
+      }
+      PairSet reported_query;
+      manager.collide(query, &reported_query, collectPair);
+      EXPECT_EQ(expected_query, reported_query);
+    }
+
+    previous = expected;
+  }
+}
+
+struct PairEvents {
+  PairSet added;
+  PairSet persisting;
+  PairSet removed;
+};
+
+template <PairSet PairEvents::*kind>
+void recordPair(CollisionObjectd* o1, CollisionObjectd* o2, void* data) {
+  EXPECT_LT(o1, o2);
+  EXPECT_TRUE((static_cast<PairEvents*>(data)->*kind)
+                  .insert(std::make_pair(o1, o2)).second);
+}
+
+// Records the events of one collidePersistent() call in events, which also
+// receives the pairs of the objects unregistered until the next call.
+void collidePersistent(fcl::SaPCollisionManager_Arrayd& manager,
+                       PairEvents& events) {
+  manager.collidePersistent(&events, recordPair<&PairEvents::added>,
+                            recordPair<&PairEvents::persisting>,
+                            recordPair<&PairEvents::removed>);
+}
+
+// Checks the persistent-pair mode read from the manager's pair set across
+// publications, re-registrations and slots given to new objects.
+GTEST_TEST(SaPCollisionManager_Array, persistent_pairs) {
+  auto sphere = std::make_shared<fcl::Sphered>(1.0);
+  CollisionObjectd a(sphere);
+  CollisionObjectd b(sphere);
+  CollisionObjectd c(sphere);
+  CollisionObjectd d(sphere);
+  auto place = [](CollisionObjectd& obj, double x) {
+    obj.setTranslation(Vector3d(x, 0, 0));
+    obj.computeAABB();
+  };
+  place(a, 0);
+  place(b, 1.5);
+  place(c, 10);
+  place(d, 11);
+
+  fcl::SaPCollisionManager_Arrayd manager;
+  manager.registerObjects({&a, &b, &c});
+  manager.setup();
+  PairEvents events;
+  collidePersistent(manager, events);
+  EXPECT_EQ(PairSet({ordered(&a, &b)}), events.added);
+  EXPECT_EQ(1u, manager.numPersistentPairs());
+
+  // Publications in between do not matter
+  manager.update();
+  manager.update();
+  events = PairEvents();
+  collidePersistent(manager, events);
+  EXPECT_TRUE(events.added.empty());
+  EXPECT_EQ(PairSet({ordered(&a, &b)}), events.persisting);
+  EXPECT_TRUE(events.removed.empty());
+
+  // Unregistering b reports its pair as removed right away, so that b
+  // coming back before the next call starts a new pair
+  events = PairEvents();
+  manager.unregisterObject(&b);
+  EXPECT_EQ(PairSet({ordered(&a, &b)}), events.removed);
+  EXPECT_EQ(0u, manager.numPersistentPairs());
+  manager.registerObject(&b);
+  manager.update();
+  collidePersistent(manager, events);
+  EXPECT_EQ(PairSet({ordered(&a, &b)}), events.added);
+  EXPECT_TRUE(events.persisting.empty());
+  EXPECT_EQ(PairSet({ordered(&a, &b)}), events.removed);
+
+  // b leaves for good and d takes its slot: the pair of d is new
+  events = PairEvents();
+  manager.unregisterObject(&b);
+  manager.update();
+  place(d, 0.5);
+  manager.registerObject(&d);
+  manager.update();
+  collidePersistent(manager, events);
+  EXPECT_EQ(PairSet({ordered(&a, &d)}), events.added);
+  EXPECT_TRUE(events.persisting.empty());
+  EXPECT_EQ(PairSet({ordered(&a, &b)}), events.removed);
+  EXPECT_EQ(1u, manager.numPersistentPairs());
+
+  // A pair that separates and overlaps again between two calls persists
+  place(d, 5);
+  manager.update();
+  place(d, 0.5);
+  manager.update();
+  events = PairEvents();
+  collidePersistent(manager, events);
+  EXPECT_EQ(PairSet({ordered(&a, &d)}), events.persisting);
+  EXPECT_TRUE(events.added.empty());
+  EXPECT_TRUE(events.removed.empty());
+
+  manager.clearPersistentPairs();
+  EXPECT_EQ(0u, manager.numPersistentPairs());
+  events = PairEvents();
+  collidePersistent(manager, events);
+  EXPECT_EQ(PairSet({ordered(&a, &d)}), events.added);
+}
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
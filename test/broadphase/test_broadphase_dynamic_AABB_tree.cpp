@@ -36,14 +36,22 @@
 
 /** Tests the dynamic axis-aligned bounding box tree.*/
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
+#include <random>
 
 #include <gtest/gtest.h>
 
 #include "fcl/common/types.h"
 #include "fcl/geometry/shape/sphere.h"
+#include "fcl/broadphase/broadphase_bruteforce.h"
 #include "fcl/broadphase/broadphase_dynamic_AABB_tree.h"
+#include "fcl/broadphase/broadphase_dynamic_AABB_tree_array.h"
+#include "fcl/broadphase/default_broadphase_callbacks.h"
+#include "fcl/broadphase/detail/hierarchy_tree.h"
+#include "fcl/broadphase/detail/hierarchy_tree_array.h"
+#include "test_fcl_utility.h"
 
 using Vector3d = fcl::Vector3d;
 
@@ -124,6 +132,603 @@ GTEST_TEST(DynamicAABBTreeCollisionManager, update) {
   }
 }
 
+// Tests that the parallel self collision reports exactly the contacts of the
+// serial self collision, in the same order, both for an exhaustive query and
+// for a query which stops at the first contact, and that contacts already in
+// the result are kept once.
+GTEST_TEST(DynamicAABBTreeCollisionManager, collideParallel) {
+  std::vector<fcl::CollisionObjectd*> env;
+  fcl::test::generateEnvironments(env, 100.0, 300);
+
+  fcl::DynamicAABBTreeCollisionManager<double> manager;
+  manager.registerObjects(env);
+  manager.setup();
+
+  const fcl::Contactd earlier_contact(env[0]->collisionGeometry().get(),
+                                      env[1]->collisionGeometry().get(), -1,
+                                      -1);
+  struct Case {
+    std::size_t num_max_contacts;
+    bool with_earlier_contact;
+  };
+  for (const Case& test_case : {Case{1, false}, Case{100000, false},
+                                Case{100000, true}}) {
+    const std::size_t num_max_contacts = test_case.num_max_contacts;
+    fcl::DefaultCollisionData<double> serial_data;
+    serial_data.request.num_max_contacts = num_max_contacts;
+    if (test_case.with_earlier_contact)
+      serial_data.result.addContact(earlier_contact);
+    manager.collide(&serial_data, fcl::DefaultCollisionFunction);
+    GTEST_ASSERT_EQ(serial_data.result.isCollision(), true);
+
+    for (unsigned int num_threads : {1u, 2u, 4u}) {
+      manager.num_threads = num_threads;
+      fcl::DefaultCollisionData<double> parallel_data;
+      parallel_data.request.num_max_contacts = num_max_contacts;
+      if (test_case.with_earlier_contact)
+        parallel_data.result.addContact(earlier_contact);
+      manager.collideParallel(&parallel_data, fcl::DefaultCollisionFunction,
+                              fcl::DefaultCollisionResetFunction<double>,
+                              fcl::DefaultCollisionMergeFunction<double>);
+
+      EXPECT_EQ(serial_data.done, parallel_data.done);
+      GTEST_ASSERT_EQ(serial_data.result.numContacts(),
+                      parallel_data.result.numContacts());
+      for (std::size_t i = 0; i < serial_data.result.numContacts(); ++i) {
+        const auto& serial_contact = serial_data.result.getContact(i);
+        const auto& parallel_contact = parallel_data.result.getContact(i);
+        EXPECT_EQ(serial_contact.o1, parallel_contact.o1);
+        EXPECT_EQ(serial_contact.o2, parallel_contact.o2);
+        EXPECT_EQ(serial_contact.b1, parallel_contact.b1);
+        EXPECT_EQ(serial_contact.b2, parallel_contact.b2);
+      }
+    }
+  }
+
+  for (auto obj : env) delete obj;
+}
+
+// Tests that the parallel self distance finds the nearest pair of the serial
+// self distance: the minimum distance, the objects and the nearest points.
+GTEST_TEST(DynamicAABBTreeCollisionManager, distanceParallel) {
+  std::vector<fcl::CollisionObjectd*> env;
+  fcl::test::generateEnvironments(env, 5000.0, 20);
+
+  fcl::DynamicAABBTreeCollisionManager<double> manager;
+  manager.registerObjects(env);
+  manager.setup();
+
+  fcl::DefaultDistanceData<double> serial_data;
+  serial_data.request.enable_nearest_points = true;
+  manager.distance(&serial_data, fcl::DefaultDistanceFunction);
+  GTEST_ASSERT_GT(serial_data.result.min_distance, 0);
+
+  for (unsigned int num_threads : {1u, 2u, 4u}) {
+    manager.num_threads = num_threads;
+    fcl::DefaultDistanceData<double> parallel_data;
+    parallel_data.request.enable_nearest_points = true;
+    manager.distanceParallel(&parallel_data, fcl::DefaultDistanceFunction,
+                             fcl::DefaultDistanceResetFunction<double>,
+                             fcl::DefaultDistanceMergeFunction<double>);
+    const fcl::DistanceResultd& serial = serial_data.result;
+    const fcl::DistanceResultd& parallel = parallel_data.result;
+    EXPECT_NEAR(serial.min_distance, parallel.min_distance, 1e-12);
+    EXPECT_EQ(serial.o1, parallel.o1);
+    EXPECT_EQ(serial.o2, parallel.o2);
+    EXPECT_EQ(serial.b1, parallel.b1);
+    EXPECT_EQ(serial.b2, parallel.b2);
+    for (int i = 0; i < 2; ++i) {
+      EXPECT_TRUE(serial.nearest_points[i].isApprox(
+          parallel.nearest_points[i], 1e-12));
+    }
+  }
+
+  for (auto obj : env) delete obj;
+}
+
+// Checks that the callable overloads visit exactly the candidate pairs of the
+// function-pointer overloads and find the same minimum distance.
+template <typename Manager>
+void testCallableQueries() {
+  std::vector<fcl::CollisionObjectd*> env;
+  fcl::test::generateEnvironments(env, 100.0, 100);
+  std::vector<fcl::CollisionObjectd*> others;
+  fcl::test::generateEnvironments(others, 100.0, 30);
+
+  Manager manager;
+  manager.registerObjects(env);
+  manager.setup();
+  Manager other_manager;
+  other_manager.registerObjects(others);
+  other_manager.setup();
+
+  using ObjectPair = std::pair<fcl::CollisionObjectd*, fcl::CollisionObjectd*>;
+  struct PairData {
+    std::vector<ObjectPair> pairs;
+  };
+  auto record_pair = [](fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2,
+                        void* cdata) -> bool {
+    static_cast<PairData*>(cdata)->pairs.emplace_back(o1, o2);
+    return false;
+  };
+
+  // Self collision.
+  PairData pointer_pairs;
+  manager.collide(&pointer_pairs, record_pair);
+  std::vector<ObjectPair> callable_pairs;
+  manager.collide([&](fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2) {
+    callable_pairs.emplace_back(o1, o2);
+    return false;
+  });
+  EXPECT_FALSE(pointer_pairs.pairs.empty());
+  EXPECT_EQ(pointer_pairs.pairs, callable_pairs);
+
+  // Single object and other manager collision.
+  pointer_pairs.pairs.clear();
+  callable_pairs.clear();
+  for (auto obj : others) {
+    manager.collide(obj, &pointer_pairs, record_pair);
+    manager.collide(obj, [&](fcl::CollisionObjectd* o1,
+                             fcl::CollisionObjectd* o2) {
+      callable_pairs.emplace_back(o1, o2);
+      return false;
+    });
+  }
+  manager.collide(&other_manager, &pointer_pairs, record_pair);
+  manager.collide(&other_manager, [&](fcl::CollisionObjectd* o1,
+                                      fcl::CollisionObjectd* o2) {
+    callable_pairs.emplace_back(o1, o2);
+    return false;
+  });
+  EXPECT_EQ(pointer_pairs.pairs, callable_pairs);
+
+  // A callable that returns true stops the traversal.
+  std::size_t num_visited = 0;
+  manager.collide([&](fcl::CollisionObjectd*, fcl::CollisionObjectd*) {
+    ++num_visited;
+    return true;
+  });
+  EXPECT_EQ(num_visited, 1u);
+
+  // Distance queries; the callable keeps its own running minimum.
+  double callable_min_dist = 0;
+  auto callable_distance = [&](fcl::CollisionObjectd* o1,
+                               fcl::CollisionObjectd* o2, double& dist) {
+    fcl::DistanceRequestd request;
+    fcl::DistanceResultd result;
+    fcl::distance(o1, o2, request, result);
+    dist = std::min(dist, result.min_distance);
+    callable_min_dist = dist;
+    return dist <= 0;
+  };
+
+  fcl::DefaultDistanceData<double> pointer_data;
+  manager.distance(&pointer_data, fcl::DefaultDistanceFunction);
+  manager.distance(callable_distance);
+  EXPECT_NEAR(pointer_data.result.min_distance, callable_min_dist, 1e-12);
+
+  pointer_data = fcl::DefaultDistanceData<double>();
+  manager.distance(others[0], &pointer_data, fcl::DefaultDistanceFunction);
+  manager.distance(others[0], callable_distance);
+  EXPECT_NEAR(pointer_data.result.min_distance, callable_min_dist, 1e-12);
+
+  pointer_data = fcl::DefaultDistanceData<double>();
+  manager.distance(&other_manager, &pointer_data,
+                   fcl::DefaultDistanceFunction);
+  manager.distance(&other_manager, callable_distance);
+  EXPECT_NEAR(pointer_data.result.min_distance, callable_min_dist, 1e-12);
+
+  for (auto obj : others) delete obj;
+  for (auto obj : env) delete obj;
+}
+
+GTEST_TEST(DynamicAABBTreeCollisionManager, callableQueries) {
+  testCallableQueries<fcl::DynamicAABBTreeCollisionManager<double>>();
+}
+
+GTEST_TEST(DynamicAABBTreeCollisionManager_Array, callableQueries) {
+  testCallableQueries<fcl::DynamicAABBTreeCollisionManager_Array<double>>();
+}
+
+// Checks that collideBatch() and distanceBatch() give every query the result
+// of the corresponding single-object query.
+template <typename Manager>
+void testBatchQueries(Manager& manager) {
+  std::vector<fcl::CollisionObjectd*> env;
+  fcl::test::generateEnvironments(env, 100.0, 100);
+  manager.registerObjects(env);
+  manager.setup();
+
+  std::vector<fcl::CollisionObjectd*> queries;
+  fcl::test::generateEnvironments(queries, 100.0, 40);
+
+  for (std::size_t num_max_contacts : {std::size_t(1), std::size_t(100000)}) {
+    std::vector<fcl::DefaultCollisionData<double>> batch_data(queries.size());
+    std::vector<void*> cdata;
+    for (auto& data : batch_data) {
+      data.request.num_max_contacts = num_max_contacts;
+      cdata.push_back(&data);
+    }
+    manager.collideBatch(queries, cdata, fcl::DefaultCollisionFunction);
+
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+      fcl::DefaultCollisionData<double> data;
+      data.request.num_max_contacts = num_max_contacts;
+      manager.collide(queries[i], &data, fcl::DefaultCollisionFunction);
+      EXPECT_EQ(data.result.isCollision(),
+                batch_data[i].result.isCollision());
+      if (num_max_contacts > 1) {
+        EXPECT_EQ(data.result.numContacts(),
+                  batch_data[i].result.numContacts());
+      }
+    }
+  }
+
+  std::vector<fcl::DefaultDistanceData<double>> batch_data(queries.size());
+  std::vector<void*> cdata;
+  for (auto& data : batch_data) cdata.push_back(&data);
+  manager.distanceBatch(queries, cdata, fcl::DefaultDistanceFunction);
+
+  for (std::size_t i = 0; i < queries.size(); ++i) {
+    fcl::DefaultDistanceData<double> data;
+    manager.distance(queries[i], &data, fcl::DefaultDistanceFunction);
+    EXPECT_NEAR(data.result.min_distance, batch_data[i].result.min_distance,
+                1e-12);
+  }
+
+  for (auto obj : queries) delete obj;
+  for (auto obj : env) delete obj;
+}
+
+GTEST_TEST(DynamicAABBTreeCollisionManager, batchQueries) {
+  {
+    fcl::DynamicAABBTreeCollisionManager<double> manager;
+    testBatchQueries(manager);
+  }
+  for (unsigned int num_threads : {1u, 4u}) {
+    fcl::DynamicAABBTreeCollisionManager<double> manager;
+    manager.enable_parallel_batch = true;
+    manager.num_threads = num_threads;
+    testBatchQueries(manager);
+  }
+}
+
+GTEST_TEST(DynamicAABBTreeCollisionManager_Array, batchQueries) {
+  {
+    fcl::DynamicAABBTreeCollisionManager_Array<double> manager;
+    testBatchQueries(manager);
+  }
+  for (unsigned int num_threads : {1u, 4u}) {
+    fcl::DynamicAABBTreeCollisionManager_Array<double> manager;
+    manager.enable_parallel_batch = true;
+    manager.num_threads = num_threads;
+    testBatchQueries(manager);
+  }
+}
+
+// The default implementation of the base class runs the queries one by one.
+GTEST_TEST(NaiveCollisionManager, batchQueries) {
+  fcl::NaiveCollisionManager<double> manager;
+  testBatchQueries(manager);
+}
+
+// Returns n random boxes drawn with the given seed.
+std::vector<fcl::AABBd> generateBoxes(std::size_t n, unsigned int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> position(-100, 100);
+  std::uniform_real_distribution<double> extent(0.1, 2);
+  std::vector<fcl::AABBd> boxes;
+  for (std::size_t i = 0; i < n; ++i) {
+    const Vector3d p(position(rng), position(rng), position(rng));
+    const Vector3d e(extent(rng), extent(rng), extent(rng));
+    boxes.emplace_back(p - e, p + e);
+  }
+  return boxes;
+}
+
+using Node = fcl::detail::NodeBase<fcl::AABBd>;
+
+// Appends the data of the leaves below node in depth-first order, checking
+// that every internal node tightly bounds its children.
+void checkTree(const Node* node, std::vector<void*>& leaves) {
+  if (node->isLeaf()) {
+    leaves.push_back(node->data);
+    return;
+  }
+  EXPECT_EQ(node->children[0]->parent, node);
+  EXPECT_EQ(node->children[1]->parent, node);
+  EXPECT_TRUE(node->bv.equal(node->children[0]->bv + node->children[1]->bv));
+  checkTree(node->children[0], leaves);
+  checkTree(node->children[1], leaves);
+}
+
+// Tests that init(), refit() and balanceTopdown() with a thread pool build
+// the same tree as the serial builder, up to the order of leaves with equal
+// morton codes.
+GTEST_TEST(HierarchyTree, parallelBuild) {
+  const std::size_t n = 5000;
+  const std::vector<fcl::AABBd> boxes = generateBoxes(n, 1);
+  const std::vector<fcl::AABBd> moved = generateBoxes(n, 2);
+  std::vector<int> ids(n);
+  fcl::detail::ThreadPool pool(4);
+
+  for (int level : {0, 1, 2, 3}) {
+    for (int topdown_level : {0, 1}) {
+      SCOPED_TRACE(::testing::Message() << "level " << level << " topdown "
+                                        << topdown_level);
+      fcl::detail::HierarchyTree<fcl::AABBd> serial(16, topdown_level);
+      fcl::detail::HierarchyTree<fcl::AABBd> parallel(16, topdown_level);
+      parallel.thread_pool = &pool;
+
+      std::vector<Node*> serial_leaves, parallel_leaves;
+      for (std::size_t i = 0; i < n; ++i) {
+        for (auto leaves : {&serial_leaves, &parallel_leaves}) {
+          Node* node = new Node;
+          node->bv = boxes[i];
+          node->parent = nullptr;
+          node->children[1] = nullptr;
+          node->data = &ids[i];
+          leaves->push_back(node);
+        }
+      }
+      const std::vector<Node*> leaf_nodes = parallel_leaves;
+      serial.init(serial_leaves, level);
+      parallel.init(parallel_leaves, level);
+
+      std::vector<void*> serial_order, parallel_order;
+      checkTree(serial.getRoot(), serial_order);
+      checkTree(parallel.getRoot(), parallel_order);
+      EXPECT_EQ(parallel.size(), n);
+      EXPECT_TRUE(serial.getRoot()->bv.equal(parallel.getRoot()->bv));
+      if (level == 0) {
+        EXPECT_EQ(serial_order, parallel_order);
+        EXPECT_EQ(serial.getMaxHeight(), parallel.getMaxHeight());
+      } else {
+        std::sort(serial_order.begin(), serial_order.end());
+        std::sort(parallel_order.begin(), parallel_order.end());
+        EXPECT_EQ(serial_order, parallel_order);
+      }
+
+      fcl::AABBd moved_bound = moved[0];
+      for (std::size_t i = 0; i < n; ++i) {
+        leaf_nodes[i]->bv = moved[i];
+        moved_bound += moved[i];
+      }
+      parallel.refit();
+      parallel_order.clear();
+      checkTree(parallel.getRoot(), parallel_order);
+      EXPECT_TRUE(parallel.getRoot()->bv.equal(moved_bound));
+
+      parallel.balanceTopdown();
+      parallel_order.clear();
+      checkTree(parallel.getRoot(), parallel_order);
+      EXPECT_EQ(parallel_order.size(), n);
+
+      // The tree remains usable for incremental changes.
+      Node* extra = parallel.insert(boxes[0], nullptr);
+      parallel.remove(leaf_nodes[0]);
+      EXPECT_EQ(parallel.size(), n);
+      parallel_order.clear();
+      checkTree(parallel.getRoot(), parallel_order);
+      parallel.remove(extra);
+    }
+  }
+}
+
+// Appends the data of the leaves below node in depth-first order, checking
+// that every internal node tightly bounds its children.
+using ArrayNode = fcl::detail::implementation_array::NodeBase<fcl::AABBd>;
+
+void checkTree(const ArrayNode* nodes, std::size_t node,
+               std::vector<void*>& leaves) {
+  if (nodes[node].isLeaf()) {
+    leaves.push_back(nodes[node].data);
+    return;
+  }
+  const std::size_t child0 = nodes[node].children[0];
+  const std::size_t child1 = nodes[node].children[1];
+  EXPECT_EQ(nodes[child0].parent, node);
+  EXPECT_EQ(nodes[child1].parent, node);
+  EXPECT_TRUE(nodes[node].bv.equal(nodes[child0].bv + nodes[child1].bv));
+  checkTree(nodes, child0, leaves);
+  checkTree(nodes, child1, leaves);
+}
+
+GTEST_TEST(HierarchyTreeArray, parallelBuild) {
+  using Tree = fcl::detail::implementation_array::HierarchyTree<fcl::AABBd>;
+  const std::size_t n = 5000;
+  const std::vector<fcl::AABBd> boxes = generateBoxes(n, 1);
+  std::vector<int> ids(n);
+  fcl::detail::ThreadPool pool(4);
+
+  for (int level : {0, 1, 2, 3}) {
+    for (int topdown_level : {0, 1}) {
+      SCOPED_TRACE(::testing::Message() << "level " << level << " topdown "
+                                        << topdown_level);
+      Tree serial(16, topdown_level);
+      Tree parallel(16, topdown_level);
+      parallel.thread_pool = &pool;
+
+      std::vector<ArrayNode> leaves(n);
+      for (std::size_t i = 0; i < n; ++i) {
+        leaves[i].bv = boxes[i];
+        leaves[i].parent = Tree::NULL_NODE;
+        leaves[i].children[1] = Tree::NULL_NODE;
+        leaves[i].data = &ids[i];
+      }
+      serial.init(leaves.data(), n, level);
+      parallel.init(leaves.data(), n, level);
+
+      std::vector<void*> serial_order, parallel_order;
+      checkTree(serial.getNodes(), serial.getRoot(), serial_order);
+      checkTree(parallel.getNodes(), parallel.getRoot(), parallel_order);
+      EXPECT_EQ(parallel.size(), n);
+      if (level == 0) {
+        EXPECT_EQ(serial_order, parallel_order);
+        EXPECT_EQ(serial.getMaxHeight(), parallel.getMaxHeight());
+      } else {
+        std::sort(serial_order.begin(), serial_order.end());
+        std::sort(parallel_order.begin(), parallel_order.end());
+        EXPECT_EQ(serial_order, parallel_order);
+      }
+
+      for (std::size_t i = 0; i < n; ++i) {
+        parallel.getNodes()[i].bv.min_ += Vector3d(1, 2, 3);
+        parallel.getNodes()[i].bv.max_ += Vector3d(1, 2, 3);
+      }
+      parallel.refit();
+      parallel.balanceTopdown();
+      parallel_order.clear();
+      checkTree(parallel.getNodes(), parallel.getRoot(), parallel_order);
+      EXPECT_EQ(parallel_order.size(), n);
+
+      // The free node list remains usable for incremental changes.
+      for (std::size_t i = 0; i < 10; ++i) parallel.insert(boxes[i], nullptr);
+      EXPECT_EQ(parallel.size(), n + 10);
+      parallel_order.clear();
+      checkTree(parallel.getNodes(), parallel.getRoot(), parallel_order);
+      EXPECT_EQ(parallel_order.size(), n + 10);
+    }
+  }
+}
+
+// Tests that a manager building its tree in parallel finds the same pairs as
+// one building it serially.
+template <typename Manager>
+void testParallelBuild() {
+  std::vector<fcl::CollisionObjectd*> env;
+  fcl::test::generateEnvironments(env, 100.0, 500);
+
+  Manager serial;
+  serial.num_threads = 1;
+  Manager parallel;
+  parallel.num_threads = 4;
+  parallel.enable_parallel_build = true;
+  parallel.parallel_build_min_objects = 0;
+
+  using ObjectPair = std::pair<fcl::CollisionObjectd*, fcl::CollisionObjectd*>;
+  auto collectPairs = [](Manager& manager) {
+    std::vector<ObjectPair> pairs;
+    manager.collide([&](fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2) {
+      pairs.emplace_back(std::min(o1, o2), std::max(o1, o2));
+      return false;
+    });
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+  };
+
+  for (Manager* manager : {&serial, &parallel}) {
+    manager->registerObjects(env);
+    manager->setup();
+  }
+  EXPECT_EQ(collectPairs(serial), collectPairs(parallel));
+
+  for (auto obj : env) {
+    obj->setTranslation(obj->getTranslation() * 0.5);
+    obj->computeAABB();
+  }
+  serial.update();
+  parallel.update();
+  const std::vector<ObjectPair> pairs = collectPairs(parallel);
+  EXPECT_FALSE(pairs.empty());
+  EXPECT_EQ(collectPairs(serial), pairs);
+
+  for (auto obj : env) delete obj;
+}
+
+GTEST_TEST(DynamicAABBTreeCollisionManager, parallelBuild) {
+  testParallelBuild<fcl::DynamicAABBTreeCollisionManager<double>>();
+}
+
+GTEST_TEST(DynamicAABBTreeCollisionManager_Array, parallelBuild) {
+  testParallelBuild<fcl::DynamicAABBTreeCollisionManager_Array<double>>();
+}
+
+// Tests that in the fat AABB mode small motions do not reinsert the leaves,
+// that objects leaving their fat AABBs are reinserted, and that the queries
+// still report every pair of overlapping objects.
+template <typename Manager>
+void testFatAABBs() {
+  std::vector<fcl::CollisionObjectd*> env;
+  fcl::test::generateEnvironments(env, 100.0, 300);
+  const std::size_t n = env.size();
+
+  Manager manager;
+  manager.use_fat_aabbs = true;
+  manager.fat_aabb_margin = 0.5;
+  manager.registerObjects(env);
+  manager.setup();
+
+  using ObjectPair = std::pair<fcl::CollisionObjectd*, fcl::CollisionObjectd*>;
+  auto overlappingPairs = [&manager]() {
+    std::vector<ObjectPair> pairs;
+    manager.collide([&](fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2) {
+      if (o1->getAABB().overlap(o2->getAABB()))
+        pairs.emplace_back(std::min(o1, o2), std::max(o1, o2));
+      return false;
+    });
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+  };
+  auto bruteForcePairs = [&env]() {
+    std::vector<ObjectPair> pairs;
+    for (std::size_t i = 0; i < env.size(); ++i) {
+      for (std::size_t j = i + 1; j < env.size(); ++j) {
+        if (env[i]->getAABB().overlap(env[j]->getAABB()))
+          pairs.emplace_back(std::min(env[i], env[j]), std::max(env[i], env[j]));
+      }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+  };
+  auto move = [](fcl::CollisionObjectd* obj, const Vector3d& delta) {
+    obj->setTranslation(obj->getTranslation() + delta);
+    obj->computeAABB();
+  };
+
+  EXPECT_FALSE(bruteForcePairs().empty());
+  EXPECT_EQ(overlappingPairs(), bruteForcePairs());
+
+  // Jittering within the margin keeps every leaf in place.
+  for (auto obj : env) move(obj, Vector3d(0.3, -0.3, 0.2));
+  manager.update();
+  EXPECT_EQ(manager.num_fat_aabb_reinsertions, 0u);
+  EXPECT_EQ(manager.num_fat_aabb_reinsertions_avoided, n);
+  EXPECT_EQ(overlappingPairs(), bruteForcePairs());
+
+  // Leaving the fat AABBs reinserts every leaf.
+  for (auto obj : env) move(obj, Vector3d(1, 0, 0));
+  manager.update();
+  EXPECT_EQ(manager.num_fat_aabb_reinsertions, n);
+  EXPECT_EQ(manager.num_fat_aabb_reinsertions_avoided, n);
+  EXPECT_EQ(overlappingPairs(), bruteForcePairs());
+
+  // A velocity extends the fat AABB along the predicted motion only.
+  fcl::CollisionObjectd* obj = env[0];
+  manager.setFatAABBMargin(obj, 0);
+  manager.setFatAABBVelocity(obj, Vector3d(5, 0, 0));
+  move(obj, Vector3d(1, 0, 0));
+  manager.update(obj);
+  EXPECT_EQ(manager.num_fat_aabb_reinsertions, n + 1);
+  move(obj, Vector3d(4, 0, 0));
+  manager.update(obj);
+  EXPECT_EQ(manager.num_fat_aabb_reinsertions_avoided, n + 1);
+  move(obj, Vector3d(1.5, 0, 0));
+  manager.update(obj);
+  EXPECT_EQ(manager.num_fat_aabb_reinsertions, n + 2);
+  EXPECT_EQ(overlappingPairs(), bruteForcePairs());
+
+  for (auto obj : env) delete obj;
+}
+
+GTEST_TEST(DynamicAABBTreeCollisionManager, fatAABBs) {
+  testFatAABBs<fcl::DynamicAABBTreeCollisionManager<double>>();
+}
+
+GTEST_TEST(DynamicAABBTreeCollisionManager_Array, fatAABBs) {
+  testFatAABBs<fcl::DynamicAABBTreeCollisionManager_Array<double>>();
+}
+
 //==============================================================================
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,256 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+/** Tests the dynamic AABB tree collision manager with OBB and k-DOP leaves. */
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fcl/broadphase/broadphase_dynamic_AABB_tree_leaf_BV.h"
+#include "fcl/geometry/bvh/BVH_model.h"
+#include "fcl/geometry/geometric_shape_to_BVH_model.h"
+#include "fcl/geometry/shape/box.h"
+#include "fcl/geometry/shape/capsule.h"
+#include "fcl/geometry/shape/sphere.h"
+#include "fcl/narrowphase/collision.h"
+#include "fcl/narrowphase/distance.h"
+
+using fcl::CollisionObjectd;
+using fcl::Transform3d;
+using fcl::Vector3d;
+using PairSet = std::set<std::pair<CollisionObjectd*, CollisionObjectd*>>;
+
+std::pair<CollisionObjectd*, CollisionObjectd*> ordered(
+    CollisionObjectd* a, CollisionObjectd* b) {
+  return a < b ? std::make_pair(a, b) : std::make_pair(b, a);
+}
+
+// Collects the pairs reported by a manager.
+bool collectPair(CollisionObjectd* o1, CollisionObjectd* o2, void* data) {
+  PairSet* pairs = static_cast<PairSet*>(data);
+  EXPECT_TRUE(pairs->insert(ordered(o1, o2)).second);
+  return false;
+}
+
+// Keeps the smallest distance between the objects of the pairs reported by a
+// manager, checking that they are objects of the scene.
+struct DistanceData {
+  std::set<CollisionObjectd*> objs;
+  double min_distance = std::numeric_limits<double>::max();
+};
+
+bool minDistance(CollisionObjectd* o1, CollisionObjectd* o2, void* data,
+                 double& dist) {
+  DistanceData* distance_data = static_cast<DistanceData*>(data);
+  EXPECT_EQ(1u, distance_data->objs.count(o1));
+  EXPECT_EQ(1u, distance_data->objs.count(o2));
+  fcl::DistanceRequestd request;
+  fcl::DistanceResultd result;
+  fcl::distance(o1, o2, request, result);
+  distance_data->min_distance =
+      std::min(distance_data->min_distance, result.min_distance);
+  dist = distance_data->min_distance;
+  return dist <= 0;
+}
+
+bool objectsCollide(CollisionObjectd* o1, CollisionObjectd* o2) {
+  fcl::CollisionRequestd request;
+  fcl::CollisionResultd result;
+  return fcl::collide(o1, o2, request, result) > 0;
+}
+
+// Randomly places and rotates the objects of the scene.
+void moveObjects(std::vector<CollisionObjectd*>& objs, std::mt19937& rng) {
+  std::uniform_real_distribution<double> position(-4.0, 4.0);
+  std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+  for (CollisionObjectd* obj : objs) {
+    Transform3d tf = Transform3d::Identity();
+    tf.linear() = (fcl::AngleAxisd(angle(rng), Vector3d::UnitX()) *
+                   fcl::AngleAxisd(angle(rng), Vector3d::UnitY()) *
+                   fcl::AngleAxisd(angle(rng), Vector3d::UnitZ()))
+                      .toRotationMatrix();
+    tf.translation() = Vector3d(position(rng), position(rng), position(rng));
+    obj->setTransform(tf);
+    obj->computeAABB();
+  }
+}
+
+// A scene of long thin links, a sphere and a mesh.
+std::vector<std::unique_ptr<CollisionObjectd>> makeScene() {
+  std::vector<std::unique_ptr<CollisionObjectd>> objs;
+  auto capsule = std::make_shared<fcl::Capsuled>(0.1, 4.0);
+  auto box = std::make_shared<fcl::Boxd>(0.2, 0.2, 4.0);
+  for (int i = 0; i < 30; ++i) {
+    objs.emplace_back(new CollisionObjectd(capsule));
+    objs.emplace_back(new CollisionObjectd(box));
+  }
+  objs.emplace_back(new CollisionObjectd(std::make_shared<fcl::Sphered>(0.5)));
+
+  auto mesh = std::make_shared<fcl::BVHModel<fcl::OBBRSSd>>();
+  fcl::generateBVHModel(*mesh, fcl::Boxd(0.2, 4.0, 0.2),
+                        Transform3d::Identity());
+  objs.emplace_back(new CollisionObjectd(mesh));
+  return objs;
+}
+
+// Checks that the manager reports every colliding pair, only pairs of
+// overlapping AABBs, and strictly fewer pairs than the AABB tree alone.
+template <typename BV>
+void testLeafBVs() {
+  std::mt19937 rng(0);
+  auto scene = makeScene();
+  std::vector<CollisionObjectd*> objs;
+  for (const auto& obj : scene) objs.push_back(obj.get());
+  moveObjects(objs, rng);
+
+  fcl::DynamicAABBTreeLeafBVCollisionManager<BV> manager;
+  fcl::DynamicAABBTreeCollisionManager<double> aabb_manager;
+  manager.registerObjects(objs);
+  manager.setup();
+  aabb_manager.registerObjects(objs);
+  aabb_manager.setup();
+  manager.registerObject(objs.front());
+  EXPECT_EQ(objs.size(), manager.size());
+  for (CollisionObjectd* obj : objs) EXPECT_NE(nullptr, manager.getLeafBV(obj));
+
+  // The manager hands out the registered objects, not its tree leaves
+  std::vector<CollisionObjectd*> managed_objs;
+  manager.getObjects(managed_objs);
+  EXPECT_EQ(std::set<CollisionObjectd*>(objs.begin(), objs.end()),
+            std::set<CollisionObjectd*>(managed_objs.begin(),
+                                        managed_objs.end()));
+
+  for (int step = 0; step < 3; ++step) {
+    if (step > 0) {
+      moveObjects(objs, rng);
+      manager.update();
+      aabb_manager.update();
+    }
+
+    PairSet pairs;
+    PairSet aabb_pairs;
+    manager.collide(&pairs, collectPair);
+    aabb_manager.collide(&aabb_pairs, collectPair);
+
+    for (const auto& pair : pairs) EXPECT_EQ(1u, aabb_pairs.count(pair));
+    for (const auto& pair : aabb_pairs) {
+      if (objectsCollide(pair.first, pair.second)) {
+        EXPECT_EQ(1u, pairs.count(pair));
+      }
+    }
+    EXPECT_LT(pairs.size(), aabb_pairs.size());
+
+    // The distance queries are those of the AABB tree
+    DistanceData distance_data;
+    DistanceData aabb_distance_data;
+    distance_data.objs.insert(objs.begin(), objs.end());
+    aabb_distance_data.objs = distance_data.objs;
+    manager.distance(&distance_data, minDistance);
+    aabb_manager.distance(&aabb_distance_data, minDistance);
+    EXPECT_EQ(aabb_distance_data.min_distance, distance_data.min_distance);
+
+    // One object against the manager
+    CollisionObjectd* query = objs[step];
+    DistanceData query_distance_data;
+    DistanceData aabb_query_distance_data;
+    query_distance_data.objs = distance_data.objs;
+    aabb_query_distance_data.objs = distance_data.objs;
+    manager.distance(query, &query_distance_data, minDistance);
+    aabb_manager.distance(query, &aabb_query_distance_data, minDistance);
+    EXPECT_EQ(aabb_query_distance_data.min_distance,
+              query_distance_data.min_distance);
+    PairSet query_pairs;
+    manager.collide(query, &query_pairs, collectPair);
+    for (const auto& pair : query_pairs) {
+      if (pair.first != pair.second) {
+        EXPECT_EQ(1u, aabb_pairs.count(pair));
+      }
+    }
+    for (CollisionObjectd* obj : objs) {
+      if (obj != query && objectsCollide(query, obj)) {
+        EXPECT_EQ(1u, query_pairs.count(ordered(query, obj)));
+      }
+    }
+  }
+
+  // Two managers splitting the scene
+  const std::size_t half = objs.size() / 2;
+  std::vector<CollisionObjectd*> objs1(objs.begin(), objs.begin() + half);
+  std::vector<CollisionObjectd*> objs2(objs.begin() + half, objs.end());
+  fcl::DynamicAABBTreeLeafBVCollisionManager<BV> manager1;
+  fcl::DynamicAABBTreeLeafBVCollisionManager<BV> manager2;
+  manager1.registerObjects(objs1);
+  manager1.setup();
+  manager2.registerObjects(objs2);
+  manager2.setup();
+
+  PairSet cross_pairs;
+  manager1.collide(&manager2, &cross_pairs, collectPair);
+  for (CollisionObjectd* o1 : objs1) {
+    for (CollisionObjectd* o2 : objs2) {
+      if (objectsCollide(o1, o2)) {
+        EXPECT_EQ(1u, cross_pairs.count(ordered(o1, o2)));
+      }
+    }
+  }
+
+  manager.unregisterObject(objs.front());
+  EXPECT_EQ(nullptr, manager.getLeafBV(objs.front()));
+  EXPECT_EQ(objs.size() - 1, manager.size());
+  manager.clear();
+  EXPECT_TRUE(manager.empty());
+}
+
+GTEST_TEST(DynamicAABBTreeLeafBVCollisionManager, OBB) {
+  testLeafBVs<fcl::OBBd>();
+}
+
+GTEST_TEST(DynamicAABBTreeLeafBVCollisionManager, KDOP18) {
+  testLeafBVs<fcl::KDOP<double, 18>>();
+}
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,110 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+/** Tests IntervalTreeCollisionManager. */
+
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fcl/broadphase/broadphase_interval_tree.h"
+#include "fcl/geometry/shape/box.h"
+
+using fcl::CollisionObjectd;
+using PairSet = std::set<std::pair<CollisionObjectd*, CollisionObjectd*>>;
+
+bool collectPair(CollisionObjectd* o1, CollisionObjectd* o2, void* data) {
+  static_cast<PairSet*>(data)->insert(std::minmax(o1, o2));
+  return false;
+}
+
+// Unregisters two objects of an overlapping row, one of which has moved since
+// the manager last saw it, and checks that the manager then holds and reports
+// exactly the remaining objects.
+GTEST_TEST(IntervalTreeCollisionManager, unregisterObject) {
+  auto box = std::make_shared<fcl::Boxd>(1, 1, 1);
+  std::vector<std::unique_ptr<CollisionObjectd>> objs;
+  for (int i = 0; i < 10; ++i) {
+    objs.emplace_back(new CollisionObjectd(box));
+    objs.back()->setTranslation(fcl::Vector3d(0.75 * i, 0, 0));
+    objs.back()->computeAABB();
+  }
+
+  fcl::IntervalTreeCollisionManagerd manager;
+  for (const auto& obj : objs) manager.registerObject(obj.get());
+  manager.setup();
+
+  // Object 3 is looked up by its end points in the manager, not its AABB
+  objs[3]->setTranslation(fcl::Vector3d(100, 100, 100));
+  objs[3]->computeAABB();
+  manager.unregisterObject(objs[3].get());
+  manager.unregisterObject(objs[6].get());
+  EXPECT_EQ(8u, manager.size());
+
+  std::vector<CollisionObjectd*> registered;
+  manager.getObjects(registered);
+  std::vector<CollisionObjectd*> expected_registered;
+  for (int i = 0; i < 10; ++i) {
+    if (i != 3 && i != 6) expected_registered.push_back(objs[i].get());
+  }
+  std::sort(registered.begin(), registered.end());
+  std::sort(expected_registered.begin(), expected_registered.end());
+  EXPECT_EQ(expected_registered, registered);
+
+  manager.update();
+  PairSet pairs;
+  manager.collide(&pairs, collectPair);
+  PairSet expected_pairs;
+  for (std::size_t i = 0; i < expected_registered.size(); ++i) {
+    for (std::size_t j = i + 1; j < expected_registered.size(); ++j) {
+      CollisionObjectd* o1 = expected_registered[i];
+      CollisionObjectd* o2 = expected_registered[j];
+      if (o1->getAABB().overlap(o2->getAABB()))
+        expected_pairs.insert(std::minmax(o1, o2));
+    }
+  }
+  EXPECT_FALSE(expected_pairs.empty());
+  EXPECT_EQ(expected_pairs, pairs);
+}
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
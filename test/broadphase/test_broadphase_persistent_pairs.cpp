@@ -0,0 +1,264 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+/** Tests the persistent-pair mode of the broadphase collision managers. */
+
+#include <memory>
+#include <new>
+#include <random>
+#include <set>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fcl/broadphase/broadphase_bruteforce.h"
+#include "fcl/broadphase/broadphase_dynamic_AABB_tree.h"
+#include "fcl/broadphase/broadphase_dynamic_AABB_tree_array.h"
+#include "fcl/broadphase/broadphase_interval_tree.h"
+#include "fcl/broadphase/broadphase_SaP.h"
+#include "fcl/broadphase/broadphase_SaP_array.h"
+#include "fcl/broadphase/broadphase_spatialhash.h"
+#include "fcl/broadphase/broadphase_SSaP.h"
+#include "fcl/geometry/shape/box.h"
+
+using fcl::CollisionObjectd;
+using fcl::Vector3d;
+using PairSet = std::set<std::pair<CollisionObjectd*, CollisionObjectd*>>;
+
+struct PairEvents {
+  PairSet added;
+  PairSet persisting;
+  PairSet removed;
+};
+
+// Records one kind of event, checking that the pairs come ordered and once.
+template <PairSet PairEvents::*kind>
+void recordPair(CollisionObjectd* o1, CollisionObjectd* o2, void* data) {
+  EXPECT_LT(o1, o2);
+  PairEvents* events = static_cast<PairEvents*>(data);
+  EXPECT_TRUE((events->*kind).insert(std::make_pair(o1, o2)).second);
+}
+
+std::pair<CollisionObjectd*, CollisionObjectd*> ordered(
+    CollisionObjectd* a, CollisionObjectd* b) {
+  return a < b ? std::make_pair(a, b) : std::make_pair(b, a);
+}
+
+PairSet bruteForcePairs(const std::vector<CollisionObjectd*>& objs) {
+  PairSet pairs;
+  for (size_t i = 0; i < objs.size(); ++i) {
+    for (size_t j = i + 1; j < objs.size(); ++j) {
+      if (objs[i]->getAABB().overlap(objs[j]->getAABB()))
+        pairs.insert(ordered(objs[i], objs[j]));
+    }
+  }
+  return pairs;
+}
+
+std::vector<std::unique_ptr<fcl::BroadPhaseCollisionManagerd>> makeManagers(
+    const Vector3d& lower_limit, const Vector3d& upper_limit) {
+  std::vector<std::unique_ptr<fcl::BroadPhaseCollisionManagerd>> managers;
+  managers.emplace_back(new fcl::NaiveCollisionManagerd());
+  managers.emplace_back(new fcl::SSaPCollisionManagerd());
+  managers.emplace_back(new fcl::SaPCollisionManagerd());
+  managers.emplace_back(new fcl::SaPCollisionManager_Arrayd());
+  managers.emplace_back(new fcl::IntervalTreeCollisionManagerd());
+  managers.emplace_back(new fcl::SpatialHashingCollisionManager<double>(
+      2.0, lower_limit, upper_limit));
+  managers.emplace_back(new fcl::DynamicAABBTreeCollisionManagerd());
+  managers.emplace_back(new fcl::DynamicAABBTreeCollisionManager_Arrayd());
+  return managers;
+}
+
+// Moves boxes around for a few steps, unregistering one of them on the way,
+// and checks that every manager splits the overlapping pairs into new,
+// persisting and removed ones as a brute force comparison does.
+GTEST_TEST(BroadPhaseCollisionManager, persistent_pairs) {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<double> position(-6, 6);
+  std::uniform_real_distribution<double> step(-0.5, 0.5);
+  std::uniform_real_distribution<double> side(0.5, 2.0);
+
+  std::vector<std::unique_ptr<CollisionObjectd>> storage;
+  std::vector<CollisionObjectd*> objs;
+  for (int i = 0; i < 100; ++i) {
+    auto box = std::make_shared<fcl::Boxd>(side(rng), side(rng), side(rng));
+    storage.emplace_back(new CollisionObjectd(box));
+    storage.back()->setTranslation(
+        Vector3d(position(rng), position(rng), position(rng)));
+    storage.back()->computeAABB();
+    objs.push_back(storage.back().get());
+  }
+
+  Vector3d lower_limit, upper_limit;
+  fcl::SpatialHashingCollisionManager<double>::computeBound(
+      objs, lower_limit, upper_limit);
+
+  auto managers = makeManagers(lower_limit, upper_limit);
+  for (auto& manager : managers) {
+    manager->registerObjects(objs);
+    manager->setup();
+  }
+
+  // The pairs of an unregistered object are reported with the data of the
+  // last collidePersistent() call, so each manager keeps its own
+  std::vector<PairEvents> events(managers.size());
+
+  PairSet previous;
+  for (int iteration = 0; iteration < 10; ++iteration) {
+    if (iteration > 0) {
+      for (CollisionObjectd* obj : objs) {
+        obj->setTranslation(obj->getTranslation() +
+                            Vector3d(step(rng), step(rng), step(rng)));
+        obj->computeAABB();
+      }
+    }
+
+    // Dropping an object ends all its pairs
+    CollisionObjectd* dropped = nullptr;
+    if (iteration == 5) {
+      dropped = objs.back();
+      objs.pop_back();
+    }
+
+    const PairSet current = bruteForcePairs(objs);
+    PairEvents expected;
+    for (const auto& pair : current) {
+      if (previous.count(pair))
+        expected.persisting.insert(pair);
+      else
+        expected.added.insert(pair);
+    }
+    for (const auto& pair : previous) {
+      if (!current.count(pair)) expected.removed.insert(pair);
+    }
+
+    for (size_t i = 0; i < managers.size(); ++i) {
+      SCOPED_TRACE(i);
+      auto& manager = managers[i];
+      events[i] = PairEvents();
+      if (dropped) manager->unregisterObject(dropped);
+      manager->update();
+
+      manager->collidePersistent(&events[i], recordPair<&PairEvents::added>,
+                                 recordPair<&PairEvents::persisting>,
+                                 recordPair<&PairEvents::removed>);
+      EXPECT_EQ(expected.added, events[i].added);
+      EXPECT_EQ(expected.persisting, events[i].persisting);
+      EXPECT_EQ(expected.removed, events[i].removed);
+      EXPECT_EQ(current.size(), manager->numPersistentPairs());
+    }
+
+    previous = current;
+  }
+
+  // After clearing, every pair is new again, and null callbacks are skipped
+  for (auto& manager : managers) {
+    manager->clearPersistentPairs();
+    PairEvents events;
+    manager->collidePersistent(&events, recordPair<&PairEvents::added>,
+                               nullptr, nullptr);
+    EXPECT_EQ(previous, events.added);
+  }
+}
+
+// Unregisters and destroys an object, then creates another one at the same
+// address: the pairs of the first one are reported as removed while it is
+// alive, and the second one only has new pairs.
+GTEST_TEST(BroadPhaseCollisionManager, persistent_pairs_destroyed_object) {
+  auto box = std::make_shared<fcl::Boxd>(1.0, 1.0, 1.0);
+  CollisionObjectd kept(box);
+  kept.computeAABB();
+
+  auto managers = makeManagers(Vector3d(-5, -5, -5), Vector3d(5, 5, 5));
+  for (size_t i = 0; i < managers.size(); ++i) {
+    SCOPED_TRACE(i);
+    auto& manager = managers[i];
+
+    // Storage for the objects created at one address
+    std::aligned_storage<sizeof(CollisionObjectd),
+                         alignof(CollisionObjectd)>::type storage;
+
+    CollisionObjectd* dropped = new (&storage) CollisionObjectd(box);
+    dropped->setTranslation(Vector3d(0.5, 0, 0));
+    dropped->computeAABB();
+    manager->registerObjects({&kept, dropped});
+    manager->setup();
+
+    PairEvents events;
+    manager->collidePersistent(&events, recordPair<&PairEvents::added>,
+                               recordPair<&PairEvents::persisting>,
+                               recordPair<&PairEvents::removed>);
+    const PairSet dropped_pairs{ordered(&kept, dropped)};
+    EXPECT_EQ(dropped_pairs, events.added);
+
+    events = PairEvents();
+    manager->unregisterObject(dropped);
+    EXPECT_EQ(dropped_pairs, events.removed);
+    EXPECT_EQ(0u, manager->numPersistentPairs());
+    dropped->~CollisionObjectd();
+
+    CollisionObjectd* added = new (&storage) CollisionObjectd(box);
+    added->setTranslation(Vector3d(0, 0.5, 0));
+    added->computeAABB();
+    manager->registerObject(added);
+    manager->update();
+
+    events = PairEvents();
+    manager->collidePersistent(&events, recordPair<&PairEvents::added>,
+                               recordPair<&PairEvents::persisting>,
+                               recordPair<&PairEvents::removed>);
+    const PairSet added_pairs{ordered(&kept, added)};
+    EXPECT_EQ(added_pairs, events.added);
+    EXPECT_TRUE(events.persisting.empty());
+    EXPECT_TRUE(events.removed.empty());
+
+    // Clearing the manager ends all the pairs
+    events = PairEvents();
+    manager->clear();
+    EXPECT_EQ(added_pairs, events.removed);
+    EXPECT_EQ(0u, manager->numPersistentPairs());
+    added->~CollisionObjectd();
+  }
+}
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,194 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+/** Tests the spatial hashing collision manager and its hash tables. */
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fcl/broadphase/broadphase_spatialhash.h"
+#include "fcl/broadphase/detail/simple_hash_table.h"
+#include "fcl/broadphase/detail/sparse_hash_table.h"
+#include "fcl/broadphase/detail/spatial_hash.h"
+#include "fcl/geometry/shape/box.h"
+
+using AABBd = fcl::AABB<double>;
+using SpatialHashd = fcl::detail::SpatialHash<double>;
+
+// Returns the values whose cells intersect the cells of the query box, which
+// is what the hash tables are expected to report.
+std::vector<int> bruteForceQuery(const SpatialHashd& hash,
+                                 const std::map<int, AABBd>& boxes,
+                                 const AABBd& query) {
+  std::vector<unsigned int> query_cells = hash(query);
+  std::sort(query_cells.begin(), query_cells.end());
+
+  std::vector<int> result;
+  for (const auto& box : boxes) {
+    for (unsigned int cell : hash(box.second)) {
+      if (std::binary_search(query_cells.begin(), query_cells.end(), cell)) {
+        result.push_back(box.first);
+        break;
+      }
+    }
+  }
+  return result;
+}
+
+// Inserts, removes and queries random boxes and compares every query with
+// the brute force answer.
+template <typename HashTable>
+void testHashTable() {
+  const AABBd scene_limit(fcl::Vector3d(0, 0, 0), fcl::Vector3d(10, 10, 10));
+  const SpatialHashd hash(scene_limit, 1.0);
+
+  // Start small so that the table has to grow
+  HashTable table(hash);
+  table.init(2);
+
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> position(0.0, 8.0);
+  std::uniform_real_distribution<double> extent(0.0, 2.0);
+  auto random_box = [&]() {
+    const fcl::Vector3d min(position(generator), position(generator),
+                            position(generator));
+    const fcl::Vector3d max = min + fcl::Vector3d(extent(generator),
+                                                  extent(generator),
+                                                  extent(generator));
+    return AABBd(min, max);
+  };
+
+  std::map<int, AABBd> boxes;
+  std::vector<int> result;
+  for (int step = 0; step < 2000; ++step) {
+    const int value = std::uniform_int_distribution<int>(1, 100)(generator);
+    auto it = boxes.find(value);
+    if (it == boxes.end()) {
+      const AABBd box = random_box();
+      table.insert(box, value);
+      boxes.emplace(value, box);
+    } else {
+      table.remove(it->second, value);
+      boxes.erase(it);
+    }
+
+    const AABBd query = random_box();
+    table.query(query, result);
+    EXPECT_EQ(bruteForceQuery(hash, boxes, query), result);
+    EXPECT_EQ(result, table.query(query));
+  }
+
+  table.clear();
+  table.query(scene_limit, result);
+  EXPECT_TRUE(result.empty());
+}
+
+GTEST_TEST(SimpleHashTable, insertRemoveQuery) {
+  testHashTable<fcl::detail::SimpleHashTable<AABBd, int, SpatialHashd>>();
+}
+
+GTEST_TEST(SparseHashTable, insertRemoveQuery) {
+  testHashTable<fcl::detail::SparseHashTable<AABBd, int, SpatialHashd>>();
+}
+
+struct NestedQuery {
+  fcl::SpatialHashingCollisionManager<double>* manager;
+  fcl::CollisionObjectd* inner_query;
+  std::set<fcl::CollisionObjectd*> found;
+};
+
+bool collectNested(fcl::CollisionObjectd*, fcl::CollisionObjectd* o2,
+                   void* data) {
+  NestedQuery* nested = static_cast<NestedQuery*>(data);
+  nested->found.insert(o2);
+
+  // A query on the same manager from within a callback
+  std::set<fcl::CollisionObjectd*> inner;
+  nested->manager->collide(
+      nested->inner_query, &inner,
+      [](fcl::CollisionObjectd*, fcl::CollisionObjectd* o, void* d) {
+        static_cast<std::set<fcl::CollisionObjectd*>*>(d)->insert(o);
+        return false;
+      });
+  return false;
+}
+
+// Checks that a query whose callback queries the same manager still reports
+// all its own objects.
+GTEST_TEST(SpatialHashingCollisionManager, nestedQueries) {
+  auto box = std::make_shared<fcl::Boxd>(1, 1, 1);
+  std::vector<std::unique_ptr<fcl::CollisionObjectd>> objs;
+  for (int i = 0; i < 20; ++i) {
+    objs.emplace_back(new fcl::CollisionObjectd(box));
+    objs.back()->setTranslation(fcl::Vector3d(0.5 * i, 0, 0));
+    objs.back()->computeAABB();
+  }
+
+  fcl::SpatialHashingCollisionManager<double> manager(
+      1.0, fcl::Vector3d(-2, -2, -2), fcl::Vector3d(12, 2, 2));
+  for (const auto& obj : objs) manager.registerObject(obj.get());
+  manager.setup();
+
+  auto outer_box = std::make_shared<fcl::Boxd>(6, 1, 1);
+  fcl::CollisionObjectd outer_query(outer_box);
+  outer_query.setTranslation(fcl::Vector3d(4.5, 0, 0));
+  outer_query.computeAABB();
+  fcl::CollisionObjectd inner_query(box);
+  inner_query.setTranslation(fcl::Vector3d(9, 0, 0));
+  inner_query.computeAABB();
+
+  NestedQuery nested{&manager, &inner_query, {}};
+  manager.collide(&outer_query, &nested, collectNested);
+
+  std::set<fcl::CollisionObjectd*> expected;
+  for (const auto& obj : objs) {
+    if (obj->getAABB().overlap(outer_query.getAABB()))
+      expected.insert(obj.get());
+  }
+  EXPECT_EQ(expected, nested.found);
+}
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
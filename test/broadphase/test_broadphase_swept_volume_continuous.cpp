@@ -0,0 +1,243 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+/** Tests the swept volume broad phase continuous collision managers. */
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fcl/broadphase/broadphase_swept_volume_continuous.h"
+#include "fcl/broadphase/default_broadphase_callbacks.h"
+#include "fcl/geometry/shape/sphere.h"
+#include "fcl/math/motion/translation_motion.h"
+#include "fcl/narrowphase/continuous_collision.h"
+
+using ContinuousObject = fcl::ContinuousCollisionObjectd;
+using ObjectPair = std::pair<ContinuousObject*, ContinuousObject*>;
+
+ObjectPair makePair(ContinuousObject* o1, ContinuousObject* o2) {
+  return (o1 < o2) ? ObjectPair(o1, o2) : ObjectPair(o2, o1);
+}
+
+// Collects the pairs the narrowphase continuous collision reports as
+// colliding.
+struct CollidingPairs {
+  fcl::ContinuousCollisionRequestd request;
+  std::set<ObjectPair> pairs;
+};
+
+bool collectCollidingPairs(ContinuousObject* o1, ContinuousObject* o2,
+                           void* data) {
+  auto* cdata = static_cast<CollidingPairs*>(data);
+  fcl::ContinuousCollisionResultd result;
+  fcl::collide(o1, o2, cdata->request, result);
+  if (result.is_collide) cdata->pairs.insert(makePair(o1, o2));
+  return false;
+}
+
+// Spheres translating between random poses.
+std::vector<std::unique_ptr<ContinuousObject>> generateMovingSpheres(
+    std::size_t n, std::mt19937& generator) {
+  std::uniform_real_distribution<double> position(-20.0, 20.0);
+  std::uniform_real_distribution<double> displacement(-5.0, 5.0);
+
+  std::vector<std::unique_ptr<ContinuousObject>> objects;
+  for (std::size_t i = 0; i < n; ++i) {
+    auto sphere = std::make_shared<fcl::Sphered>(1.0);
+    sphere->computeLocalAABB();
+
+    fcl::Transform3d tf_beg = fcl::Transform3d::Identity();
+    tf_beg.translation() = fcl::Vector3d(
+        position(generator), position(generator), position(generator));
+    fcl::Transform3d tf_end = tf_beg;
+    tf_end.translation() += fcl::Vector3d(displacement(generator),
+                                          displacement(generator),
+                                          displacement(generator));
+
+    auto motion =
+        std::make_shared<fcl::TranslationMotion<double>>(tf_beg, tf_end);
+    objects.emplace_back(new ContinuousObject(sphere, motion));
+  }
+  return objects;
+}
+
+// The pairs of the brute force O(N^2) continuous collision.
+std::set<ObjectPair> bruteForcePairs(
+    const std::vector<std::unique_ptr<ContinuousObject>>& objects) {
+  CollidingPairs data;
+  for (std::size_t i = 0; i < objects.size(); ++i) {
+    for (std::size_t j = i + 1; j < objects.size(); ++j)
+      collectCollidingPairs(objects[i].get(), objects[j].get(), &data);
+  }
+  return data.pairs;
+}
+
+template <typename Manager>
+void testSelfCollision() {
+  std::mt19937 generator(7);
+  const auto objects = generateMovingSpheres(200, generator);
+
+  std::vector<ContinuousObject*> object_ptrs;
+  for (const auto& object : objects) object_ptrs.push_back(object.get());
+
+  Manager manager;
+  manager.registerObjects(object_ptrs);
+  manager.setup();
+  EXPECT_EQ(objects.size(), manager.size());
+
+  const std::set<ObjectPair> expected = bruteForcePairs(objects);
+  EXPECT_FALSE(expected.empty());
+
+  CollidingPairs data;
+  manager.collide(&data, collectCollidingPairs);
+  EXPECT_EQ(expected, data.pairs);
+
+  // The swept AABBs enclose both end poses of every object.
+  for (const auto& object : objects) {
+    fcl::Transform3d tf;
+    object->getMotion()->integrate(0.0);
+    object->getMotion()->getCurrentTransform(tf);
+    EXPECT_TRUE(object->getAABB().contain(tf.translation()));
+    object->getMotion()->integrate(1.0);
+    object->getMotion()->getCurrentTransform(tf);
+    EXPECT_TRUE(object->getAABB().contain(tf.translation()));
+  }
+
+  // Single object queries against the manager.
+  const auto queries = generateMovingSpheres(20, generator);
+  for (const auto& query : queries) {
+    CollidingPairs query_data;
+    manager.collide(query.get(), &query_data, collectCollidingPairs);
+
+    CollidingPairs expected_data;
+    for (const auto& object : objects)
+      collectCollidingPairs(query.get(), object.get(), &expected_data);
+    EXPECT_EQ(expected_data.pairs, query_data.pairs);
+  }
+
+  // Removing half of the objects drops their pairs.
+  for (std::size_t i = 0; i < objects.size(); i += 2)
+    manager.unregisterObject(objects[i].get());
+  std::vector<ContinuousObject*> remaining;
+  manager.getObjects(remaining);
+  EXPECT_EQ(objects.size() / 2, remaining.size());
+
+  CollidingPairs remaining_data;
+  manager.collide(&remaining_data, collectCollidingPairs);
+  for (const auto& pair : expected) {
+    const bool kept = std::count(remaining.begin(), remaining.end(),
+                                 pair.first) &&
+                      std::count(remaining.begin(), remaining.end(),
+                                 pair.second);
+    EXPECT_EQ(kept, remaining_data.pairs.count(pair) == 1);
+  }
+}
+
+GTEST_TEST(DynamicAABBTreeContinuousCollisionManager, collide) {
+  testSelfCollision<fcl::DynamicAABBTreeContinuousCollisionManagerd>();
+}
+
+GTEST_TEST(SaPContinuousCollisionManager, collide) {
+  testSelfCollision<fcl::SaPContinuousCollisionManagerd>();
+}
+
+// The default callback keeps the earliest contact of all the pairs.
+GTEST_TEST(DynamicAABBTreeContinuousCollisionManager, defaultCallback) {
+  std::mt19937 generator(11);
+  const auto objects = generateMovingSpheres(200, generator);
+
+  fcl::DynamicAABBTreeContinuousCollisionManagerd manager;
+  for (const auto& object : objects) manager.registerObject(object.get());
+  manager.setup();
+
+  fcl::DefaultContinuousCollisionData<double> data;
+  manager.collide(&data, fcl::DefaultContinuousCollisionFunction);
+  ASSERT_TRUE(data.result.is_collide);
+
+  for (const auto& pair : bruteForcePairs(objects)) {
+    fcl::ContinuousCollisionResultd result;
+    fcl::collide(pair.first, pair.second, data.request, result);
+    EXPECT_LE(data.result.time_of_contact, result.time_of_contact);
+  }
+}
+
+// Registering an object again keeps its swept volume in the discrete manager.
+template <typename Manager>
+void testDuplicateRegistration() {
+  std::mt19937 generator(13);
+  const auto objects = generateMovingSpheres(100, generator);
+
+  std::vector<ContinuousObject*> object_ptrs;
+  for (const auto& object : objects) object_ptrs.push_back(object.get());
+
+  Manager manager;
+  manager.registerObjects(object_ptrs);
+  manager.registerObjects(object_ptrs);
+  for (const auto& object : objects) manager.registerObject(object.get());
+  manager.setup();
+  EXPECT_EQ(objects.size(), manager.size());
+
+  CollidingPairs data;
+  manager.collide(&data, collectCollidingPairs);
+  EXPECT_EQ(bruteForcePairs(objects), data.pairs);
+
+  for (const auto& object : objects) manager.unregisterObject(object.get());
+  EXPECT_TRUE(manager.empty());
+
+  CollidingPairs empty_data;
+  manager.collide(&empty_data, collectCollidingPairs);
+  EXPECT_TRUE(empty_data.pairs.empty());
+}
+
+GTEST_TEST(DynamicAABBTreeContinuousCollisionManager, duplicateRegistration) {
+  testDuplicateRegistration<fcl::DynamicAABBTreeContinuousCollisionManagerd>();
+}
+
+GTEST_TEST(SaPContinuousCollisionManager, duplicateRegistration) {
+  testDuplicateRegistration<fcl::SaPContinuousCollisionManagerd>();
+}
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -38,6 +38,7 @@
 
 #include "fcl/geometry/shape/convex.h"
 
+#include <random>
 #include <vector>
 
 #include <Eigen/StdVector>
@@ -145,6 +146,10 @@ class Polytope {
     polygons_->push_back(static_cast<int>(indices.size()));
     polygons_->insert(polygons_->end(), indices);
   }
+  void add_face(const std::vector<int>& indices) {
+    polygons_->push_back(static_cast<int>(indices.size()));
+    polygons_->insert(polygons_->end(), indices.begin(), indices.end());
+  }
   // Confirms the number of vertices and number of polygons matches the counts
   // implied by vertex_count() and face_count(), respectively.
   void confirm_data() {
@@ -264,6 +269,161 @@ class Cube : public Polytope<S> {
   }
 };
 
+// A sphere of unit radius (scaled by `scale`) approximated by `rings` rings of
+// `segments` vertices between two poles. The faces between two rings are
+// planar quads; those touching a pole are triangles.
+template <typename S>
+class TessellatedSphere : public Polytope<S> {
+ public:
+  TessellatedSphere(S scale, int rings, int segments)
+    : Polytope<S>(scale), rings_(rings), segments_(segments) {
+    const S pi = constants<S>::pi();
+    this->add_vertex(Vector3<S>(0, 0, scale));    // North pole
+    this->add_vertex(Vector3<S>(0, 0, -scale));   // South pole
+    for (int i = 0; i < rings; ++i) {
+      const S polar = pi * (i + 1) / (rings + 1);
+      for (int j = 0; j < segments; ++j) {
+        const S azimuth = 2 * pi * j / segments;
+        this->add_vertex(scale * Vector3<S>(std::sin(polar) * std::cos(azimuth),
+                                            std::sin(polar) * std::sin(azimuth),
+                                            std::cos(polar)));
+      }
+    }
+
+    auto vertex = [segments](int ring, int segment) {
+      return 2 + ring * segments + (segment % segments);
+    };
+    for (int j = 0; j < segments; ++j) {
+      this->add_face({0, vertex(0, j), vertex(0, j + 1)});
+      this->add_face({1, vertex(rings - 1, j + 1), vertex(rings - 1, j)});
+      for (int i = 0; i + 1 < rings; ++i) {
+        this->add_face({vertex(i, j), vertex(i + 1, j), vertex(i + 1, j + 1),
+                        vertex(i, j + 1)});
+      }
+    }
+
+    this->confirm_data();
+  }
+
+  // Polytope properties; only the counts are needed by the tests.
+  int face_count() const final { return segments_ * (rings_ + 1); }
+  int vertex_count() const final { return 2 + rings_ * segments_; }
+  S volume() const final { return 0; }
+  Vector3<S> com() const final { return Vector3<S>::Zero(); }
+  Matrix3<S> principal_inertia_tensor() const final {
+    return Matrix3<S>::Zero();
+  }
+  std::string description() const final {
+    return "Tessellated sphere with scale: " + std::to_string(this->scale());
+  }
+
+ private:
+  int rings_;
+  int segments_;
+};
+
+// A prism of unit radius and height 2 (scaled by `scale`) over a regular
+// polygon of `segments` vertices, whose two caps are single polygons.
+template <typename S>
+class Prism : public Polytope<S> {
+ public:
+  Prism(S scale, int segments) : Polytope<S>(scale), segments_(segments) {
+    const S pi = constants<S>::pi();
+    for (S z : {scale, -scale}) {
+      for (int j = 0; j < segments; ++j) {
+        const S azimuth = 2 * pi * j / segments;
+        this->add_vertex(Vector3<S>(scale * std::cos(azimuth),
+                                    scale * std::sin(azimuth), z));
+      }
+    }
+
+    std::vector<int> top;
+    std::vector<int> bottom;
+    for (int j = 0; j < segments; ++j) {
+      top.push_back(j);
+      bottom.push_back(2 * segments - 1 - j);
+    }
+    this->add_face(top);
+    this->add_face(bottom);
+    for (int j = 0; j < segments; ++j) {
+      const int next = (j + 1) % segments;
+      this->add_face({j, segments + j, segments + next, next});
+    }
+
+    this->confirm_data();
+  }
+
+  // Polytope properties; only the counts are needed by the tests.
+  int face_count() const final { return segments_ + 2; }
+  int vertex_count() const final { return 2 * segments_; }
+  S volume() const final { return 0; }
+  Vector3<S> com() const final { return Vector3<S>::Zero(); }
+  Matrix3<S> principal_inertia_tensor() const final {
+    return Matrix3<S>::Zero();
+  }
+  std::string description() const final {
+    return "Prism with " + std::to_string(segments_) + " segments";
+  }
+
+ private:
+  int segments_;
+};
+
+// Confirms that findExtremeVertexIndex() returns a vertex with the largest
+// projection for random directions and starting vertices, both for polytopes
+// searched by hill climbing and for those scanned linearly.
+template <typename S>
+void testFindExtremeVertex(const Polytope<S>& polytope) {
+  const Convex<S> convex = polytope.MakeConvex();
+  const std::vector<Vector3<S>>& vertices = convex.getVertices();
+  const int num_vertices = static_cast<int>(vertices.size());
+  const S tolerance = 8 * constants<S>::eps() * polytope.scale();
+
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<S> coordinate(-1, 1);
+  std::uniform_int_distribution<int> start(-1, num_vertices);
+  int hint = 0;
+  for (int i = 0; i < 1000; ++i) {
+    const Vector3<S> dir(coordinate(rng), coordinate(rng), coordinate(rng));
+    S max_dot = -std::numeric_limits<S>::max();
+    for (const auto& v : vertices) max_dot = max(max_dot, dir.dot(v));
+
+    // From an arbitrary (possibly out of range) start and from the previous
+    // support vertex.
+    const int index = convex.findExtremeVertexIndex(dir, start(rng));
+    GTEST_ASSERT_GE(index, 0);
+    GTEST_ASSERT_LT(index, num_vertices);
+    EXPECT_NEAR(dir.dot(vertices[index]), max_dot, tolerance)
+        << polytope.description();
+
+    hint = convex.findExtremeVertexIndex(dir, hint);
+    EXPECT_NEAR(dir.dot(vertices[hint]), max_dot, tolerance)
+        << polytope.description();
+  }
+
+  // Along a face normal every vertex of the face is extreme; the index must
+  // be the one a linear scan picks, whatever the start.
+  const std::vector<int>& faces = convex.getFaces();
+  int face_index = 0;
+  for (int f = 0; f < convex.getFaceCount(); ++f) {
+    const Vector3<S>& a = vertices[faces[face_index + 1]];
+    const Vector3<S>& b = vertices[faces[face_index + 2]];
+    const Vector3<S>& c = vertices[faces[face_index + 3]];
+    const Vector3<S> normal = (b - a).cross(c - a);
+    face_index += faces[face_index] + 1;
+
+    int expected = 0;
+    for (int v = 1; v < num_vertices; ++v) {
+      if (normal.dot(vertices[v]) > normal.dot(vertices[expected]))
+        expected = v;
+    }
+    for (int s = 0; s < num_vertices; s += 7) {
+      EXPECT_EQ(convex.findExtremeVertexIndex(normal, s), expected)
+          << polytope.description() << " face " << f << " start " << s;
+    }
+  }
+}
+
 void testConvexConstruction() {
   Cube<double> cube{1};
   // Set the cube at some other location to make sure that the interior point
@@ -513,6 +673,18 @@ GTEST_TEST(ConvexGeometry, CenterOfMass_Tetrahedron) {
   }
 }
 
+GTEST_TEST(ConvexGeometry, FindExtremeVertex) {
+  // The cube and tetrahedron are scanned linearly, the spheres climbed.
+  testFindExtremeVertex(Cube<double>(2));
+  testFindExtremeVertex(EquilateralTetrahedron<double>(2));
+  testFindExtremeVertex(TessellatedSphere<double>(3, 8, 12));
+  testFindExtremeVertex(TessellatedSphere<double>(3, 40, 80));
+  testFindExtremeVertex(TessellatedSphere<float>(3, 40, 80));
+  // Caps with more tied vertices than the climb gathers on the stack.
+  testFindExtremeVertex(Prism<double>(2, 40));
+  testFindExtremeVertex(Prism<double>(2, 100));
+}
+
 // TODO(SeanCurtis-TRI): Add Tetrahedron inertia unit test.
 
 // TODO(SeanCurtis-TRI): Extend the moment of inertia test.
@@ -0,0 +1,168 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+/** Tests that the Minkowski difference of statically typed shapes agrees with
+ the one that dispatches on the shape types at runtime. */
+
+#include "fcl/narrowphase/detail/convexity_based_algorithm/epa.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fcl/geometry/shape/box.h"
+#include "fcl/geometry/shape/capsule.h"
+#include "fcl/geometry/shape/cone.h"
+#include "fcl/geometry/shape/convex.h"
+#include "fcl/geometry/shape/cylinder.h"
+#include "fcl/geometry/shape/ellipsoid.h"
+#include "fcl/geometry/shape/sphere.h"
+#include "fcl/geometry/shape/triangle_p.h"
+
+namespace fcl {
+namespace detail {
+namespace {
+
+// An octahedron with the given half diagonal.
+template <typename S>
+Convex<S> MakeOctahedron(S r) {
+  auto vertices = std::make_shared<std::vector<Vector3<S>>>();
+  vertices->emplace_back(r, 0, 0);
+  vertices->emplace_back(-r, 0, 0);
+  vertices->emplace_back(0, r, 0);
+  vertices->emplace_back(0, -r, 0);
+  vertices->emplace_back(0, 0, r);
+  vertices->emplace_back(0, 0, -r);
+  auto faces = std::make_shared<std::vector<int>>(std::vector<int>{
+      3, 0, 2, 4,  3, 2, 1, 4,  3, 1, 3, 4,  3, 3, 0, 4,
+      3, 2, 0, 5,  3, 1, 2, 5,  3, 3, 1, 5,  3, 0, 3, 5});
+  return Convex<S>(vertices, 8, faces);
+}
+
+// Sets up the runtime and the typed Minkowski differences of s1 and s2 in the
+// given poses, then checks that their supports agree along random directions
+// and that GJK and EPA give the same results on both.
+template <typename Shape1, typename Shape2>
+void checkTypedMinkowskiDiff(
+    const Shape1& s1, const Transform3<double>& tf1,
+    const Shape2& s2, const Transform3<double>& tf2) {
+  MinkowskiDiff<double> runtime;
+  TypedMinkowskiDiff<Shape1, Shape2> typed;
+  for (MinkowskiDiff<double>* shape :
+       {&runtime, static_cast<MinkowskiDiff<double>*>(&typed)}) {
+    shape->shapes[0] = &s1;
+    shape->shapes[1] = &s2;
+    shape->toshape1.noalias() = tf2.linear().transpose() * tf1.linear();
+    shape->toshape0 = tf1.inverse(Eigen::Isometry) * tf2;
+  }
+
+  std::mt19937 generator(0);
+  std::normal_distribution<double> distribution;
+  for (int i = 0; i < 100; ++i) {
+    Vector3<double> d(distribution(generator), distribution(generator),
+                      distribution(generator));
+    d.normalize();
+    const Vector3<double> v = 0.1 * d.unitOrthogonal();
+    EXPECT_EQ(runtime.support(d), typed.support(d));
+    EXPECT_EQ(runtime.support(d, v), typed.support(d, v));
+    EXPECT_EQ(runtime.support(d, 0), typed.support(d, 0));
+    EXPECT_EQ(runtime.support(d, 1), typed.support(d, 1));
+  }
+
+  const Vector3<double> guess(1, 0, 0);
+  GJK<double> runtime_gjk(128, 1e-6);
+  GJK<double, TypedMinkowskiDiff<Shape1, Shape2>> typed_gjk(128, 1e-6);
+  const GJK<double>::Status runtime_status = runtime_gjk.evaluate(runtime, -guess);
+  const GJK<double>::Status typed_status = typed_gjk.evaluate(typed, -guess);
+  EXPECT_EQ(runtime_status, typed_status);
+  EXPECT_EQ(runtime_gjk.distance, typed_gjk.distance);
+
+  if (runtime_status == GJK<double>::Inside) {
+    EPA<double> runtime_epa(128, 64, 255, 1e-6);
+    EPA<double> typed_epa(128, 64, 255, 1e-6);
+    EXPECT_EQ(runtime_epa.evaluate(runtime_gjk, -guess),
+              typed_epa.evaluate(typed_gjk, -guess));
+    EXPECT_EQ(runtime_epa.depth, typed_epa.depth);
+    EXPECT_EQ(runtime_epa.normal, typed_epa.normal);
+  }
+}
+
+// The pairs are tested both separated and overlapping.
+template <typename Shape1, typename Shape2>
+void checkTypedMinkowskiDiff(const Shape1& s1, const Shape2& s2) {
+  Transform3<double> tf1 = Transform3<double>::Identity();
+  tf1.linear() =
+      AngleAxis<double>(0.3, Vector3<double>(1, 2, 3).normalized()).matrix();
+  for (double x : {0.25, 4.0}) {
+    Transform3<double> tf2 = Transform3<double>::Identity();
+    tf2.linear() =
+        AngleAxis<double>(-0.7, Vector3<double>(3, 1, 2).normalized()).matrix();
+    tf2.translation() = Vector3<double>(x, 0.1, -0.2);
+    checkTypedMinkowskiDiff(s1, tf1, s2, tf2);
+  }
+}
+
+GTEST_TEST(TypedMinkowskiDiff, AgreesWithRuntimeDispatch) {
+  const Box<double> box(1, 2, 3);
+  const Sphere<double> sphere(0.8);
+  const Ellipsoid<double> ellipsoid(0.5, 1, 1.5);
+  const Capsule<double> capsule(0.5, 2);
+  const Cone<double> cone(0.7, 1.5);
+  const Cylinder<double> cylinder(0.6, 1.8);
+  const Convex<double> convex = MakeOctahedron(1.2);
+  const TriangleP<double> triangle(Vector3<double>(0, 0, 0),
+                                   Vector3<double>(1, 0, 0),
+                                   Vector3<double>(0, 1, 0.5));
+
+  checkTypedMinkowskiDiff(box, sphere);
+  checkTypedMinkowskiDiff(ellipsoid, capsule);
+  checkTypedMinkowskiDiff(cone, cylinder);
+  checkTypedMinkowskiDiff(convex, box);
+  checkTypedMinkowskiDiff(capsule, convex);
+  checkTypedMinkowskiDiff(cylinder, triangle);
+}
+
+}  // namespace
+}  // namespace detail
+}  // namespace fcl
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
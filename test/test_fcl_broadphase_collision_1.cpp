@@ -41,10 +41,12 @@
 #include "fcl/broadphase/broadphase_bruteforce.h"
 #include "fcl/broadphase/broadphase_spatialhash.h"
 #include "fcl/broadphase/broadphase_SaP.h"
+#include "fcl/broadphase/broadphase_SaP_array.h"
 #include "fcl/broadphase/broadphase_SSaP.h"
 #include "fcl/broadphase/broadphase_interval_tree.h"
 #include "fcl/broadphase/broadphase_dynamic_AABB_tree.h"
 #include "fcl/broadphase/broadphase_dynamic_AABB_tree_array.h"
+#include "fcl/broadphase/broadphase_dynamic_AABB_tree_leaf_BV.h"
 #include "fcl/broadphase/default_broadphase_callbacks.h"
 #include "fcl/broadphase/detail/sparse_hash_table.h"
 #include "fcl/broadphase/detail/spatial_hash.h"
@@ -213,6 +215,7 @@ void broad_phase_duplicate_check_test(S env_scale, std::size_t env_size, bool ve
   managers.push_back(new NaiveCollisionManager<S>());
   managers.push_back(new SSaPCollisionManager<S>());
   managers.push_back(new SaPCollisionManager<S>());
+  managers.push_back(new SaPCollisionManager_Array<S>());
   managers.push_back(new IntervalTreeCollisionManager<S>());
   Vector3<S> lower_limit, upper_limit;
   SpatialHashingCollisionManager<S>::computeBound(env, lower_limit, upper_limit);
@@ -224,6 +227,8 @@ void broad_phase_duplicate_check_test(S env_scale, std::size_t env_size, bool ve
 #endif
   managers.push_back(new DynamicAABBTreeCollisionManager<S>());
   managers.push_back(new DynamicAABBTreeCollisionManager_Array<S>());
+  managers.push_back(new DynamicAABBTreeLeafBVCollisionManager<OBB<S>>());
+  managers.push_back(new DynamicAABBTreeLeafBVCollisionManager<KDOP<S, 18>>());
 
   {
     DynamicAABBTreeCollisionManager<S>* m = new DynamicAABBTreeCollisionManager<S>();
@@ -371,6 +376,7 @@ void broad_phase_update_collision_test(S env_scale, std::size_t env_size, std::s
 
 
   managers.push_back(new SaPCollisionManager<S>());
+  managers.push_back(new SaPCollisionManager_Array<S>());
   managers.push_back(new IntervalTreeCollisionManager<S>());
 
   Vector3<S> lower_limit, upper_limit;
@@ -384,6 +390,8 @@ void broad_phase_update_collision_test(S env_scale, std::size_t env_size, std::s
 #endif
   managers.push_back(new DynamicAABBTreeCollisionManager<S>());
   managers.push_back(new DynamicAABBTreeCollisionManager_Array<S>());
+  managers.push_back(new DynamicAABBTreeLeafBVCollisionManager<OBB<S>>());
+  managers.push_back(new DynamicAABBTreeLeafBVCollisionManager<KDOP<S, 18>>());
 
   {
     DynamicAABBTreeCollisionManager<S>* m = new DynamicAABBTreeCollisionManager<S>();
@@ -41,10 +41,12 @@
 #include "fcl/broadphase/broadphase_bruteforce.h"
 #include "fcl/broadphase/broadphase_spatialhash.h"
 #include "fcl/broadphase/broadphase_SaP.h"
+#include "fcl/broadphase/broadphase_SaP_array.h"
 #include "fcl/broadphase/broadphase_SSaP.h"
 #include "fcl/broadphase/broadphase_interval_tree.h"
 #include "fcl/broadphase/broadphase_dynamic_AABB_tree.h"
 #include "fcl/broadphase/broadphase_dynamic_AABB_tree_array.h"
+#include "fcl/broadphase/broadphase_dynamic_AABB_tree_leaf_BV.h"
 #include "fcl/broadphase/default_broadphase_callbacks.h"
 #include "fcl/broadphase/detail/sparse_hash_table.h"
 #include "fcl/broadphase/detail/spatial_hash.h"
@@ -205,6 +207,7 @@ void broad_phase_collision_test(S env_scale, std::size_t env_size, std::size_t q
   managers.push_back(new NaiveCollisionManager<S>());
   managers.push_back(new SSaPCollisionManager<S>());
   managers.push_back(new SaPCollisionManager<S>());
+  managers.push_back(new SaPCollisionManager_Array<S>());
   managers.push_back(new IntervalTreeCollisionManager<S>());
 
   Vector3<S> lower_limit, upper_limit;
@@ -221,6 +224,8 @@ void broad_phase_collision_test(S env_scale, std::size_t env_size, std::size_t q
   managers.push_back(new DynamicAABBTreeCollisionManager<S>());
 
   managers.push_back(new DynamicAABBTreeCollisionManager_Array<S>());
+  managers.push_back(new DynamicAABBTreeLeafBVCollisionManager<OBB<S>>());
+  managers.push_back(new DynamicAABBTreeLeafBVCollisionManager<KDOP<S, 18>>());
 
   {
     DynamicAABBTreeCollisionManager<S>* m = new DynamicAABBTreeCollisionManager<S>();
@@ -41,6 +41,7 @@
 #include "fcl/broadphase/broadphase_bruteforce.h"
 #include "fcl/broadphase/broadphase_spatialhash.h"
 #include "fcl/broadphase/broadphase_SaP.h"
+#include "fcl/broadphase/broadphase_SaP_array.h"
 #include "fcl/broadphase/broadphase_SSaP.h"
 #include "fcl/broadphase/broadphase_interval_tree.h"
 #include "fcl/broadphase/broadphase_dynamic_AABB_tree.h"
@@ -334,6 +335,7 @@ void broad_phase_self_distance_test(S env_scale, std::size_t env_size, bool use_
   managers.push_back(new NaiveCollisionManager<S>());
   managers.push_back(new SSaPCollisionManager<S>());
   managers.push_back(new SaPCollisionManager<S>());
+  managers.push_back(new SaPCollisionManager_Array<S>());
   managers.push_back(new IntervalTreeCollisionManager<S>());
 
   Vector3<S> lower_limit, upper_limit;
@@ -477,6 +479,7 @@ void broad_phase_distance_test(S env_scale, std::size_t env_size, std::size_t qu
   managers.push_back(new NaiveCollisionManager<S>());
   managers.push_back(new SSaPCollisionManager<S>());
   managers.push_back(new SaPCollisionManager<S>());
+  managers.push_back(new SaPCollisionManager_Array<S>());
   managers.push_back(new IntervalTreeCollisionManager<S>());
 
   Vector3<S> lower_limit, upper_limit;
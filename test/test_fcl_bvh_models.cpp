@@ -38,8 +38,15 @@
 
 #include "fcl/config.h"
 #include "fcl/geometry/bvh/BVH_model.h"
+#include "fcl/geometry/bvh/detail/BV_fitter.h"
+#include "fcl/geometry/geometric_shape_to_BVH_model.h"
+#include "fcl/narrowphase/collision.h"
 #include "test_fcl_utility.h"
+#include "fcl_resources/config.h"
+#include <atomic>
+#include <functional>
 #include <iostream>
+#include <thread>
 
 using namespace fcl;
 
@@ -223,6 +230,235 @@ GTEST_TEST(FCL_BVH_MODELS, building_bvh_models)
   testBVHModel<KDOP<double, 24> >();
 }
 
+template<typename BV>
+void checkBVHSubtree(const BVHModel<BV>& model, int bv_id,
+                     std::vector<int>& primitive_count)
+{
+  const BVNode<BV>& node = model.getBV(bv_id);
+  if(node.isLeaf())
+  {
+    GTEST_ASSERT_EQ(node.num_primitives, 1);
+    ++primitive_count[node.primitiveId()];
+    return;
+  }
+
+  const BVNode<BV>& left = model.getBV(node.leftChild());
+  const BVNode<BV>& right = model.getBV(node.rightChild());
+  GTEST_ASSERT_EQ(left.num_primitives + right.num_primitives,
+                  node.num_primitives);
+  GTEST_ASSERT_EQ(left.first_primitive, node.first_primitive);
+  GTEST_ASSERT_EQ(right.first_primitive,
+                  left.first_primitive + left.num_primitives);
+
+  checkBVHSubtree(model, node.leftChild(), primitive_count);
+  checkBVHSubtree(model, node.rightChild(), primitive_count);
+}
+
+/// Builds env.obj with the default settings and with those set by configure,
+/// checks the structure of the latter and that both report the same contacts.
+template<typename BV>
+void testBVHModelAlternativeBuild(
+    const std::function<void(BVHModel<BV>&)>& configure)
+{
+  using S = typename BV::S;
+
+  std::vector<Vector3<S>> points;
+  std::vector<Triangle> triangles;
+  test::loadOBJFile(TEST_RESOURCES_DIR"/env.obj", points, triangles);
+
+  std::shared_ptr<BVHModel<BV>> top_down(new BVHModel<BV>);
+  std::shared_ptr<BVHModel<BV>> other(new BVHModel<BV>);
+  configure(*other);
+  for(auto* model : {top_down.get(), other.get()})
+  {
+    model->beginModel();
+    model->addSubModel(points, triangles);
+    model->endModel();
+  }
+
+  GTEST_ASSERT_EQ(other->getNumBVs(), 2 * other->num_tris - 1);
+  std::vector<int> primitive_count(other->num_tris, 0);
+  checkBVHSubtree(*other, 0, primitive_count);
+  for(int count : primitive_count)
+    GTEST_ASSERT_EQ(count, 1);
+
+  // The leaf BVs come from the model's fitter
+  detail::BVFitter<BV> fitter;
+  fitter.set(other->vertices, other->tri_indices, BVH_MODEL_TRIANGLES);
+  for(int i = 0; i < other->getNumBVs(); ++i)
+  {
+    const BVNode<BV>& node = other->getBV(i);
+    if(!node.isLeaf())
+      continue;
+    unsigned int primitive_id = node.primitiveId();
+    const BV bv = fitter.fit(&primitive_id, 1);
+    EXPECT_TRUE(bv.center() == node.bv.center());
+    EXPECT_EQ(bv.volume(), node.bv.volume());
+  }
+
+  // Both hierarchies must report the same contacts against a moving box.
+  std::shared_ptr<Box<S>> box(new Box<S>(400, 400, 400));
+  aligned_vector<Transform3<S>> transforms;
+  S extents[] = {-3000, -3000, -3000, 3000, 3000, 3000};
+  test::generateRandomTransforms(extents, transforms, 50);
+
+  for(const auto& tf : transforms)
+  {
+    CollisionObject<S> obj_top_down(top_down);
+    CollisionObject<S> obj_other(other);
+    CollisionObject<S> obj_box(box, tf);
+
+    CollisionRequest<S> request(100000, true);
+    CollisionResult<S> result_top_down;
+    CollisionResult<S> result_other;
+    collide(&obj_top_down, &obj_box, request, result_top_down);
+    collide(&obj_other, &obj_box, request, result_other);
+    GTEST_ASSERT_EQ(result_top_down.numContacts(), result_other.numContacts());
+  }
+}
+
+template<typename BV>
+void configureLBVH(BVHModel<BV>& model)
+{
+  model.build_method = BVH_BUILD_METHOD_LBVH;
+  model.build_num_threads = 4;
+}
+
+GTEST_TEST(FCL_BVH_MODELS, building_bvh_models_lbvh)
+{
+  testBVHModelAlternativeBuild<AABB<double>>(&configureLBVH<AABB<double>>);
+  testBVHModelAlternativeBuild<OBBRSS<double>>(&configureLBVH<OBBRSS<double>>);
+  testBVHModelAlternativeBuild<KDOP<double, 16> >(
+        &configureLBVH<KDOP<double, 16> >);
+}
+
+/// The default fitter, recording whether fit() was ever entered by two threads
+/// at once
+template<typename BV>
+class CheckedFitter : public detail::BVFitter<BV>
+{
+public:
+  BV fit(unsigned int* primitive_indices, int num_primitives) override
+  {
+    if(num_active++ > 0)
+      overlapped = true;
+    ++num_calls;
+    const BV bv = detail::BVFitter<BV>::fit(primitive_indices, num_primitives);
+    --num_active;
+    return bv;
+  }
+
+  std::atomic<int> num_active{0};
+  std::atomic<int> num_calls{0};
+  std::atomic<bool> overlapped{false};
+};
+
+template<typename BV>
+void testLBVHFitterAndConcurrentBuilds()
+{
+  using S = typename BV::S;
+
+  std::vector<Vector3<S>> points;
+  std::vector<Triangle> triangles;
+  test::loadOBJFile(TEST_RESOURCES_DIR"/env.obj", points, triangles);
+
+  // A fitter other than the default one is never called concurrently.
+  {
+    auto fitter = std::make_shared<CheckedFitter<BV>>();
+    BVHModel<BV> model;
+    configureLBVH(model);
+    model.bv_fitter = fitter;
+    model.beginModel();
+    model.addSubModel(points, triangles);
+    model.endModel();
+    EXPECT_FALSE(fitter->overlapped);
+    EXPECT_EQ(fitter->num_calls, model.num_tris);
+  }
+
+  // Models built at the same time get the same hierarchies as one built alone.
+  BVHModel<BV> reference;
+  configureLBVH(reference);
+  reference.beginModel();
+  reference.addSubModel(points, triangles);
+  reference.endModel();
+
+  std::vector<BVHModel<BV>> models(4);
+  std::vector<std::thread> threads;
+  for(auto& model : models)
+  {
+    threads.emplace_back([&]() {
+      configureLBVH(model);
+      model.beginModel();
+      model.addSubModel(points, triangles);
+      model.endModel();
+    });
+  }
+  for(auto& thread : threads)
+    thread.join();
+
+  for(const auto& model : models)
+  {
+    GTEST_ASSERT_EQ(model.getNumBVs(), reference.getNumBVs());
+    for(int i = 0; i < model.getNumBVs(); ++i)
+    {
+      EXPECT_EQ(model.getBV(i).first_child, reference.getBV(i).first_child);
+      EXPECT_TRUE(model.getBV(i).bv.center() == reference.getBV(i).bv.center());
+    }
+  }
+}
+
+GTEST_TEST(FCL_BVH_MODELS, lbvh_fitter_and_concurrent_builds)
+{
+  testLBVHFitterAndConcurrentBuilds<AABB<double>>();
+  testLBVHFitterAndConcurrentBuilds<OBBRSS<double>>();
+}
+
+template<typename BV>
+void configureSAH(BVHModel<BV>& model)
+{
+  model.bv_splitter.reset(
+        new detail::BVSplitter<BV>(detail::SPLIT_METHOD_SAH));
+}
+
+template<typename BV>
+void testBVHModelSAHQuality()
+{
+  using S = typename BV::S;
+
+  std::vector<Vector3<S>> points;
+  std::vector<Triangle> triangles;
+  test::loadOBJFile(TEST_RESOURCES_DIR"/env.obj", points, triangles);
+
+  BVHModel<BV> mean;
+  BVHModel<BV> sah;
+  configureSAH(sah);
+  for(auto* model : {&mean, &sah})
+  {
+    model->beginModel();
+    model->addSubModel(points, triangles);
+    model->endModel();
+  }
+
+  const BVHTreeQuality<S> mean_quality = mean.computeTreeQuality();
+  const BVHTreeQuality<S> sah_quality = sah.computeTreeQuality();
+  EXPECT_GT(mean_quality.sah_cost, 0);
+  EXPECT_LT(sah_quality.sah_cost, mean_quality.sah_cost);
+}
+
+GTEST_TEST(FCL_BVH_MODELS, building_bvh_models_sah)
+{
+  testBVHModelAlternativeBuild<AABB<double>>(&configureSAH<AABB<double>>);
+  testBVHModelAlternativeBuild<OBB<double>>(&configureSAH<OBB<double>>);
+  testBVHModelAlternativeBuild<RSS<double>>(&configureSAH<RSS<double>>);
+  testBVHModelAlternativeBuild<kIOS<double>>(&configureSAH<kIOS<double>>);
+  testBVHModelAlternativeBuild<OBBRSS<double>>(&configureSAH<OBBRSS<double>>);
+  testBVHModelAlternativeBuild<KDOP<double, 24> >(
+        &configureSAH<KDOP<double, 24> >);
+
+  testBVHModelSAHQuality<AABB<double>>();
+  testBVHModelSAHQuality<OBBRSS<double>>();
+}
+
 //==============================================================================
 int main(int argc, char* argv[])
 {
@@ -35,6 +35,9 @@
 
 /** @author Jia Pan */
 
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "fcl/math/bv/utility.h"
@@ -42,6 +45,7 @@
 #include "fcl/narrowphase/detail/gjk_solver_indep.h"
 #include "fcl/narrowphase/detail/gjk_solver_libccd.h"
 #include "fcl/narrowphase/detail/traversal/collision_node.h"
+#include "fcl/narrowphase/detail/traversal/parallel_traversal.h"
 
 #include "test_fcl_utility.h"
 
@@ -54,6 +58,128 @@ bool collide_Test(const Transform3<typename BV::S>& tf,
                   const std::vector<Vector3<typename BV::S>>& vertices1, const std::vector<Triangle>& triangles1,
                   const std::vector<Vector3<typename BV::S>>& vertices2, const std::vector<Triangle>& triangles2, detail::SplitMethodType split_method, bool verbose = true);
 
+template <typename BV>
+void test_mesh_mesh_parallel_traversal()
+{
+  using S = typename BV::S;
+
+  std::vector<Vector3<S>> p1, p2;
+  std::vector<Triangle> t1, t2;
+  test::loadOBJFile(TEST_RESOURCES_DIR"/env.obj", p1, t1);
+  test::loadOBJFile(TEST_RESOURCES_DIR"/rob.obj", p2, t2);
+
+  std::shared_ptr<BVHModel<BV>> m1(new BVHModel<BV>);
+  std::shared_ptr<BVHModel<BV>> m2(new BVHModel<BV>);
+  m1->beginModel();
+  m1->addSubModel(p1, t1);
+  m1->endModel();
+  m2->beginModel();
+  m2->addSubModel(p2, t2);
+  m2->endModel();
+
+  aligned_vector<Transform3<S>> transforms;
+  S extents[] = {-3000, -3000, 0, 3000, 3000, 3000};
+  test::generateRandomTransforms(extents, transforms, 50);
+
+  for(const auto& tf : transforms)
+  {
+    CollisionObject<S> o1(m1, tf);
+    CollisionObject<S> o2(m2, Transform3<S>::Identity());
+
+    for(std::size_t num_max_contacts : {std::size_t(1), std::size_t(100000)})
+    {
+      CollisionRequest<S> request(num_max_contacts, false);
+      CollisionResult<S> serial_result;
+      collide(&o1, &o2, request, serial_result);
+
+      request.enable_parallel_traversal = true;
+      request.num_traversal_threads = 4;
+      CollisionResult<S> parallel_result;
+      collide(&o1, &o2, request, parallel_result);
+
+      EXPECT_EQ(serial_result.isCollision(), parallel_result.isCollision());
+      EXPECT_EQ(serial_result.numContacts(), parallel_result.numContacts());
+    }
+  }
+}
+
+GTEST_TEST(FCL_COLLISION, mesh_mesh_parallel_traversal)
+{
+  test_mesh_mesh_parallel_traversal<AABB<double>>();
+  test_mesh_mesh_parallel_traversal<OBB<double>>();
+  test_mesh_mesh_parallel_traversal<RSS<double>>();
+  test_mesh_mesh_parallel_traversal<OBBRSS<double>>();
+}
+
+// Checks that the traversal pool is handed to one query at a time and that
+// queries run from several threads at once, which mostly find it taken, get
+// the serial results.
+GTEST_TEST(FCL_COLLISION, mesh_mesh_parallel_traversal_shared_pool)
+{
+  {
+    std::shared_ptr<detail::ThreadPool> pool =
+        detail::acquireTraversalThreadPool(2);
+    GTEST_ASSERT_NE(pool, nullptr);
+    EXPECT_EQ(pool->size(), 2u);
+    EXPECT_EQ(detail::acquireTraversalThreadPool(2), nullptr);
+    EXPECT_EQ(detail::acquireTraversalThreadPool(1), nullptr);
+  }
+  EXPECT_NE(detail::acquireTraversalThreadPool(2), nullptr);
+
+  std::vector<Vector3d> p1, p2;
+  std::vector<Triangle> t1, t2;
+  test::loadOBJFile(TEST_RESOURCES_DIR"/env.obj", p1, t1);
+  test::loadOBJFile(TEST_RESOURCES_DIR"/rob.obj", p2, t2);
+
+  std::shared_ptr<BVHModel<OBBRSSd>> m1(new BVHModel<OBBRSSd>);
+  std::shared_ptr<BVHModel<OBBRSSd>> m2(new BVHModel<OBBRSSd>);
+  m1->beginModel();
+  m1->addSubModel(p1, t1);
+  m1->endModel();
+  m2->beginModel();
+  m2->addSubModel(p2, t2);
+  m2->endModel();
+
+  aligned_vector<Transform3d> transforms;
+  double extents[] = {-3000, -3000, 0, 3000, 3000, 3000};
+  test::generateRandomTransforms(extents, transforms, 20);
+
+  CollisionRequestd request(100000, false);
+  std::vector<std::size_t> serial_num_contacts;
+  for(const auto& tf : transforms)
+  {
+    CollisionObjectd o1(m1, tf);
+    CollisionObjectd o2(m2, Transform3d::Identity());
+    CollisionResultd result;
+    collide(&o1, &o2, request, result);
+    serial_num_contacts.push_back(result.numContacts());
+  }
+
+  request.enable_parallel_traversal = true;
+  request.num_traversal_threads = 2;
+  std::vector<std::vector<std::size_t>> num_contacts(
+      4, std::vector<std::size_t>(transforms.size()));
+  std::vector<std::thread> threads;
+  for(std::size_t t = 0; t < num_contacts.size(); ++t)
+  {
+    threads.emplace_back([&, t]() {
+      for(std::size_t i = 0; i < transforms.size(); ++i)
+      {
+        CollisionObjectd o1(m1, transforms[i]);
+        CollisionObjectd o2(m2, Transform3d::Identity());
+        CollisionResultd result;
+        collide(&o1, &o2, request, result);
+        num_contacts[t][i] = result.numContacts();
+      }
+    });
+  }
+  for(auto& thread : threads)
+    thread.join();
+
+  for(const auto& thread_num_contacts : num_contacts)
+    EXPECT_EQ(serial_num_contacts, thread_num_contacts);
+}
+
 template<typename BV>
 bool collide_Test2(const Transform3<typename BV::S>& tf,
                    const std::vector<Vector3<typename BV::S>>& vertices1, const std::vector<Triangle>& triangles1,
@@ -0,0 +1,545 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "fcl/narrowphase/continuous_collision.h"
+#include "fcl/narrowphase/detail/convexity_based_algorithm/gjk_raycast.h"
+#include "fcl/geometry/shape/box.h"
+#include "fcl/geometry/shape/capsule.h"
+#include "fcl/geometry/shape/cylinder.h"
+#include "fcl/geometry/shape/sphere.h"
+#include "fcl/geometry/geometric_shape_to_BVH_model.h"
+#include "test_fcl_utility.h"
+
+using namespace fcl;
+
+//==============================================================================
+template <typename S>
+Transform3<S> translation(S x, S y, S z)
+{
+  Transform3<S> tf = Transform3<S>::Identity();
+  tf.translation() = Vector3<S>(x, y, z);
+  return tf;
+}
+
+//==============================================================================
+template <typename S>
+void testRayShootingSpheres()
+{
+  const Sphere<S> s1(1);
+  const Sphere<S> s2(1);
+
+  ContinuousCollisionRequest<S> request;
+  request.ccd_solver_type = CCDC_RAY_SHOOTING;
+  request.ccd_motion_type = CCDM_TRANS;
+
+  // Head on: the gap of 8 closes after 80% of the motion.
+  {
+    ContinuousCollisionResult<S> result;
+    continuousCollide<S>(&s1, translation<S>(0, 0, 0), translation<S>(10, 0, 0),
+                         &s2, translation<S>(10, 0, 0), translation<S>(10, 0, 0),
+                         request, result);
+    EXPECT_TRUE(result.is_collide);
+    EXPECT_NEAR(result.time_of_contact, 0.8, 1e-3);
+    EXPECT_LE(result.time_of_contact, 0.8);
+    EXPECT_NEAR(result.contact_tf1.translation()[0], 8, 1e-2);
+  }
+
+  // Both moving, towards each other
+  {
+    ContinuousCollisionResult<S> result;
+    continuousCollide<S>(&s1, translation<S>(0, 0, 0), translation<S>(4, 0, 0),
+                         &s2, translation<S>(10, 0, 0), translation<S>(4, 0, 0),
+                         request, result);
+    EXPECT_TRUE(result.is_collide);
+    EXPECT_NEAR(result.time_of_contact, 0.8, 1e-3);
+  }
+
+  // Passing by at a distance of 2.5 between the centers
+  {
+    ContinuousCollisionResult<S> result;
+    continuousCollide<S>(&s1, translation<S>(0, 0, 0), translation<S>(20, 0, 0),
+                         &s2, translation<S>(10, 2.5, 0), translation<S>(10, 2.5, 0),
+                         request, result);
+    EXPECT_FALSE(result.is_collide);
+  }
+
+  // Stopping short
+  {
+    ContinuousCollisionResult<S> result;
+    continuousCollide<S>(&s1, translation<S>(0, 0, 0), translation<S>(7, 0, 0),
+                         &s2, translation<S>(10, 0, 0), translation<S>(10, 0, 0),
+                         request, result);
+    EXPECT_FALSE(result.is_collide);
+  }
+
+  // Overlapping from the start
+  {
+    ContinuousCollisionResult<S> result;
+    continuousCollide<S>(&s1, translation<S>(0, 0, 0), translation<S>(5, 0, 0),
+                         &s2, translation<S>(1, 0, 0), translation<S>(1, 0, 0),
+                         request, result);
+    EXPECT_TRUE(result.is_collide);
+    EXPECT_NEAR(result.time_of_contact, 0, 1e-6);
+  }
+}
+
+//==============================================================================
+template <typename S>
+void testGJKRaycastIterationLimit()
+{
+  // A unit box at the origin and a sphere of radius 0.5 translating by ray
+  // from (-5, y, 0) past it or into it
+  const Box<S> box(1, 1, 1);
+  const Sphere<S> sphere(0.5);
+  const Vector3<S> ray(10, 0, 0);
+
+  for(S y : {S(0), S(2)})
+  {
+    detail::MinkowskiDiff<S> shape;
+    shape.shapes[0] = &box;
+    shape.shapes[1] = &sphere;
+    shape.toshape1.setIdentity();
+    shape.toshape0 = translation<S>(-5, y, 0);
+
+    S toi;
+    Vector3<S> normal;
+    const bool hit = detail::gjkRaycast(shape, ray, S(1e-6), 64, toi, normal);
+    EXPECT_EQ(hit, y == 0);
+    if(hit)
+      EXPECT_NEAR(toi, 0.4, 1e-6);
+
+    // A single iteration cannot get within the tolerance of the difference,
+    // which must not be reported as a hit
+    EXPECT_FALSE(detail::gjkRaycast(shape, ray, S(1e-6), 1, toi, normal));
+  }
+}
+
+//==============================================================================
+template <typename S>
+void testRayShootingMatchesNaive()
+{
+  const Box<S> box(1, 2, 3);
+  const Capsule<S> capsule(0.5, 2);
+  const Cylinder<S> cylinder(0.7, 1.5);
+  const std::vector<const CollisionGeometry<S>*> shapes{&box, &capsule, &cylinder};
+
+  ContinuousCollisionRequest<S> ray_request;
+  ray_request.ccd_solver_type = CCDC_RAY_SHOOTING;
+  ray_request.ccd_motion_type = CCDM_TRANS;
+
+  ContinuousCollisionRequest<S> naive_request;
+  naive_request.ccd_solver_type = CCDC_NAIVE;
+  naive_request.ccd_motion_type = CCDM_TRANS;
+  naive_request.num_max_iterations = 2001;
+  naive_request.toc_err = 1 / S(2000);
+
+  aligned_vector<Transform3<S>> transforms;
+  S extents[] = {-4, -4, -4, 4, 4, 4};
+  test::generateRandomTransforms(extents, transforms, 40);
+
+  for(std::size_t i = 0; i + 1 < transforms.size(); i += 2)
+  {
+    const Transform3<S>& tf1_beg = transforms[i];
+    Transform3<S> tf1_end = tf1_beg;
+    tf1_end.translation() = transforms[i + 1].translation();
+    const Transform3<S> tf2 = Transform3<S>::Identity();
+
+    for(const auto* o1 : shapes)
+    {
+      for(const auto* o2 : shapes)
+      {
+        ContinuousCollisionResult<S> ray_result;
+        ContinuousCollisionResult<S> naive_result;
+        continuousCollide(o1, tf1_beg, tf1_end, o2, tf2, tf2,
+                          ray_request, ray_result);
+        continuousCollide(o1, tf1_beg, tf1_end, o2, tf2, tf2,
+                          naive_request, naive_result);
+
+        GTEST_ASSERT_EQ(ray_result.is_collide, naive_result.is_collide);
+        if(ray_result.is_collide)
+        {
+          // Naive sampling only finds the first sample inside; the ray never
+          // passes the exact time of contact.
+          EXPECT_LE(ray_result.time_of_contact,
+                    naive_result.time_of_contact + 1e-6);
+          EXPECT_NEAR(ray_result.time_of_contact,
+                      naive_result.time_of_contact, 2e-3);
+        }
+      }
+    }
+  }
+}
+
+//==============================================================================
+template <typename S>
+void testAdaptiveNaiveSpheres()
+{
+  const Sphere<S> s1(1);
+  const Sphere<S> s2(1);
+
+  // A coarse grid of samples, refined by bisection
+  ContinuousCollisionRequest<S> request;
+  request.ccd_solver_type = CCDC_NAIVE;
+  request.ccd_motion_type = CCDM_TRANS;
+  request.use_adaptive_sampling = true;
+  request.num_max_iterations = 10;
+  request.toc_err = 1e-5;
+
+  // Head on: the gap of 8 closes after 80% of the motion.
+  {
+    ContinuousCollisionResult<S> result;
+    continuousCollide<S>(&s1, translation<S>(0, 0, 0), translation<S>(10, 0, 0),
+                         &s2, translation<S>(10, 0, 0), translation<S>(10, 0, 0),
+                         request, result);
+    EXPECT_TRUE(result.is_collide);
+    EXPECT_GE(result.time_of_contact, 0.8 - 1e-9);
+    EXPECT_LE(result.time_of_contact, 0.8 + request.toc_err);
+  }
+
+  // Passing by at a distance of 2.5 between the centers
+  {
+    ContinuousCollisionResult<S> result;
+    continuousCollide<S>(&s1, translation<S>(0, 0, 0), translation<S>(20, 0, 0),
+                         &s2, translation<S>(10, 2.5, 0), translation<S>(10, 2.5, 0),
+                         request, result);
+    EXPECT_FALSE(result.is_collide);
+  }
+
+  // Overlapping from the start
+  {
+    ContinuousCollisionResult<S> result;
+    continuousCollide<S>(&s1, translation<S>(0, 0, 0), translation<S>(5, 0, 0),
+                         &s2, translation<S>(1, 0, 0), translation<S>(1, 0, 0),
+                         request, result);
+    EXPECT_TRUE(result.is_collide);
+    EXPECT_EQ(result.time_of_contact, 0);
+  }
+}
+
+//==============================================================================
+template <typename S>
+void testAdaptiveNaiveMatchesUniform()
+{
+  const Box<S> box(1, 2, 3);
+  const Capsule<S> capsule(0.5, 2);
+  BVHModel<OBBRSS<S>> mesh;
+  generateBVHModel(mesh, Cylinder<S>(0.7, 1.5), Transform3<S>::Identity(), 16, 4);
+  const std::vector<const CollisionGeometry<S>*> geoms{&box, &capsule, &mesh};
+
+  ContinuousCollisionRequest<S> adaptive_request;
+  adaptive_request.ccd_solver_type = CCDC_NAIVE;
+  adaptive_request.ccd_motion_type = CCDM_LINEAR;
+  adaptive_request.use_adaptive_sampling = true;
+  adaptive_request.num_max_iterations = 101;
+  adaptive_request.toc_err = 1e-4;
+
+  ContinuousCollisionRequest<S> uniform_request;
+  uniform_request.ccd_solver_type = CCDC_NAIVE;
+  uniform_request.ccd_motion_type = CCDM_LINEAR;
+  uniform_request.num_max_iterations = 2001;
+  uniform_request.toc_err = 1 / S(2000);
+
+  aligned_vector<Transform3<S>> transforms;
+  S extents[] = {-4, -4, -4, 4, 4, 4};
+  test::generateRandomTransforms(extents, transforms, 20);
+
+  for(std::size_t i = 0; i + 1 < transforms.size(); i += 2)
+  {
+    const Transform3<S>& tf1_beg = transforms[i];
+    const Transform3<S>& tf1_end = transforms[i + 1];
+    const Transform3<S> tf2 = Transform3<S>::Identity();
+
+    for(const auto* o1 : geoms)
+    {
+      for(const auto* o2 : geoms)
+      {
+        ContinuousCollisionResult<S> adaptive_result;
+        ContinuousCollisionResult<S> uniform_result;
+        continuousCollide(o1, tf1_beg, tf1_end, o2, tf2, tf2,
+                          adaptive_request, adaptive_result);
+        continuousCollide(o1, tf1_beg, tf1_end, o2, tf2, tf2,
+                          uniform_request, uniform_result);
+
+        GTEST_ASSERT_EQ(adaptive_result.is_collide, uniform_result.is_collide);
+        if(adaptive_result.is_collide)
+        {
+          // Bisection resolves the contact more finely than the uniform
+          // samples do.
+          EXPECT_LE(adaptive_result.time_of_contact,
+                    uniform_result.time_of_contact + adaptive_request.toc_err);
+          EXPECT_NEAR(adaptive_result.time_of_contact,
+                      uniform_result.time_of_contact, 1e-3);
+        }
+      }
+    }
+  }
+}
+
+//==============================================================================
+template <typename S>
+void testTrajectorySphereBox()
+{
+  auto sphere = std::make_shared<Sphere<S>>(0.5);
+  auto box = std::make_shared<Box<S>>(1, 1, 1);
+  const CollisionObject<S> o1(sphere);
+  const CollisionObject<S> o2(box);
+
+  // The sphere moves along the x axis one unit per segment and touches the
+  // box halfway through segment 5.
+  aligned_vector<Transform3<S>> waypoints1;
+  for(int i = 0; i <= 10; ++i)
+    waypoints1.push_back(translation<S>(i, 0, 0));
+  aligned_vector<Transform3<S>> waypoints2{translation<S>(6.5, 0, 0)};
+
+  ContinuousCollisionRequest<S> request;
+  request.ccd_solver_type = CCDC_RAY_SHOOTING;
+  request.ccd_motion_type = CCDM_TRANS;
+
+  for(unsigned int num_threads : {1u, 4u})
+  {
+    request.num_trajectory_threads = num_threads;
+
+    TrajectoryCollisionResult<S> result;
+    const S t = continuousCollideTrajectory(
+          &o1, waypoints1, &o2, waypoints2, request, result);
+    EXPECT_TRUE(result.is_collide);
+    EXPECT_EQ(result.segment, 5);
+    EXPECT_NEAR(result.time_of_contact, 0.5, 1e-3);
+    EXPECT_NEAR(t, 5.5, 1e-3);
+    EXPECT_NEAR(result.contact_tf1.translation()[0], 5.5, 1e-3);
+
+    // Passing by
+    aligned_vector<Transform3<S>> waypoints3{translation<S>(6.5, 2, 0)};
+    TrajectoryCollisionResult<S> miss;
+    EXPECT_EQ(continuousCollideTrajectory(
+                &o1, waypoints1, &o2, waypoints3, request, miss), 10);
+    EXPECT_FALSE(miss.is_collide);
+    EXPECT_EQ(miss.segment, -1);
+  }
+
+  // Mismatched waypoint counts
+  {
+    aligned_vector<Transform3<S>> waypoints3(3, translation<S>(6.5, 0, 0));
+    TrajectoryCollisionResult<S> result;
+    EXPECT_EQ(continuousCollideTrajectory(
+                &o1, waypoints1, &o2, waypoints3, request, result), -1);
+  }
+}
+
+//==============================================================================
+template <typename S>
+void testTrajectoryMatchesSegments()
+{
+  auto box = std::make_shared<Box<S>>(1, 2, 3);
+  auto mesh = std::make_shared<BVHModel<OBBRSS<S>>>();
+  generateBVHModel(*mesh, Cylinder<S>(0.7, 1.5), Transform3<S>::Identity(), 16, 4);
+  const CollisionObject<S> o1(box);
+  const CollisionObject<S> o2(mesh);
+
+  aligned_vector<Transform3<S>> transforms;
+  S extents[] = {-3, -3, -3, 3, 3, 3};
+  test::generateRandomTransforms(extents, transforms, 200);
+  const aligned_vector<Transform3<S>> waypoints1(
+        transforms.begin(), transforms.begin() + 100);
+  const aligned_vector<Transform3<S>> waypoints2(
+        transforms.begin() + 100, transforms.end());
+
+  ContinuousCollisionRequest<S> request;
+  request.ccd_solver_type = CCDC_NAIVE;
+  request.ccd_motion_type = CCDM_LINEAR;
+  request.num_max_iterations = 50;
+  request.toc_err = 1 / S(49);
+
+  // Reference: the segments one at a time, up to the first contact
+  int expected_segment = -1;
+  ContinuousCollisionResult<S> expected;
+  for(std::size_t i = 0; i + 1 < waypoints1.size(); ++i)
+  {
+    continuousCollide(o1.collisionGeometry().get(), waypoints1[i], waypoints1[i + 1],
+                      o2.collisionGeometry().get(), waypoints2[i], waypoints2[i + 1],
+                      request, expected);
+    if(expected.is_collide)
+    {
+      expected_segment = static_cast<int>(i);
+      break;
+    }
+  }
+  EXPECT_TRUE(expected.is_collide);
+
+  for(unsigned int num_threads : {1u, 0u})
+  {
+    request.num_trajectory_threads = num_threads;
+
+    TrajectoryCollisionResult<S> result;
+    continuousCollideTrajectory(&o1, waypoints1, &o2, waypoints2, request, result);
+    EXPECT_EQ(result.is_collide, expected.is_collide);
+    EXPECT_EQ(result.segment, expected_segment);
+    EXPECT_EQ(result.time_of_contact, expected.time_of_contact);
+  }
+}
+
+//==============================================================================
+template <typename BV>
+void testPolynomialMeshes()
+{
+  using S = typename BV::S;
+
+  BVHModel<BV> m1;
+  BVHModel<BV> m2;
+  generateBVHModel(m1, Box<S>(1, 1, 1), translation<S>(0, 0, 0));
+  generateBVHModel(m2, Box<S>(1, 1, 1), translation<S>(3, 0.2, 0.1));
+  const std::vector<Vector3<S>> vertices1(m1.vertices, m1.vertices + m1.num_vertices);
+  const std::vector<Vector3<S>> vertices2(m2.vertices, m2.vertices + m2.num_vertices);
+
+  ContinuousCollisionRequest<S> request;
+  request.ccd_solver_type = CCDC_POLYNOMIAL_SOLVER;
+  request.ccd_motion_type = CCDM_TRANS;
+
+  // The gap of 2 closes halfway through the motion of m2. The polynomial
+  // solver may report a later root, so only bound the time of contact.
+  const auto hit = [&](ContinuousCollisionResult<S>& result)
+  {
+    continuousCollide<S>(&m1, translation<S>(0, 0, 0), translation<S>(0, 0, 0),
+                         &m2, translation<S>(0, 0, 0), translation<S>(-4, 0, 0),
+                         request, result);
+  };
+
+  ContinuousCollisionResult<S> result;
+  hit(result);
+  EXPECT_TRUE(result.is_collide);
+  EXPECT_GE(result.time_of_contact, 0.5 - 1e-6);
+  EXPECT_LE(result.time_of_contact, 1);
+
+  {
+    ContinuousCollisionResult<S> miss;
+    continuousCollide<S>(&m1, translation<S>(0, 0, 0), translation<S>(0, 0, 0),
+                         &m2, translation<S>(0, 0, 0), translation<S>(-1, 0, 0),
+                         request, miss);
+    EXPECT_FALSE(miss.is_collide);
+  }
+
+  // The models are left untouched by the queries.
+  EXPECT_TRUE(m1.prev_vertices == nullptr);
+  EXPECT_TRUE(m2.prev_vertices == nullptr);
+  for(int i = 0; i < m1.num_vertices; ++i)
+    EXPECT_TRUE(m1.vertices[i] == vertices1[i]);
+  for(int i = 0; i < m2.num_vertices; ++i)
+    EXPECT_TRUE(m2.vertices[i] == vertices2[i]);
+
+  // Concurrent queries on the same models agree with the serial one.
+  const int num_threads = 4;
+  const int num_queries = 50;
+  std::vector<std::thread> threads;
+  std::vector<int> mismatches(num_threads, 0);
+  for(int t = 0; t < num_threads; ++t)
+  {
+    threads.emplace_back([&, t]()
+    {
+      for(int i = 0; i < num_queries; ++i)
+      {
+        ContinuousCollisionResult<S> local;
+        hit(local);
+        if(!local.is_collide || local.time_of_contact != result.time_of_contact)
+          ++mismatches[t];
+      }
+    });
+  }
+  for(auto& thread : threads)
+    thread.join();
+
+  for(int t = 0; t < num_threads; ++t)
+    EXPECT_EQ(mismatches[t], 0);
+}
+
+//==============================================================================
+GTEST_TEST(FCL_CONTINUOUS_COLLISION, polynomial_meshes)
+{
+  testPolynomialMeshes<AABB<double>>();
+  testPolynomialMeshes<OBBRSS<double>>();
+  testPolynomialMeshes<KDOP<double, 16>>();
+}
+
+//==============================================================================
+GTEST_TEST(FCL_CONTINUOUS_COLLISION, ray_shooting_spheres)
+{
+  testRayShootingSpheres<double>();
+}
+
+//==============================================================================
+GTEST_TEST(FCL_CONTINUOUS_COLLISION, gjk_raycast_iteration_limit)
+{
+  testGJKRaycastIterationLimit<double>();
+}
+
+//==============================================================================
+GTEST_TEST(FCL_CONTINUOUS_COLLISION, ray_shooting_matches_naive)
+{
+  testRayShootingMatchesNaive<double>();
+}
+
+//==============================================================================
+GTEST_TEST(FCL_CONTINUOUS_COLLISION, adaptive_naive_spheres)
+{
+  testAdaptiveNaiveSpheres<double>();
+}
+
+//==============================================================================
+GTEST_TEST(FCL_CONTINUOUS_COLLISION, adaptive_naive_matches_uniform)
+{
+  testAdaptiveNaiveMatchesUniform<double>();
+}
+
+//==============================================================================
+GTEST_TEST(FCL_CONTINUOUS_COLLISION, trajectory_sphere_box)
+{
+  testTrajectorySphereBox<double>();
+}
+
+//==============================================================================
+GTEST_TEST(FCL_CONTINUOUS_COLLISION, trajectory_matches_segments)
+{
+  testTrajectoryMatchesSegments<double>();
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
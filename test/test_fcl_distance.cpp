@@ -38,6 +38,7 @@
 #include <gtest/gtest.h>
 
 #include "fcl/narrowphase/detail/traversal/collision_node.h"
+#include "fcl/narrowphase/distance.h"
 #include "test_fcl_utility.h"
 #include "eigen_matrix_compare.h"
 #include "fcl_resources/config.h"
@@ -309,6 +310,62 @@ GTEST_TEST(FCL_DISTANCE, mesh_distance)
   test_mesh_distance<double>();
 }
 
+template <typename BV>
+void test_mesh_distance_parallel_traversal()
+{
+  using S = typename BV::S;
+
+  std::vector<Vector3<S>> p1, p2;
+  std::vector<Triangle> t1, t2;
+  test::loadOBJFile(TEST_RESOURCES_DIR"/env.obj", p1, t1);
+  test::loadOBJFile(TEST_RESOURCES_DIR"/rob.obj", p2, t2);
+
+  std::shared_ptr<BVHModel<BV>> m1(new BVHModel<BV>);
+  std::shared_ptr<BVHModel<BV>> m2(new BVHModel<BV>);
+  m1->beginModel();
+  m1->addSubModel(p1, t1);
+  m1->endModel();
+  m2->beginModel();
+  m2->addSubModel(p2, t2);
+  m2->endModel();
+
+  aligned_vector<Transform3<S>> transforms;
+  S extents[] = {-3000, -3000, 0, 3000, 3000, 3000};
+  test::generateRandomTransforms(extents, transforms, 20);
+
+  for(const auto& tf : transforms)
+  {
+    CollisionObject<S> o1(m1, tf);
+    CollisionObject<S> o2(m2, Transform3<S>::Identity());
+
+    DistanceRequest<S> request(true);
+    DistanceResult<S> serial_result;
+    distance(&o1, &o2, request, serial_result);
+
+    request.enable_parallel_traversal = true;
+    request.num_traversal_threads = 4;
+    DistanceResult<S> parallel_result;
+    distance(&o1, &o2, request, parallel_result);
+
+    EXPECT_NEAR(serial_result.min_distance, parallel_result.min_distance,
+                constants<S>::eps_34());
+    if(parallel_result.min_distance > 0)
+    {
+      EXPECT_NEAR((parallel_result.nearest_points[0]
+                   - parallel_result.nearest_points[1]).norm(),
+                  parallel_result.min_distance, 1e-6);
+    }
+  }
+}
+
+GTEST_TEST(FCL_DISTANCE, mesh_distance_parallel_traversal)
+{
+  test_mesh_distance_parallel_traversal<AABB<double>>();
+  test_mesh_distance_parallel_traversal<RSS<double>>();
+  test_mesh_distance_parallel_traversal<kIOS<double>>();
+  test_mesh_distance_parallel_traversal<OBBRSS<double>>();
+}
+
 template <typename S>
 void NearestPointFromDegenerateSimplex() {
   // Tests a historical bug. In certain configurations, the distance query
@@ -0,0 +1,188 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+#include <gtest/gtest.h>
+
+#include "fcl/narrowphase/collision.h"
+#include "fcl/narrowphase/distance.h"
+#include "fcl/geometry/shape/cone.h"
+#include "fcl/geometry/shape/cylinder.h"
+#include "fcl/geometry/shape/ellipsoid.h"
+
+using namespace fcl;
+
+//==============================================================================
+// The pose of the cylinder at step i of a smooth motion around the ellipsoid,
+// passing through it when offset is small.
+template <typename S>
+Transform3<S> trajectoryPose(int i, S offset)
+{
+  const S t = 0.01 * i;
+  Transform3<S> tf = Transform3<S>::Identity();
+  tf.linear() = AngleAxis<S>(t, Vector3<S>(1, 2, 3).normalized()).matrix();
+  tf.translation() = Vector3<S>(offset + 0.2 * std::cos(t), 0.3 * std::sin(t), 0.1 * t);
+  return tf;
+}
+
+//==============================================================================
+template <typename S>
+void testGJKSimplexCacheWarmStart()
+{
+  // Ellipsoid-cylinder pairs have no closed-form solution, so the built-in
+  // solver runs GJK on them.
+  auto ellipsoid = std::make_shared<Ellipsoid<S>>(0.5, 1.0, 0.7);
+  auto cylinder = std::make_shared<Cylinder<S>>(0.6, 1.8);
+  const Transform3<S> tf1 = Transform3<S>::Identity();
+
+  DistanceRequest<S> distance_request(true);
+  distance_request.gjk_solver_type = GST_INDEP;
+  CollisionRequest<S> collision_request(1, true);
+  collision_request.gjk_solver_type = GST_INDEP;
+
+  const int steps = 50;
+
+  // Separated: the distances match the ones found without the cache.
+  GJKSimplexCache<S> distance_cache;
+  distance_cache.setMeasureIterationsSaved(true);
+  for (int i = 0; i < steps; ++i)
+  {
+    const Transform3<S> tf2 = trajectoryPose<S>(i, 2.5);
+
+    DistanceResult<S> result;
+    const S dist = distance(ellipsoid.get(), tf1, cylinder.get(), tf2,
+                            distance_request, result);
+    DistanceResult<S> cached_result;
+    const S cached_dist = distance(ellipsoid.get(), tf1, cylinder.get(), tf2,
+                                   distance_request, cached_result,
+                                   distance_cache);
+    // GJK stops within its tolerance of the distance; on curved surfaces the
+    // nearest points are known less accurately than that.
+    EXPECT_NEAR(dist, cached_dist, 1e-5);
+    EXPECT_LT((cached_result.nearest_points[0]
+               - result.nearest_points[0]).norm(), 2e-3);
+    EXPECT_LT((cached_result.nearest_points[1]
+               - result.nearest_points[1]).norm(), 2e-3);
+  }
+  EXPECT_EQ(distance_cache.getQueryCount(), static_cast<std::size_t>(steps));
+  EXPECT_EQ(distance_cache.getWarmStartCount(),
+            static_cast<std::size_t>(steps - 1));
+  EXPECT_GT(distance_cache.getIterationsSaved(), 0);
+
+  // Approaching until penetrating: the contacts match the ones found without
+  // the cache, to the accuracy EPA runs to. Only the separated steps, and the
+  // first penetrating one, are warm started.
+  GJKSimplexCache<S> collision_cache;
+  collision_cache.setMeasureIterationsSaved(true);
+  int num_separated = 0;
+  for (int i = 0; i < steps; ++i)
+  {
+    const Transform3<S> tf2 = trajectoryPose<S>(i, 1.6 - 0.03 * i);
+
+    CollisionResult<S> result;
+    collide(ellipsoid.get(), tf1, cylinder.get(), tf2,
+            collision_request, result);
+    CollisionResult<S> cached_result;
+    collide(ellipsoid.get(), tf1, cylinder.get(), tf2,
+            collision_request, cached_result, collision_cache);
+    GTEST_ASSERT_EQ(result.isCollision(), cached_result.isCollision());
+    if (!result.isCollision())
+    {
+      ++num_separated;
+      continue;
+    }
+
+    const Contact<S>& contact = result.getContact(0);
+    const Contact<S>& cached_contact = cached_result.getContact(0);
+    EXPECT_NEAR(contact.penetration_depth, cached_contact.penetration_depth,
+                collision_request.gjk_tolerance);
+    EXPECT_LT((contact.normal - cached_contact.normal).norm(),
+              collision_request.gjk_tolerance);
+  }
+  GTEST_ASSERT_GT(num_separated, 1);
+  GTEST_ASSERT_LT(num_separated, steps);
+  EXPECT_EQ(collision_cache.getWarmStartCount(),
+            static_cast<std::size_t>(num_separated));
+
+  collision_cache.clear();
+  EXPECT_EQ(collision_cache.getQueryCount(), 0u);
+  EXPECT_EQ(collision_cache.getIterationsSaved(), 0);
+}
+
+//==============================================================================
+template <typename S>
+void testGJKSimplexCacheNewPair()
+{
+  auto ellipsoid = std::make_shared<Ellipsoid<S>>(0.5, 1.0, 0.7);
+  auto cylinder = std::make_shared<Cylinder<S>>(0.6, 1.8);
+  auto cone = std::make_shared<Cone<S>>(0.8, 1.2);
+  const Transform3<S> tf1 = Transform3<S>::Identity();
+  const Transform3<S> tf2 = trajectoryPose<S>(0, 2.5);
+
+  DistanceRequest<S> request;
+  request.gjk_solver_type = GST_INDEP;
+  DistanceResult<S> result;
+
+  // A cache given another pair of shapes starts that pair cold.
+  GJKSimplexCache<S> cache;
+  distance(ellipsoid.get(), tf1, cylinder.get(), tf2, request, result, cache);
+  distance(ellipsoid.get(), tf1, cone.get(), tf2, request, result, cache);
+  EXPECT_EQ(cache.getWarmStartCount(), 0u);
+  distance(ellipsoid.get(), tf1, cone.get(), tf2, request, result, cache);
+  EXPECT_EQ(cache.getWarmStartCount(), 1u);
+
+  // The libccd solver leaves the cache alone.
+  request.gjk_solver_type = GST_LIBCCD;
+  distance(ellipsoid.get(), tf1, cone.get(), tf2, request, result, cache);
+  EXPECT_EQ(cache.getQueryCount(), 3u);
+}
+
+//==============================================================================
+GTEST_TEST(FCL_GJK_SIMPLEX_CACHE, warm_start)
+{
+  testGJKSimplexCacheWarmStart<double>();
+}
+
+//==============================================================================
+GTEST_TEST(FCL_GJK_SIMPLEX_CACHE, new_pair)
+{
+  testGJKSimplexCacheNewPair<double>();
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
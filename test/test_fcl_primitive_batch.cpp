@@ -0,0 +1,253 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#include <gtest/gtest.h>
+
+#include "fcl/narrowphase/primitive_batch.h"
+#include "fcl/narrowphase/detail/primitive_shape_algorithm/capsule_capsule.h"
+#include "fcl/narrowphase/detail/primitive_shape_algorithm/sphere_box.h"
+#include "fcl/narrowphase/detail/primitive_shape_algorithm/sphere_capsule.h"
+#include "fcl/narrowphase/detail/primitive_shape_algorithm/sphere_sphere.h"
+#include "test_fcl_utility.h"
+
+using namespace fcl;
+
+// The batches hold more pairs than one block, and not a multiple of it, so
+// the tests cover the last, partial block.
+const std::size_t kPairCount = 150;
+
+//==============================================================================
+// The signed distance computed one pair at a time by the closed-form
+// algorithms: the distance if they report separation, otherwise minus the
+// penetration depth of the contact.
+template <typename S, typename Shape1, typename Shape2,
+          typename DistanceFunction, typename IntersectFunction>
+S referenceSignedDistance(const Shape1& s1, const Transform3<S>& tf1,
+                          const Shape2& s2, const Transform3<S>& tf2,
+                          DistanceFunction distance,
+                          IntersectFunction intersect)
+{
+  S dist;
+  Vector3<S> p1, p2;
+  if (distance(s1, tf1, s2, tf2, &dist, &p1, &p2))
+    return dist;
+
+  std::vector<ContactPoint<S>> contacts;
+  EXPECT_TRUE(intersect(s1, tf1, s2, tf2, &contacts));
+  EXPECT_EQ(contacts.size(), 1u);
+  return contacts.empty() ? S(0) : -contacts[0].penetration_depth;
+}
+
+//==============================================================================
+// Checks the batched distances against the reference ones and the colliding
+// pairs against the pairs with a non-positive reference distance.
+template <typename S, typename Batch>
+void checkBatch(const Batch& batch, const std::vector<S>& expected, S tol)
+{
+  std::vector<S> distances;
+  batchDistance(batch, distances);
+  GTEST_ASSERT_EQ(distances.size(), expected.size());
+
+  std::vector<std::size_t> expected_colliding;
+  for (std::size_t i = 0; i < expected.size(); ++i)
+  {
+    EXPECT_NEAR(distances[i], expected[i], tol) << "pair " << i;
+    if (expected[i] <= 0)
+      expected_colliding.push_back(i);
+  }
+
+  std::vector<std::size_t> colliding;
+  EXPECT_EQ(batchCollide(batch, colliding), expected_colliding.size());
+  EXPECT_EQ(colliding, expected_colliding);
+}
+
+//==============================================================================
+template <typename S>
+aligned_vector<Transform3<S>> randomPoses(std::size_t n)
+{
+  S extents[] = {-1, -1, -1, 1, 1, 1};
+  aligned_vector<Transform3<S>> transforms;
+  test::generateRandomTransforms(extents, transforms, n);
+  return transforms;
+}
+
+//==============================================================================
+template <typename S>
+void testSphereSphereBatch(S tol)
+{
+  const auto poses1 = randomPoses<S>(kPairCount);
+  const auto poses2 = randomPoses<S>(kPairCount);
+
+  SphereSphereBatch<S> batch;
+  batch.reserve(kPairCount + 1);
+  std::vector<S> expected;
+  for (std::size_t i = 0; i < kPairCount; ++i)
+  {
+    const Sphere<S> s1(0.1 + 0.4 * i / kPairCount);
+    const Sphere<S> s2(0.3);
+    batch.add(s1, poses1[i], s2, poses2[i]);
+    expected.push_back(referenceSignedDistance(
+        s1, poses1[i], s2, poses2[i],
+        detail::sphereSphereDistance<S>, detail::sphereSphereIntersect<S>));
+  }
+
+  // Concentric spheres.
+  batch.add(Sphere<S>(0.2), poses1[0], Sphere<S>(0.5), poses1[0]);
+  expected.push_back(-0.7);
+
+  EXPECT_EQ(batch.size(), kPairCount + 1);
+  checkBatch(batch, expected, tol);
+
+  batch.clear();
+  EXPECT_EQ(batch.size(), 0u);
+  checkBatch(batch, std::vector<S>(), tol);
+}
+
+//==============================================================================
+template <typename S>
+void testSphereCapsuleBatch(S tol)
+{
+  const auto poses1 = randomPoses<S>(kPairCount);
+  const auto poses2 = randomPoses<S>(kPairCount);
+
+  SphereCapsuleBatch<S> batch;
+  std::vector<S> expected;
+  for (std::size_t i = 0; i < kPairCount; ++i)
+  {
+    const Sphere<S> s1(0.2);
+    // Every tenth capsule has a zero length: a sphere.
+    const Capsule<S> s2(0.1 + 0.2 * i / kPairCount, i % 10 ? 0.8 : 0.0);
+    batch.add(s1, poses1[i], s2, poses2[i]);
+    expected.push_back(referenceSignedDistance(
+        s1, poses1[i], s2, poses2[i],
+        detail::sphereCapsuleDistance<S>, detail::sphereCapsuleIntersect<S>));
+  }
+
+  EXPECT_EQ(batch.size(), kPairCount);
+  checkBatch(batch, expected, tol);
+}
+
+//==============================================================================
+template <typename S>
+void testCapsuleCapsuleBatch(S tol)
+{
+  const auto poses1 = randomPoses<S>(kPairCount);
+  auto poses2 = randomPoses<S>(kPairCount);
+  // Parallel center lines.
+  for (std::size_t i = 0; i < kPairCount; i += 7)
+    poses2[i].linear() = poses1[i].linear();
+
+  CapsuleCapsuleBatch<S> batch;
+  std::vector<S> expected;
+  for (std::size_t i = 0; i < kPairCount; ++i)
+  {
+    // Some capsules of zero length, one or both of the pair.
+    const Capsule<S> s1(0.15, i % 5 ? 1.0 : 0.0);
+    const Capsule<S> s2(0.1 + 0.2 * i / kPairCount, i % 3 ? 0.6 : 0.0);
+    batch.add(s1, poses1[i], s2, poses2[i]);
+
+    S dist;
+    Vector3<S> p1, p2;
+    detail::capsuleCapsuleDistance(s1, poses1[i], s2, poses2[i],
+                                   &dist, &p1, &p2);
+    expected.push_back(dist);
+  }
+
+  EXPECT_EQ(batch.size(), kPairCount);
+  checkBatch(batch, expected, tol);
+}
+
+//==============================================================================
+template <typename S>
+void testSphereBoxBatch(S tol)
+{
+  const auto poses1 = randomPoses<S>(kPairCount);
+  const auto poses2 = randomPoses<S>(kPairCount);
+
+  SphereBoxBatch<S> batch;
+  std::vector<S> expected;
+  for (std::size_t i = 0; i < kPairCount; ++i)
+  {
+    const Sphere<S> s1(0.1 + 0.2 * i / kPairCount);
+    const Box<S> s2(0.4, 0.8, 1.2);
+    // Every tenth sphere center is inside the box.
+    Transform3<S> pose1 = poses1[i];
+    if (i % 10 == 0)
+      pose1.translation() = poses2[i] * Vector3<S>(0.1, -0.3, 0.2);
+    batch.add(s1, pose1, s2, poses2[i]);
+    expected.push_back(referenceSignedDistance(
+        s1, pose1, s2, poses2[i],
+        detail::sphereBoxDistance<S>, detail::sphereBoxIntersect<S>));
+  }
+
+  EXPECT_EQ(batch.size(), kPairCount);
+  checkBatch(batch, expected, tol);
+}
+
+//==============================================================================
+GTEST_TEST(FCL_PRIMITIVE_BATCH, sphere_sphere)
+{
+  testSphereSphereBatch<double>(1e-12);
+  testSphereSphereBatch<float>(1e-5f);
+}
+
+//==============================================================================
+GTEST_TEST(FCL_PRIMITIVE_BATCH, sphere_capsule)
+{
+  testSphereCapsuleBatch<double>(1e-12);
+  testSphereCapsuleBatch<float>(1e-5f);
+}
+
+//==============================================================================
+GTEST_TEST(FCL_PRIMITIVE_BATCH, capsule_capsule)
+{
+  testCapsuleCapsuleBatch<double>(1e-12);
+  testCapsuleCapsuleBatch<float>(1e-5f);
+}
+
+//==============================================================================
+GTEST_TEST(FCL_PRIMITIVE_BATCH, sphere_box)
+{
+  testSphereBoxBatch<double>(1e-12);
+  testSphereBoxBatch<float>(1e-5f);
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
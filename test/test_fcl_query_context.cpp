@@ -0,0 +1,290 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011-2014, Willow Garage, Inc.
+ *  Copyright (c) 2014-2016, Open Source Robotics Foundation
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Open Source Robotics Foundation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#include <new>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include "fcl/narrowphase/collision.h"
+#include "fcl/narrowphase/distance.h"
+#include "fcl/geometry/shape/box.h"
+#include "fcl/geometry/shape/convex.h"
+#include "fcl/geometry/shape/cylinder.h"
+#include "fcl/geometry/shape/ellipsoid.h"
+#include "test_fcl_utility.h"
+
+using namespace fcl;
+
+//==============================================================================
+template <typename S>
+void testQueryContextMatchesPlainQueries(GJKSolverType solver_type)
+{
+  auto box = std::make_shared<Box<S>>(1.0, 2.0, 1.5);
+  auto ellipsoid = std::make_shared<Ellipsoid<S>>(0.5, 1.0, 0.7);
+  auto cylinder = std::make_shared<Cylinder<S>>(0.6, 1.8);
+
+  std::vector<CollisionObject<S>> objs;
+  objs.emplace_back(box);
+  objs.emplace_back(ellipsoid);
+  objs.emplace_back(cylinder);
+
+  S extents[] = {-2, -2, -2, 2, 2, 2};
+  aligned_vector<Transform3<S>> transforms;
+  test::generateRandomTransforms(extents, transforms, 50 * objs.size());
+
+  CollisionRequest<S> collision_request(1, true);
+  collision_request.gjk_solver_type = solver_type;
+  DistanceRequest<S> distance_request(true);
+  distance_request.gjk_solver_type = solver_type;
+
+  // A single context serves every query, interleaving collision and distance
+  // requests so that the reused solver state is exercised.
+  QueryContext<S> context;
+  const S tol = 1e-12;
+  std::size_t num_collisions = 0;
+  for (std::size_t i = 0; i < transforms.size(); i += objs.size())
+  {
+    for (std::size_t j = 0; j < objs.size(); ++j)
+      objs[j].setTransform(transforms[i + j]);
+
+    for (std::size_t j = 0; j < objs.size(); ++j)
+    {
+      for (std::size_t k = j; k < objs.size(); ++k)
+      {
+        if (j == k) continue;
+
+        CollisionResult<S> expected_collision;
+        CollisionResult<S> collision;
+        collide(&objs[j], &objs[k], collision_request, expected_collision);
+        collide(&objs[j], &objs[k], collision_request, collision, context);
+        GTEST_ASSERT_EQ(collision.numContacts(),
+                        expected_collision.numContacts());
+        if (collision.isCollision())
+        {
+          ++num_collisions;
+          EXPECT_NEAR(collision.getContact(0).penetration_depth,
+                      expected_collision.getContact(0).penetration_depth,
+                      tol);
+          EXPECT_TRUE(collision.getContact(0).normal.isApprox(
+                        expected_collision.getContact(0).normal));
+        }
+
+        DistanceResult<S> expected_distance;
+        DistanceResult<S> distance_result;
+        const S expected = distance(&objs[j], &objs[k], distance_request,
+                                    expected_distance);
+        const S actual = distance(&objs[j], &objs[k], distance_request,
+                                  distance_result, context);
+        EXPECT_NEAR(actual, expected, tol);
+      }
+    }
+  }
+
+  // The random placements must have produced penetrating pairs, otherwise the
+  // EPA workspace was never used.
+  EXPECT_GT(num_collisions, 0u);
+}
+
+//==============================================================================
+// A convex polytope of many vertices approximating a sphere, so that its
+// support searches climb the vertex adjacency graph.
+template <typename S>
+std::shared_ptr<Convex<S>> makeConvexBall(S radius)
+{
+  const int rings = 20;
+  const int segments = 40;
+  auto vertices = std::make_shared<std::vector<Vector3<S>>>();
+  auto faces = std::make_shared<std::vector<int>>();
+  vertices->emplace_back(0, 0, radius);
+  vertices->emplace_back(0, 0, -radius);
+  for (int i = 0; i < rings; ++i)
+  {
+    const S polar = constants<S>::pi() * (i + 1) / (rings + 1);
+    for (int j = 0; j < segments; ++j)
+    {
+      const S azimuth = 2 * constants<S>::pi() * j / segments;
+      vertices->push_back(radius * Vector3<S>(
+          std::sin(polar) * std::cos(azimuth),
+          std::sin(polar) * std::sin(azimuth), std::cos(polar)));
+    }
+  }
+
+  auto vertex = [&](int ring, int segment) {
+    return 2 + ring * segments + segment % segments;
+  };
+  for (int j = 0; j < segments; ++j)
+  {
+    faces->insert(faces->end(), {3, 0, vertex(0, j), vertex(0, j + 1)});
+    faces->insert(faces->end(),
+                  {3, 1, vertex(rings - 1, j + 1), vertex(rings - 1, j)});
+    for (int i = 0; i + 1 < rings; ++i)
+      faces->insert(faces->end(), {4, vertex(i, j), vertex(i + 1, j),
+                                   vertex(i + 1, j + 1), vertex(i, j + 1)});
+  }
+  return std::make_shared<Convex<S>>(vertices, segments * (rings + 1), faces);
+}
+
+//==============================================================================
+// The support vertices remembered by a context must not change the results of
+// later queries on the same convex pair.
+template <typename S>
+void testQueryContextConvexSupportCache()
+{
+  auto ball = makeConvexBall<S>(1.0);
+  auto box = std::make_shared<Box<S>>(1.0, 2.0, 1.5);
+  CollisionObject<S> o1(ball);
+  CollisionObject<S> o2(box);
+
+  S extents[] = {-1.5, -1.5, -1.5, 1.5, 1.5, 1.5};
+  aligned_vector<Transform3<S>> transforms;
+  test::generateRandomTransforms(extents, transforms, 100);
+
+  CollisionRequest<S> collision_request(1, true);
+  collision_request.gjk_solver_type = GST_INDEP;
+  DistanceRequest<S> distance_request(true);
+  distance_request.gjk_solver_type = GST_INDEP;
+
+  QueryContext<S> context;
+  const S tol = 1e-6;
+  for (const auto& tf : transforms)
+  {
+    o2.setTransform(tf);
+
+    CollisionResult<S> expected_collision;
+    CollisionResult<S> collision;
+    collide(&o1, &o2, collision_request, expected_collision);
+    collide(&o1, &o2, collision_request, collision, context);
+    GTEST_ASSERT_EQ(collision.numContacts(), expected_collision.numContacts());
+    if (collision.isCollision())
+    {
+      // The context solver runs EPA to the request's GJK tolerance.
+      EXPECT_NEAR(collision.getContact(0).penetration_depth,
+                  expected_collision.getContact(0).penetration_depth,
+                  collision_request.gjk_tolerance);
+    }
+
+    DistanceResult<S> expected_distance;
+    DistanceResult<S> distance_result;
+    EXPECT_NEAR(distance(&o1, &o2, distance_request, distance_result, context),
+                distance(&o1, &o2, distance_request, expected_distance), tol);
+  }
+
+  EXPECT_EQ(context.getSupportVertexCache().size(), 1u);
+
+  // The cache holds the support vertex last found on the ball, not the
+  // vertex the searches started from.
+  detail::MinkowskiDiff<S> shape;
+  shape.shapes[0] = ball.get();
+  shape.shapes[1] = box.get();
+  context.getSupportVertexCache().load(shape);
+  EXPECT_NE(shape.support_hints[0], 0);
+
+  context.getSupportVertexCache().clear();
+  EXPECT_EQ(context.getSupportVertexCache().size(), 0u);
+}
+
+//==============================================================================
+// The cache drops the hints of a destroyed Convex and stays within max_size.
+template <typename S>
+void testSupportVertexCacheStaleAndBounded()
+{
+  auto box = std::make_shared<Box<S>>(1.0, 2.0, 1.5);
+  detail::SupportVertexCache<S> cache;
+  detail::MinkowskiDiff<S> shape;
+
+  typename std::aligned_storage<sizeof(Convex<S>), alignof(Convex<S>)>::type
+      storage;
+  Convex<S>* convex = new (&storage) Convex<S>(*makeConvexBall<S>(1.0));
+  shape.shapes[0] = convex;
+  shape.shapes[1] = box.get();
+  shape.support_hints[0] = 5;
+  cache.store(shape);
+  shape.support_hints[0] = 0;
+  cache.load(shape);
+  EXPECT_EQ(shape.support_hints[0], 5);
+
+  // A new ball at the address of the old one has vertices of its own.
+  convex->~Convex<S>();
+  convex = new (&storage) Convex<S>(*makeConvexBall<S>(1.0));
+  shape.shapes[0] = convex;
+  shape.support_hints[0] = 0;
+  cache.load(shape);
+  EXPECT_EQ(shape.support_hints[0], 0);
+
+  std::vector<std::shared_ptr<Box<S>>> boxes;
+  for (std::size_t i = 0; i <= detail::SupportVertexCache<S>::max_size; ++i)
+  {
+    boxes.push_back(std::make_shared<Box<S>>(1.0, 1.0, 1.0));
+    shape.shapes[1] = boxes.back().get();
+    cache.store(shape);
+    EXPECT_LE(cache.size(), detail::SupportVertexCache<S>::max_size);
+  }
+  EXPECT_GT(cache.size(), 0u);
+
+  convex->~Convex<S>();
+}
+
+//==============================================================================
+GTEST_TEST(FCL_QUERY_CONTEXT, matches_plain_queries_libccd)
+{
+  testQueryContextMatchesPlainQueries<double>(GST_LIBCCD);
+}
+
+//==============================================================================
+GTEST_TEST(FCL_QUERY_CONTEXT, matches_plain_queries_indep)
+{
+  testQueryContextMatchesPlainQueries<double>(GST_INDEP);
+}
+
+//==============================================================================
+GTEST_TEST(FCL_QUERY_CONTEXT, convex_support_cache)
+{
+  testQueryContextConvexSupportCache<double>();
+}
+
+//==============================================================================
+GTEST_TEST(FCL_QUERY_CONTEXT, convex_support_cache_stale_and_bounded)
+{
+  testSupportVertexCacheStaleAndBounded<double>();
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}